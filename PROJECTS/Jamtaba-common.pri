@@ -48,6 +48,8 @@ HEADERS += looper/Looper.h
 HEADERS += looper/LooperLayer.h
 HEADERS += looper/LooperStates.h
 HEADERS += looper/LooperPersistence.h
+HEADERS += looper/LoopInfo.h
+HEADERS += looper/LoopsIndex.h
 HEADERS += audio/core/AudioDriver.h
 HEADERS += audio/core/AudioNode.h
 HEADERS += audio/core/LocalInputNode.h
@@ -55,6 +57,7 @@ HEADERS += audio/core/LocalInputGroup.h
 HEADERS += audio/core/AudioNodeProcessor.h
 HEADERS += audio/core/AudioMixer.h
 HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/SamplesRingBuffer.h
 HEADERS += audio/core/AudioPeak.h
 HEADERS += audio/core/Plugins.h
 HEADERS += audio/core/Filters.h
@@ -62,8 +65,13 @@ HEADERS += audio/core/PluginDescriptor.h
 HEADERS += audio/Encoder.h
 HEADERS += audio/vorbis/VorbisDecoder.h
 HEADERS += audio/vorbis/VorbisEncoder.h
+HEADERS += audio/vorbis/AdaptiveEncodingQuality.h
 HEADERS += audio/RoomStreamerNode.h
+HEADERS += audio/RoomStreamPipeline.h
+HEADERS += audio/RoomStreamPrefetcher.h
 HEADERS += audio/NinjamTrackNode.h
+HEADERS += audio/IntervalTelemetry.h
+HEADERS += audio/HostPositionFollower.h
 HEADERS += audio/MetronomeTrackNode.h
 HEADERS += audio/SamplesBufferResampler.h
 HEADERS += audio/SamplesBufferRecorder.h
@@ -73,9 +81,11 @@ HEADERS += video/FFMpegMuxer.h
 HEADERS += video/FFMpegDemuxer.h
 HEADERS += video/VideoFrameGrabber.h
 HEADERS += video/VideoWidget.h
+HEADERS += video/VideoFrameScaler.h
 HEADERS += file/FileReader.h
 HEADERS += file/FileReaderFactory.h
 HEADERS += file/WaveFileReader.h
+HEADERS += file/MappedWaveFile.h
 HEADERS += file/WaveFileWriter.h
 HEADERS += file/OggFileReader.h
 HEADERS += file/Mp3FileReader.h
@@ -127,6 +137,7 @@ HEADERS += gui/widgets/PeakMeter.h
 HEADERS += gui/widgets/WavePeakPanel.h
 HEADERS += gui/widgets/UserNameLineEdit.h
 HEADERS += gui/widgets/MapWidget.h
+HEADERS += gui/widgets/MapTilesLoader.h
 HEADERS += gui/widgets/MapMarker.h
 HEADERS += gui/widgets/MultiStateButton.h
 HEADERS += gui/widgets/BlinkableButton.h
@@ -149,11 +160,13 @@ HEADERS += gui/ThemeLoader.h
 HEADERS += ninjam/UserChannel.h
 HEADERS += geo/IpToLocationResolver.h
 HEADERS += geo/WebIpToLocationResolver.h
+HEADERS += geo/IpLocationTable.h
 HEADERS += Utils.h
 HEADERS += Configurator.h
 HEADERS += persistence/Settings.h
 HEADERS += persistence/UsersDataCache.h
 HEADERS += persistence/CacheHeader.h
+HEADERS += persistence/SettingsWriter.h
 HEADERS += log/Logging.h
 HEADERS += UploadIntervalData.h
 HEADERS += performance/PerformanceMonitor.h
@@ -168,6 +181,8 @@ SOURCES += looper/LooperLayer.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += file/WaveFileWriter.cpp
 SOURCES += looper/LooperPersistence.cpp
+SOURCES += looper/LoopInfo.cpp
+SOURCES += looper/LoopsIndex.cpp
 SOURCES += audio/core/AudioDriver.cpp
 SOURCES += audio/core/AudioNode.cpp
 SOURCES += audio/core/LocalInputNode.cpp
@@ -176,23 +191,31 @@ SOURCES += audio/core/AudioNodeProcessor.cpp
 SOURCES += audio/core/AudioMixer.cpp
 SOURCES += audio/core/Filters.cpp
 SOURCES += audio/RoomStreamerNode.cpp
+SOURCES += audio/RoomStreamPipeline.cpp
+SOURCES += audio/RoomStreamPrefetcher.cpp
 SOURCES += audio/core/Plugins.cpp
 SOURCES += audio/Mp3Decoder.cpp
 SOURCES += audio/NinjamTrackNode.cpp
+SOURCES += audio/IntervalTelemetry.cpp
+SOURCES += audio/HostPositionFollower.cpp
 SOURCES += audio/MetronomeTrackNode.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/SamplesRingBuffer.cpp
 SOURCES += audio/core/PluginDescriptor.cpp
 SOURCES += audio/SamplesBufferResampler.cpp
 SOURCES += audio/vorbis/VorbisDecoder.cpp
 SOURCES += audio/vorbis/VorbisEncoder.cpp
+SOURCES += audio/vorbis/AdaptiveEncodingQuality.cpp
 SOURCES += audio/core/AudioPeak.cpp
 SOURCES += audio/Resampler.cpp
 SOURCES += video/FFMpegMuxer.cpp
 SOURCES += video/FFMpegDemuxer.cpp
 SOURCES += video/VideoFrameGrabber.cpp
 SOURCES += video/VideoWidget.cpp
+SOURCES += video/VideoFrameScaler.cpp
 SOURCES += file/FileReaderFactory.cpp
 SOURCES += file/WaveFileReader.cpp
+SOURCES += file/MappedWaveFile.cpp
 SOURCES += file/OggFileReader.cpp
 SOURCES += file/Mp3FileReader.cpp
 SOURCES += file/FileUtils.cpp
@@ -251,6 +274,7 @@ SOURCES += gui/widgets/IntervalChunksDisplay.cpp
 SOURCES += gui/widgets/MarqueeLabel.cpp
 SOURCES += gui/widgets/MapMarker.cpp
 SOURCES += gui/widgets/MapWidget.cpp
+SOURCES += gui/widgets/MapTilesLoader.cpp
 SOURCES += gui/widgets/MultiStateButton.cpp
 SOURCES += gui/widgets/BlinkableButton.cpp
 SOURCES += gui/widgets/BoostSpinBox.cpp
@@ -268,11 +292,13 @@ SOURCES += gui/ThemeLoader.cpp
 SOURCES += geo/IpToLocationResolver.cpp
 SOURCES += log/logging.cpp
 SOURCES += geo/WebIpToLocationResolver.cpp
+SOURCES += geo/IpLocationTable.cpp
 SOURCES += loginserver/LoginService.cpp
 SOURCES += Configurator.cpp
 SOURCES += persistence/UsersDataCache.cpp
 SOURCES += persistence/Settings.cpp
 SOURCES += persistence/CacheHeader.cpp
+SOURCES += persistence/SettingsWriter.cpp
 SOURCES += UploadIntervalData.cpp
 
 #multiplatform implementations
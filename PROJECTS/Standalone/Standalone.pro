@@ -41,10 +41,13 @@ HEADERS += audio/PortAudioDriver.h
 HEADERS += audio/Host.h
 HEADERS += midi/RtMidiDriver.h
 HEADERS += vst/VstPlugin.h
+HEADERS += vst/SandboxedVstPlugin.h
+HEADERS += vst/SandboxChannel.h
 HEADERS += vst/VstHost.h
 HEADERS += vst/VstLoader.h
 HEADERS += PluginFinder.h
 HEADERS += vst/VstPluginFinder.h
+HEADERS += vst/VstScanCache.h
 HEADERS += vst/Utils.h
 HEADERS += Libs/SingleApplication/singleapplication.h
 
@@ -64,9 +67,12 @@ SOURCES += gui/FxPanelItem.cpp
 SOURCES += gui/MidiToolsDialog.cpp
 SOURCES += midi/RtMidiDriver.cpp
 SOURCES += vst/VstPlugin.cpp
+SOURCES += vst/SandboxedVstPlugin.cpp
+SOURCES += vst/SandboxChannel.cpp
 SOURCES += vst/VstHost.cpp
 SOURCES += PluginFinder.cpp
 SOURCES += vst/VstPluginFinder.cpp
+SOURCES += vst/VstScanCache.cpp
 SOURCES += vst/Utils.cpp
 SOURCES += vst/VstLoader.cpp
 SOURCES += Libs/SingleApplication/singleapplication.cpp
@@ -37,11 +37,15 @@ VPATH       += $$SOURCE_PATH/Scanners
 HEADERS += vst/VstHost.h
 HEADERS += vst/Utils.h
 HEADERS += VstScanner/VstPluginScanner.h
+HEADERS += VstScanner/VstSandboxHost.h
+HEADERS += vst/SandboxChannel.h
 HEADERS += BaseScanner.h
 
 SOURCES += VstScanner/main.cpp
 SOURCES += BaseScanner.cpp
 SOURCES += VstScanner/VstPluginScanner.cpp
+SOURCES += VstScanner/VstSandboxHost.cpp
+SOURCES += vst/SandboxChannel.cpp
 SOURCES += vst/VstHost.cpp
 SOURCES += vst/VstLoader.cpp
 SOURCES += vst/Utils.cpp
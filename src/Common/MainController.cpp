@@ -17,6 +17,7 @@
 #include "audio/core/AudioNode.h"
 #include "audio/core/LocalInputNode.h"
 #include "ThemeLoader.h"
+#include "persistence/SettingsWriter.h"
 
 #include <QBuffer>
 #include <QByteArray>
@@ -44,7 +45,9 @@ MainController::MainController(const Settings &settings) :
     mainWindow(nullptr),
     masterGain(1),
     lastInputTrackID(0),
+    maxPluginsLatency(0),
     usersDataCache(Configurator::getInstance()->getCacheDir()),
+    loopsIndex(Configurator::getInstance()->getCacheDir()),
     lastFrameTimeStamp(0),
     videoEncoder()
 {
@@ -127,6 +130,14 @@ void MainController::setEncodingQuality(float newEncodingQuality)
         ninjamController->recreateEncoders();
 }
 
+void MainController::setAdaptiveEncodingQuality(bool adaptive)
+{
+    settings.setAdaptiveEncodingQuality(adaptive);
+
+    if (isPlayingInNinjamRoom())
+        ninjamController->recreateEncoders();
+}
+
 void MainController::finishUploads()
 {
     for (int channelIndex : audioIntervalsToUpload.keys()) {
@@ -440,9 +451,12 @@ void MainController::removeAllInputTracks()
 
 void MainController::removeInputTrackNode(int inputTrackIndex)
 {
-    QMutexLocker locker(&mutex);
+    {
+        QMutexLocker locker(&mutex);
+
+        if (!inputTracks.contains(inputTrackIndex))
+            return;
 
-    if (inputTracks.contains(inputTrackIndex)) {
         // remove from group
         Audio::LocalInputNode *inputTrack = inputTracks[inputTrackIndex];
         int trackGroupIndex = inputTrack->getChanneGrouplIndex();
@@ -453,8 +467,11 @@ void MainController::removeInputTrackNode(int inputTrackIndex)
         }
 
         inputTracks.remove(inputTrackIndex);
-        removeTrack(inputTrackIndex);
     }
+
+    removeTrack(inputTrackIndex); // the node is deleted out of the lock
+
+    updateLatencyCompensation(); // the removed track can be the slowest track
 }
 
 int MainController::addInputTrackNode(Audio::LocalInputNode *inputTrackNode)
@@ -463,12 +480,17 @@ int MainController::addInputTrackNode(Audio::LocalInputNode *inputTrackNode)
     inputTracks.insert(inputTrackID, inputTrackNode);
     addTrack(inputTrackID, inputTrackNode);
 
+    if (ninjamController && ninjamController->isRunning()) // the looper memory is allocated here, not in the next interval start
+        inputTrackNode->getLooper()->reserve(ninjamController->getSamplesPerInterval());
+
     int trackGroupIndex = inputTrackNode->getChanneGrouplIndex();
     if (!trackGroups.contains(trackGroupIndex))
         trackGroups.insert(trackGroupIndex, new Audio::LocalInputGroup(trackGroupIndex, inputTrackNode));
     else
         trackGroups[trackGroupIndex]->addInputNode(inputTrackNode);
 
+    updateLatencyCompensation(); // the new track (without plugins) is aligned with the slowest track
+
     return inputTrackID;
 }
 
@@ -603,18 +625,29 @@ void MainController::storeIOSettings(int firstIn, int lastIn, int firstOut, int
 
 void MainController::removeTrack(long trackID)
 {
-    QMutexLocker locker(&mutex);
-    /** remove Track is called from ninjam service thread, and cause a crash if the process callback (audio Thread) is iterating over tracksNodes to render audio */
+    Audio::AudioNode *trackNode = nullptr;
+    {
+        QMutexLocker locker(&mutex);
+        /** remove Track is called from ninjam service thread, and cause a crash if the process callback (audio Thread) is iterating over tracksNodes to render audio */
 
-    auto trackNode = tracksNodes[trackID];
-    if (trackNode) {
+        trackNode = tracksNodes.take(trackID);
+        if (trackNode)
+            audioMixer.removeNode(trackNode);
+    }
+
+    if (trackNode) { // the audio thread is not using the node anymore, the plugins are unloaded without blocking it
         trackNode->suspendProcessors();
-        audioMixer.removeNode(trackNode);
-        tracksNodes.remove(trackID);
         delete trackNode;
     }
 }
 
+void MainController::reserveLoopersMemory(uint intervalLenght)
+{
+    for (LocalInputNode *inputTrack : inputTracks.values()) {
+        inputTrack->getLooper()->reserve(intervalLenght);
+    }
+}
+
 void MainController::setAllLoopersStatus(bool activated)
 {
     for (LocalInputNode *inputTrack : inputTracks.values()) {
@@ -661,6 +694,33 @@ void MainController::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffe
     }
 }
 
+void MainController::updateLatencyCompensation()
+{
+    // the tracks with less plugins latency are delayed to stay aligned with the slowest track
+    int maxLatency = 0;
+    for (Audio::LocalInputNode *inputTrack : inputTracks)
+        maxLatency = qMax(maxLatency, inputTrack->getProcessorsLatency());
+
+    // the delay lines are allocated here, the audio thread is locked just to swap them
+    QList<QPair<Audio::LocalInputNode *, Audio::SamplesBuffer *>> delayLines;
+    for (Audio::LocalInputNode *inputTrack : inputTracks) {
+        int compensation = qBound(0, maxLatency - inputTrack->getProcessorsLatency(), Audio::LocalInputNode::MAX_LATENCY_COMPENSATION);
+        if (compensation != inputTrack->getLatencyCompensation())
+            delayLines.append(qMakePair(inputTrack, compensation > 0 ? new Audio::SamplesBuffer(2, compensation) : nullptr));
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        for (auto &delayLine : delayLines)
+            delayLine.second = delayLine.first->setLatencyCompensationBuffer(delayLine.second); // the previous delay line is returned
+    }
+
+    for (const auto &delayLine : delayLines)
+        delete delayLine.second;
+
+    maxPluginsLatency.store(maxLatency);
+}
+
 void MainController::syncWithNinjamIntervalStart(uint intervalLenght)
 {
     for (Audio::LocalInputNode *inputTrack : inputTracks.values()) {
@@ -670,9 +730,8 @@ void MainController::syncWithNinjamIntervalStart(uint intervalLenght)
 
 Audio::AudioPeak MainController::getTrackPeak(int trackID)
 {
-    QMutexLocker locker(&mutex);
-
-    auto trackNode = tracksNodes[trackID];
+    // the tracks are added and removed in this (GUI) thread, the audio thread is not blocked by the meters
+    auto trackNode = tracksNodes.value(trackID);
 
     if (trackNode && !trackNode->isMuted())
         return trackNode->getLastPeak();
@@ -844,6 +903,8 @@ MainController::~MainController()
 
     qCDebug(jtCore()) << "cleaning jamRecorders done!";
 
+    Persistence::SettingsWriter::getInstance()->flush(); // waiting the settings file writing
+
     qCDebug(jtCore) << "MainController destructor finished!";
 
     qDebug() << MainController::CRASH_FLAG_STRING; // used to put a crash flag in the log file
@@ -899,7 +960,12 @@ void MainController::setAllTracksActivation(bool activated)
 void MainController::playRoomStream(const Login::RoomInfo &roomInfo)
 {
     if (roomInfo.hasStream()) {
+        roomStreamPrefetcher.addInterest(roomInfo.getID(), roomInfo.getStreamUrl(), Audio::RoomStreamPrefetcher::LISTEN_INTEREST);
+        QByteArray prefetchedBytes = roomStreamPrefetcher.takePrefetchedBytes(roomInfo.getID());
+        roomStreamPrefetcher.setListenedRoom(roomInfo.getID());
+
         roomStreamer->setStreamPath(roomInfo.getStreamUrl());
+        roomStreamer->addPrefetchedBytes(prefetchedBytes); // avoid the buffering time if the room was prefetched
         currentStreamingRoomID = roomInfo.getID();
 
         // mute all tracks and unmute the room Streamer
@@ -912,6 +978,7 @@ void MainController::stopRoomStream()
 {
     roomStreamer->stopCurrentStream();
     currentStreamingRoomID = -1000;
+    roomStreamPrefetcher.setListenedRoom(currentStreamingRoomID);
 
     setAllTracksActivation(true);
     // roomStreamer->setMuteStatus(true);
@@ -972,6 +1039,10 @@ void MainController::start()
         roomStreamer.reset(new Audio::NinjamRoomStreamerNode()); // new Audio::AudioFileStreamerNode(":/teste.mp3");
         this->audioMixer.addNode(roomStreamer.data());
 
+        roomStreamPrefetcher.setMaxPrefetchedRooms(settings.getRoomStreamsToPrefetch());
+
+        loopsIndex.setLoopsPath(settings.getLooperSavePath()); // indexing the saved loops in background
+
         connect(&ninjamService, &Service::connectedInServer, this, &MainController::connectInNinjamServer);
 
         connect(&ninjamService, &Service::disconnectedFromServer, this, &MainController::disconnectFromNinjamServer);
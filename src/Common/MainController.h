@@ -9,10 +9,12 @@
 #include "loginserver/LoginService.h"
 #include "persistence/Settings.h"
 #include "persistence/UsersDataCache.h"
+#include "looper/LoopsIndex.h"
 #include "recorder/JamRecorder.h"
 #include "audio/core/AudioNode.h"
 #include "audio/core/AudioMixer.h"
 #include "audio/RoomStreamerNode.h"
+#include "audio/RoomStreamPrefetcher.h"
 #include "midi/MidiDriver.h"
 #include "UploadIntervalData.h"
 #include "audio/core/LocalInputGroup.h"
@@ -69,8 +71,8 @@ public:
 
     inline QString getTheme() const { return settings.getTheme(); }
 
-    bool addTrack(long trackID, Audio::AudioNode *trackNode);
-    void removeTrack(long trackID);
+    virtual bool addTrack(long trackID, Audio::AudioNode *trackNode);
+    virtual void removeTrack(long trackID);
 
     void playRoomStream(const Login::RoomInfo &roomInfo);
     bool isPlayingRoomStream() const;
@@ -149,6 +151,7 @@ public:
     virtual float getSampleRate() const = 0;
 
     float getEncodingQuality() const;
+    bool isUsingAdaptiveEncodingQuality() const;
 
     static QByteArray newGUID();
 
@@ -186,6 +189,9 @@ public:
     void saveEncodedAudio(const QString &userName, quint8 channelIndex, const QByteArray &encodedAudio);
 
     Audio::AbstractMp3Streamer *getRoomStreamer() const;
+    Audio::RoomStreamPrefetcher *getRoomStreamPrefetcher();
+
+    Audio::LoopsIndex *getLoopsIndex();
 
     void setUserName(const QString &newUserName);
 
@@ -196,6 +202,10 @@ public:
     // used to recreate audio encoder with enough channels
     int getMaxAudioChannelsForEncoding(uint trackGroupIndex) const;
 
+    // called in main thread when a plugins chain (or a plugin latency) changes, align the local tracks
+    void updateLatencyCompensation();
+    int getMaxPluginsLatency() const; // in samples, the transmitted intervals are shifted by this latency
+
     bool setTheme(const QString &themeName);
 
     //TODO: move this code to NinjamController.
@@ -228,6 +238,7 @@ public:
     quint8 getLooperBitDepth() const;
 
     void setAllLoopersStatus(bool activated);
+    void reserveLoopersMemory(uint intervalLenght);
 
     static bool crashedInLastExecution();
     static QString getVersionFromLogContent();
@@ -239,6 +250,7 @@ signals:
 public slots:
     virtual void setSampleRate(int newSampleRate);
     void setEncodingQuality(float newEncodingQuality);
+    void setAdaptiveEncodingQuality(bool adaptive);
     void storeLooperBitDepth(quint8 bitDepth);
 
     void storeRememberSettings(bool boost, bool level, bool pan, bool mute, bool lowCut);
@@ -292,6 +304,8 @@ private:
     QScopedPointer<Audio::AbstractMp3Streamer> roomStreamer;
     long long currentStreamingRoomID;
 
+    Audio::RoomStreamPrefetcher roomStreamPrefetcher;
+
     QMap<int, Audio::LocalInputGroup *> trackGroups;
 
     QMap<int, bool> getXmitChannelsFlags() const;
@@ -315,8 +329,12 @@ private:
 
     Persistence::UsersDataCache usersDataCache;
 
+    Audio::LoopsIndex loopsIndex;
+
     int lastInputTrackID; // used to generate a unique key/ID for each input track
 
+    QAtomicInt maxPluginsLatency; // computed in main thread, read in audio thread
+
     const static quint8 CAMERA_FPS;
 
     bool canGrabNewFrameFromCamera() const;
@@ -353,6 +371,11 @@ protected slots:
 };
 
 
+inline int MainController::getMaxPluginsLatency() const
+{
+    return maxPluginsLatency.load();
+}
+
 inline Persistence::UsersDataCache *MainController::getUsersDataCache()
 {
     return &usersDataCache;
@@ -368,6 +391,16 @@ inline Audio::AbstractMp3Streamer *MainController::getRoomStreamer() const
     return roomStreamer.data();
 }
 
+inline Audio::RoomStreamPrefetcher *MainController::getRoomStreamPrefetcher()
+{
+    return &roomStreamPrefetcher;
+}
+
+inline Audio::LoopsIndex *MainController::getLoopsIndex()
+{
+    return &loopsIndex;
+}
+
 inline QString MainController::getMetronomeFirstBeatFile() const
 {
     return settings.getMetronomeFirstBeatFile();
@@ -408,6 +441,11 @@ inline float MainController::getEncodingQuality() const
     return settings.getEncodingQuality();
 }
 
+inline bool MainController::isUsingAdaptiveEncodingQuality() const
+{
+    return settings.isUsingAdaptiveEncodingQuality();
+}
+
 inline int MainController::getInputTracksCount() const
 {
     return inputTracks.size(); // return the individual tracks (subchannels) count
@@ -511,6 +549,7 @@ inline void MainController::storeLooperAudioEncodingFlag(bool encodeAudioWhenSav
 inline void MainController::storeLooperFolder(const QString &newLooperFolder)
 {
     settings.setLooperFolder(newLooperFolder);
+    loopsIndex.setLoopsPath(settings.getLooperSavePath());
 }
 
 inline quint8 MainController::getLooperPreferedLayersCount() const
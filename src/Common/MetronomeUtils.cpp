@@ -3,17 +3,54 @@
 #include "audio/core/SamplesBuffer.h"
 #include "file/FileReaderFactory.h"
 #include "file/FileReader.h"
-#include "audio/Resampler.h"
 #include <QString>
 #include <QFileInfo>
 #include <QFile>
 #include <QDir>
+#include <QDateTime>
+#include <QMutexLocker>
 #include <QDebug>
 
+#include <cmath>
+
 using namespace Audio;
 
 const QString MetronomeUtils::DEFAULT_BUILT_IN_METRONOME_ALIAS("Default");
 const QString MetronomeUtils::DEFAULT_BUILT_IN_METRONOME_DIR(":/metronome");
+const int MetronomeUtils::MAX_CACHED_SOUNDS = 64;
+
+QHash<QString, MetronomeUtils::DecodedSound> MetronomeUtils::decodedSounds;
+QHash<QString, QSharedPointer<SamplesBuffer>> MetronomeUtils::resampledSounds;
+QMutex MetronomeUtils::soundsCacheMutex;
+
+static void resampleWithWindowedSinc(const float *in, int inLength, float *out, int outLength)
+{
+    // band limited interpolation, too slow for the audio thread but the metronome sounds are resampled only one time
+    static const double PI = 3.141592653589793238463;
+    static const int HALF_TAPS = 16;
+
+    if (inLength <= 0 || outLength <= 0)
+        return;
+
+    double step = static_cast<double>(inLength) / outLength; // input samples per output sample
+    double cutoff = qMin(1.0, 1.0 / step); // lowpass in the new Nyquist frequency when downsampling
+    int radius = static_cast<int>(std::ceil(HALF_TAPS / cutoff));
+
+    for (int i = 0; i < outLength; ++i) {
+        double center = i * step;
+        int first = qMax(0, static_cast<int>(center) - radius + 1);
+        int last = qMin(inLength - 1, static_cast<int>(center) + radius);
+        double sum = 0;
+        for (int j = first; j <= last; ++j) {
+            double distance = center - j;
+            double x = distance * cutoff * PI;
+            double sinc = (x != 0) ? std::sin(x) / x : 1.0;
+            double window = 0.5 + 0.5 * std::cos(PI * distance / radius); // Hann window
+            sum += in[j] * sinc * window;
+        }
+        out[i] = static_cast<float>(sum * cutoff);
+    }
+}
 
 QList<QString> MetronomeUtils::getBuiltInMetronomeAliases()
 {
@@ -130,21 +167,66 @@ void MetronomeUtils::removeSilenceInBufferStart(Audio::SamplesBuffer &buffer)
 
 void MetronomeUtils::createBuffer(const QString &audioFilePath, Audio::SamplesBuffer &outBuffer, quint32 localSampleRate)
 {
-    std::unique_ptr<Audio::FileReader> reader = Audio::FileReaderFactory::createFileReader(audioFilePath);
-    quint32 audioFileSampleRate; //will be changed inside reader->read
-    Audio::SamplesBuffer originalBuffer(1);//assuming mono for while
-    reader->read(audioFilePath, originalBuffer, audioFileSampleRate);//buffer will be filled with audio file samples
-
-    //need resample?
-    if (audioFileSampleRate != (uint)localSampleRate) {
-        createResampledBuffer(originalBuffer, outBuffer, audioFileSampleRate, localSampleRate);
+    QSharedPointer<SamplesBuffer> sound = getSound(audioFilePath, localSampleRate);
+
+    if (sound->isMono())
+        outBuffer.setToMono();
+    else
+        outBuffer.setToStereo();
+    outBuffer.setFrameLenght(sound->getFrameLenght());
+    outBuffer.set(*sound);
+}
+
+QSharedPointer<SamplesBuffer> MetronomeUtils::getSound(const QString &audioFilePath, quint32 localSampleRate)
+{
+    QMutexLocker locker(&soundsCacheMutex);
+
+    // the modification time is used in the key, so the changed custom sounds are decoded again
+    QFileInfo fileInfo(audioFilePath);
+    QString soundKey = fileInfo.absoluteFilePath() + "|" + QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+    QString resampledSoundKey = soundKey + "|" + QString::number(localSampleRate);
+
+    if (resampledSounds.contains(resampledSoundKey))
+        return resampledSounds[resampledSoundKey];
+
+    if (resampledSounds.size() >= MAX_CACHED_SOUNDS) { // many changed custom sounds, the old versions are discarded
+        resampledSounds.clear();
+        decodedSounds.clear();
+    }
+
+    if (!decodedSounds.contains(soundKey)) {
+        std::unique_ptr<Audio::FileReader> reader = Audio::FileReaderFactory::createFileReader(audioFilePath);
+        DecodedSound decodedSound;
+        decodedSound.buffer.reset(new SamplesBuffer(1)); //assuming mono for while
+        decodedSound.sampleRate = localSampleRate; //will be changed inside reader->read
+        if (!reader->read(audioFilePath, *decodedSound.buffer, decodedSound.sampleRate)) { //buffer will be filled with audio file samples
+            qCritical() << "Can't read the metronome sound" << audioFilePath;
+            return decodedSound.buffer; // not cached, empty buffer
+        }
+        decodedSounds.insert(soundKey, decodedSound);
+    }
+
+    const DecodedSound &decodedSound = decodedSounds[soundKey];
+
+    QSharedPointer<SamplesBuffer> resampledSound;
+    if (decodedSound.sampleRate != localSampleRate) { //need resample?
+        resampledSound.reset(new SamplesBuffer(decodedSound.buffer->getChannels()));
+        createResampledBuffer(*decodedSound.buffer, *resampledSound, decodedSound.sampleRate, localSampleRate);
     }
-    else{
-        if (originalBuffer.isMono())
-            outBuffer.setToMono();
-        outBuffer.setFrameLenght(originalBuffer.getFrameLenght());
-        outBuffer.set(originalBuffer);
+    else {
+        resampledSound = decodedSound.buffer; // sharing the decoded samples
     }
+
+    resampledSounds.insert(resampledSoundKey, resampledSound);
+
+    return resampledSound;
+}
+
+void MetronomeUtils::clearSoundsCache()
+{
+    QMutexLocker locker(&soundsCacheMutex);
+    resampledSounds.clear();
+    decodedSounds.clear();
 }
 
 void MetronomeUtils::createResampledBuffer(const Audio::SamplesBuffer &buffer, Audio::SamplesBuffer &outBuffer, int originalSampleRate,
@@ -159,8 +241,7 @@ void MetronomeUtils::createResampledBuffer(const Audio::SamplesBuffer &buffer, A
     outBuffer.setFrameLenght(finalSize);
 
     for (int c = 0; c < channels; ++c) {
-        SimpleResampler resampler;
-        resampler.process(buffer.getSamplesArray(c),
-                          buffer.getFrameLenght(), outBuffer.getSamplesArray(c), finalSize);
+        resampleWithWindowedSinc(buffer.getSamplesArray(c), buffer.getFrameLenght(),
+                                 outBuffer.getSamplesArray(c), finalSize);
     }
 }
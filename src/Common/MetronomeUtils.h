@@ -3,6 +3,9 @@
 
 #include <QFile>
 #include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
 
 class QString;
 
@@ -27,11 +30,30 @@ public:
 
     static QList<int> getAccentBeatsFromString(QString value);
 
+    static void clearSoundsCache();
+
 private:
     static void createBuffer(const QString &audioFilePath, Audio::SamplesBuffer &outBuffer, quint32 localSampleRate);
     static void createResampledBuffer(const Audio::SamplesBuffer &buffer, Audio::SamplesBuffer &outBuffer, int originalSampleRate,
                                          int finalSampleRate);
 
+    static QSharedPointer<Audio::SamplesBuffer> getSound(const QString &audioFilePath, quint32 localSampleRate);
+
+    /**
+     * The sounds are decoded one time and the resampled versions are cached by sample rate. The cache is shared by all
+     * controllers in the process (standalone or plugin instances), so the metronome is recreated without read files.
+     */
+    struct DecodedSound
+    {
+        QSharedPointer<Audio::SamplesBuffer> buffer;
+        quint32 sampleRate;
+    };
+
+    static QHash<QString, DecodedSound> decodedSounds; // key is the file path and last modification time
+    static QHash<QString, QSharedPointer<Audio::SamplesBuffer>> resampledSounds; // key is the decoded sound key and sample rate
+    static QMutex soundsCacheMutex;
+    static const int MAX_CACHED_SOUNDS;
+
     static QString buildMetronomeFileNameFromAlias(const QString &alias, const QString &Beat);
 
     static void createBuiltInSound(const QString &alias, const QString &beat, Audio::SamplesBuffer &beatBuffer, quint32 localSampleRate);
@@ -29,6 +29,8 @@
 #include <QThread>
 #include <QFileInfo>
 #include <QWaitCondition>
+#include <QSaveFile>
+#include <QTextStream>
 
 #include <cmath>
 #include <cassert>
@@ -155,7 +157,9 @@ public:
         //
     }
     
-    virtual void process() = 0;
+    virtual void prepare() {} // called when the event is scheduled (not in audio thread), the expensive work is done here
+
+    virtual void process() = 0; // called in audio thread, in the interval start
     
     virtual ~SchedulableEvent()
     {
@@ -177,6 +181,12 @@ public:
     {
     }
 
+    void prepare()
+    {
+        controller->nextBpi = newBpi;
+        controller->reserveLoopersMemory();
+    }
+
     void process()
     {
         controller->currentBpi = newBpi;
@@ -200,6 +210,12 @@ public:
     {
     
     }
+
+    void prepare()
+    {
+        controller->nextBpm = newBpm;
+        controller->reserveLoopersMemory();
+    }
     
     void process()
     {
@@ -218,39 +234,74 @@ class NinjamController::InputChannelChangedEvent : public SchedulableEvent
     public:
         InputChannelChangedEvent(NinjamController* controller, int channelIndex) :
             SchedulableEvent(controller),
-            channelIndex(channelIndex)
+            channelIndex(channelIndex),
+            newEncoder(nullptr)
         {
         }
+
+        ~InputChannelChangedEvent()
+        {
+            delete newEncoder; // not processed event, or the replaced encoder. Events are deleted in main thread.
+        }
+
+        void prepare()
+        {
+            newEncoder = controller->createEncoderForChannel(channelIndex);
+        }
         
         void process()
         {
-            controller->recreateEncoderForChannel(channelIndex);
+            if (newEncoder)
+                newEncoder = controller->swapEncoder(channelIndex, newEncoder); // the event is the owner of the replaced encoder
         }
     
     private:
         int channelIndex;
+        AudioEncoder *newEncoder; // created in prepare(), the VorbisEncoder initialization is slow for audio thread
 };
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 QList<QString> NinjamController::chatBlockedUsers; // initializing the static member
 
+const int NinjamController::PROCESSED_EVENTS_CAPACITY = 64;
+const int NinjamController::DECODERS_REQUESTS_CHECK_PERIOD = 10;
+
 NinjamController::NinjamController(Controller::MainController* mainController) :
     mainController(mainController),
     metronomeTrackNode(createMetronomeTrackNode( mainController->getSampleRate())),
+    inputMixBuffer(2, 4096), // pre-allocated, resized in audio thread only for bigger blocks
+    stepInBuffer(2, 4096),
+    stepOutBuffer(2, 4096),
+    stepInSamples(2),
+    stepOutSamples(2),
     intervalPosition(0),
     lastBeat(0),
     samplesInInterval(0),
     currentBpi(0),
     currentBpm(0),
+    nextBpi(0),
+    nextBpm(0),
     mutex(QMutex::Recursive),
     encodersMutex(QMutex::Recursive),
+    intervalPreRollTime(mainController->getSettings().getIntervalPreRollTime()),
+    intervalPreRollRequested(0),
+    playedIntervalsReleaseRequested(0),
+    adaptiveEncodingQuality(mainController->getEncodingQuality(), VorbisEncoder::QUALITY_LOW),
     encodingThread(nullptr),
     preparedForTransmit(false),
-    waitingIntervals(0) // waiting for start transmit
+    waitingIntervals(0), // waiting for start transmit
+    transmitLatency(0),
+    transmitIntervalSamples(0),
+    transmitPartIsFirst(true),
+    transmitPartBuffer(2, 4096)
 {
     running = false;
 
+    processedEvents.reserve(PROCESSED_EVENTS_CAPACITY);
+
+    decodersRequestsTimer.setInterval(DECODERS_REQUESTS_CHECK_PERIOD);
+    connect(&decodersRequestsTimer, &QTimer::timeout, this, &NinjamController::checkDecodersRequests);
 }
 
 Ninjam::User NinjamController::getUserByName(const QString &userName) const
@@ -279,6 +330,7 @@ void NinjamController::removeEncoder(int groupChannelIndex)
     if (encoders.contains(groupChannelIndex)) {
         encoders.remove(groupChannelIndex);
     }
+    newestEncodersSettings.remove(groupChannelIndex);
 }
 
 //+++++++++++++++++++++++++ THE MAIN LOGIC IS HERE  ++++++++++++++++++++++++++++++++++++++++++++++++
@@ -300,20 +352,25 @@ void NinjamController::process(const Audio::SamplesBuffer &in, Audio::SamplesBuf
     do {
         emit startProcessing(intervalPosition); // vst host time line is updated with this event
 
+        bool newInterval = intervalPosition == 0;
+        if (newInterval) { // starting new interval, the interval size and position can be changed here
+            handleNewInterval();
+        }
+
         int samplesToProcessInThisStep = (std::min)((int)(samplesInInterval - intervalPosition), totalSamplesToProcess - offset);
 
         assert(samplesToProcessInThisStep);
 
-        static Audio::SamplesBuffer tempOutBuffer(out.getChannels(), samplesToProcessInThisStep);
-        tempOutBuffer.setFrameLenght(samplesToProcessInThisStep);
-        tempOutBuffer.zero();
-
-        Audio::SamplesBuffer tempInBuffer(in.getChannels(), samplesToProcessInThisStep);
-        tempInBuffer.set(in, offset, samplesToProcessInThisStep, 0);
-
-        bool newInterval = intervalPosition == 0;
-        if (newInterval) { // starting new interval
-            handleNewInterval();
+        long preRollSamples = getIntervalPreRollSamples(sampleRate);
+        if (preRollSamples > 0) {
+            long preRollPosition = samplesInInterval - preRollSamples;
+            if (intervalPosition < preRollPosition && intervalPosition + samplesToProcessInThisStep >= preRollPosition) {
+                // the next interval first samples are decoded in the thread pool, the interval start is just swapping the decoders
+                intervalPreRollRequested.store(1);
+            }
+        }
+        else if (newInterval) { // pre-roll disabled, the played intervals are still released out of audio thread
+            playedIntervalsReleaseRequested.store(1);
         }
 
         metronomeTrackNode->setIntervalPosition(this->intervalPosition);
@@ -328,31 +385,38 @@ void NinjamController::process(const Audio::SamplesBuffer &in, Audio::SamplesBuf
         for (NinjamTrackNode* track : trackNodes) {
             track->setProcessingLastPartOfInterval(isLastPart); // TODO resampler still need a flag indicating the last part?
         }
-        mainController->doAudioProcess(tempInBuffer, tempOutBuffer, sampleRate);
-        out.add(tempOutBuffer, offset); // generate audio output
-        //++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        if (samplesToProcessInThisStep == totalSamplesToProcess) { // the whole block is in the same interval, rendering in place
+            mainController->doAudioProcess(in, out, sampleRate);
+        }
+        else { // the block is crossing the interval boundary, each part is rendered in place using views of the block
+            if (stepInBuffer.getChannels() != in.getChannels()) {
+                stepInBuffer = Audio::SamplesBuffer(in.getChannels());
+                stepInSamples.resize(in.getChannels());
+            }
 
-        if (preparedForTransmit) {
-            // 1) mix input subchannels, 2) encode and 3) send the encoded audio
-            bool isFirstPart = intervalPosition == 0;
-            int groupedChannels = mainController->getInputTrackGroupsCount();
-            for (int groupIndex = 0; groupIndex < groupedChannels; ++groupIndex) {
-                if (mainController->isTransmiting(groupIndex)) {
-                    int channels = mainController->getMaxAudioChannelsForEncoding(groupIndex);
-                    if (channels > 0) {
-                        Audio::SamplesBuffer inputMixBuffer(channels, samplesToProcessInThisStep);
-
-                        if (encoders.contains(groupIndex)) {
-                            inputMixBuffer.zero();
-                            mainController->mixGroupedInputs(groupIndex, inputMixBuffer);
-
-                            // encoding is running in another thread to avoid slow down the audio thread
-                            encodingThread->addSamplesToEncode( inputMixBuffer, groupIndex, isFirstPart, isLastPart);
-                        }
-                    }
-                }
+            if (stepOutBuffer.getChannels() != out.getChannels()) {
+                stepOutBuffer = Audio::SamplesBuffer(out.getChannels());
+                stepOutSamples.resize(out.getChannels());
             }
+
+            for (uint c = 0; c < stepInSamples.size(); ++c)
+                stepInSamples[c] = in.getSamplesArray(c) + offset;
+
+            for (uint c = 0; c < stepOutSamples.size(); ++c)
+                stepOutSamples[c] = out.getSamplesArray(c) + offset;
+
+            stepInBuffer.wrap(stepInSamples.data(), samplesToProcessInThisStep);
+            stepOutBuffer.wrap(stepOutSamples.data(), samplesToProcessInThisStep);
+
+            mainController->doAudioProcess(stepInBuffer, stepOutBuffer, sampleRate);
+
+            stepInBuffer.unwrap();
+            stepOutBuffer.unwrap();
         }
+        //++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        if (preparedForTransmit)
+            encodeGroupedInputs(samplesToProcessInThisStep);
 
         samplesProcessed += samplesToProcessInThisStep;
         offset += samplesToProcessInThisStep;
@@ -362,6 +426,66 @@ void NinjamController::process(const Audio::SamplesBuffer &in, Audio::SamplesBuf
 }
 
 
+void NinjamController::encodeGroupedInputs(int samplesToProcess)
+{
+    // the transmitted interval is ending in this step? The tiny intervals created by latency changes are avoided.
+    long transmitEnd = (transmitLatency > 0) ? transmitLatency : samplesInInterval;
+    bool transmitEndInThisStep = intervalPosition < transmitEnd && transmitEnd <= intervalPosition + samplesToProcess
+            && transmitIntervalSamples + (transmitEnd - intervalPosition) >= samplesInInterval / 2;
+    int samplesBeforeEnd = transmitEndInThisStep ? static_cast<int>(transmitEnd - intervalPosition) : samplesToProcess;
+
+    // 1) mix input subchannels, 2) encode and 3) send the encoded audio
+    int groupedChannels = mainController->getInputTrackGroupsCount();
+    for (int groupIndex = 0; groupIndex < groupedChannels; ++groupIndex) {
+        if (!mainController->isTransmiting(groupIndex))
+            continue;
+
+        int channels = mainController->getMaxAudioChannelsForEncoding(groupIndex);
+        if (channels <= 0 || !encoders.contains(groupIndex))
+            continue;
+
+        inputMixBuffer.setFrameLenght(samplesToProcess);
+        if (channels > 1)
+            inputMixBuffer.setToStereo();
+        else
+            inputMixBuffer.setToMono();
+
+        inputMixBuffer.zero();
+        mainController->mixGroupedInputs(groupIndex, inputMixBuffer);
+
+        sendTransmitPart(groupIndex, 0, samplesBeforeEnd, transmitPartIsFirst, transmitEndInThisStep);
+        if (samplesBeforeEnd < samplesToProcess) // the next transmitted interval is starting in this step
+            sendTransmitPart(groupIndex, samplesBeforeEnd, samplesToProcess - samplesBeforeEnd, true, false);
+    }
+
+    if (transmitEndInThisStep) {
+        transmitIntervalSamples = samplesToProcess - samplesBeforeEnd;
+        transmitPartIsFirst = samplesBeforeEnd == samplesToProcess; // the next step is starting the next interval
+    }
+    else {
+        transmitIntervalSamples += samplesToProcess;
+        transmitPartIsFirst = false;
+    }
+}
+
+void NinjamController::sendTransmitPart(int groupIndex, int offset, int samples, bool isFirstPart, bool isLastPart)
+{
+    // encoding is running in another thread to avoid slow down the audio thread
+    if (offset == 0 && samples == static_cast<int>(inputMixBuffer.getFrameLenght())) {
+        encodingThread->addSamplesToEncode(inputMixBuffer, groupIndex, isFirstPart, isLastPart);
+        return;
+    }
+
+    transmitPartBuffer.setFrameLenght(samples);
+    if (inputMixBuffer.isMono())
+        transmitPartBuffer.setToMono();
+    else
+        transmitPartBuffer.setToStereo();
+
+    transmitPartBuffer.set(inputMixBuffer, offset, samples, 0);
+    encodingThread->addSamplesToEncode(transmitPartBuffer, groupIndex, isFirstPart, isLastPart);
+}
+
 Audio::MetronomeTrackNode* NinjamController::createMetronomeTrackNode(int sampleRate)
 {
     Audio::SamplesBuffer firstBeatBuffer(2);
@@ -387,6 +511,9 @@ Audio::MetronomeTrackNode* NinjamController::createMetronomeTrackNode(int sample
 
 void NinjamController::recreateMetronome(int newSampleRate)
 {
+    // the new metronome sounds are loaded and resampled before the old metronome is removed, the metronome is not muted while the files are read
+    Audio::MetronomeTrackNode *newMetronome = createMetronomeTrackNode(newSampleRate);
+
     // remove the old metronome
     float oldGain = metronomeTrackNode->getGain();
     float oldPan = metronomeTrackNode->getPan();
@@ -397,7 +524,7 @@ void NinjamController::recreateMetronome(int newSampleRate)
     mainController->removeTrack(METRONOME_TRACK_ID);
 
     // recreate metronome using the new sample rate
-    this->metronomeTrackNode = createMetronomeTrackNode(newSampleRate);
+    this->metronomeTrackNode = newMetronome;
     this->metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
     this->metronomeTrackNode->setGain( oldGain );
     this->metronomeTrackNode->setPan( oldPan );
@@ -413,6 +540,8 @@ void NinjamController::stop(bool emitDisconnectedSignal)
     if (isRunning()) {
         this->running = false;
 
+        decodersRequestsTimer.stop();
+
         // store metronome settings
         Audio::AudioNode* metronomeTrack = mainController->getTrackNode(METRONOME_TRACK_ID);
         if (metronomeTrack) {
@@ -442,12 +571,17 @@ void NinjamController::stop(bool emitDisconnectedSignal)
         delete encoder;
     }
     encoders.clear();
+    newestEncodersSettings.clear();
 
     // delete possible non consumed events
-    for (SchedulableEvent *e : scheduledEvents)
-        delete e;
-    
-    scheduledEvents.clear();
+    {
+        QMutexLocker eventsLocker(&scheduledEventsMutex);
+        for (SchedulableEvent *e : scheduledEvents)
+            delete e;
+
+        scheduledEvents.clear();
+    }
+    deleteProcessedEvents();
 
     qCDebug(jtNinjamCore) << "NinjamController destructor - disconnecting...";
 
@@ -460,6 +594,7 @@ void NinjamController::stop(bool emitDisconnectedSignal)
     disconnect(ninjamService, &Ninjam::Service::userChannelRemoved, this, &NinjamController::removeNinjamRemoteChannel);
     disconnect(ninjamService, &Ninjam::Service::userChannelUpdated, this, &NinjamController::updateNinjamRemoteChannel);
     disconnect(ninjamService, &Ninjam::Service::audioIntervalDownloading, this, &NinjamController::handleIntervalDownloading);
+    disconnect(ninjamService, &Ninjam::Service::intervalUploaded, this, &NinjamController::handleIntervalUploaded);
 
     disconnect(ninjamService, &Ninjam::Service::publicChatMessageReceived, this, &NinjamController::publicChatMessageReceived);
     disconnect(ninjamService, &Ninjam::Service::privateChatMessageReceived, this, &NinjamController::privateChatMessageReceived);
@@ -481,6 +616,7 @@ NinjamController::~NinjamController()
         delete e;
     }
 
+    deleteProcessedEvents();
 }
 
 void NinjamController::start(const Ninjam::Server& server)
@@ -489,15 +625,19 @@ void NinjamController::start(const Ninjam::Server& server)
     QMutexLocker locker(&mutex);
 
     //schedule an update in internal attributes
-    scheduledEvents.append(new BpiChangeEvent(this, server.getBpi()));
-    scheduledEvents.append(new BpmChangeEvent(this, server.getBpm()));
+    scheduleEvent(new BpiChangeEvent(this, server.getBpi()));
+    scheduleEvent(new BpmChangeEvent(this, server.getBpm()));
+
     preparedForTransmit = false; // the xmit start after the first interval is received
     emit preparingTransmission();
 
+    adaptiveEncodingQuality.setMaxQuality(mainController->getEncodingQuality());
+    adaptiveEncodingQuality.reset(); // starting with the user selected quality
+
     // schedule the encoders creation (one encoder for each channel)
     int channels = mainController->getInputTrackGroupsCount();
     for (int channelIndex = 0; channelIndex < channels; ++channelIndex) {
-        scheduledEvents.append(new InputChannelChangedEvent(this, channelIndex));
+        scheduleEvent(new InputChannelChangedEvent(this, channelIndex));
     }
 
     processScheduledChanges();
@@ -527,6 +667,7 @@ void NinjamController::start(const Ninjam::Server& server)
         connect(ninjamService, &Ninjam::Service::userChannelRemoved, this, &NinjamController::removeNinjamRemoteChannel);
         connect(ninjamService, &Ninjam::Service::userChannelUpdated, this, &NinjamController::updateNinjamRemoteChannel);
         connect(ninjamService, &Ninjam::Service::audioIntervalDownloading, this, &NinjamController::handleIntervalDownloading);
+        connect(ninjamService, &Ninjam::Service::intervalUploaded, this, &NinjamController::handleIntervalUploaded);
         connect(ninjamService, &Ninjam::Service::userExited, this, &NinjamController::handleNinjamUserExiting);
         connect(ninjamService, &Ninjam::Service::userEntered, this, &NinjamController::handleNinjamUserEntering);
 
@@ -544,6 +685,8 @@ void NinjamController::start(const Ninjam::Server& server)
 
         this->running = true;
 
+        decodersRequestsTimer.start();
+
         emit started();
     }
     qCDebug(jtNinjamCore) << "ninjam controller started!";
@@ -645,6 +788,7 @@ void NinjamController::addTrack(const Ninjam::User &user, const Ninjam::UserChan
     }
 
     NinjamTrackNode* trackNode = new NinjamTrackNode(generateNewTrackID());
+    trackNode->getTelemetry().setChannelName(user.getName(), channel.getName());
 
     bool trackAdded = false;
 
@@ -728,6 +872,35 @@ void NinjamController::setMetronomeAccentBeats(QList<int> accentBeats)
 //    }
 //}
 
+long NinjamController::getIntervalPreRollSamples(int sampleRate) const
+{
+    long preRollSamples = static_cast<long>(sampleRate) * intervalPreRollTime / 1000;
+    return qMin(preRollSamples, samplesInInterval / 2);
+}
+
+void NinjamController::checkDecodersRequests()
+{
+    if (intervalPreRollRequested.fetchAndStoreOrdered(0))
+        startIntervalPreRoll();
+
+    if (playedIntervalsReleaseRequested.fetchAndStoreOrdered(0))
+        releasePlayedIntervals();
+}
+
+void NinjamController::startIntervalPreRoll()
+{
+    QMutexLocker locker(&mutex);
+    for (NinjamTrackNode *track : trackNodes.values())
+        track->primeNextInterval(&decodersThreadPool);
+}
+
+void NinjamController::releasePlayedIntervals()
+{
+    QMutexLocker locker(&mutex);
+    for (NinjamTrackNode *track : trackNodes.values())
+        track->releasePlayedIntervals(&decodersThreadPool);
+}
+
 void NinjamController::handleNewInterval()
 {
     // check if the transmiting can start
@@ -735,6 +908,8 @@ void NinjamController::handleNewInterval()
         if(waitingIntervals >= TOTAL_PREPARED_INTERVALS){
             preparedForTransmit = true;
             waitingIntervals = 0;
+            transmitIntervalSamples = 0;
+            transmitPartIsFirst = true;
             emit preparedToTransmit();
         }
         else {
@@ -742,9 +917,10 @@ void NinjamController::handleNewInterval()
         }
     }
 
-    if (hasScheduledChanges()) {
-        processScheduledChanges();
-    }
+    processScheduledChanges();
+
+    // the transmitted interval is shifted by the slowest local track latency
+    transmitLatency = qMin(static_cast<long>(mainController->getMaxPluginsLatency()), samplesInInterval / 4);
     
     //QMutexLocker locker(&mutex);
     for (NinjamTrackNode* track : trackNodes.values()) {
@@ -760,12 +936,63 @@ void NinjamController::handleNewInterval()
     mainController->syncWithNinjamIntervalStart(samplesInInterval);
 }
 
+void NinjamController::scheduleEvent(SchedulableEvent *event)
+{
+    event->prepare(); // the new objects are created here, and just swapped in the interval start
+
+    deleteProcessedEvents(); // the replaced encoders are deleted with the events
+
+    QMutexLocker locker(&scheduledEventsMutex);
+    scheduledEvents.push_back(event);
+}
+
+void NinjamController::deleteProcessedEvents()
+{
+    std::vector<SchedulableEvent *> eventsToDelete;
+    eventsToDelete.reserve(PROCESSED_EVENTS_CAPACITY); // swapped with the audio thread vector
+
+    scheduledEventsMutex.lock();
+    processedEvents.swap(eventsToDelete);
+    scheduledEventsMutex.unlock();
+
+    // the events (and the replaced encoders) are deleted without blocking the audio thread
+    for (SchedulableEvent *event : eventsToDelete)
+        delete event;
+}
+
+void NinjamController::discardScheduledEncoderChanges()
+{
+    std::vector<SchedulableEvent *> discardedEvents;
+
+    scheduledEventsMutex.lock();
+    auto it = scheduledEvents.begin();
+    while (it != scheduledEvents.end()) {
+        if (dynamic_cast<InputChannelChangedEvent *>(*it)) {
+            discardedEvents.push_back(*it);
+            it = scheduledEvents.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    scheduledEventsMutex.unlock();
+
+    for (SchedulableEvent *event : discardedEvents)
+        delete event; // the not installed encoders are deleted here
+}
+
 void NinjamController::processScheduledChanges()
 {
-    for (SchedulableEvent* event : scheduledEvents) {
+    // the lists are not allocated or released here, the processed events are deleted in main thread
+    QMutexLocker locker(&scheduledEventsMutex);
+    if (scheduledEvents.empty())
+        return;
+
+    for (SchedulableEvent *event : scheduledEvents) {
         event->process();
-        delete event;
+        processedEvents.push_back(event);
     }
+
     scheduledEvents.clear();
 }
 
@@ -776,10 +1003,22 @@ long NinjamController::getSamplesPerBeat()
 
 long NinjamController::computeTotalSamplesInInterval()
 {
-    double intervalPeriod =  60000.0 / currentBpm * currentBpi;
+    return computeTotalSamplesInInterval(currentBpi, currentBpm);
+}
+
+long NinjamController::computeTotalSamplesInInterval(int bpi, int bpm) const
+{
+    double intervalPeriod =  60000.0 / bpm * bpi;
     return (long)(mainController->getSampleRate() * intervalPeriod / 1000.0);
 }
 
+void NinjamController::reserveLoopersMemory()
+{
+    // the loopers are resized in the audio thread when the scheduled changes are processed, allocating here (GUI thread)
+    if (nextBpi > 0 && nextBpm > 0)
+        mainController->reserveLoopersMemory(computeTotalSamplesInInterval(nextBpi, nextBpm));
+}
+
 //ninjam slots
 void NinjamController::handleNinjamUserEntering(const Ninjam::User &user)
 {
@@ -810,6 +1049,7 @@ void NinjamController::updateNinjamRemoteChannel(const Ninjam::User &user, const
     QMutexLocker locker(&mutex);
     if (trackNodes.contains(uniqueKey)) {
         NinjamTrackNode* trackNode = trackNodes[uniqueKey];
+        trackNode->getTelemetry().setChannelName(user.getName(), channel.getName());
         emit channelNameChanged(user, channel, trackNode->getID());
     }
 
@@ -818,13 +1058,12 @@ void NinjamController::updateNinjamRemoteChannel(const Ninjam::User &user, const
 void NinjamController::scheduleBpiChangeEvent(quint16 newBpi, quint16 oldBpi)
 {
     Q_UNUSED(oldBpi);
-    scheduledEvents.append(new BpiChangeEvent(this, newBpi));
+    scheduleEvent(new BpiChangeEvent(this, newBpi));
 }
 
 void NinjamController::scheduleBpmChangeEvent(quint16 newBpm)
 {
-    Q_UNUSED(newBpm)
-    scheduledEvents.append(new BpmChangeEvent(this, newBpm));
+    scheduleEvent(new BpmChangeEvent(this, newBpm));
 }
 
 void NinjamController::handleIntervalCompleted(const Ninjam::User &user, quint8 channelIndex, const QByteArray &encodedData)
@@ -841,6 +1080,13 @@ void NinjamController::handleIntervalCompleted(const Ninjam::User &user, quint8
     if (trackNodes.contains(channelKey)) {
         NinjamTrackNode* trackNode = trackNodes[channelKey];
         if (trackNode) {
+            // how much time until this interval is played? If the interval start was missed the interval is late.
+            Audio::IntervalTelemetry &telemetry = trackNode->getTelemetry();
+            long marginInSamples = telemetry.hasMissedInterval() ? -intervalPosition
+                    : (samplesInInterval - intervalPosition) + trackNode->getQueuedIntervals() * samplesInInterval;
+            int sampleRate = qMax(1, static_cast<int>(mainController->getSampleRate()));
+            telemetry.finishDownload(encodedData.size(), static_cast<int>(marginInSamples * 1000LL / sampleRate));
+
             trackNode->addVorbisEncodedInterval(encodedData);
             emit channelAudioFullyDownloaded(trackNode->getID());
         }
@@ -859,9 +1105,30 @@ void NinjamController::reset(bool keepRecentIntervals)
     intervalPosition = lastBeat = 0;
 }
 
+bool NinjamController::exportIntervalsTelemetry(const QString &filePath)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        qCritical() << "Can't open the intervals telemetry file" << filePath << file.errorString();
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << Audio::IntervalTelemetry::getCsvHeader() << endl;
+
+    {
+        QMutexLocker locker(&mutex);
+        for (NinjamTrackNode *trackNode : trackNodes.values())
+            stream << trackNode->getTelemetry().getCsvLine() << endl;
+    }
+
+    stream.flush();
+    return file.commit();
+}
+
 void NinjamController::scheduleEncoderChangeForChannel(int channelIndex)
 {
-    scheduledEvents.append(new InputChannelChangedEvent(this, channelIndex));
+    scheduleEvent(new InputChannelChangedEvent(this, channelIndex));
 }
 
 QByteArray NinjamController::encode(const Audio::SamplesBuffer &buffer, uint channelIndex)
@@ -882,40 +1149,88 @@ QByteArray NinjamController::encodeLastPartOfInterval(uint channelIndex)
     return QByteArray();
 }
 
-void NinjamController::recreateEncoderForChannel(int channelIndex)
+AudioEncoder *NinjamController::createEncoderForChannel(int channelIndex)
 {
-
-    QMutexLocker locker(&encodersMutex);
     int maxChannelsForEncoding = mainController->getMaxAudioChannelsForEncoding(channelIndex);
 
     if (maxChannelsForEncoding <= 0) // input track is setted as noInput?
-        return;
+        return nullptr;
 
-    bool currentEncoderIsInvalid = encoders.contains(channelIndex) &&
-            (encoders[channelIndex]->getChannels() != maxChannelsForEncoding
-                || encoders[channelIndex]->getSampleRate() != mainController->getSampleRate());
+    int sampleRate = mainController->getSampleRate();
+    float encodingQuality = getEncodingQuality();
 
-    if (!encoders.contains(channelIndex) || currentEncoderIsInvalid) { // a new encoder is necessary?
+    // compared with the newest encoder, a scheduled encoder is installed in the next interval start
+    if (newestEncodersSettings.contains(channelIndex)) {
+        const EncoderSettings &newest = newestEncodersSettings[channelIndex];
+        bool newestEncoderIsValid = newest.channels == maxChannelsForEncoding &&
+                newest.sampleRate == sampleRate &&
+                qFuzzyCompare(1.0f + newest.quality, 1.0f + encodingQuality);
 
-        if (currentEncoderIsInvalid && encoders.contains(channelIndex)) {
-            delete encoders[channelIndex];
-        }
+        if (newestEncoderIsValid)
+            return nullptr; // a new encoder is not necessary
+    }
+
+    EncoderSettings settings = { maxChannelsForEncoding, sampleRate, encodingQuality };
+    newestEncodersSettings.insert(channelIndex, settings);
 
-        int sampleRate = mainController->getSampleRate();
-        float encodingQuality = mainController->getEncodingQuality();
+    return new VorbisEncoder(maxChannelsForEncoding, sampleRate, encodingQuality);
+}
+
+AudioEncoder *NinjamController::swapEncoder(int channelIndex, AudioEncoder *newEncoder)
+{
+    QMutexLocker locker(&encodersMutex);
+    AudioEncoder *replacedEncoder = encoders.value(channelIndex, nullptr);
+    encoders[channelIndex] = newEncoder;
 
-        encoders[channelIndex] = new VorbisEncoder(maxChannelsForEncoding, sampleRate, encodingQuality);
+    return replacedEncoder;
+}
+
+void NinjamController::recreateEncoderForChannel(int channelIndex)
+{
+    AudioEncoder *newEncoder = createEncoderForChannel(channelIndex);
+    if (newEncoder)
+        delete swapEncoder(channelIndex, newEncoder);
+}
+
+float NinjamController::getEncodingQuality() const
+{
+    if (mainController->isUsingAdaptiveEncodingQuality())
+        return adaptiveEncodingQuality.getQuality();
+
+    return mainController->getEncodingQuality();
+}
+
+void NinjamController::handleIntervalUploaded(qint64 uploadTime, qint64 intervalBytes)
+{
+    if (!mainController->isUsingAdaptiveEncodingQuality())
+        return;
+
+    qint64 intervalPeriod = static_cast<qint64>(mainController->getNinjamService()->getIntervalPeriod());
+
+    adaptiveEncodingQuality.setMaxQuality(mainController->getEncodingQuality());
+    if (adaptiveEncodingQuality.update(uploadTime, intervalBytes, intervalPeriod)) {
+        qCDebug(jtNinjamCore) << "Interval (" << intervalBytes << "bytes) uploaded in" << uploadTime << "ms, interval period:" << intervalPeriod << "ms, new encoding quality:" << adaptiveEncodingQuality.getQuality();
+
+        // the new encoders are created now and used in the next interval
+        int channels = mainController->getInputTrackGroupsCount();
+        for (int channelIndex = 0; channelIndex < channels; ++channelIndex)
+            scheduleEncoderChangeForChannel(channelIndex);
     }
 }
 
 void NinjamController::recreateEncoders()
 {
+    adaptiveEncodingQuality.setMaxQuality(mainController->getEncodingQuality());
+
     if (isRunning()) {
+        discardScheduledEncoderChanges(); // the scheduled encoders would replace the recreated encoders in the next interval
+
         QMutexLocker locker(&encodersMutex); // this method is called from main thread, and the encoders are used in audio thread every time
         for (int e = 0; e < encoders.size(); ++e) {
             delete encoders[e];
         }
         encoders.clear(); // new encoders will be create on demand
+        newestEncodersSettings.clear();
 
         int trackGroupsCount = mainController->getInputTrackGroupsCount();
         for (int channelIndex = 0; channelIndex < trackGroupsCount; ++channelIndex) {
@@ -950,6 +1265,8 @@ void NinjamController::handleIntervalDownloading(const Ninjam::User &user, quint
     mutex.unlock();
 
     if (track) {
+        track->getTelemetry().startDownload();
+
         if (!track->isPlaying()) { // track is not playing yet and receive the first interval bytes
             emit channelXmitChanged(track->getID(), true);
         }
@@ -6,8 +6,14 @@
 #include "ninjam/User.h"
 #include "ninjam/Server.h"
 #include "audio/Encoder.h"
+#include "audio/vorbis/AdaptiveEncodingQuality.h"
+#include "audio/core/SamplesBuffer.h"
 
 #include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QAtomicInt>
+#include <vector>
 
 class NinjamTrackNode;
 
@@ -65,6 +71,8 @@ public:
 
     bool isPreparedForTransmit() const;
 
+    bool exportIntervalsTelemetry(const QString &filePath); // CSV file, one line for each remote channel
+
     void recreateMetronome(int newSampleRate);
 
     void blockUserInChat(const Ninjam::User &user);
@@ -123,7 +131,17 @@ protected:
 
     Audio::MetronomeTrackNode *metronomeTrackNode;
 
+    virtual void handleNewInterval(); // called in audio thread, the interval position can be changed here
+
 private:
+    Audio::SamplesBuffer inputMixBuffer; // the grouped inputs are mixed here before encoding, reused by all groups
+
+    // used only when an audio block is crossing the interval boundary, each part is a view wrapping the block samples
+    Audio::SamplesBuffer stepInBuffer;
+    Audio::SamplesBuffer stepOutBuffer;
+    std::vector<float *> stepInSamples;
+    std::vector<float *> stepOutSamples;
+
     static QString getUniqueKeyForChannel(const Ninjam::UserChannel &channel);
     static QString getUniqueKeyForUser(const Ninjam::User& user);
 
@@ -140,14 +158,31 @@ private:
     int currentBpi;
     int currentBpm;
 
+    // the values after the scheduled changes, used to prepare the loopers memory before the changes are processed
+    quint16 nextBpi;
+    quint16 nextBpm;
+
     QMutex mutex;
     QMutex encodersMutex;
 
+    QThreadPool decodersThreadPool; // the next intervals of all tracks are decoded in parallel before the interval start
+    int intervalPreRollTime; // in milliseconds
+    long getIntervalPreRollSamples(int sampleRate) const;
+
+    // requested by the audio thread, the decoders tasks are started by the main thread timer
+    QAtomicInt intervalPreRollRequested;
+    QAtomicInt playedIntervalsReleaseRequested;
+    QTimer decodersRequestsTimer;
+    static const int DECODERS_REQUESTS_CHECK_PERIOD; // in milliseconds
+    void startIntervalPreRoll();
+    void releasePlayedIntervals();
+
     long computeTotalSamplesInInterval();
+    long computeTotalSamplesInInterval(int bpi, int bpm) const;
+    void reserveLoopersMemory();
     long getSamplesPerBeat();
 
     void processScheduledChanges();
-    bool hasScheduledChanges() const;
 
     static long generateNewTrackID();
 
@@ -156,8 +191,22 @@ private:
     QMap<int, AudioEncoder *> encoders;
     AudioEncoder *getEncoder(quint8 channelIndex);
 
-    void handleNewInterval();
+    struct EncoderSettings
+    {
+        int channels;
+        int sampleRate;
+        float quality;
+    };
+
+    // the settings of the newest encoder created for each channel, installed or waiting for the interval start. Used only in main thread.
+    QMap<int, EncoderSettings> newestEncodersSettings;
+
     void recreateEncoderForChannel(int channelIndex);
+    AudioEncoder *createEncoderForChannel(int channelIndex); // nullptr if the newest encoder can be used
+    AudioEncoder *swapEncoder(int channelIndex, AudioEncoder *newEncoder); // return the replaced encoder, deleted out of audio thread
+
+    AdaptiveEncodingQuality adaptiveEncodingQuality; // used only in main thread
+    float getEncodingQuality() const; // the adaptive quality or the user selected quality
 
     void setXmitStatus(int channelID, bool transmiting);
 
@@ -167,7 +216,15 @@ private:
     class BpiChangeEvent;
     class BpmChangeEvent;
     class InputChannelChangedEvent;// user change the channel input selection from mono to stereo or vice-versa, or user added a new channel, both cases requires a new encoder in next interval
-    QList<SchedulableEvent *> scheduledEvents;
+    std::vector<SchedulableEvent *> scheduledEvents;
+    std::vector<SchedulableEvent *> processedEvents; // pre-allocated, the audio thread is not deleting the processed events
+    QMutex scheduledEventsMutex; // the events are scheduled and deleted in main thread, and processed in audio thread
+
+    static const int PROCESSED_EVENTS_CAPACITY;
+
+    void scheduleEvent(SchedulableEvent *event); // prepare and schedule the event to next interval
+    void deleteProcessedEvents();
+    void discardScheduledEncoderChanges();
 
     class EncodingThread;
 
@@ -175,6 +232,18 @@ private:
 
     bool preparedForTransmit;
     int waitingIntervals;
+
+    /**
+        The local tracks are delayed by the plugins latency compensation, so the transmitted intervals are
+        ending 'transmitLatency' samples after the interval boundary. The latency is updated in the interval start.
+    */
+    long transmitLatency;
+    long transmitIntervalSamples; // samples sent in the current transmitted interval
+    bool transmitPartIsFirst;
+    Audio::SamplesBuffer transmitPartBuffer; // used when the transmitted interval is ending in the middle of a step
+
+    void encodeGroupedInputs(int samplesToProcess);
+    void sendTransmitPart(int groupIndex, int offset, int samples, bool isFirstPart, bool isLastPart);
     static const int TOTAL_PREPARED_INTERVALS = 2; // how many intervals Jamtaba will wait to start trasmiting?
 
 private slots:
@@ -183,6 +252,8 @@ private slots:
     void scheduleBpiChangeEvent(quint16 newBpi, quint16 oldBpi);
     void handleIntervalCompleted(const Ninjam::User &user, quint8 channelIndex, const QByteArray &encodedAudioData);
     void handleIntervalDownloading(const Ninjam::User &user, quint8 channelIndex, int downloadedBytes);
+    void handleIntervalUploaded(qint64 uploadTime, qint64 intervalBytes);
+    void checkDecodersRequests();
     void addNinjamRemoteChannel(const Ninjam::User &user, const Ninjam::UserChannel &channel);
     void removeNinjamRemoteChannel(const Ninjam::User &user, const Ninjam::UserChannel &channel);
     void updateNinjamRemoteChannel(const Ninjam::User &user, const Ninjam::UserChannel &channel);
@@ -198,11 +269,6 @@ inline QList<NinjamTrackNode *> NinjamController::getTrackNodes() const
     return trackNodes.values();
 }
 
-inline bool NinjamController::hasScheduledChanges() const
-{
-    return !scheduledEvents.isEmpty();
-}
-
 inline bool NinjamController::isPreparedForTransmit() const
 {
     return preparedForTransmit;
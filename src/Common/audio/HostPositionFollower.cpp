@@ -0,0 +1,90 @@
+#include "HostPositionFollower.h"
+
+#include <QtGlobal>
+#include <cmath>
+
+using namespace Audio;
+
+const int HostPositionFollower::MAX_CORRECTION_PER_BLOCK = 4;
+const int HostPositionFollower::MAX_SMOOTH_CORRECTION = 512;
+
+HostPositionFollower::HostPositionFollower() :
+    intervalStartPpqPosition(0),
+    synchronizedBpi(0),
+    resyncPending(false),
+    resyncDrift(0)
+{
+
+}
+
+void HostPositionFollower::reset()
+{
+    synchronizedBpi = 0;
+    resyncPending = false;
+    resyncDrift = 0;
+}
+
+void HostPositionFollower::anchor(double hostPpqPosition, long intervalPosition, long samplesInInterval, int bpi)
+{
+    // the interval start is anchored in host timeline, so the next audio callbacks can be compared with host position
+    double samplesPerBeat = static_cast<double>(samplesInInterval) / bpi;
+    intervalStartPpqPosition = hostPpqPosition - intervalPosition / samplesPerBeat;
+    synchronizedBpi = bpi;
+    resyncPending = false;
+}
+
+long HostPositionFollower::follow(double hostPpqPosition, long intervalPosition, long samplesInInterval)
+{
+    if (synchronizedBpi <= 0 || samplesInInterval <= 0)
+        return intervalPosition;
+
+    double samplesPerBeat = static_cast<double>(samplesInInterval) / synchronizedBpi;
+    double samplesSinceIntervalStart = (hostPpqPosition - intervalStartPpqPosition) * samplesPerBeat;
+    long expectedPosition = static_cast<long>(std::fmod(std::round(samplesSinceIntervalStart), samplesInInterval));
+    if (expectedPosition < 0)
+        expectedPosition += samplesInInterval;
+
+    // the drift is wrapped, the shortest way is used when host and ninjam are in different sides of interval boundary
+    long drift = expectedPosition - intervalPosition;
+    if (drift > samplesInInterval/2)
+        drift -= samplesInInterval;
+    else if (drift < -samplesInInterval/2)
+        drift += samplesInInterval;
+
+    if (qAbs(drift) > MAX_SMOOTH_CORRECTION) { // host is looping, or the user moved the host cursor
+        resyncPending = true; // the current interval is not cut, the next interval will start in the host position
+        resyncDrift = drift;
+        return intervalPosition;
+    }
+
+    resyncPending = false; // host is aligned again (jumped back, for example)
+
+    if (qAbs(drift) <= 1) // rounding errors
+        return intervalPosition;
+
+    // small drifts are corrected slowly to avoid audible glitches, interval boundary is never crossed here
+    long correction = qBound(-MAX_CORRECTION_PER_BLOCK, static_cast<int>(drift), MAX_CORRECTION_PER_BLOCK);
+    long newPosition = intervalPosition + correction;
+    if (newPosition > 0 && newPosition < samplesInInterval)
+        return newPosition;
+
+    return intervalPosition;
+}
+
+long HostPositionFollower::takeResyncPosition(long samplesInInterval, int bpi)
+{
+    if (!resyncPending)
+        return 0;
+
+    resyncPending = false;
+
+    if (bpi != synchronizedBpi || samplesInInterval <= 0) // the drift was measured in the old interval size
+        return 0;
+
+    // host and ninjam are running in the same tempo, the drift measured in the last callback is the same in the boundary
+    long position = resyncDrift % samplesInInterval;
+    if (position < 0)
+        position += samplesInInterval;
+
+    return position;
+}
@@ -0,0 +1,49 @@
+#ifndef HOST_POSITION_FOLLOWER_H
+#define HOST_POSITION_FOLLOWER_H
+
+namespace Audio {
+
+/**
+ * Keeps the ninjam interval position aligned with the plugin host timeline. The interval start is anchored
+ * in a host position (in quarter notes), small drifts are corrected a few samples per audio block and the
+ * host jumps (loops, cursor moved) are resynchronized only in the next interval start.
+ */
+
+class HostPositionFollower
+{
+public:
+    HostPositionFollower();
+
+    void reset(); // not anchored, the next host position will be used as anchor
+
+    bool isAnchored(int bpi) const; // BPI changes are invalidating the anchor
+    void anchor(double hostPpqPosition, long intervalPosition, long samplesInInterval, int bpi);
+
+    long follow(double hostPpqPosition, long intervalPosition, long samplesInInterval); // return the corrected interval position
+
+    bool hasPendingResync() const;
+    long takeResyncPosition(long samplesInInterval, int bpi); // the new interval start position, called in interval start
+
+    static const int MAX_CORRECTION_PER_BLOCK; // in samples, small drifts are corrected in many audio callbacks
+    static const int MAX_SMOOTH_CORRECTION; // bigger drifts are treated as loops or jumps in host timeline
+
+private:
+    double intervalStartPpqPosition; // host position (in quarter notes) where the synchronized interval started
+    int synchronizedBpi; // zero when not anchored
+    bool resyncPending;
+    long resyncDrift;
+};
+
+inline bool HostPositionFollower::isAnchored(int bpi) const
+{
+    return synchronizedBpi > 0 && synchronizedBpi == bpi;
+}
+
+inline bool HostPositionFollower::hasPendingResync() const
+{
+    return resyncPending;
+}
+
+} // namespace
+
+#endif // HOST_POSITION_FOLLOWER_H
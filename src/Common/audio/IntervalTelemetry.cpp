@@ -0,0 +1,111 @@
+#include "IntervalTelemetry.h"
+
+#include <QStringList>
+
+#include <limits>
+
+using namespace Audio;
+
+IntervalTelemetry::IntervalTelemetry() :
+    downloading(0),
+    missedSinceLastInterval(0),
+    receivedIntervals(0),
+    missedIntervals(0),
+    lastIntervalBytes(0),
+    averageIntervalBytes(0),
+    downloadTime(0),
+    throughput(0),
+    arrivalMargin(0),
+    minArrivalMargin(std::numeric_limits<int>::max()),
+    decodeTime(0)
+{
+
+}
+
+void IntervalTelemetry::startDownload()
+{
+    if (!isDownloading()) { // the first chunk of the interval
+        downloadTimer.start();
+        downloading.store(1);
+    }
+}
+
+void IntervalTelemetry::finishDownload(int intervalBytes, int margin)
+{
+    int elapsedTime = downloadTimer.isValid() ? static_cast<int>(downloadTimer.elapsed()) : 0;
+
+    downloading.store(0);
+    missedSinceLastInterval.store(0);
+
+    int received = receivedIntervals.load();
+    int average = averageIntervalBytes.load();
+    average = (received == 0) ? intervalBytes : average + (intervalBytes - average) / 8; // smoothing
+
+    lastIntervalBytes.store(intervalBytes);
+    averageIntervalBytes.store(average);
+    downloadTime.store(elapsedTime);
+    throughput.store(elapsedTime > 0 ? static_cast<int>(intervalBytes * 1000LL / elapsedTime) : 0);
+    arrivalMargin.store(margin);
+    if (margin < minArrivalMargin.load())
+        minArrivalMargin.store(margin);
+
+    receivedIntervals.ref();
+}
+
+void IntervalTelemetry::addMissedInterval()
+{
+    missedIntervals.ref();
+    missedSinceLastInterval.store(1);
+}
+
+void IntervalTelemetry::setDecodeTime(int time)
+{
+    decodeTime.store(time);
+}
+
+void IntervalTelemetry::setChannelName(const QString &userName, const QString &channelName)
+{
+    this->userName = userName;
+    this->channelName = channelName;
+}
+
+IntervalTelemetry::Snapshot IntervalTelemetry::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.receivedIntervals = receivedIntervals.load();
+    snapshot.missedIntervals = missedIntervals.load();
+    snapshot.lastIntervalBytes = lastIntervalBytes.load();
+    snapshot.averageIntervalBytes = averageIntervalBytes.load();
+    snapshot.downloadTime = downloadTime.load();
+    snapshot.throughput = throughput.load();
+    snapshot.arrivalMargin = arrivalMargin.load();
+    snapshot.minArrivalMargin = snapshot.receivedIntervals > 0 ? minArrivalMargin.load() : 0;
+    snapshot.decodeTime = decodeTime.load();
+    return snapshot;
+}
+
+QString IntervalTelemetry::getCsvHeader()
+{
+    return "user,channel,received intervals,missed intervals,last interval bytes,average interval bytes,"
+           "download time (ms),throughput (bytes/s),arrival margin (ms),min arrival margin (ms),decode time (us)";
+}
+
+QString IntervalTelemetry::getCsvLine() const
+{
+    Snapshot snapshot = getSnapshot();
+
+    QStringList values;
+    values << QString(userName).replace(',', ' ')
+           << QString(channelName).replace(',', ' ')
+           << QString::number(snapshot.receivedIntervals)
+           << QString::number(snapshot.missedIntervals)
+           << QString::number(snapshot.lastIntervalBytes)
+           << QString::number(snapshot.averageIntervalBytes)
+           << QString::number(snapshot.downloadTime)
+           << QString::number(snapshot.throughput)
+           << QString::number(snapshot.arrivalMargin)
+           << QString::number(snapshot.minArrivalMargin)
+           << QString::number(snapshot.decodeTime);
+
+    return values.join(',');
+}
@@ -0,0 +1,95 @@
+#ifndef INTERVAL_TELEMETRY_H
+#define INTERVAL_TELEMETRY_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QString>
+
+namespace Audio {
+
+/**
+ * Delivery statistics of the intervals received in a ninjam track (one user channel). The values are written
+ * by the network (main) thread, the audio thread and the decoding threads, so the counters are atomics and
+ * the GUI is reading a snapshot. Used to find if a late interval is caused by network, server or decoding.
+ */
+
+class IntervalTelemetry
+{
+public:
+    IntervalTelemetry();
+
+    struct Snapshot
+    {
+        int receivedIntervals;
+        int missedIntervals; // the interval was not available in the interval start
+        int lastIntervalBytes;
+        int averageIntervalBytes;
+        int downloadTime; // in milliseconds, from the first received chunk to the last
+        int throughput; // in bytes per second
+        int arrivalMargin; // in milliseconds until the interval playback, negative when the interval is late
+        int minArrivalMargin;
+        int decodeTime; // in microseconds, used to decode the last played interval
+    };
+
+    Snapshot getSnapshot() const;
+
+    // network thread
+    void startDownload();
+    void finishDownload(int intervalBytes, int arrivalMargin);
+    bool hasMissedInterval() const; // an interval was missed since the last received interval
+
+    // audio thread
+    bool isDownloading() const;
+    void addMissedInterval();
+    void setDecodeTime(int decodeTime);
+
+    // the names are used only in main thread, in CSV export
+    void setChannelName(const QString &userName, const QString &channelName);
+    QString getUserName() const;
+    QString getChannelName() const;
+
+    static QString getCsvHeader();
+    QString getCsvLine() const;
+
+private:
+    QElapsedTimer downloadTimer; // used only in network thread
+    QAtomicInt downloading;
+    QAtomicInt missedSinceLastInterval;
+
+    QAtomicInt receivedIntervals;
+    QAtomicInt missedIntervals;
+    QAtomicInt lastIntervalBytes;
+    QAtomicInt averageIntervalBytes;
+    QAtomicInt downloadTime;
+    QAtomicInt throughput;
+    QAtomicInt arrivalMargin;
+    QAtomicInt minArrivalMargin;
+    QAtomicInt decodeTime;
+
+    QString userName;
+    QString channelName;
+};
+
+inline bool IntervalTelemetry::isDownloading() const
+{
+    return downloading.load() != 0;
+}
+
+inline bool IntervalTelemetry::hasMissedInterval() const
+{
+    return missedSinceLastInterval.load() != 0;
+}
+
+inline QString IntervalTelemetry::getUserName() const
+{
+    return userName;
+}
+
+inline QString IntervalTelemetry::getChannelName() const
+{
+    return channelName;
+}
+
+} // namespace
+
+#endif // INTERVAL_TELEMETRY_H
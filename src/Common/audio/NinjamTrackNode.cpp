@@ -6,12 +6,17 @@
 #include <QByteArray>
 #include <QMutexLocker>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QAtomicInt>
 #include <QtConcurrent/QtConcurrent>
 #include "audio/core/Filters.h"
 
 const double NinjamTrackNode::LOW_CUT_DRASTIC_FREQUENCY = 220.0; // in Hertz
 const double NinjamTrackNode::LOW_CUT_NORMAL_FREQUENCY = 120.0; // in Hertz
 
+const quint32 NinjamTrackNode::PRIMED_FRAMES = 8192; // at least two big audio blocks, including resampling
+const int NinjamTrackNode::RETIRED_DECODERS_CAPACITY = 8;
+
 class NinjamTrackNode::LowCutFilter
 {
 public:
@@ -64,57 +69,109 @@ class NinjamTrackNode::IntervalDecoder
 {
 public:
     explicit IntervalDecoder(const QByteArray &vorbisData);
-    void decode(quint32 maxSamplesToDecode);
+    void prime(quint32 samplesToDecode);
     quint32 getDecodedSamples(Audio::SamplesBuffer &outBuffer, uint samplesToDecode);
     inline int getSampleRate() const { return vorbisDecoder.getSampleRate(); }
     inline bool isStereo() const { return vorbisDecoder.isStereo(); }
     void stopDecoding();
+    int getDecodeTime() const; // in microseconds
 private:
+    void decodeUntil(quint32 samplesToDecode); // the decoder mutex is locked by the caller
     VorbisDecoder vorbisDecoder;
     Audio::SamplesBuffer decodedBuffer;
-    QMutex mutex;
+    QMutex decoderMutex; // locked while decoding, the audio thread is not waiting for the priming tasks
+    QMutex bufferMutex; // locked only to append or take the decoded samples
+    bool finished; // all samples are decoded, protected by the buffer mutex
+    quint32 framesBehind; // played as silence while a priming task was decoding, skipped later (audio thread only)
+    QAtomicInt decodeTime; // sum of all decoding calls, read in audio thread
 };
 
 NinjamTrackNode::IntervalDecoder::IntervalDecoder(const QByteArray &vorbisData)
-    :decodedBuffer(2)
+    :decodedBuffer(2),
+      finished(false),
+      framesBehind(0),
+      decodeTime(0)
 {
     vorbisDecoder.setInputData(vorbisData);
 }
 
-void NinjamTrackNode::IntervalDecoder::decode(quint32 maxSamplesToDecode)
+void NinjamTrackNode::IntervalDecoder::prime(quint32 samplesToDecode)
+{
+    QMutexLocker locker(&decoderMutex);
+    decodeUntil(samplesToDecode);
+}
+
+void NinjamTrackNode::IntervalDecoder::decodeUntil(quint32 samplesToDecode)
 {
-    mutex.lock();
+    QElapsedTimer timer;
+    timer.start();
+    while (true) {
+        bufferMutex.lock();
+        quint32 decodedFrames = decodedBuffer.getFrameLenght();
+        bufferMutex.unlock();
+
+        if (decodedFrames >= samplesToDecode)
+            break;
+
+        const Audio::SamplesBuffer &decodedSamples = vorbisDecoder.decode(samplesToDecode - decodedFrames);
 
-    decodedBuffer.append(vorbisDecoder.decode(maxSamplesToDecode));
+        QMutexLocker locker(&bufferMutex);
+        decodedBuffer.append(decodedSamples);
+        if (decodedSamples.isEmpty()) {
+            finished = true;
+            break; //no more samples to decode
+        }
+    }
+    decodeTime.fetchAndAddRelaxed(static_cast<int>(timer.nsecsElapsed() / 1000));
+}
 
-    mutex.unlock();
+int NinjamTrackNode::IntervalDecoder::getDecodeTime() const
+{
+    return decodeTime.load();
 }
 
 void NinjamTrackNode::IntervalDecoder::stopDecoding()
 {
-    mutex.lock(); // this funcion is called from GUI thread
+    decoderMutex.lock(); // this funcion is called from GUI thread
 
     vorbisDecoder.setInputData(QByteArray()); // empty data
 
-    mutex.unlock();
+    decoderMutex.unlock();
 }
 
 quint32 NinjamTrackNode::IntervalDecoder::getDecodedSamples(Audio::SamplesBuffer &outBuffer, uint samplesToDecode)
 {
-    mutex.lock();
-    while (decodedBuffer.getFrameLenght() < samplesToDecode) { //need decode more samples to fill outBuffer?
-        quint32 toDecode = samplesToDecode - decodedBuffer.getFrameLenght();
-        const Audio::SamplesBuffer &decodedSamples = vorbisDecoder.decode(toDecode);
-        decodedBuffer.append(decodedSamples);
-        if (decodedSamples.isEmpty())
-            break; //no more samples to decode
+    // intervals not primed are decoded here, the audio thread is not waiting when a priming task is decoding
+    if (decoderMutex.tryLock()) {
+        decodeUntil(framesBehind + samplesToDecode);
+        decoderMutex.unlock();
+    }
+
+    outBuffer.setFrameLenght(samplesToDecode);
+
+    if (!bufferMutex.tryLock()) { // the priming task is appending the samples
+        outBuffer.zero();
+        framesBehind += samplesToDecode;
+        return samplesToDecode;
+    }
+
+    // the frames played as silence are skipped, the interval is kept aligned
+    quint32 framesToSkip = qMin(framesBehind, decodedBuffer.getFrameLenght());
+    decodedBuffer.discardFirstSamples(framesToSkip);
+    framesBehind -= framesToSkip;
+
+    quint32 decodedFrames = qMin(samplesToDecode, decodedBuffer.getFrameLenght());
+    quint32 totalSamples = decodedFrames;
+    if (decodedFrames < samplesToDecode && !finished) { // still decoding, the missing frames are silence
+        outBuffer.zero();
+        framesBehind += samplesToDecode - decodedFrames;
+        totalSamples = samplesToDecode;
     }
 
-    quint32 totalSamples = qMin(samplesToDecode, decodedBuffer.getFrameLenght());
     outBuffer.setFrameLenght(totalSamples);
-    outBuffer.set(decodedBuffer);
-    decodedBuffer.discardFirstSamples(totalSamples);
-    mutex.unlock();
+    outBuffer.set(decodedBuffer, 0, decodedFrames, 0);
+    decodedBuffer.discardFirstSamples(decodedFrames);
+    bufferMutex.unlock();
     return totalSamples;
 }
 
@@ -123,11 +180,10 @@ quint32 NinjamTrackNode::IntervalDecoder::getDecodedSamples(Audio::SamplesBuffer
 NinjamTrackNode::NinjamTrackNode(int ID) :
     ID(ID),
     processingLastPartOfInterval(false),
-    currentDecoder(nullptr),
     decodersMutex(QMutex::NonRecursive),
     lowCut(new NinjamTrackNode::LowCutFilter(44100))
 {
-
+    retiredDecoders.reserve(RETIRED_DECODERS_CAPACITY); // no allocations in audio thread when the intervals are retired
 }
 
 bool NinjamTrackNode::isStereo() const
@@ -142,7 +198,7 @@ void NinjamTrackNode::stopDecoding()
 {
     discardDownloadedIntervals(false);
 
-    if (currentDecoder != nullptr)
+    if (currentDecoder)
         currentDecoder->stopDecoding();
 }
 
@@ -188,14 +244,9 @@ int NinjamTrackNode::getSampleRate() const
 NinjamTrackNode::~NinjamTrackNode()
 {
     decodersMutex.lock();
-    foreach (IntervalDecoder *decoder, decoders)
-        delete decoder;
-
     decoders.clear();
-    if (currentDecoder) {
-        delete currentDecoder;
-        currentDecoder = nullptr;
-    }
+    retiredDecoders.clear();
+    currentDecoder.clear();
     decodersMutex.unlock();
 }
 
@@ -203,11 +254,10 @@ void NinjamTrackNode::discardDownloadedIntervals(bool keepMostRecentInterval)
 {
     decodersMutex.lock();
     if (!keepMostRecentInterval) {
-        while (!decoders.isEmpty())
-            delete decoders.takeFirst();
+        decoders.clear();
     } else {
         while(decoders.size() > 1)//keep the last downloaded interval
-            delete decoders.takeFirst();
+            decoders.removeFirst();
     }
     qDebug() << "intervals discarded";
     decodersMutex.unlock();
@@ -216,32 +266,82 @@ void NinjamTrackNode::discardDownloadedIntervals(bool keepMostRecentInterval)
 bool NinjamTrackNode::isPlaying()
 {
     QMutexLocker locker(&decodersMutex);
-    return currentDecoder != nullptr;
+    return !currentDecoder.isNull();
 }
 
 bool NinjamTrackNode::startNewInterval()
 {
     decodersMutex.lock();
     if (currentDecoder) {
-        delete currentDecoder; //discard the previous interval decoder
-        currentDecoder = nullptr;
+        telemetry.setDecodeTime(currentDecoder->getDecodeTime());
+        retiredDecoders.push_back(currentDecoder); //discard the previous interval decoder, released in the next priming
+        currentDecoder.clear();
     }
     if (!decoders.isEmpty())
         currentDecoder = decoders.takeFirst(); //using the next buffered decoder (next interval)
+    else if (telemetry.isDownloading())
+        telemetry.addMissedInterval(); // the interval is needed now, but still downloading
 
     decodersMutex.unlock();
     return isPlaying();
 }
 
+int NinjamTrackNode::getQueuedIntervals()
+{
+    QMutexLocker locker(&decodersMutex);
+    return decoders.size();
+}
+
 void NinjamTrackNode::addVorbisEncodedInterval(const QByteArray &vorbisData)
 {
+    QSharedPointer<IntervalDecoder> newIntervalDecoder(new IntervalDecoder(vorbisData));
     decodersMutex.lock();
-    IntervalDecoder *newIntervalDecoder = new IntervalDecoder(vorbisData);
     decoders.append(newIntervalDecoder);
     decodersMutex.unlock();
 
     //decoding the first samples in a separated thread to avoid slow down the audio thread in interval start (first beat)
-    QtConcurrent::run(newIntervalDecoder, &NinjamTrackNode::IntervalDecoder::decode, 256);
+    QtConcurrent::run([newIntervalDecoder]() {
+        newIntervalDecoder->prime(256);
+    });
+}
+
+void NinjamTrackNode::primeNextInterval(QThreadPool *threadPool)
+{
+    QSharedPointer<IntervalDecoder> nextDecoder;
+    std::vector<QSharedPointer<IntervalDecoder>> playedDecoders;
+    playedDecoders.reserve(RETIRED_DECODERS_CAPACITY); // swapped with the audio thread list
+
+    decodersMutex.lock();
+    if (!decoders.isEmpty())
+        nextDecoder = decoders.first();
+    playedDecoders.swap(retiredDecoders);
+    decodersMutex.unlock();
+
+    if (!nextDecoder && playedDecoders.empty())
+        return;
+
+    QtConcurrent::run(threadPool, [nextDecoder, playedDecoders]() mutable {
+        playedDecoders.clear(); // the played intervals are deleted here, not in the audio thread
+        if (nextDecoder)
+            nextDecoder->prime(PRIMED_FRAMES);
+    });
+}
+
+void NinjamTrackNode::releasePlayedIntervals(QThreadPool *threadPool)
+{
+    std::vector<QSharedPointer<IntervalDecoder>> playedDecoders;
+    playedDecoders.reserve(RETIRED_DECODERS_CAPACITY);
+
+    decodersMutex.lock();
+    playedDecoders.swap(retiredDecoders);
+    decodersMutex.unlock();
+
+    if (playedDecoders.empty())
+        return;
+
+    QtConcurrent::run(threadPool, [playedDecoders]() mutable {
+        playedDecoders.clear();
+    });
 }
 
 // ++++++++++++++++++++++++++++++++++++++
@@ -3,14 +3,19 @@
 
 #include "core/AudioNode.h"
 #include <QByteArray>
+#include <QSharedPointer>
+#include <vector>
 #include "vorbis/VorbisDecoder.h"
 #include "SamplesBufferResampler.h"
+#include "IntervalTelemetry.h"
 
 namespace Audio {
 class SamplesBuffer;
 class StreamBuffer;
 }
 
+class QThreadPool;
+
 class NinjamTrackNode : public Audio::AudioNode
 {
 
@@ -32,6 +37,10 @@ public:
     LowCutState getLowCutState() const;
 
     bool startNewInterval();
+
+    // decode the first samples of the next interval and release the played intervals using the thread pool
+    void primeNextInterval(QThreadPool *threadPool);
+    void releasePlayedIntervals(QThreadPool *threadPool); // used when the pre-roll is disabled
     int getID() const;
 
     int getSampleRate() const;
@@ -47,6 +56,11 @@ public:
 
     void setProcessingLastPartOfInterval(bool status);
 
+    int getQueuedIntervals(); // downloaded intervals waiting to be played
+
+    Audio::IntervalTelemetry &getTelemetry();
+    const Audio::IntervalTelemetry &getTelemetry() const;
+
 private:
     int ID;
     SamplesBufferResampler resampler;
@@ -64,12 +78,29 @@ private:
 
     class IntervalDecoder;
 
-    QList<IntervalDecoder*> decoders;
-    IntervalDecoder* currentDecoder;
+    // shared pointers, the decoders can be in use by the priming tasks when they are discarded
+    QList<QSharedPointer<IntervalDecoder>> decoders;
+    QSharedPointer<IntervalDecoder> currentDecoder;
+    std::vector<QSharedPointer<IntervalDecoder>> retiredDecoders; // played intervals, released out of audio thread
     QMutex decodersMutex;
 
+    static const quint32 PRIMED_FRAMES; // decoded before the interval start
+    static const int RETIRED_DECODERS_CAPACITY;
+
+    Audio::IntervalTelemetry telemetry;
+
 };
 
+inline Audio::IntervalTelemetry &NinjamTrackNode::getTelemetry()
+{
+    return telemetry;
+}
+
+inline const Audio::IntervalTelemetry &NinjamTrackNode::getTelemetry() const
+{
+    return telemetry;
+}
+
 inline void NinjamTrackNode::setProcessingLastPartOfInterval(bool status)
 {
     this->processingLastPartOfInterval = status;
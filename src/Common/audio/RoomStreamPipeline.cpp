@@ -0,0 +1,206 @@
+#include "RoomStreamPipeline.h"
+#include "Mp3Decoder.h"
+#include "core/SamplesRingBuffer.h"
+#include "log/Logging.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QDebug>
+
+using namespace Audio;
+
+RoomStreamDownloader::RoomStreamDownloader() :
+    httpClient(nullptr),
+    reply(nullptr),
+    streamID(0)
+{
+    clock.start();
+}
+
+void RoomStreamDownloader::start(const QUrl &streamUrl, quint32 streamID)
+{
+    stop();
+
+    this->streamID = streamID;
+
+    if (streamUrl.isEmpty())
+        return;
+
+    if (!httpClient)
+        httpClient = new QNetworkAccessManager(this);
+
+    qCDebug(jtNinjamRoomStreamer) << "connecting in " << streamUrl;
+
+    reply = httpClient->get(QNetworkRequest(streamUrl));
+    connect(reply, &QNetworkReply::readyRead, this, &RoomStreamDownloader::readBytes);
+    connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(handleError(QNetworkReply::NetworkError)));
+}
+
+void RoomStreamDownloader::stop()
+{
+    if (reply) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        reply = nullptr;
+    }
+}
+
+void RoomStreamDownloader::readBytes()
+{
+    if (!reply || !reply->isOpen() || !reply->isReadable()) {
+        qCritical() << "problem in device!";
+        return;
+    }
+
+    QByteArray bytes = reply->readAll();
+    if (!bytes.isEmpty())
+        emit bytesDownloaded(bytes, clock.elapsed(), streamID);
+}
+
+void RoomStreamDownloader::handleError(QNetworkReply::NetworkError error)
+{
+    Q_UNUSED(error);
+
+    QString msg = "ERROR playing room stream";
+    qCritical() << msg;
+    emit this->error(msg);
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++
+
+const int RoomStreamDecoder::MAX_BYTES_PER_DECODING = 2048;
+const int RoomStreamDecoder::MIN_TARGET_FILL_MS = 1500;
+const int RoomStreamDecoder::MAX_TARGET_FILL_MS = 6000;
+const int RoomStreamDecoder::REBUFFERING_PENALTY_MS = 500;
+const double RoomStreamDecoder::JITTER_SAFETY_FACTOR = 2.0;
+const double RoomStreamDecoder::PEAK_GAP_DECAY = 0.98;
+
+RoomStreamDecoder::RoomStreamDecoder(SamplesRingBuffer &ringBuffer, Mp3Decoder *decoder) :
+    ringBuffer(ringBuffer),
+    decoder(decoder),
+    decodingTimer(nullptr),
+    currentStreamID(0),
+    lastArrivalTime(-1),
+    peakArrivalGap(0),
+    sampleRate(44100),
+    targetFill(0),
+    bufferedBytes(0),
+    rebufferings(0),
+    discardGeneration(0),
+    discardPosition(0),
+    lastSeenRebufferings(0),
+    rebufferingPenalty(0)
+{
+    updateTargetFill(-1);
+}
+
+RoomStreamDecoder::~RoomStreamDecoder()
+{
+    delete decoder;
+}
+
+void RoomStreamDecoder::reset(quint32 newStreamID)
+{
+    currentStreamID = newStreamID; // the bytes still queued from the old reply are ignored
+
+    if (decodingTimer)
+        decodingTimer->stop();
+
+    decoder->reset(); // discard unprocessed bytes
+    pendingBytes.clear();
+    bufferedBytes.store(0);
+
+    lastArrivalTime = -1;
+    peakArrivalGap = 0;
+    rebufferingPenalty = 0;
+    lastSeenRebufferings = rebufferings.load();
+
+    updateTargetFill(-1);
+
+    // the samples in the ring are from the previous stream, the position is published before the generation
+    discardPosition.storeRelease(static_cast<int>(ringBuffer.getWritePosition()));
+    discardGeneration.fetchAndAddRelease(1);
+}
+
+void RoomStreamDecoder::addBytes(const QByteArray &bytes, qint64 arrivalTime, quint32 streamID)
+{
+    if (streamID != currentStreamID)
+        return; // bytes from a stopped stream
+
+    if (!decodingTimer) {
+        decodingTimer = new QTimer(this);
+        decodingTimer->setInterval(20);
+        connect(decodingTimer, &QTimer::timeout, this, &RoomStreamDecoder::decodePendingBytes);
+    }
+
+    if (!decodingTimer->isActive())
+        decodingTimer->start();
+
+    pendingBytes.append(bytes);
+    bufferedBytes.store(pendingBytes.size());
+
+    updateTargetFill(arrivalTime);
+
+    decodePendingBytes();
+}
+
+void RoomStreamDecoder::updateTargetFill(qint64 arrivalTime)
+{
+    if (arrivalTime >= 0) {
+        if (lastArrivalTime >= 0) {
+            double gap = arrivalTime - lastArrivalTime;
+            if (gap > peakArrivalGap)
+                peakArrivalGap = gap; // react fast to bigger gaps
+            else
+                peakArrivalGap = peakArrivalGap * PEAK_GAP_DECAY + gap * (1.0 - PEAK_GAP_DECAY); // and relax slowly
+        }
+        lastArrivalTime = arrivalTime;
+    }
+
+    int currentRebufferings = rebufferings.load();
+    if (currentRebufferings != lastSeenRebufferings) {
+        rebufferingPenalty += REBUFFERING_PENALTY_MS * (currentRebufferings - lastSeenRebufferings);
+        lastSeenRebufferings = currentRebufferings;
+        qCDebug(jtNinjamRoomStreamer) << "Rebuffering detected, penalty:" << rebufferingPenalty << "ms";
+    }
+
+    int targetMs = MIN_TARGET_FILL_MS + static_cast<int>(peakArrivalGap * JITTER_SAFETY_FACTOR) + rebufferingPenalty;
+    targetMs = qBound(MIN_TARGET_FILL_MS, targetMs, MAX_TARGET_FILL_MS);
+
+    uint targetFrames = static_cast<uint>(static_cast<qint64>(targetMs) * sampleRate.load() / 1000);
+    targetFill.store(static_cast<int>(qMin(targetFrames, ringBuffer.getCapacity() / 2)));
+}
+
+void RoomStreamDecoder::decodePendingBytes()
+{
+    static const uint MAX_DECODED_FRAMES = 4096 * 2; // the max frames returned by a single mp3 decoding call
+
+    if (rebufferings.load() != lastSeenRebufferings)
+        updateTargetFill(-1);
+
+    int bytesProcessed = 0;
+    while (bytesProcessed < pendingBytes.size() && ringBuffer.getFreeFrames() >= MAX_DECODED_FRAMES) {
+        int bytesToProcess = qMin(pendingBytes.size() - bytesProcessed, MAX_BYTES_PER_DECODING);
+        const SamplesBuffer decodedBuffer = decoder->decode(pendingBytes.data() + bytesProcessed, bytesToProcess);
+        bytesProcessed += bytesToProcess;
+
+        if (!decodedBuffer.isEmpty())
+            ringBuffer.write(decodedBuffer);
+    }
+
+    if (bytesProcessed > 0) {
+        pendingBytes.remove(0, bytesProcessed);
+        bufferedBytes.store(pendingBytes.size());
+
+        int decoderSampleRate = decoder->getSampleRate();
+        if (decoderSampleRate != sampleRate.load()) {
+            sampleRate.store(decoderSampleRate);
+            updateTargetFill(-1);
+        }
+    }
+
+    if (pendingBytes.isEmpty() && decodingTimer)
+        decodingTimer->stop(); // idle, restarted when new bytes arrive
+}
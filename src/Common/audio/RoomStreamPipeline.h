@@ -0,0 +1,138 @@
+#ifndef ROOM_STREAM_PIPELINE_H
+#define ROOM_STREAM_PIPELINE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QUrl>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+
+class QNetworkAccessManager;
+class QTimer;
+
+namespace Audio {
+
+class Mp3Decoder;
+class SamplesRingBuffer;
+
+/**
+ * The room stream pipeline used by NinjamRoomStreamerNode:
+ *      RoomStreamDownloader (I/O thread) -> RoomStreamDecoder (worker thread) -> SamplesRingBuffer -> audio thread
+ */
+
+class RoomStreamDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    RoomStreamDownloader();
+
+public slots:
+    void start(const QUrl &streamUrl, quint32 streamID);
+    void stop();
+
+signals:
+    void bytesDownloaded(const QByteArray &bytes, qint64 arrivalTime, quint32 streamID); // arrival time in ms, used to estimate network jitter
+    void error(const QString &errorMessage);
+
+private slots:
+    void readBytes();
+    void handleError(QNetworkReply::NetworkError error);
+
+private:
+    QNetworkAccessManager *httpClient; // created in the I/O thread
+    QNetworkReply *reply;
+    quint32 streamID;
+    QElapsedTimer clock;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++
+
+class RoomStreamDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    RoomStreamDecoder(SamplesRingBuffer &ringBuffer, Mp3Decoder *decoder);
+    ~RoomStreamDecoder();
+
+    // thread safe getters
+    int getSampleRate() const;
+    uint getTargetFill() const; // in frames
+    uint getBufferedBytes() const;
+
+    void notifyRebuffering(); // called by the audio thread when the ring buffer run out of samples
+
+    // incremented in each reset, the audio thread discards the ring samples written before the discard position
+    uint getDiscardGeneration() const;
+    uint getDiscardPosition() const;
+
+public slots:
+    void addBytes(const QByteArray &bytes, qint64 arrivalTime, quint32 streamID);
+    void reset(quint32 newStreamID);
+    void decodePendingBytes();
+
+private:
+    void updateTargetFill(qint64 arrivalTime);
+
+    SamplesRingBuffer &ringBuffer;
+    Mp3Decoder *decoder;
+
+    QByteArray pendingBytes;
+    QTimer *decodingTimer; // created in the worker thread to top up the ring while the audio thread consume samples, stopped when idle
+    quint32 currentStreamID;
+
+    qint64 lastArrivalTime;
+    double peakArrivalGap; // in ms, slowly decaying peak of the time between network packets
+
+    QAtomicInt sampleRate;
+    QAtomicInt targetFill;
+    QAtomicInt bufferedBytes;
+    QAtomicInt rebufferings;
+    QAtomicInt discardGeneration;
+    QAtomicInt discardPosition; // the ring write position when the stream was reset
+    int lastSeenRebufferings;
+    int rebufferingPenalty; // in ms, increased on each rebuffering event
+
+    static const int MAX_BYTES_PER_DECODING;
+    static const int MIN_TARGET_FILL_MS;
+    static const int MAX_TARGET_FILL_MS;
+    static const int REBUFFERING_PENALTY_MS;
+    static const double JITTER_SAFETY_FACTOR;
+    static const double PEAK_GAP_DECAY;
+};
+
+inline int RoomStreamDecoder::getSampleRate() const
+{
+    return sampleRate.load();
+}
+
+inline uint RoomStreamDecoder::getTargetFill() const
+{
+    return static_cast<uint>(targetFill.load());
+}
+
+inline uint RoomStreamDecoder::getBufferedBytes() const
+{
+    return static_cast<uint>(bufferedBytes.load());
+}
+
+inline void RoomStreamDecoder::notifyRebuffering()
+{
+    rebufferings.fetchAndAddRelaxed(1);
+}
+
+inline uint RoomStreamDecoder::getDiscardGeneration() const
+{
+    return static_cast<uint>(discardGeneration.loadAcquire());
+}
+
+inline uint RoomStreamDecoder::getDiscardPosition() const
+{
+    return static_cast<uint>(discardPosition.loadAcquire());
+}
+
+} // namespace
+
+#endif // ROOM_STREAM_PIPELINE_H
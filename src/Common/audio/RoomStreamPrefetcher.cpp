@@ -0,0 +1,280 @@
+#include "RoomStreamPrefetcher.h"
+#include "log/Logging.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QDebug>
+#include <algorithm>
+
+using namespace Audio;
+
+const int RoomStreamPrefetcher::RETAINED_SECONDS = 6;
+const int RoomStreamPrefetcher::MAX_RETAINED_BYTES_PER_ROOM = 256 * 1024;
+const qint64 RoomStreamPrefetcher::MAX_BYTES_PER_SECOND = 64 * 1024; // 512 kbps
+const qint64 RoomStreamPrefetcher::DEFAULT_BYTES_PER_SECOND = 16 * 1024; // 128 kbps
+const double RoomStreamPrefetcher::INTEREST_DECAY = 0.9;
+
+class RoomStreamPrefetcher::PrefetchedStream
+{
+public:
+    explicit PrefetchedStream(QNetworkReply *reply) :
+        reply(reply),
+        receivedBytes(0)
+    {
+        clock.start();
+    }
+
+    ~PrefetchedStream()
+    {
+        reply->disconnect();
+        reply->abort();
+        reply->deleteLater();
+    }
+
+    void appendBytes(const QByteArray &newBytes)
+    {
+        receivedBytes += newBytes.size();
+        bytes.append(newBytes);
+
+        int maxBytes = getMaxRetainedBytes();
+        if (bytes.size() > maxBytes)
+            bytes.remove(0, bytes.size() - maxBytes); // keep just the last seconds
+    }
+
+    qint64 getBytesPerSecond() const
+    {
+        qint64 elapsed = clock.elapsed();
+        if (elapsed < 1000)
+            return 0; // not enough data
+
+        return receivedBytes * 1000 / elapsed;
+    }
+
+    QNetworkReply *reply;
+    QByteArray bytes;
+
+private:
+    int getMaxRetainedBytes() const
+    {
+        qint64 bytesPerSecond = getBytesPerSecond();
+        if (bytesPerSecond <= 0)
+            return MAX_RETAINED_BYTES_PER_ROOM;
+
+        return static_cast<int>(qMin(bytesPerSecond * RETAINED_SECONDS, static_cast<qint64>(MAX_RETAINED_BYTES_PER_ROOM)));
+    }
+
+    qint64 receivedBytes;
+    QElapsedTimer clock;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++
+
+RoomStreamPrefetcher::RoomStreamPrefetcher(QObject *parent) :
+    QObject(parent),
+    httpClient(new QNetworkAccessManager(this)),
+    listenedRoomID(-1000),
+    maxPrefetchedRooms(0)
+{
+    connect(&updateTimer, &QTimer::timeout, this, &RoomStreamPrefetcher::updateConnections);
+    updateTimer.setInterval(5000); // check the bandwidth cap periodically
+}
+
+RoomStreamPrefetcher::~RoomStreamPrefetcher()
+{
+    qDeleteAll(streams);
+}
+
+void RoomStreamPrefetcher::setMaxPrefetchedRooms(int maxRooms)
+{
+    maxPrefetchedRooms = qMax(0, maxRooms);
+
+    if (maxPrefetchedRooms > 0)
+        updateTimer.start();
+    else
+        updateTimer.stop();
+
+    updateConnections();
+}
+
+void RoomStreamPrefetcher::addInterest(long long roomID, const QString &streamUrl, InterestWeight weight)
+{
+    if (streamUrl.isEmpty())
+        return;
+
+    // older interests lose importance, the recently hovered/listened rooms are preferred
+    for (auto it = interests.begin(); it != interests.end(); ++it)
+        it.value() *= INTEREST_DECAY;
+
+    interests[roomID] += static_cast<int>(weight);
+    streamUrls[roomID] = streamUrl;
+
+    updateConnections();
+}
+
+void RoomStreamPrefetcher::updateRoom(long long roomID, const QString &streamUrl, bool roomIsEmpty)
+{
+    finishedRooms.remove(roomID); // the room list changed, a finished stream can be connected again
+
+    if (roomIsEmpty || streamUrl.isEmpty()) {
+        interests.remove(roomID);
+        streamUrls.remove(roomID);
+        disconnectRoom(roomID);
+        return;
+    }
+
+    if (streamUrls.contains(roomID) && streamUrls[roomID] != streamUrl) {
+        streamUrls[roomID] = streamUrl;
+        disconnectRoom(roomID); // reconnected in the new url by updateConnections()
+        updateConnections();
+    }
+}
+
+void RoomStreamPrefetcher::removeMissingRooms(const QSet<long long> &publicRoomIDs)
+{
+    bool roomsRemoved = false;
+
+    for (long long roomID : interests.keys()) {
+        if (!publicRoomIDs.contains(roomID)) {
+            interests.remove(roomID);
+            disconnectRoom(roomID);
+            roomsRemoved = true;
+        }
+    }
+
+    for (long long roomID : streamUrls.keys()) {
+        if (!publicRoomIDs.contains(roomID))
+            streamUrls.remove(roomID);
+    }
+
+    finishedRooms.intersect(publicRoomIDs);
+
+    if (roomsRemoved)
+        updateConnections(); // the bandwidth of the removed rooms can be used by other rooms
+}
+
+void RoomStreamPrefetcher::setListenedRoom(long long roomID)
+{
+    listenedRoomID = roomID;
+
+    updateConnections();
+}
+
+QByteArray RoomStreamPrefetcher::takePrefetchedBytes(long long roomID)
+{
+    PrefetchedStream *stream = streams.value(roomID, nullptr);
+    if (!stream)
+        return QByteArray();
+
+    QByteArray bytes = stream->bytes;
+    stream->bytes.clear();
+
+    qCDebug(jtNinjamRoomStreamer) << "Using" << bytes.size() << "prefetched bytes from room" << roomID;
+
+    return bytes;
+}
+
+qint64 RoomStreamPrefetcher::getRetainedBytes() const
+{
+    qint64 total = 0;
+    for (const PrefetchedStream *stream : streams)
+        total += stream->bytes.size();
+
+    return total;
+}
+
+qint64 RoomStreamPrefetcher::getBytesPerSecond() const
+{
+    qint64 total = 0;
+    for (const PrefetchedStream *stream : streams)
+        total += stream->getBytesPerSecond();
+
+    return total;
+}
+
+qint64 RoomStreamPrefetcher::estimateBytesPerSecond(long long roomID) const
+{
+    PrefetchedStream *stream = streams.value(roomID, nullptr);
+    if (stream) {
+        qint64 bytesPerSecond = stream->getBytesPerSecond();
+        if (bytesPerSecond > 0)
+            return bytesPerSecond;
+    }
+
+    return DEFAULT_BYTES_PER_SECOND;
+}
+
+QList<long long> RoomStreamPrefetcher::getRoomsSortedByInterest() const
+{
+    QList<long long> rooms = interests.keys();
+    std::sort(rooms.begin(), rooms.end(), [this](long long r1, long long r2){
+        return interests[r1] > interests[r2];
+    });
+
+    return rooms;
+}
+
+void RoomStreamPrefetcher::updateConnections()
+{
+    QList<long long> roomsToPrefetch;
+    qint64 totalBytesPerSecond = 0;
+
+    if (maxPrefetchedRooms > 0) {
+        for (long long roomID : getRoomsSortedByInterest()) {
+            if (roomsToPrefetch.size() >= maxPrefetchedRooms)
+                break;
+
+            if (roomID == listenedRoomID || finishedRooms.contains(roomID))
+                continue;
+
+            qint64 bytesPerSecond = estimateBytesPerSecond(roomID);
+            if (totalBytesPerSecond + bytesPerSecond > MAX_BYTES_PER_SECOND)
+                continue; // try a lower bitrate room
+
+            totalBytesPerSecond += bytesPerSecond;
+            roomsToPrefetch.append(roomID);
+        }
+    }
+
+    for (long long roomID : streams.keys()) {
+        if (!roomsToPrefetch.contains(roomID))
+            disconnectRoom(roomID);
+    }
+
+    for (long long roomID : roomsToPrefetch) {
+        if (!streams.contains(roomID))
+            connectRoom(roomID);
+    }
+}
+
+void RoomStreamPrefetcher::connectRoom(long long roomID)
+{
+    QUrl streamUrl(streamUrls.value(roomID));
+    if (streamUrl.isEmpty())
+        return;
+
+    qCDebug(jtNinjamRoomStreamer) << "Prefetching room" << roomID << streamUrl;
+
+    QNetworkReply *reply = httpClient->get(QNetworkRequest(streamUrl));
+    PrefetchedStream *stream = new PrefetchedStream(reply);
+    streams.insert(roomID, stream);
+
+    connect(reply, &QNetworkReply::readyRead, this, [stream](){
+        stream->appendBytes(stream->reply->readAll());
+    });
+
+    connect(reply, &QNetworkReply::finished, this, [this, roomID](){
+        qCDebug(jtNinjamRoomStreamer) << "Prefetched stream finished for room" << roomID;
+        finishedRooms.insert(roomID); // avoid reconnecting (and downloading again) in every update
+        disconnectRoom(roomID);
+    });
+}
+
+void RoomStreamPrefetcher::disconnectRoom(long long roomID)
+{
+    PrefetchedStream *stream = streams.take(roomID);
+    if (stream) {
+        qCDebug(jtNinjamRoomStreamer) << "Stopping the prefetching for room" << roomID;
+        delete stream;
+    }
+}
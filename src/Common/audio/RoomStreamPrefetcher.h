@@ -0,0 +1,90 @@
+#ifndef ROOM_STREAM_PREFETCHER_H
+#define ROOM_STREAM_PREFETCHER_H
+
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QUrl>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+namespace Audio {
+
+/**
+ * Keep the public room streams the user is most interested in (hovered or listened rooms) connected in
+ * background. Nothing is decoded, just the last seconds of compressed (mp3) data are retained, so when
+ * the user starts to listen a prefetched room the NinjamRoomStreamerNode is filled instantly.
+ *
+ * The prefetching is disabled when the max prefetched rooms is zero (the default).
+ */
+
+class RoomStreamPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RoomStreamPrefetcher(QObject *parent = nullptr);
+    ~RoomStreamPrefetcher();
+
+    enum InterestWeight
+    {
+        HOVER_INTEREST = 1,
+        LISTEN_INTEREST = 5
+    };
+
+    void setMaxPrefetchedRooms(int maxRooms); // zero disable the prefetching
+    int getMaxPrefetchedRooms() const;
+
+    void addInterest(long long roomID, const QString &streamUrl, InterestWeight weight);
+    void updateRoom(long long roomID, const QString &streamUrl, bool roomIsEmpty); // called when the public rooms list is refreshed
+    void removeMissingRooms(const QSet<long long> &publicRoomIDs); // forget the rooms not listed in the refreshed public rooms list
+    void setListenedRoom(long long roomID); // the listened room is streamed by NinjamRoomStreamerNode, not prefetched
+
+    QByteArray takePrefetchedBytes(long long roomID);
+
+    qint64 getRetainedBytes() const; // memory used by all prefetched rooms
+    qint64 getBytesPerSecond() const; // bandwidth used by all prefetched rooms
+
+private slots:
+    void updateConnections();
+
+private:
+    class PrefetchedStream;
+
+    void connectRoom(long long roomID);
+    void disconnectRoom(long long roomID);
+
+    QList<long long> getRoomsSortedByInterest() const;
+    qint64 estimateBytesPerSecond(long long roomID) const;
+
+    QNetworkAccessManager *httpClient;
+
+    QMap<long long, QString> streamUrls;
+    QMap<long long, double> interests;
+    QMap<long long, PrefetchedStream *> streams;
+    QSet<long long> finishedRooms; // not reconnected until the room is updated in the public rooms list
+
+    long long listenedRoomID;
+    int maxPrefetchedRooms;
+
+    QTimer updateTimer;
+
+    static const int RETAINED_SECONDS;
+    static const int MAX_RETAINED_BYTES_PER_ROOM;
+    static const qint64 MAX_BYTES_PER_SECOND; // bandwidth cap for all prefetched rooms
+    static const qint64 DEFAULT_BYTES_PER_SECOND; // used before the stream bitrate is known
+    static const double INTEREST_DECAY;
+};
+
+inline int RoomStreamPrefetcher::getMaxPrefetchedRooms() const
+{
+    return maxPrefetchedRooms;
+}
+
+} // namespace
+
+#endif // ROOM_STREAM_PREFETCHER_H
@@ -1,5 +1,6 @@
 #include "RoomStreamerNode.h"
 #include "Mp3Decoder.h"
+#include "RoomStreamPipeline.h"
 #include "core/AudioDriver.h"
 #include "core/SamplesBuffer.h"
 #include "log/Logging.h"
@@ -75,6 +76,13 @@ void AbstractMp3Streamer::processReplacing(const Audio::SamplesBuffer &in,
     internalInputBuffer.setFrameLenght(samplesToRender);
     internalInputBuffer.set(bufferedSamples);
 
+    bufferedSamples.discardFirstSamples(samplesToRender);// keep non rendered samples for next audio callback
+
+    renderInternalInputBuffer(out, targetSampleRate);
+}
+
+void AbstractMp3Streamer::renderInternalInputBuffer(Audio::SamplesBuffer &out, int targetSampleRate)
+{
     if (needResamplingFor(targetSampleRate)) {
         const Audio::SamplesBuffer &resampledBuffer = resampler.resample(internalInputBuffer,
                                                                          out.getFrameLenght());
@@ -85,8 +93,6 @@ void AbstractMp3Streamer::processReplacing(const Audio::SamplesBuffer &in,
         internalOutputBuffer.set(internalInputBuffer);
     }
 
-    bufferedSamples.discardFirstSamples(samplesToRender);// keep non rendered samples for next audio callback
-
     if (internalOutputBuffer.getFrameLenght() < out.getFrameLenght())
         qCDebug(jtNinjamRoomStreamer) << out.getFrameLenght()
             - internalOutputBuffer.getFrameLenght() << " samples missing";
@@ -145,18 +151,59 @@ void AbstractMp3Streamer::setStreamPath(const QString &streamPath)
     initialize(streamPath);
 }
 
+void AbstractMp3Streamer::addPrefetchedBytes(const QByteArray &bytes)
+{
+    bytesToDecode.append(bytes);
+}
+
 // +++++++++++++++++++++++++++++++++++++++
 
-const int NinjamRoomStreamerNode::BUFFER_SIZE = 128000;
+const int NinjamRoomStreamerNode::RING_BUFFER_CAPACITY = 48000 * 8; // 8 seconds in 48 KHz (rounded up to a power of 2 in the ring)
 
 NinjamRoomStreamerNode::NinjamRoomStreamerNode(const QUrl &streamPath) :
-    AbstractMp3Streamer(new Mp3DecoderMiniMp3()),
-    httpClient(nullptr),
-    buffering(false)
+    AbstractMp3Streamer(nullptr), // the decoding is done by the RoomStreamDecoder in the worker thread
+    ringBuffer(2, RING_BUFFER_CAPACITY),
+    downloader(new RoomStreamDownloader()),
+    streamDecoder(new RoomStreamDecoder(ringBuffer, new Mp3DecoderMiniMp3())),
+    buffering(false),
+    rebufferingEvents(0),
+    streamID(0),
+    lastDiscardGeneration(0)
 {
+    ioThread.setObjectName("RoomStreamIO");
+    decoderThread.setObjectName("RoomStreamDecoder");
+
+    downloader->moveToThread(&ioThread);
+    streamDecoder->moveToThread(&decoderThread);
+
+    connect(&ioThread, &QThread::finished, downloader, &QObject::deleteLater);
+    connect(&decoderThread, &QThread::finished, streamDecoder, &QObject::deleteLater);
+
+    // all these connections are queued, the signals are crossing threads
+    connect(this, &NinjamRoomStreamerNode::streamStartRequested, downloader, &RoomStreamDownloader::start);
+    connect(this, &NinjamRoomStreamerNode::streamStopRequested, downloader, &RoomStreamDownloader::stop);
+    connect(this, &NinjamRoomStreamerNode::decoderResetRequested, streamDecoder, &RoomStreamDecoder::reset);
+    connect(this, &NinjamRoomStreamerNode::prefetchedBytesAdded, streamDecoder, &RoomStreamDecoder::addBytes);
+    connect(downloader, &RoomStreamDownloader::bytesDownloaded, streamDecoder, &RoomStreamDecoder::addBytes);
+    connect(downloader, &RoomStreamDownloader::error, this, &NinjamRoomStreamerNode::error);
+
+    ioThread.start();
+    decoderThread.start();
+
     setStreamPath(streamPath.toString());
 }
 
+NinjamRoomStreamerNode::~NinjamRoomStreamerNode()
+{
+    emit streamStopRequested();
+
+    ioThread.quit();
+    decoderThread.quit();
+
+    ioThread.wait();
+    decoderThread.wait();
+}
+
 bool NinjamRoomStreamerNode::needResamplingFor(int targetSampleRate) const
 {
     if (!streaming)
@@ -164,85 +211,96 @@ bool NinjamRoomStreamerNode::needResamplingFor(int targetSampleRate) const
     return AbstractMp3Streamer::needResamplingFor(targetSampleRate);
 }
 
-void NinjamRoomStreamerNode::initialize(const QString &streamPath)
+int NinjamRoomStreamerNode::getSampleRate() const
 {
-    AbstractMp3Streamer::initialize(streamPath);
+    return streamDecoder->getSampleRate();
+}
 
-    buffering = true;
-    bufferedSamples.zero();
-    bytesToDecode.clear();
+void NinjamRoomStreamerNode::stopCurrentStream()
+{
+    qCDebug(jtNinjamRoomStreamer) << "stopping room stream";
 
-    if (!streamPath.isEmpty()) {
+    streaming = false;
 
-        qCDebug(jtNinjamRoomStreamer) << "connecting in " << streamPath;
+    ++streamID; // the bytes already downloaded from the old reply are discarded by the decoder
 
-        QNetworkReply *reply = httpClient.get(QNetworkRequest(QUrl(streamPath)));
-        QObject::connect(reply, SIGNAL(readyRead()), this, SLOT(on_reply_read()));
-        QObject::connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(on_reply_error(QNetworkReply::NetworkError)));
-        this->device = reply;
-    }
-}
+    emit streamStopRequested();
+    emit decoderResetRequested(streamID);
 
-void NinjamRoomStreamerNode::on_reply_error(QNetworkReply::NetworkError /*error*/)
-{
-    QString msg = "ERROR playing room stream";
-    qCritical() << msg;
-    emit error(msg);
+    lastPeak.zero();
 }
 
-void NinjamRoomStreamerNode::on_reply_read()
+void NinjamRoomStreamerNode::addPrefetchedBytes(const QByteArray &bytes)
 {
-    if (!device) {
-        qCDebug(jtNinjamRoomStreamer) << "device is null!";
-        return;
-    }
-    if (device->isOpen() && device->isReadable()) {
-        QMutexLocker locker(&mutex);
-        bytesToDecode.append(device->readAll());
-        if (buffering) {
-            qCDebug(jtNinjamRoomStreamer) << "bytes downloaded  bytesToDecode:"<<bytesToDecode.size()
-                                      << " bufferedSamples: " << bufferedSamples.getFrameLenght();
-        }
-    } else {
-        qCritical() << "problem in device!";
-    }
+    if (!bytes.isEmpty())
+        emit prefetchedBytesAdded(bytes, -1, streamID); // no arrival time, prefetched bytes are not used to estimate the network jitter
 }
 
-NinjamRoomStreamerNode::~NinjamRoomStreamerNode()
+void NinjamRoomStreamerNode::initialize(const QString &streamPath)
 {
+    AbstractMp3Streamer::initialize(streamPath);
+
+    buffering = true;
+
+    if (!streamPath.isEmpty())
+        emit streamStartRequested(QUrl(streamPath), streamID);
 }
 
 void NinjamRoomStreamerNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
                                               int sampleRate, std::vector<Midi::MidiMessage> &midiBuffer)
 {
     Q_UNUSED(in)
-    QMutexLocker locker(&mutex);
-    if (buffering && bytesToDecode.size() >= BUFFER_SIZE)
+    Q_UNUSED(midiBuffer)
+
+    uint discardGeneration = streamDecoder->getDiscardGeneration();
+    if (discardGeneration != lastDiscardGeneration) { // the ring is discarded in the consumer side
+        lastDiscardGeneration = discardGeneration;
+        ringBuffer.discardUntil(streamDecoder->getDiscardPosition()); // the samples already decoded for the new stream are kept
+    }
+
+    if (!streaming)
+        return;
+
+    uint samplesToRender = getSamplesToRender(sampleRate, out.getFrameLenght());
+    if (samplesToRender == 0) // empty output block
+        return;
+
+    uint availableSamples = ringBuffer.getAvailableFrames();
+
+    if (buffering) {
+        if (availableSamples < qMax(streamDecoder->getTargetFill(), samplesToRender))
+            return;
+
         buffering = false;
-    if (!buffering && bytesToDecode.isEmpty())
+    }
+
+    if (availableSamples < samplesToRender) {
+        qCDebug(jtNinjamRoomStreamer) << "not enough decoded samples. Buffering ...";
         buffering = true;
-    if (buffering)
+        rebufferingEvents.fetchAndAddRelaxed(1);
+        streamDecoder->notifyRebuffering(); // the decoder will increase the target fill
         return;
-    uint samplesToRender = getSamplesToRender(sampleRate, out.getFrameLenght());
-    while (bufferedSamples.getFrameLenght() < samplesToRender) {// need decoding?
-        decode(256);
-        if (bytesToDecode.isEmpty()) {// no more bytes to decode
-            qCritical() << "no more bytes to decode and not enough buffered samples. Buffering ...";
-            buffering = true;
-            break;
-        }
     }
-    if (!bufferedSamples.isEmpty())
-        AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
+
+    internalInputBuffer.setFrameLenght(samplesToRender);
+    ringBuffer.read(internalInputBuffer, samplesToRender);
+
+    renderInternalInputBuffer(out, sampleRate);
 }
 
 int NinjamRoomStreamerNode::getBufferingPercentage() const
 {
-    if (buffering)
-        return bytesToDecode.size()/(float)BUFFER_SIZE * 100;
-
     if (!streaming)
         return 0;
+
+    if (buffering) {
+        uint targetFill = streamDecoder->getTargetFill();
+        if (targetFill == 0)
+            return 0;
+
+        return qMin(100, static_cast<int>(ringBuffer.getAvailableFrames() / (float)targetFill * 100));
+    }
+
     return 100;//if not buffering and is streaming, the buffer is completed (100%)
 }
 
@@ -4,12 +4,16 @@
 #include "core/AudioNode.h"
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QThread>
 #include "SamplesBufferResampler.h"
+#include "core/SamplesRingBuffer.h"
 
 class QIODevice;
 
 namespace Audio {
 class Mp3Decoder;
+class RoomStreamDownloader;
+class RoomStreamDecoder;
 
 class AbstractMp3Streamer : public AudioNode
 {
@@ -22,6 +26,7 @@ public:
                           int sampleRate, std::vector<Midi::MidiMessage> &midiBuffer) override;
     virtual void stopCurrentStream();
     virtual void setStreamPath(const QString &streamPath);
+    virtual void addPrefetchedBytes(const QByteArray &bytes); // compressed bytes downloaded before the stream was started
     bool isStreaming() const;
 
     virtual int getSampleRate() const;
@@ -48,6 +53,7 @@ protected:
     SamplesBufferResampler resampler;
 
     int getSamplesToRender(int targetSampleRate, int outLenght);
+    void renderInternalInputBuffer(Audio::SamplesBuffer &out, int targetSampleRate); // resample (if necessary) and add the internalInputBuffer samples in 'out'
 };
 
 inline bool AbstractMp3Streamer::isStreaming() const
@@ -57,6 +63,12 @@ inline bool AbstractMp3Streamer::isStreaming() const
 
 // +++++++++++++++++++++++++++++++++++++++++++++
 
+/**
+ * The room stream bytes are downloaded in an I/O thread and decoded in a worker thread into a lock-free
+ * ring buffer. The audio thread just consume PCM samples. The amount of buffered audio needed to start (or
+ * restart) the playback is adapted using the observed network jitter and the rebuffering events.
+ */
+
 class NinjamRoomStreamerNode : public AbstractMp3Streamer
 {
     Q_OBJECT
@@ -68,22 +80,41 @@ public:
     void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<Midi::MidiMessage> &midiBuffer) override;
     bool needResamplingFor(int targetSampleRate) const override;
 
+    void stopCurrentStream() override;
+    void addPrefetchedBytes(const QByteArray &bytes) override;
+
+    int getSampleRate() const override;
+
     bool isBuffering() const override;
 
     int getBufferingPercentage() const override;
 
+    uint getRebufferingEvents() const;
+
+signals:
+    void streamStartRequested(const QUrl &streamUrl, quint32 streamID);
+    void streamStopRequested();
+    void decoderResetRequested(quint32 streamID);
+    void prefetchedBytesAdded(const QByteArray &bytes, qint64 arrivalTime, quint32 streamID);
+
 protected:
     void initialize(const QString &streamPath);
 
 private:
-    QNetworkAccessManager httpClient;
+    SamplesRingBuffer ringBuffer;
+
+    QThread ioThread;
+    QThread decoderThread;
+    RoomStreamDownloader *downloader;
+    RoomStreamDecoder *streamDecoder;
+
     bool buffering;
+    QAtomicInt rebufferingEvents;
 
-    static const int BUFFER_SIZE;
+    quint32 streamID; // incremented when the stream is stopped, the bytes from old streams are ignored by the decoder
+    uint lastDiscardGeneration; // used only in audio thread
 
-private slots:
-    void on_reply_error(QNetworkReply::NetworkError);
-    void on_reply_read();
+    static const int RING_BUFFER_CAPACITY;
 };
 
 inline bool NinjamRoomStreamerNode::isBuffering() const
@@ -91,6 +122,11 @@ inline bool NinjamRoomStreamerNode::isBuffering() const
     return buffering;
 }
 
+inline uint NinjamRoomStreamerNode::getRebufferingEvents() const
+{
+    return static_cast<uint>(rebufferingEvents.load());
+}
+
 // ++++++++++++++++++++++++++++
 
 class AudioFileStreamerNode : public AbstractMp3Streamer
@@ -5,9 +5,11 @@
 #include "AudioPeak.h"
 #include <cmath>
 #include <cassert>
+#include <utility>
 #include <QDebug>
 #include "midi/MidiDriver.h"
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 #include "audio/Resampler.h"
 
@@ -15,6 +17,7 @@ using namespace Audio;
 
 const double AudioNode::ROOT_2_OVER_2 = 1.414213562373095 *0.5;
 const double AudioNode::PI_OVER_2 = 3.141592653589793238463 * 0.5;
+const int AudioNode::CPU_USAGE_SCALE = 1000;
 
 
 void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<Midi::MidiMessage> &midiBuffer)
@@ -34,38 +37,93 @@ void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, in
         }
     }
 
-    internalOutputBuffer.set(internalInputBuffer); // if we have no plugins inserted the input samples are just copied  to output buffer.
+    processChain(midiBuffer, sampleRate);
 
-    static SamplesBuffer tempInputBuffer(2);
+    preFaderProcess(internalOutputBuffer); //call overrided preFaderProcess in subclasses to allow some preFader process.
 
-    // process inserted plugins
-    for (int i=0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        auto processor = processors[i];
-        if (processor && !processor->isBypassed()) {
-            tempInputBuffer.setFrameLenght(internalOutputBuffer.getFrameLenght());
-            tempInputBuffer.set(internalOutputBuffer); // the output from previous plugin is used as input to the next plugin in the chain
+    internalOutputBuffer.applyGain(gain, leftGain, rightGain, boost);
 
-            processor->process(tempInputBuffer, internalOutputBuffer, midiBuffer);
+    lastPeak.update(internalOutputBuffer.computePeak());
 
-            // some plugins are blocking the midi messages. If a VSTi can't generate messages the previous messages list will be sended for the next plugin in the chain. The messages list is cleared only when the plugin can generate midi messages.
-            if (processor->isVirtualInstrument() && processor->canGenerateMidiMessages())
-                midiBuffer.clear(); // only the fresh messages will be passed by the next plugin in the chain
+    postFaderProcess(internalOutputBuffer);
 
+    out.add(internalOutputBuffer);
 
-            auto pulledMessages = pullMidiMessagesGeneratedByPlugins();
-            midiBuffer.insert(midiBuffer.end(), pulledMessages.begin(), pulledMessages.end());
-        }
+    if (outputBus && !muted)
+        outputBus->buffer.add(internalOutputBuffer, outputBus->offset);
+}
+
+void AudioNode::processChain(std::vector<Midi::MidiMessage> &midiBuffer, int sampleRate)
+{
+    int activeProcessors = 0;
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor && !slot.processor->isBypassed())
+            activeProcessors++;
     }
 
-    preFaderProcess(internalOutputBuffer); //call overrided preFaderProcess in subclasses to allow some preFader process.
+    if (activeProcessors == 0) {
+        internalOutputBuffer.set(internalInputBuffer); // if we have no plugins the input samples are just copied to output buffer.
+        return;
+    }
 
-    internalOutputBuffer.applyGain(gain, leftGain, rightGain, boost);
+    /**
+        The processors are writing in internalOutputBuffer and processingBuffer alternately, the output of
+        a plugin is the input of the next plugin in the chain. The first output buffer is choosed to
+        guarantee the last plugin is writing in internalOutputBuffer, so no samples are copied between slots.
+    */
 
-    lastPeak.update(internalOutputBuffer.computePeak());
+    processingBuffer.setFrameLenght(internalOutputBuffer.getFrameLenght());
 
-    postFaderProcess(internalOutputBuffer);
+    const SamplesBuffer *input = &internalInputBuffer;
+    SamplesBuffer *output = (activeProcessors % 2 == 0) ? &processingBuffer : &internalOutputBuffer;
+    SamplesBuffer *nextOutput = (output == &processingBuffer) ? &internalOutputBuffer : &processingBuffer;
 
-    out.add(internalOutputBuffer);
+    const double blockDuration = static_cast<double>(internalOutputBuffer.getFrameLenght()) / qMax(sampleRate, 1) * 1000000000.0; // in nanoseconds
+
+    QElapsedTimer timer;
+    for (ProcessorSlot &slot : processors) {
+        AudioNodeProcessor *processor = slot.processor;
+        if (!processor || processor->isBypassed())
+            continue;
+
+        timer.start();
+        processor->process(*input, *output, midiBuffer);
+        float cpuUsage = timer.nsecsElapsed() / blockDuration * 100.0;
+        float lastCpuUsage = slot.cpuUsage.load() / static_cast<float>(CPU_USAGE_SCALE);
+        float smoothedCpuUsage = lastCpuUsage + (cpuUsage - lastCpuUsage) * 0.1f; // smoothing the readout
+        slot.cpuUsage.store(static_cast<int>(smoothedCpuUsage * CPU_USAGE_SCALE));
+
+        // some plugins are blocking the midi messages. If a VSTi can't generate messages the previous messages list will be sended for the next plugin in the chain. The messages list is cleared only when the plugin can generate midi messages.
+        if (processor->isVirtualInstrument() && processor->canGenerateMidiMessages())
+            midiBuffer.clear(); // only the fresh messages will be passed by the next plugin in the chain
+
+        auto pulledMessages = pullMidiMessagesGeneratedByPlugins();
+        midiBuffer.insert(midiBuffer.end(), pulledMessages.begin(), pulledMessages.end());
+
+        input = output;
+        std::swap(output, nextOutput);
+    }
+}
+
+int AudioNode::getProcessorsLatency() const
+{
+    int latency = 0;
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor && !slot.processor->isBypassed())
+            latency += slot.processor->getLatency();
+    }
+
+    return latency;
+}
+
+float AudioNode::getProcessorCpuUsage(const AudioNodeProcessor *processor) const
+{
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor == processor)
+            return slot.cpuUsage.load() / static_cast<float>(CPU_USAGE_SCALE);
+    }
+
+    return 0;
 }
 
 void AudioNode::setRmsWindowSize(int samples)
@@ -76,6 +134,7 @@ void AudioNode::setRmsWindowSize(int samples)
 AudioNode::AudioNode() :
     internalInputBuffer(2),
     internalOutputBuffer(2),
+    processingBuffer(2),
     lastPeak(),
     muted(false),
     soloed(false),
@@ -85,12 +144,10 @@ AudioNode::AudioNode() :
     pan(0),
     leftGain(1.0),
     rightGain(1.0),
-    resamplingCorrection(0)
+    resamplingCorrection(0),
+    outputBus(nullptr)
 {
 
-    for (int i=0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        processors[i] = nullptr;
-    }
 }
 
 std::vector<Midi::MidiMessage> AudioNode::pullMidiMessagesGeneratedByPlugins() const
@@ -187,12 +244,10 @@ void AudioNode::updateGains()
 
 AudioNode::~AudioNode()
 {
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i]){
-            delete processors[i];
-            processors[i] = nullptr;
-        }
-    }
+    for (const ProcessorSlot &slot : processors)
+        delete slot.processor;
+
+    processors.clear();
 }
 
 bool AudioNode::connect(AudioNode &other)
@@ -214,44 +269,61 @@ bool AudioNode::disconnect(AudioNode &otherNode)
 void AudioNode::addProcessor(AudioNodeProcessor *newProcessor, quint32 slotIndex)
 {
     assert(newProcessor);
-    assert(slotIndex < MAX_PROCESSORS_PER_TRACK);
-    processors[slotIndex] = newProcessor;
+
+    ProcessorSlot emptySlot = { nullptr, 0 };
+    while (static_cast<quint32>(processors.size()) <= slotIndex)
+        processors.append(emptySlot);
+
+    processors[slotIndex].processor = newProcessor;
+    processors[slotIndex].cpuUsage.store(0);
 }
 
 void AudioNode::removeProcessor(AudioNodeProcessor *processor)
 {
     assert(processor);
     processor->suspend();
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i] == processor){
-            processors[i] = nullptr;
+    detachProcessor(processor);
+    delete processor;
+}
+
+bool AudioNode::detachProcessor(AudioNodeProcessor *processor)
+{
+    bool detached = false;
+    for (ProcessorSlot &slot : processors) {
+        if (slot.processor == processor) {
+            slot.processor = nullptr;
+            detached = true;
             break;
         }
     }
-    delete processor;
+
+    while (!processors.isEmpty() && !processors.last().processor)
+        processors.removeLast(); // the empty slots in the chain end are not necessary
+
+    return detached;
 }
 
 void AudioNode::suspendProcessors()
 {
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i])
-            processors[i]->suspend();
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor)
+            slot.processor->suspend();
     }
 }
 
 void AudioNode::updateProcessorsGui()
 {
     QMutexLocker locker(&mutex);
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i])
-            processors[i]->updateGui();
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor)
+            slot.processor->updateGui();
     }
 }
 
 void AudioNode::resumeProcessors()
 {
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i])
-            processors[i]->resume();
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor)
+            slot.processor->resume();
     }
 }
@@ -3,6 +3,7 @@
 
 #include <QSet>
 #include <QMutex>
+#include <QAtomicInt>
 #include "SamplesBuffer.h"
 #include "AudioDriver.h"
 #include "midi/MidiMessage.h"
@@ -13,6 +14,18 @@ namespace Audio {
 
 class AudioNodeProcessor;
 
+/**
+ * An extra output (the plugin stereo outputs) receiving the post fader samples of the routed nodes. The
+ * offset is moved when an audio block is processed in more steps, crossing the ninjam interval boundary.
+ */
+struct OutputBus
+{
+    OutputBus() : buffer(2, 4096), offset(0) {}
+
+    SamplesBuffer buffer;
+    uint offset;
+};
+
 class AudioNode : public QObject
 {
     Q_OBJECT
@@ -37,10 +50,14 @@ public:
 
     virtual void addProcessor(AudioNodeProcessor *newProcessor, quint32 slotIndex);
     void removeProcessor(AudioNodeProcessor *processor);
+    bool detachProcessor(AudioNodeProcessor *processor); // the processor is not suspended or deleted, the caller owns it
     void suspendProcessors();
     void resumeProcessors();
     virtual void updateProcessorsGui();
 
+    int getProcessorsLatency() const; // sum of the latency (in samples) reported by the active processors
+    float getProcessorCpuUsage(const AudioNodeProcessor *processor) const; // percentage of the audio block duration
+
     void setGain(float gainValue);
     void setBoost(float boostValue);
 
@@ -64,7 +81,7 @@ public:
 
     virtual void reset(); // reset pan, gain, boost, etc
 
-    static const quint8 MAX_PROCESSORS_PER_TRACK = 4;
+    void setOutputBus(OutputBus *bus); // nullptr to stop routing, the node is rendered only in the main mix
 
 protected:
 
@@ -73,10 +90,19 @@ protected:
 
     int getInputResamplingLength(int sourceSampleRate, int targetSampleRate, int outFrameLenght);
 
+    struct ProcessorSlot
+    {
+        AudioNodeProcessor *processor; // nullptr in empty slots, the plugins in the next slots are not moved when a plugin is removed
+        QAtomicInt cpuUsage; // percentage in fixed point (CPU_USAGE_SCALE), written in audio thread and read in GUI thread
+    };
+
+    static const int CPU_USAGE_SCALE;
+
     QSet<AudioNode *> connections;
-    AudioNodeProcessor *processors[MAX_PROCESSORS_PER_TRACK];
+    QList<ProcessorSlot> processors; // the chain grow when a plugin is added in a new slot
     SamplesBuffer internalInputBuffer;
     SamplesBuffer internalOutputBuffer;
+    SamplesBuffer processingBuffer; // used with internalOutputBuffer as ping-pong buffers in the processors chain
 
     mutable Audio::AudioPeak lastPeak;
     QMutex mutex; // used to protected connections manipulation because nodes can be added or removed by different threads
@@ -103,8 +129,12 @@ private:
 
     double resamplingCorrection;
 
+    OutputBus *outputBus;
+
     void updateGains();
 
+    void processChain(std::vector<Midi::MidiMessage> &midiBuffer, int sampleRate);
+
 signals:
     void gainChanged(float newGain);
     void panChanged(float newPan);
@@ -129,6 +159,11 @@ inline bool AudioNode::isActivated() const
     return activated;
 }
 
+inline void AudioNode::setOutputBus(OutputBus *bus)
+{
+    outputBus = bus;
+}
+
 inline float AudioNode::getPan() const
 {
     return pan;
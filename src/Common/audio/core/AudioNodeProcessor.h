@@ -17,6 +17,7 @@ public:
 
     virtual ~AudioNodeProcessor();
 
+    // 'in' and 'out' are different buffers and 'out' is not containing the input samples, all the 'out' samples must be written
     virtual void process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, std::vector<Midi::MidiMessage> &midiMessages) = 0;
     virtual void suspend() = 0;
     virtual void resume() = 0;
@@ -32,6 +33,8 @@ public:
 
     virtual bool canGenerateMidiMessages() const;
 
+    virtual int getLatency() const; // in samples
+
 protected:
     bool bypassed;
 
@@ -53,6 +56,11 @@ inline bool AudioNodeProcessor::canGenerateMidiMessages() const
     return false;
 }
 
+inline int AudioNodeProcessor::getLatency() const
+{
+    return 0;
+}
+
 inline AudioNodeProcessor::~AudioNodeProcessor()
 {
     //
@@ -33,15 +33,8 @@ LocalInputNode *LocalInputGroup::getInputNode(quint8 index) const
 void LocalInputGroup::mixGroupedInputs(Audio::SamplesBuffer &out)
 {
     for (auto inputTrack : groupedInputs) {
-        if (!inputTrack->isMuted()) {
-            auto lastBuffer = inputTrack->getLastBuffer();
-            if (lastBuffer.getChannels() == out.getChannels()) {
-                out.add(lastBuffer);
-            }
-            else {
-                out.add(inputTrack->getLastBufferMixedToMono());
-            }
-        }
+        if (!inputTrack->isMuted())
+            inputTrack->mixLastBufferTo(out); // no copies, the input samples are summed in 'out'
     }
 }
 
@@ -6,8 +6,12 @@
 
 #include <QDateTime>
 
+#include <algorithm>
+
 using namespace Audio;
 
+const int LocalInputNode::MAX_LATENCY_COMPENSATION = 192000; // 1 second in 192 KHz
+
 LocalInputNode::MidiInput::MidiInput() :
       lastMidiActivity(0),
       channel(-1),
@@ -84,7 +88,10 @@ LocalInputNode::LocalInputNode(Controller::MainController *controller, int paren
     stereoInverted(false),
     receivingRoutedMidiInput(false),
     routingMidiInput(false),
-    looper(LocalInputNode::createLooper(controller))
+    looper(LocalInputNode::createLooper(controller)),
+    latencyCompensationBuffer(nullptr),
+    latencyCompensation(0),
+    latencyCompensationPosition(0)
 {
     Q_UNUSED(isMono)
     setToNoInput();
@@ -93,6 +100,7 @@ LocalInputNode::LocalInputNode(Controller::MainController *controller, int paren
 LocalInputNode::~LocalInputNode()
 {
     delete looper;
+    delete latencyCompensationBuffer;
 }
 
 Looper *LocalInputNode::createLooper(Controller::MainController *controller)
@@ -146,34 +154,66 @@ bool LocalInputNode::isAudio() const
 
 void LocalInputNode::setProcessorsSampleRate(int newSampleRate)
 {
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i])
-            processors[i]->setSampleRate(newSampleRate);
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor)
+            slot.processor->setSampleRate(newSampleRate);
     }
 }
 
 void LocalInputNode::closeProcessorsWindows()
 {
-    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
-        if (processors[i])
-            processors[i]->closeEditor();
+    for (const ProcessorSlot &slot : processors) {
+        if (slot.processor)
+            slot.processor->closeEditor();
     }
 }
 
-SamplesBuffer LocalInputNode::getLastBufferMixedToMono() const
+SamplesBuffer *LocalInputNode::setLatencyCompensationBuffer(SamplesBuffer *delayLine)
 {
-    if (internalOutputBuffer.isMono())
-        return internalOutputBuffer;
+    SamplesBuffer *previousDelayLine = latencyCompensationBuffer;
 
-    const uint samples = internalOutputBuffer.getFrameLenght();
-    SamplesBuffer lastBuffer(1, samples);
-    float *samplesArray = lastBuffer.getSamplesArray(0);
-    float *internalArrays[2] = {internalOutputBuffer.getSamplesArray(0), internalOutputBuffer.getSamplesArray(1)};
-    for (uint s = 0; s < samples; ++s) {
-        samplesArray[s] = internalArrays[0][s] * leftGain + internalArrays[1][s] * rightGain;
+    latencyCompensationBuffer = delayLine;
+    latencyCompensation = delayLine ? static_cast<int>(delayLine->getFrameLenght()) : 0;
+    latencyCompensationPosition = 0;
+
+    return previousDelayLine;
+}
+
+void LocalInputNode::applyLatencyCompensation(SamplesBuffer &out)
+{
+    if (latencyCompensation <= 0)
+        return;
+
+    // swapping the block samples with the delay line samples, the out samples are delayed by 'latencyCompensation' samples
+    const int frames = out.getFrameLenght();
+    const int channels = qMin(out.getChannels(), latencyCompensationBuffer->getChannels());
+    int processedFrames = 0;
+    while (processedFrames < frames) {
+        int framesToSwap = qMin(frames - processedFrames, latencyCompensation - latencyCompensationPosition);
+        for (int c = 0; c < channels; ++c) {
+            float *outSamples = out.getSamplesArray(c) + processedFrames;
+            float *delayedSamples = latencyCompensationBuffer->getSamplesArray(c) + latencyCompensationPosition;
+            std::swap_ranges(outSamples, outSamples + framesToSwap, delayedSamples);
+        }
+        processedFrames += framesToSwap;
+        latencyCompensationPosition = (latencyCompensationPosition + framesToSwap) % latencyCompensation;
     }
+}
 
-    return lastBuffer;
+void LocalInputNode::mixLastBufferTo(SamplesBuffer &out) const
+{
+    if (!out.isMono() || internalOutputBuffer.isMono()) {
+        out.add(internalOutputBuffer); // same channels, or mono samples added in both output channels
+        return;
+    }
+
+    // stereo to mono, summing directly in the output buffer
+    const uint samples = qMin(out.getFrameLenght(), internalOutputBuffer.getFrameLenght());
+    float *outArray = out.getSamplesArray(0);
+    const float *internalArrays[2] = {internalOutputBuffer.getSamplesArray(0), internalOutputBuffer.getSamplesArray(1)};
+    for (uint s = 0; s < samples; ++s) {
+        outArray[s] += internalArrays[0][s] * leftGain + internalArrays[1][s] * rightGain;
+    }
 }
 
 void LocalInputNode::setAudioInputSelection(int firstChannelIndex, int channelCount)
@@ -339,6 +379,8 @@ qint8 LocalInputNode::getTranspose() const
 
 void LocalInputNode::preFaderProcess(SamplesBuffer &out) // this function is called by the base class AudioNode when processing audio. It's the TemplateMethod design pattern idea.
 {
+    applyLatencyCompensation(out); // aligning with the other local tracks before the looper, the local monitor and the encoder
+
     looper->addBuffer(out); // rec incoming samples before apply local track gain, pan and boost
 
     if (stereoInverted)
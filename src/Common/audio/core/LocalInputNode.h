@@ -59,12 +59,22 @@ public:
     int getChanneGrouplIndex() const;
 
     const Audio::SamplesBuffer &getLastBuffer() const;
-    SamplesBuffer getLastBufferMixedToMono() const;
+    void mixLastBufferTo(Audio::SamplesBuffer &out) const; // stereo buffers are folded to mono outputs using the pan law
 
     void setProcessorsSampleRate(int newSampleRate);
 
     void closeProcessorsWindows();
 
+    /**
+        The delay line (allocated in main thread) applied after the plugins chain to align with the other local
+        tracks, nullptr to remove the compensation. Called with the audio thread locked, the previous delay line
+        is returned to be deleted out of the lock.
+    */
+    SamplesBuffer *setLatencyCompensationBuffer(SamplesBuffer *delayLine);
+    int getLatencyCompensation() const;
+
+    static const int MAX_LATENCY_COMPENSATION;
+
     bool hasMidiActivity() const;
 
     quint8 getMidiActivityValue() const;
@@ -168,8 +178,19 @@ private:
 
     static Audio::Looper *createLooper(Controller::MainController *controller);
 
+    SamplesBuffer *latencyCompensationBuffer; // circular delay line
+    int latencyCompensation;
+    int latencyCompensationPosition;
+
+    void applyLatencyCompensation(SamplesBuffer &out);
+
 };
 
+inline int LocalInputNode::getLatencyCompensation() const
+{
+    return latencyCompensation;
+}
+
 inline Audio::Looper *LocalInputNode::getLooper() const
 {
     return looper;
@@ -25,6 +25,26 @@ void Plugin::closeEditor()
     }
 }
 
+QByteArray Plugin::getPersistentState(bool usingLastState) const
+{
+    if (usingLastState)
+        return lastPersistentState;
+
+    QByteArray state = getSerializedData();
+    if (!state.isEmpty())
+        lastPersistentState = state;
+    else if (!lastPersistentState.isEmpty())
+        qWarning() << "Can't serialize" << getName() << "the last saved state is used";
+
+    return lastPersistentState;
+}
+
+void Plugin::restorePersistentState(const QByteArray &state)
+{
+    restoreFromSerializedData(state);
+    lastPersistentState = state;
+}
+
 void Plugin::editorDialogFinished()
 {
     closeEditor();
@@ -81,8 +101,7 @@ void JamtabaDelay::start()
 void JamtabaDelay::process(const Audio::SamplesBuffer &in, SamplesBuffer &out, std::vector<Midi::MidiMessage> &midiBuffer)
 {
     Q_UNUSED(midiBuffer)
-    Q_UNUSED(in)
-    Q_UNUSED(out)
+    out.set(in); // the delay is disabled, just passing the input samples
 // if(isBypassed()){
 // return;
 // }
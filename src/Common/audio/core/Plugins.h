@@ -33,6 +33,13 @@ public:
     virtual QByteArray getSerializedData() const = 0;
     virtual void restoreFromSerializedData(const QByteArray &data) = 0;
 
+    /**
+        The plugin state saved in the settings. A failed (empty) serialization is not overwriting the last
+        saved state, and when 'usingLastState' is true the plugin is not serialized again (auto saves).
+    */
+    QByteArray getPersistentState(bool usingLastState = false) const;
+    void restorePersistentState(const QByteArray &state);
+
     PluginDescriptor getDescriptor() const;
 
 protected:
@@ -40,6 +47,9 @@ protected:
     QDialog *editorWindow;
     PluginDescriptor descriptor;
 
+private:
+    mutable QByteArray lastPersistentState;
+
 private slots:
     void editorDialogFinished();
 };
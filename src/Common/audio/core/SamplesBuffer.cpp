@@ -19,10 +19,15 @@ SamplesBuffer::SamplesBuffer(unsigned int channels, unsigned int frameLenght) :
     frameLenght(frameLenght),
     rmsRunningSum(0.0f),
     summedSamples(0),
-    rmsWindowSize(13230) // 300 ms in 44100 KHz
+    rmsWindowSize(13230), // 300 ms in 44100 KHz
+    wrappingExternalSamples(false),
+    externalFrameLenght(0),
+    ownedFrameLenght(0)
 {
     for (unsigned int c = 0; c < channels; ++c)
-        samples.push_back(std::vector<float>(frameLenght));
+        ownedSamples.push_back(std::vector<float>(frameLenght));
+
+    updateSamplesPointers();
 
     squaredSums[0] = squaredSums[1] = 0.0f;
     lastRmsValues[0] = lastRmsValues[1] = 0.0f;
@@ -32,11 +37,23 @@ SamplesBuffer::SamplesBuffer(unsigned int channels, unsigned int frameLenght) :
 SamplesBuffer::SamplesBuffer(const SamplesBuffer &other) :
       channels(other.channels),
       frameLenght(other.frameLenght),
-      samples(other.samples),
       rmsRunningSum(other.rmsRunningSum),
       summedSamples(other.summedSamples),
-      rmsWindowSize(other.rmsWindowSize)
+      rmsWindowSize(other.rmsWindowSize),
+      wrappingExternalSamples(false),
+      externalFrameLenght(0),
+      ownedFrameLenght(0)
 {
+    if (other.wrappingExternalSamples) { // the copy owns the samples, the external channels are not shared
+        for (unsigned int c = 0; c < other.samples.size(); ++c)
+            ownedSamples.push_back(std::vector<float>(other.samples[c], other.samples[c] + other.frameLenght));
+    }
+    else {
+        ownedSamples = other.ownedSamples;
+    }
+
+    updateSamplesPointers();
+
     // qWarning() << "Samples Buffer copy constructor!";
     squaredSums[0] = other.squaredSums[0];
     squaredSums[1] = other.squaredSums[1];
@@ -59,9 +76,14 @@ SamplesBuffer &SamplesBuffer::operator=(const SamplesBuffer &other)
     lastRmsValues[0] = other.lastRmsValues[0];
     lastRmsValues[1] = other.lastRmsValues[1];
 
-    samples.clear();
+    wrappingExternalSamples = false;
+    externalFrameLenght = 0;
+
+    ownedSamples.clear();
     for (unsigned int c = 0; c < channels; ++c)
-        samples.push_back(std::vector<float>(frameLenght));
+        ownedSamples.push_back(std::vector<float>(frameLenght));
+
+    updateSamplesPointers();
 
     return *this;
 }
@@ -70,6 +92,55 @@ SamplesBuffer::~SamplesBuffer()
 {
 }
 
+void SamplesBuffer::wrap(float **externalSamples, unsigned int frameLenght)
+{
+    Q_ASSERT(externalSamples);
+
+    if (!wrappingExternalSamples)
+        ownedFrameLenght = this->frameLenght;
+
+    for (unsigned int c = 0; c < channels; ++c)
+        samples[c] = externalSamples[c];
+
+    wrappingExternalSamples = true;
+    externalFrameLenght = frameLenght;
+    this->frameLenght = frameLenght;
+}
+
+void SamplesBuffer::unwrap()
+{
+    if (!wrappingExternalSamples)
+        return;
+
+    wrappingExternalSamples = false;
+    externalFrameLenght = 0;
+    frameLenght = ownedFrameLenght;
+    updateSamplesPointers();
+}
+
+void SamplesBuffer::updateSamplesPointers()
+{
+    samples.resize(ownedSamples.size());
+    for (unsigned int c = 0; c < ownedSamples.size(); ++c)
+        samples[c] = ownedSamples[c].data();
+}
+
+void SamplesBuffer::copyExternalSamples(unsigned int newFrameLenght)
+{
+    // the external channels can't grow, the wrapped samples are copied to the owned storage
+    for (unsigned int c = 0; c < channels; ++c) {
+        std::vector<float> &channelSamples = ownedSamples[c];
+        if (channelSamples.size() < newFrameLenght)
+            channelSamples.resize(newFrameLenght);
+
+        std::memcpy(channelSamples.data(), samples[c], std::min(frameLenght, newFrameLenght) * sizeof(float));
+    }
+
+    wrappingExternalSamples = false;
+    externalFrameLenght = 0;
+    updateSamplesPointers();
+}
+
 void SamplesBuffer::setRmsWindowSize(int samples)
 {
     rmsWindowSize = samples;
@@ -80,7 +151,13 @@ void SamplesBuffer::invertStereo()
     if (channels != 2)
         return; // trying invert a non stereo buffer
 
-    std::iter_swap(samples.begin(), samples.begin() + 1); // swap first and second channels
+    if (wrappingExternalSamples) {
+        std::iter_swap(samples.begin(), samples.begin() + 1); // swap first and second channels
+    }
+    else {
+        std::iter_swap(ownedSamples.begin(), ownedSamples.begin() + 1);
+        updateSamplesPointers();
+    }
 }
 
 void SamplesBuffer::discardFirstSamples(unsigned int samplesToDiscard)
@@ -89,7 +166,7 @@ void SamplesBuffer::discardFirstSamples(unsigned int samplesToDiscard)
     int toCopy = frameLenght - toDiscard;
     uint newFrameLenght = frameLenght - toDiscard;
     for (uint c = 0; c < channels; ++c) {
-        std::copy_n(samples[c].begin() + toDiscard, toCopy, samples[c].begin());
+        std::memmove(samples[c], samples[c] + toDiscard, toCopy * sizeof(float));
     }
     setFrameLenght(newFrameLenght);
 }
@@ -106,7 +183,7 @@ float *SamplesBuffer::getSamplesArray(unsigned int channel) const
 {
     Q_ASSERT(channel < samples.size());
 
-    return const_cast<float *>(&(samples[channel][0]));
+    return samples[channel];
 }
 
 void SamplesBuffer::applyGain(float gainFactor, float boostFactor)
@@ -179,7 +256,7 @@ void SamplesBuffer::zero()
 
     const uint bytesToProcess = frameLenght * sizeof(float);
     for (unsigned int c = 0; c < channels; ++c) {
-        Q_ASSERT(samples[c].size() >= frameLenght);
+        Q_ASSERT(getAvailableFrames(c) >= frameLenght);
         memset(&(samples[c][0]), 0, bytesToProcess);
     }
 }
@@ -231,15 +308,15 @@ void SamplesBuffer::add(const SamplesBuffer &buffer, int internalWriteOffset)
     if (buffer.channels >= channels) {
         for (unsigned int c = 0; c < channels; ++c) {
             for (unsigned int s = 0; s < framesToProcess; ++s) {
-                Q_ASSERT(s + internalWriteOffset < samples[c].size());
+                Q_ASSERT(s + internalWriteOffset < getAvailableFrames(c));
                 samples[c][s + internalWriteOffset] += buffer.samples[c][s];
             }
         }
     }
     else { // samples is stereo and buffer is mono
         for (unsigned int s = 0; s < framesToProcess; ++s) {
-            Q_ASSERT(s + internalWriteOffset < samples[0].size());
-            Q_ASSERT(s + internalWriteOffset < samples[1].size());
+            Q_ASSERT(s + internalWriteOffset < getAvailableFrames(0));
+            Q_ASSERT(s + internalWriteOffset < getAvailableFrames(1));
             samples[0][s + internalWriteOffset] += buffer.samples[0][s];
             samples[1][s + internalWriteOffset] += buffer.samples[0][s];
         }
@@ -249,7 +326,7 @@ void SamplesBuffer::add(const SamplesBuffer &buffer, int internalWriteOffset)
 void SamplesBuffer::add(uint channel, float *samples, uint samplesToAdd)
 {
     Q_ASSERT(channel < channels && channels == this->samples.size());
-    Q_ASSERT(samplesToAdd <= frameLenght && samplesToAdd <= this->samples[channel].size());
+    Q_ASSERT(samplesToAdd <= frameLenght && samplesToAdd <= getAvailableFrames(channel));
 
     void *dest = &(this->samples[channel][0]);
     const uint bytesToCopy = std::min(static_cast<uint>(frameLenght), samplesToAdd) * sizeof(float);
@@ -259,7 +336,7 @@ void SamplesBuffer::add(uint channel, float *samples, uint samplesToAdd)
 void SamplesBuffer::add(uint channel, uint sampleIndex, float sampleValue)
 {
     Q_ASSERT(channel < channels && channels == samples.size());
-    Q_ASSERT(sampleIndex < samples[channel].size());
+    Q_ASSERT(sampleIndex < getAvailableFrames(channel));
 
     samples[channel][sampleIndex] += sampleValue;
 }
@@ -267,7 +344,7 @@ void SamplesBuffer::add(uint channel, uint sampleIndex, float sampleValue)
 void SamplesBuffer::set(uint channel, uint sampleIndex, float sampleValue)
 {
     Q_ASSERT(channel < channels && channels <= samples.size());
-    Q_ASSERT(sampleIndex < samples[channel].size());
+    Q_ASSERT(sampleIndex < getAvailableFrames(channel));
 
     samples[channel][sampleIndex] = sampleValue;
 }
@@ -280,14 +357,21 @@ void SamplesBuffer::setToMono()
 
 void SamplesBuffer::setToStereo()
 {
-    if (this->samples.size() < 2) {
-        size_t channelsToAdd = 2 - this->samples.size();
-        for (uint c = 0; c < channelsToAdd; ++c)
-            samples.push_back(std::vector<float>(frameLenght));
-    }
+    if (wrappingExternalSamples && channels < 2) // only one external channel was wrapped
+        copyExternalSamples(frameLenght);
+
+    if (!wrappingExternalSamples) {
+        if (ownedSamples.size() < 2) {
+            size_t channelsToAdd = 2 - ownedSamples.size();
+            for (uint c = 0; c < channelsToAdd; ++c)
+                ownedSamples.push_back(std::vector<float>(frameLenght));
+        }
 
-    for (unsigned int c = 0; c < samples.size(); ++c)
-        samples[c].resize(frameLenght);
+        for (unsigned int c = 0; c < ownedSamples.size(); ++c)
+            ownedSamples[c].resize(frameLenght);
+
+        updateSamplesPointers();
+    }
 
     this->channels = 2;
 }
@@ -300,7 +384,7 @@ void SamplesBuffer::set(const SamplesBuffer &buffer)
 float SamplesBuffer::get(uint channel, uint sampleIndex) const
 {
     Q_ASSERT(channel < channels);
-    Q_ASSERT(sampleIndex < samples[channel].capacity());
+    Q_ASSERT(sampleIndex < getAvailableFrames(channel));
 
     return samples[channel][sampleIndex];
 }
@@ -310,9 +394,15 @@ void SamplesBuffer::setFrameLenght(unsigned int newFrameLenght)
     if (newFrameLenght == frameLenght)
         return;
 
-    if (newFrameLenght > frameLenght) {
+    if (wrappingExternalSamples) {
+        if (newFrameLenght > externalFrameLenght)
+            copyExternalSamples(newFrameLenght);
+    }
+    else if (newFrameLenght > frameLenght) {
         for (unsigned int c = 0; c < channels; ++c)
-            samples[c].resize(newFrameLenght);
+            ownedSamples[c].resize(newFrameLenght);
+
+        updateSamplesPointers();
     }
     this->frameLenght = newFrameLenght;
 }
@@ -359,10 +449,10 @@ void SamplesBuffer::set(const SamplesBuffer &buffer, uint bufferOffset, uint sam
             if (!buffer.isMono()) {
                 int channelsToCopy = qMin(channels, buffer.channels);
                 for (int c = 0; c < channelsToCopy; ++c) {
-                    Q_ASSERT(internalOffset < samples[c].size());
-                    Q_ASSERT(bufferOffset < buffer.samples[c].size());
-                    Q_ASSERT(bufferOffset + framesToProcess < buffer.samples[c].size());
-                    Q_ASSERT(internalOffset + framesToProcess < samples[c].size());
+                    Q_ASSERT(internalOffset < getAvailableFrames(c));
+                    Q_ASSERT(bufferOffset < buffer.getAvailableFrames(c));
+                    Q_ASSERT(bufferOffset + framesToProcess < buffer.getAvailableFrames(c));
+                    Q_ASSERT(internalOffset + framesToProcess < getAvailableFrames(c));
                     std::memcpy(&(samples[c][internalOffset]), &(buffer.samples[c][bufferOffset]), bytesToProcess);
                 }
             } else {
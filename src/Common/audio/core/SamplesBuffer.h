@@ -23,7 +23,16 @@ private:
     int rmsWindowSize; // how many samples until have enough data to compute rms?
     float lastRmsValues[2];
 
-    std::vector< std::vector<float> > samples;
+    std::vector< std::vector<float> > ownedSamples;
+    std::vector<float *> samples; // pointers to the owned samples or to the wrapped external channels
+
+    bool wrappingExternalSamples;
+    unsigned int externalFrameLenght;
+    unsigned int ownedFrameLenght; // restored when the external channels are unwrapped
+
+    void updateSamplesPointers();
+    void copyExternalSamples(unsigned int newFrameLenght);
+    unsigned int getAvailableFrames(unsigned int channel) const;
 
 public:
     explicit SamplesBuffer(unsigned int channels);
@@ -41,6 +50,11 @@ public:
 
     float *getSamplesArray(unsigned int channel) const;
 
+    // read and write the external channels (host buffers, for example) in place until unwrap() is called
+    void wrap(float **externalSamples, unsigned int frameLenght);
+    void unwrap();
+    bool isWrapping() const;
+
     void discardFirstSamples(unsigned int samplesToDiscard); // discard N samples and set frame lenght to new size
     void append(const SamplesBuffer &other);
 
@@ -111,6 +125,16 @@ inline unsigned int SamplesBuffer::getFrameLenght() const
     return frameLenght;
 }
 
+inline bool SamplesBuffer::isWrapping() const
+{
+    return wrappingExternalSamples;
+}
+
+inline unsigned int SamplesBuffer::getAvailableFrames(unsigned int channel) const
+{
+    return wrappingExternalSamples ? externalFrameLenght : ownedSamples[channel].size();
+}
+
 } // namespace
 
 #endif // SAMPLESBUFFER_H
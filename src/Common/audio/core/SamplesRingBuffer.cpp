@@ -0,0 +1,95 @@
+#include "SamplesRingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Audio;
+
+namespace {
+
+// the capacity is a power of 2, so the counters wrap around (at 2^32) without breaking the buffer indexes
+unsigned int nextPowerOfTwo(unsigned int value)
+{
+    unsigned int power = 1;
+    while (power < value)
+        power <<= 1;
+
+    return power;
+}
+
+} // namespace
+
+SamplesRingBuffer::SamplesRingBuffer(unsigned int channels, unsigned int capacity) :
+    channels(channels),
+    capacity(nextPowerOfTwo(capacity)),
+    readCounter(0),
+    writeCounter(0)
+{
+    for (unsigned int c = 0; c < channels; ++c)
+        samples.push_back(std::vector<float>(this->capacity));
+}
+
+unsigned int SamplesRingBuffer::write(const SamplesBuffer &buffer)
+{
+    const unsigned int writePosition = static_cast<unsigned int>(writeCounter.load()); // only the producer change writeCounter
+    const unsigned int framesToWrite = std::min(buffer.getFrameLenght(), getFreeFrames());
+    if (framesToWrite == 0)
+        return 0;
+
+    const unsigned int startIndex = writePosition & (capacity - 1);
+    const unsigned int firstPart = std::min(framesToWrite, capacity - startIndex);
+    const unsigned int secondPart = framesToWrite - firstPart;
+
+    for (unsigned int c = 0; c < channels; ++c) {
+        // mono buffers are copied to all channels
+        const float *source = buffer.getSamplesArray(std::min(c, static_cast<unsigned int>(buffer.getChannels() - 1)));
+        float *destination = &(samples[c][0]);
+        std::memcpy(destination + startIndex, source, firstPart * sizeof(float));
+        if (secondPart > 0)
+            std::memcpy(destination, source + firstPart, secondPart * sizeof(float));
+    }
+
+    writeCounter.storeRelease(static_cast<int>(writePosition + framesToWrite));
+
+    return framesToWrite;
+}
+
+unsigned int SamplesRingBuffer::read(SamplesBuffer &out, unsigned int framesToRead)
+{
+    const unsigned int readPosition = static_cast<unsigned int>(readCounter.load()); // only the consumer change readCounter
+    const unsigned int framesAvailable = std::min(framesToRead, std::min(getAvailableFrames(), out.getFrameLenght()));
+    if (framesAvailable == 0)
+        return 0;
+
+    const unsigned int startIndex = readPosition & (capacity - 1);
+    const unsigned int firstPart = std::min(framesAvailable, capacity - startIndex);
+    const unsigned int secondPart = framesAvailable - firstPart;
+
+    const unsigned int outChannels = static_cast<unsigned int>(out.getChannels());
+    for (unsigned int c = 0; c < outChannels; ++c) {
+        const float *source = &(samples[std::min(c, channels - 1)][0]);
+        float *destination = out.getSamplesArray(c);
+        std::memcpy(destination, source + startIndex, firstPart * sizeof(float));
+        if (secondPart > 0)
+            std::memcpy(destination + firstPart, source, secondPart * sizeof(float));
+    }
+
+    readCounter.storeRelease(static_cast<int>(readPosition + framesAvailable));
+
+    return framesAvailable;
+}
+
+void SamplesRingBuffer::discardAll()
+{
+    readCounter.storeRelease(writeCounter.loadAcquire());
+}
+
+void SamplesRingBuffer::discardUntil(unsigned int writePosition)
+{
+    const unsigned int readPosition = static_cast<unsigned int>(readCounter.loadAcquire());
+    const unsigned int framesToDiscard = writePosition - readPosition;
+    if (framesToDiscard == 0 || framesToDiscard > getAvailableFrames())
+        return; // the position was already consumed
+
+    readCounter.storeRelease(static_cast<int>(writePosition));
+}
@@ -0,0 +1,71 @@
+#ifndef SAMPLES_RING_BUFFER_H
+#define SAMPLES_RING_BUFFER_H
+
+#include "SamplesBuffer.h"
+
+#include <QAtomicInt>
+#include <vector>
+
+namespace Audio {
+
+/**
+ * Lock-free single producer/single consumer ring of float samples. The producer (a worker thread)
+ * call write(), the consumer (the audio thread) call read() and discardAll(). The storage is
+ * allocated in the constructor, so reading and writing never allocate.
+ */
+
+class SamplesRingBuffer
+{
+public:
+    SamplesRingBuffer(unsigned int channels, unsigned int capacity);
+
+    // producer side
+    unsigned int write(const SamplesBuffer &buffer);
+    unsigned int getFreeFrames() const;
+    unsigned int getWritePosition() const; // used to mark the end of the samples written until now
+
+    // consumer side
+    unsigned int read(SamplesBuffer &out, unsigned int framesToRead);
+    void discardAll();
+    void discardUntil(unsigned int writePosition); // discard only the samples written before 'writePosition'
+    unsigned int getAvailableFrames() const;
+
+    unsigned int getCapacity() const;
+
+private:
+    SamplesRingBuffer(const SamplesRingBuffer &other);
+    SamplesRingBuffer &operator=(const SamplesRingBuffer &other);
+
+    const unsigned int channels;
+    const unsigned int capacity;
+
+    std::vector< std::vector<float> > samples;
+
+    // monotonic counters, the buffer index is 'counter % capacity'. Unsigned arithmetic handle the wrap around.
+    QAtomicInt readCounter;
+    QAtomicInt writeCounter;
+};
+
+inline unsigned int SamplesRingBuffer::getCapacity() const
+{
+    return capacity;
+}
+
+inline unsigned int SamplesRingBuffer::getAvailableFrames() const
+{
+    return static_cast<unsigned int>(writeCounter.loadAcquire()) - static_cast<unsigned int>(readCounter.loadAcquire());
+}
+
+inline unsigned int SamplesRingBuffer::getWritePosition() const
+{
+    return static_cast<unsigned int>(writeCounter.loadAcquire());
+}
+
+inline unsigned int SamplesRingBuffer::getFreeFrames() const
+{
+    return capacity - getAvailableFrames();
+}
+
+} // namespace
+
+#endif // SAMPLES_RING_BUFFER_H
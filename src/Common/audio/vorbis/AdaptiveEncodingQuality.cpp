@@ -0,0 +1,61 @@
+#include "AdaptiveEncodingQuality.h"
+
+const float AdaptiveEncodingQuality::QUALITY_STEP = 0.1f;
+const float AdaptiveEncodingQuality::TARGET_LATENCY = 0.25f;
+const float AdaptiveEncodingQuality::FAST_UPLOAD_LATENCY = 0.05f;
+const int AdaptiveEncodingQuality::FAST_UPLOADS_TO_INCREASE = 4;
+
+AdaptiveEncodingQuality::AdaptiveEncodingQuality(float maxQuality, float minQuality) :
+    quality(maxQuality),
+    maxQuality(maxQuality),
+    minQuality(minQuality),
+    fastUploads(0)
+{
+
+}
+
+void AdaptiveEncodingQuality::setMaxQuality(float maxQuality)
+{
+    this->maxQuality = maxQuality;
+    setQuality(quality); // the current quality can be above the new max quality
+}
+
+void AdaptiveEncodingQuality::reset()
+{
+    quality = maxQuality;
+    fastUploads = 0;
+}
+
+void AdaptiveEncodingQuality::setQuality(float newQuality)
+{
+    float lowestQuality = qMin(minQuality, maxQuality);
+    quality = qBound(lowestQuality, newQuality, maxQuality);
+}
+
+bool AdaptiveEncodingQuality::update(qint64 uploadTime, qint64 intervalBytes, qint64 intervalPeriod)
+{
+    if (intervalPeriod <= 0 || intervalBytes <= 0) // nothing was measured
+        return false;
+
+    // the interval is uploaded while it is recorded, the upload rate (bytes/uploadTime) is slower than
+    // the encoded audio rate (bytes/intervalPeriod) when the last bytes are leaving after the interval end
+    qint64 uploadDelay = qMax(Q_INT64_C(0), uploadTime - intervalPeriod);
+    float latency = uploadDelay / static_cast<float>(intervalPeriod);
+    float previousQuality = quality;
+
+    if (latency > TARGET_LATENCY) {
+        fastUploads = 0;
+        setQuality(quality - QUALITY_STEP);
+    }
+    else if (latency < FAST_UPLOAD_LATENCY) {
+        if (++fastUploads >= FAST_UPLOADS_TO_INCREASE) {
+            fastUploads = 0;
+            setQuality(quality + QUALITY_STEP);
+        }
+    }
+    else {
+        fastUploads = 0; // the upload is not late, but the quality can't be increased
+    }
+
+    return !qFuzzyCompare(1.0f + quality, 1.0f + previousQuality);
+}
@@ -0,0 +1,44 @@
+#ifndef ADAPTIVE_ENCODING_QUALITY_H
+#define ADAPTIVE_ENCODING_QUALITY_H
+
+#include <QtGlobal>
+
+/**
+ * Choose the vorbis encoding quality using the time to upload the last intervals. The quality is reduced when the
+ * upload is late (the other users are receiving our intervals late) and increased slowly, after some fast uploads,
+ * until the quality selected by user. The quality is changed only in interval boundaries (new encoders).
+ */
+
+class AdaptiveEncodingQuality
+{
+public:
+    AdaptiveEncodingQuality(float maxQuality, float minQuality);
+
+    // the upload time is measured from the interval begin to the socket drain, returns true when the quality is changed
+    bool update(qint64 uploadTime, qint64 intervalBytes, qint64 intervalPeriod);
+
+    void setMaxQuality(float maxQuality); // the user selected quality
+    void reset();
+
+    float getQuality() const;
+
+    static const float QUALITY_STEP;
+    static const float TARGET_LATENCY; // max upload time after the interval end, in fraction of the interval period
+    static const float FAST_UPLOAD_LATENCY; // the uploads are fast enough to increase the quality
+    static const int FAST_UPLOADS_TO_INCREASE; // sequential fast uploads before the quality increase
+
+private:
+    void setQuality(float newQuality);
+
+    float quality;
+    float maxQuality;
+    float minQuality; // the lowest encoder quality
+    int fastUploads;
+};
+
+inline float AdaptiveEncodingQuality::getQuality() const
+{
+    return quality;
+}
+
+#endif // ADAPTIVE_ENCODING_QUALITY_H
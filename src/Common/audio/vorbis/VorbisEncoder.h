@@ -21,6 +21,7 @@ public:
 
     int getChannels() const;
     int getSampleRate() const;
+    float getQuality() const;
 
     static const float QUALITY_LOW;
     static const float QUALITY_NORMAL;
@@ -37,6 +38,8 @@ private:
 
     int totalEncoded;
 
+    float quality;
+
     bool initialized;
 
     QByteArray outBuffer;
@@ -62,4 +65,9 @@ inline int VorbisEncoder::getSampleRate() const
     return info.rate;
 }
 
+inline float VorbisEncoder::getQuality() const
+{
+    return quality;
+}
+
 #endif // VORBISENCODER_H
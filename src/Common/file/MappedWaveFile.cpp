@@ -0,0 +1,245 @@
+#include "MappedWaveFile.h"
+
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+using namespace Audio;
+
+const uint MappedWaveFile::FRAMES_PER_BLOCK = 4096;
+
+namespace {
+
+const quint16 WAVE_FORMAT_PCM = 0x0001;
+const quint16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+const quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// the conversion kernels are simple loops over contiguous memory, so the compiler can vectorize them
+
+void convert8Bits(const uchar *in, float *out, uint samples)
+{
+    for (uint i = 0; i < samples; ++i)
+        out[i] = (static_cast<int>(in[i]) - 128) * (1.0f / 128.0f); // 8 bits wave files are unsigned
+}
+
+void convert16Bits(const uchar *in, float *out, uint samples)
+{
+    for (uint i = 0; i < samples; ++i)
+        out[i] = qFromLittleEndian<qint16>(in + i * 2) * (1.0f / 32767.0f); // same scale used by WaveFileWriter
+}
+
+void convert24Bits(const uchar *in, float *out, uint samples)
+{
+    for (uint i = 0; i < samples; ++i) {
+        const uchar *sample = in + i * 3;
+        qint32 value = static_cast<qint32>((static_cast<quint32>(sample[0]) << 8) | (static_cast<quint32>(sample[1]) << 16) | (static_cast<quint32>(sample[2]) << 24)) >> 8; // sign extended
+        out[i] = value * (1.0f / 8388607.0f);
+    }
+}
+
+void convert32Bits(const uchar *in, float *out, uint samples)
+{
+    for (uint i = 0; i < samples; ++i)
+        out[i] = qFromLittleEndian<qint32>(in + i * 4) * (1.0f / 2147483647.0f);
+}
+
+void convertFloat32Bits(const uchar *in, float *out, uint samples)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    std::memcpy(out, in, samples * sizeof(float));
+#else
+    for (uint i = 0; i < samples; ++i) {
+        quint32 value = qFromLittleEndian<quint32>(in + i * 4);
+        std::memcpy(out + i, &value, sizeof(float));
+    }
+#endif
+}
+
+} // namespace
+
+MappedWaveFile::MappedWaveFile() :
+    data(nullptr),
+    sampleRate(0),
+    channels(0),
+    bitsPerSample(0),
+    bytesPerFrame(0),
+    frameLenght(0),
+    sampleFormat(UNKNOWN_FORMAT)
+{
+
+}
+
+MappedWaveFile::~MappedWaveFile()
+{
+    close();
+}
+
+void MappedWaveFile::close()
+{
+    data = nullptr;
+    fileContent.clear();
+
+    if (file.isOpen())
+        file.close(); // unmap the file
+
+    sampleRate = 0;
+    channels = 0;
+    bitsPerSample = 0;
+    bytesPerFrame = 0;
+    frameLenght = 0;
+    sampleFormat = UNKNOWN_FORMAT;
+}
+
+bool MappedWaveFile::open(const QString &filePath)
+{
+    close();
+
+    file.setFileName(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << "Failed to open WAV file ..." << filePath;
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *fileData = file.map(0, size);
+    if (!fileData) { // some files can't be mapped (compressed resources, for example)
+        fileContent = file.readAll();
+        fileData = reinterpret_cast<const uchar *>(fileContent.constData());
+    }
+
+    if (!parseHeader(fileData, size)) {
+        qCritical() << "Error loading " << filePath << ", invalid wave file header!";
+        close();
+        return false;
+    }
+
+    block.resize(FRAMES_PER_BLOCK * channels);
+
+    return true;
+}
+
+bool MappedWaveFile::parseHeader(const uchar *fileData, qint64 size)
+{
+    if (size < 12 || std::memcmp(fileData, "RIFF", 4) != 0 || std::memcmp(fileData + 8, "WAVE", 4) != 0)
+        return false;
+
+    quint16 formatTag = 0;
+    quint16 blockAlign = 0;
+    bool formatFounded = false;
+
+    qint64 offset = 12;
+    while (offset + 8 <= size) {
+        const uchar *chunk = fileData + offset;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const uchar *chunkData = chunk + 8;
+        const qint64 availableBytes = size - offset - 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || availableBytes < 16)
+                return false;
+
+            formatTag = qFromLittleEndian<quint16>(chunkData);
+            channels = qFromLittleEndian<quint16>(chunkData + 2);
+            sampleRate = qFromLittleEndian<quint32>(chunkData + 4);
+            blockAlign = qFromLittleEndian<quint16>(chunkData + 12);
+            bitsPerSample = qFromLittleEndian<quint16>(chunkData + 14);
+
+            if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26 && availableBytes >= 26)
+                formatTag = qFromLittleEndian<quint16>(chunkData + 24); // the first 2 bytes of the sub format GUID
+
+            formatFounded = true;
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!formatFounded || channels == 0)
+                return false;
+
+            switch (bitsPerSample) {
+            case 8: sampleFormat = PCM_8_BITS; break;
+            case 16: sampleFormat = PCM_16_BITS; break;
+            case 24: sampleFormat = PCM_24_BITS; break;
+            case 32: sampleFormat = formatTag == WAVE_FORMAT_IEEE_FLOAT ? FLOAT_32_BITS : PCM_32_BITS; break;
+            default:
+                qCritical() << "Can't handle " << bitsPerSample << " bits per sample!";
+                return false;
+            }
+
+            if (formatTag != WAVE_FORMAT_PCM && formatTag != WAVE_FORMAT_IEEE_FLOAT)
+                return false;
+
+            const uint packedFrameSize = channels * bitsPerSample / 8;
+            bytesPerFrame = blockAlign >= packedFrameSize ? blockAlign : packedFrameSize;
+            const qint64 dataSize = qMin(static_cast<qint64>(chunkSize), availableBytes); // some writers don't update the chunk size
+            frameLenght = static_cast<uint>(dataSize / bytesPerFrame);
+            data = chunkData;
+
+            return true;
+        }
+
+        offset += 8 + chunkSize + (chunkSize & 1); // chunks are word aligned
+    }
+
+    return false;
+}
+
+bool MappedWaveFile::convert(const uchar *in, float *out, uint samples) const
+{
+    switch (sampleFormat) {
+    case PCM_8_BITS:    convert8Bits(in, out, samples);      break;
+    case PCM_16_BITS:   convert16Bits(in, out, samples);     break;
+    case PCM_24_BITS:   convert24Bits(in, out, samples);     break;
+    case PCM_32_BITS:   convert32Bits(in, out, samples);     break;
+    case FLOAT_32_BITS: convertFloat32Bits(in, out, samples); break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+uint MappedWaveFile::read(uint firstFrame, uint framesToRead, SamplesBuffer &out, uint outOffset)
+{
+    if (!data || firstFrame >= frameLenght || outOffset >= out.getFrameLenght())
+        return 0;
+
+    framesToRead = qMin(framesToRead, frameLenght - firstFrame);
+    framesToRead = qMin(framesToRead, out.getFrameLenght() - outOffset);
+
+    const uint outChannels = static_cast<uint>(out.getChannels());
+    const bool paddedFrames = bytesPerFrame != channels * (bitsPerSample / 8u);
+
+    uint framesReaded = 0;
+    while (framesReaded < framesToRead) {
+        const uint blockFrames = qMin(FRAMES_PER_BLOCK, framesToRead - framesReaded);
+        const uint blockSamples = blockFrames * channels;
+        const uchar *in = data + static_cast<qint64>(firstFrame + framesReaded) * bytesPerFrame;
+        float *converted = &block[0];
+
+        if (!paddedFrames) {
+            if (!convert(in, converted, blockSamples)) // the whole block is contiguous
+                return framesReaded;
+        }
+        else {
+            for (uint f = 0; f < blockFrames; ++f) { // skipping the padding in the end of each frame
+                if (!convert(in + f * bytesPerFrame, converted + f * channels, channels))
+                    return framesReaded;
+            }
+        }
+
+        // deinterleave
+        for (uint c = 0; c < outChannels; ++c) {
+            const uint sourceChannel = qMin(c, static_cast<uint>(channels - 1)); // mono files are copied to all channels
+            float *outSamples = out.getSamplesArray(c) + outOffset + framesReaded;
+            if (channels == 1) {
+                std::memcpy(outSamples, converted, blockFrames * sizeof(float));
+            }
+            else {
+                for (uint f = 0; f < blockFrames; ++f)
+                    outSamples[f] = converted[f * channels + sourceChannel];
+            }
+        }
+
+        framesReaded += blockFrames;
+    }
+
+    return framesReaded;
+}
@@ -0,0 +1,99 @@
+#ifndef MAPPEDWAVEFILE_H
+#define MAPPEDWAVEFILE_H
+
+#include "audio/core/SamplesBuffer.h"
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+namespace Audio {
+
+/**
+ * A wave file mapped in memory. The header is parsed once in open() and the PCM data is converted
+ * to float only when a range of frames is requested, in blocks, without a per sample stream.
+ * When the file can't be mapped (compressed Qt resources, for example) the file content is loaded in memory.
+ */
+
+class MappedWaveFile
+{
+public:
+    MappedWaveFile();
+    ~MappedWaveFile();
+
+    bool open(const QString &filePath);
+    void close();
+
+    bool isOpen() const;
+
+    quint32 getSampleRate() const;
+    quint16 getChannels() const;
+    quint16 getBitsPerSample() const;
+    uint getFrameLenght() const;
+
+    // convert 'framesToRead' frames starting at 'firstFrame' and copy them to 'out' starting at 'outOffset'. Return the converted frames.
+    uint read(uint firstFrame, uint framesToRead, Audio::SamplesBuffer &out, uint outOffset = 0);
+
+private:
+    MappedWaveFile(const MappedWaveFile &other);
+    MappedWaveFile &operator=(const MappedWaveFile &other);
+
+    enum SampleFormat
+    {
+        UNKNOWN_FORMAT,
+        PCM_8_BITS,
+        PCM_16_BITS,
+        PCM_24_BITS,
+        PCM_32_BITS,
+        FLOAT_32_BITS
+    };
+
+    bool parseHeader(const uchar *data, qint64 size);
+    bool convert(const uchar *in, float *out, uint samples) const;
+
+    QFile file;
+    QByteArray fileContent; // used only when the file can't be mapped
+    const uchar *data; // the start of the 'data' chunk
+
+    quint32 sampleRate;
+    quint16 channels;
+    quint16 bitsPerSample;
+    uint bytesPerFrame; // the 'blockAlign' value, can be bigger than the samples size (padded frames)
+    uint frameLenght;
+    SampleFormat sampleFormat;
+
+    std::vector<float> block; // interleaved samples converted to float, allocated in open()
+
+    static const uint FRAMES_PER_BLOCK;
+};
+
+inline bool MappedWaveFile::isOpen() const
+{
+    return data != nullptr;
+}
+
+inline quint32 MappedWaveFile::getSampleRate() const
+{
+    return sampleRate;
+}
+
+inline quint16 MappedWaveFile::getChannels() const
+{
+    return channels;
+}
+
+inline quint16 MappedWaveFile::getBitsPerSample() const
+{
+    return bitsPerSample;
+}
+
+inline uint MappedWaveFile::getFrameLenght() const
+{
+    return frameLenght;
+}
+
+} // namespace
+
+#endif // MAPPEDWAVEFILE_H
@@ -16,7 +16,11 @@ bool OggFileReader::read(const QString &filePath, Audio::SamplesBuffer &outBuffe
     }
 
     VorbisDecoder decoder;
-    decoder.setInputData(oggFile.readAll());
+    const uchar *mappedData = oggFile.map(0, oggFile.size());
+    if (mappedData) // avoid the intermediate copy made by readAll()
+        decoder.setInputData(QByteArray::fromRawData(reinterpret_cast<const char *>(mappedData), oggFile.size()));
+    else
+        decoder.setInputData(oggFile.readAll());
     decoder.initialize(); // read the ogg headers from file
     sampleRate = decoder.getSampleRate();
     if (decoder.isMono())
@@ -0,0 +1,245 @@
+#include "IpLocationTable.h"
+#include "log/Logging.h"
+
+#include <QHostAddress>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Geo;
+
+const quint32 IpLocationTable::SIGNATURE = 0x4A544950; // JTIP
+const quint32 IpLocationTable::REVISION = 1;
+const int IpLocationTable::MAX_APPENDED_RECORDS = 1024;
+
+IpLocationTable::IpLocationTable(const QString &filePath) :
+    filePath(filePath),
+    sortedRecords(nullptr),
+    sortedRecordsCount(0)
+{
+    open();
+}
+
+IpLocationTable::~IpLocationTable()
+{
+    compact();
+    close();
+}
+
+bool IpLocationTable::createKey(const QString &ip, quint8 *key)
+{
+    QHostAddress address;
+    if (!address.setAddress(ip))
+        return false;
+
+    if (address.protocol() == QAbstractSocket::IPv4Protocol) { // ::ffff:a.b.c.d
+        quint32 ipv4 = address.toIPv4Address();
+        std::memset(key, 0, 10);
+        key[10] = key[11] = 0xFF;
+        key[12] = (ipv4 >> 24) & 0xFF;
+        key[13] = (ipv4 >> 16) & 0xFF;
+        key[14] = (ipv4 >> 8) & 0xFF;
+        key[15] = ipv4 & 0xFF;
+        return true;
+    }
+
+    Q_IPV6ADDR ipv6 = address.toIPv6Address();
+    std::memcpy(key, ipv6.c, 16);
+    return true;
+}
+
+bool IpLocationTable::keyLessThan(const Record &r1, const Record &r2)
+{
+    return std::memcmp(r1.ip, r2.ip, sizeof(r1.ip)) < 0;
+}
+
+bool IpLocationTable::open()
+{
+    file.setFileName(filePath);
+    if (!file.open(QFile::ReadWrite)) {
+        qCritical() << "Can't open the IP locations file" << filePath << file.errorString();
+        return false;
+    }
+
+    Header header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(Header)) != sizeof(Header)
+            || header.signature != SIGNATURE || header.revision != REVISION) {
+        return reset(); // new file or old revision
+    }
+
+    const qint64 sortedBytes = static_cast<qint64>(header.sortedRecords) * sizeof(Record);
+    if (file.size() < static_cast<qint64>(sizeof(Header)) + sortedBytes) {
+        qCritical() << "Corrupted IP locations file:" << filePath;
+        return reset();
+    }
+
+    if (header.sortedRecords > 0) {
+        uchar *data = file.map(sizeof(Header), sortedBytes);
+        if (!data) {
+            qCritical() << "Can't map the IP locations file:" << file.errorString();
+            return reset();
+        }
+        sortedRecords = reinterpret_cast<const Record *>(data);
+        sortedRecordsCount = header.sortedRecords;
+    }
+
+    // appended records are few, they are loaded in memory
+    const qint64 appendedStart = sizeof(Header) + sortedBytes;
+    const qint64 appendedCount = (file.size() - appendedStart) / sizeof(Record);
+    file.seek(appendedStart);
+    for (qint64 i = 0; i < appendedCount; ++i) {
+        Record record;
+        if (file.read(reinterpret_cast<char *>(&record), sizeof(Record)) != sizeof(Record))
+            break;
+        appendedRecords.insert(QByteArray(reinterpret_cast<const char *>(record.ip), sizeof(record.ip)), record);
+    }
+
+    file.resize(appendedStart + appendedCount * sizeof(Record)); // discard a partially written record
+
+    qCDebug(jtIpToLocation) << sortedRecordsCount << "sorted and" << appendedRecords.size() << "appended IP locations in" << filePath;
+
+    return true;
+}
+
+void IpLocationTable::close()
+{
+    if (sortedRecords) {
+        file.unmap(reinterpret_cast<uchar *>(const_cast<Record *>(sortedRecords)));
+        sortedRecords = nullptr;
+    }
+    sortedRecordsCount = 0;
+    appendedRecords.clear();
+
+    file.close();
+}
+
+bool IpLocationTable::reset()
+{
+    if (sortedRecords) {
+        file.unmap(reinterpret_cast<uchar *>(const_cast<Record *>(sortedRecords)));
+        sortedRecords = nullptr;
+    }
+    sortedRecordsCount = 0;
+    appendedRecords.clear();
+
+    Header header;
+    header.signature = SIGNATURE;
+    header.revision = REVISION;
+    header.sortedRecords = 0;
+    header.reserved = 0;
+
+    file.resize(0);
+    file.seek(0);
+    return file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) == sizeof(Header);
+}
+
+bool IpLocationTable::find(const QString &ip, QString *countryCode, QPointF *latLong) const
+{
+    Record key;
+    if (!createKey(ip, key.ip))
+        return false;
+
+    const Record *record = nullptr;
+
+    auto appended = appendedRecords.constFind(QByteArray::fromRawData(reinterpret_cast<const char *>(key.ip), sizeof(key.ip)));
+    if (appended != appendedRecords.constEnd()) {
+        record = &appended.value();
+    }
+    else if (sortedRecords) {
+        const Record *end = sortedRecords + sortedRecordsCount;
+        const Record *found = std::lower_bound(sortedRecords, end, key, keyLessThan);
+        if (found != end && std::memcmp(found->ip, key.ip, sizeof(key.ip)) == 0)
+            record = found;
+    }
+
+    if (!record)
+        return false;
+
+    if (countryCode)
+        *countryCode = QString::fromLatin1(record->countryCode, 2);
+
+    if (latLong)
+        *latLong = QPointF(record->latitude, record->longitude);
+
+    return true;
+}
+
+bool IpLocationTable::insert(const QString &ip, const QString &countryCode, const QPointF &latLong)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(Record));
+    if (!createKey(ip, record.ip) || countryCode.size() != 2 || !file.isOpen())
+        return false;
+
+    QByteArray code = countryCode.toLatin1();
+    record.countryCode[0] = code.at(0);
+    record.countryCode[1] = code.at(1);
+    record.latitude = static_cast<float>(latLong.x());
+    record.longitude = static_cast<float>(latLong.y());
+
+    file.seek(file.size());
+    if (file.write(reinterpret_cast<const char *>(&record), sizeof(Record)) != sizeof(Record)) {
+        qCritical() << "Can't append in the IP locations file:" << file.errorString();
+        return false;
+    }
+    file.flush();
+
+    appendedRecords.insert(QByteArray(reinterpret_cast<const char *>(record.ip), sizeof(record.ip)), record);
+
+    if (appendedRecords.size() >= MAX_APPENDED_RECORDS)
+        compact();
+
+    return true;
+}
+
+void IpLocationTable::compact()
+{
+    if (appendedRecords.isEmpty())
+        return;
+
+    // sorted records first, the appended (newest) records are replacing the old records with the same IP
+    std::vector<Record> records;
+    records.reserve(sortedRecordsCount + appendedRecords.size());
+    if (sortedRecords)
+        records.insert(records.end(), sortedRecords, sortedRecords + sortedRecordsCount);
+    for (const Record &record : appendedRecords)
+        records.push_back(record);
+
+    std::stable_sort(records.begin(), records.end(), keyLessThan);
+
+    std::vector<Record> uniqueRecords;
+    uniqueRecords.reserve(records.size());
+    for (const Record &record : records) {
+        if (!uniqueRecords.empty() && !keyLessThan(uniqueRecords.back(), record))
+            uniqueRecords.back() = record; // same IP
+        else
+            uniqueRecords.push_back(record);
+    }
+
+    close();
+
+    if (!rewrite(uniqueRecords))
+        qCritical() << "Can't compact the IP locations file" << filePath;
+
+    open();
+}
+
+bool IpLocationTable::rewrite(const std::vector<Record> &records)
+{
+    QSaveFile saveFile(filePath);
+    if (!saveFile.open(QFile::WriteOnly))
+        return false;
+
+    Header header;
+    header.signature = SIGNATURE;
+    header.revision = REVISION;
+    header.sortedRecords = static_cast<quint32>(records.size());
+    header.reserved = 0;
+
+    saveFile.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    if (!records.empty())
+        saveFile.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Record));
+
+    return saveFile.commit();
+}
@@ -0,0 +1,87 @@
+#ifndef IP_LOCATION_TABLE_H
+#define IP_LOCATION_TABLE_H
+
+#include <QString>
+#include <QPointF>
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+
+#include <vector>
+
+namespace Geo {
+
+/**
+ * IP => (country code, latitude, longitude) table persisted in a file. The sorted records are memory mapped and
+ * searched using binary search, nothing is parsed when Jamtaba starts. New locations are appended in the end of
+ * the file and merged in the sorted records (compaction) when the appended records are too many or when the
+ * table is destroyed. IPv4 addresses are stored as IPv4-mapped IPv6 addresses, so all keys have 128 bits.
+ */
+
+class IpLocationTable
+{
+public:
+    explicit IpLocationTable(const QString &filePath);
+    ~IpLocationTable();
+
+    bool find(const QString &ip, QString *countryCode, QPointF *latLong) const;
+    bool insert(const QString &ip, const QString &countryCode, const QPointF &latLong);
+
+    void compact();
+
+    int getSize() const; // including appended records not compacted yet
+    int getAppendedRecords() const;
+
+    static const int MAX_APPENDED_RECORDS;
+
+private:
+    struct Record
+    {
+        quint8 ip[16];
+        float latitude;
+        float longitude;
+        char countryCode[2];
+        quint8 reserved[6];
+    };
+
+    struct Header
+    {
+        quint32 signature;
+        quint32 revision;
+        quint32 sortedRecords;
+        quint32 reserved;
+    };
+
+    bool open();
+    void close();
+    bool reset();
+    bool rewrite(const std::vector<Record> &records);
+
+    static bool createKey(const QString &ip, quint8 *key);
+    static bool keyLessThan(const Record &r1, const Record &r2);
+
+    QString filePath;
+    QFile file;
+
+    const Record *sortedRecords; // memory mapped
+    quint32 sortedRecordsCount;
+
+    QMap<QByteArray, Record> appendedRecords;
+
+    static const quint32 SIGNATURE;
+    static const quint32 REVISION;
+};
+
+inline int IpLocationTable::getSize() const
+{
+    return static_cast<int>(sortedRecordsCount) + appendedRecords.size();
+}
+
+inline int IpLocationTable::getAppendedRecords() const
+{
+    return appendedRecords.size();
+}
+
+} // namespace
+
+#endif // IP_LOCATION_TABLE_H
@@ -6,17 +6,31 @@
 
 using namespace Geo;
 
-IpToLocationLITEResolver::IpToLocationLITEResolver(QString binFilePath)
+IpToLocationLITEResolver::IpToLocationLITEResolver(const QString &binFilePath)
 {
-    const char* filePath = binFilePath.toStdString().c_str();
-    this->IP2LocationObj = IP2Location_open((char*)filePath);
+    QByteArray filePath = binFilePath.toLocal8Bit(); // keep the bytes alive while the file is opened
+    this->IP2LocationObj = IP2Location_open(filePath.data());
 }
 
-Location IpToLocationLITEResolver::resolve(QString ip){
+Location IpToLocationLITEResolver::resolve(const QString &ip, const QString &languageCode)
+{
+    Q_UNUSED(languageCode) // the LITE database has only english country names
+
+    if (!IP2LocationObj)
+        return Location();
+
+    QByteArray ipBytes = ip.toLatin1();
+    IP2LocationRecord *record = IP2Location_get_all(IP2LocationObj, ipBytes.data());
+    if (!record)
+        return Location();
 
-IP2LocationRecord *record = IP2Location_get_all(IP2LocationObj, (char*)ip.toStdString().c_str());
+    QString countryCode(record->country_short);
+    if (countryCode.size() != 2) { // "-" or "INVALID IPV4 ADDRESS"
+        IP2Location_free_record(record);
+        return Location();
+    }
 
-    Location loc( QString(record->country_long), QString(record->country_short) );
+    Location loc(QString(record->country_long), countryCode, record->latitude, record->longitude);
 
 /*
 printf("%s %s %s %s %s %f %f %s %s %s %s %s %s %s %s %s %s %s %s %s\n",
@@ -46,5 +60,6 @@ printf("%s %s %s %s %s %f %f %s %s %s %s %s %s %s %s %s %s %s %s %s\n",
 }
 
 IpToLocationLITEResolver::~IpToLocationLITEResolver(){
-    IP2Location_close(IP2LocationObj);
+    if (IP2LocationObj)
+        IP2Location_close(IP2LocationObj);
 }
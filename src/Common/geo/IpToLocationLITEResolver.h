@@ -10,12 +10,13 @@
 
 namespace Geo{
 
+// offline resolver using the IP2Location LITE database, used as first tier in WebIpToLocationResolver
 class IpToLocationLITEResolver : public IpToLocationResolver
 {
 public:
-    explicit IpToLocationLITEResolver(QString binFilePath);
+    explicit IpToLocationLITEResolver(const QString &binFilePath);
     ~IpToLocationLITEResolver();
-    Location resolve(QString ip);
+    Location resolve(const QString &ip, const QString &languageCode) override;
 private:
 IP2Location* IP2LocationObj;
 
@@ -9,7 +9,6 @@
 #include <QObject>
 #include <QStandardPaths>
 #include <QDir>
-#include <QTextStream>
 #include <QDataStream>
 #include <QTimer>
 #include <QPointF>
@@ -21,47 +20,73 @@ using namespace Geo;
 const QString WebIpToLocationResolver::COUNTRY_CODES_FILE = "country_codes_cache.bin";
 const QString WebIpToLocationResolver::COUNTRY_NAMES_FILE_PREFIX = "country_names_cache"; //the language code will be concatenated
 const QString WebIpToLocationResolver::LAT_LONG_CACHE_FILE = "lat_long_cache.bin";
+const QString WebIpToLocationResolver::LOCATIONS_TABLE_FILE = "ip_locations.bin";
+
+const int WebIpToLocationResolver::REQUESTS_DELAY = 250;
+const int WebIpToLocationResolver::MAX_PARALLEL_REQUESTS = 4;
 
 const quint32 WebIpToLocationResolver::COUNTRY_NAMES_CACHE_REVISION = 1;
 const quint32 WebIpToLocationResolver::COUNTRY_CODES_CACHE_REVISION = 1;
 const quint32 WebIpToLocationResolver::LAT_LONG_CACHE_REVISION = 1;
 
 WebIpToLocationResolver::WebIpToLocationResolver(const QDir &cacheDir)
-    :currentLanguage("en"), // using english as default language
+    :locationsTable(cacheDir.absoluteFilePath(LOCATIONS_TABLE_FILE)),
+     offlineMode(false),
+     currentLanguage("en"), // using english as default language
      cacheDir(cacheDir)
 {
     QObject::connect(&httpClient, SIGNAL(finished(QNetworkReply*)), this, SLOT(replyFinished(QNetworkReply*)));
 
-    loadCountryCodesFromFile();
-    loadLatLongsFromFile();
+    requestsTimer.setSingleShot(true);
+    requestsTimer.setInterval(REQUESTS_DELAY);
+    QObject::connect(&requestsTimer, &QTimer::timeout, this, &WebIpToLocationResolver::sendPendingRequests);
 
-    if (!needLoadTheOldCache()) {
-        loadCountryNamesFromFile(currentLanguage); // loading the english country names by default
-    }
-    else {
-        loadOldCacheContent();
-        deleteOldCacheFile();
-    }
+    importOldCacheFiles();
+
+    loadCountryNamesFromFile(currentLanguage); // loading the english country names by default
+
+    deleteOldCacheFile();
 }
 
 WebIpToLocationResolver::~WebIpToLocationResolver()
 {
-    saveCountryCodesToFile();
-    saveCountryNamesToFile();
-    saveLatLongsToFile();
+    saveCountryNamesToFile(); // the locations table is saved when new locations are resolved
 }
 
-void WebIpToLocationResolver::saveLatLongsToFile()
+void WebIpToLocationResolver::setOfflineResolver(IpToLocationResolver *resolver)
 {
-    if (latLongCache.isEmpty())
+    offlineResolver.reset(resolver);
+}
+
+void WebIpToLocationResolver::setOfflineMode(bool offlineMode)
+{
+    this->offlineMode = offlineMode;
+    if (offlineMode) {
+        requestsTimer.stop();
+        pendingIps.clear();
+    }
+}
+
+void WebIpToLocationResolver::importOldCacheFiles()
+{
+    if (!cacheDir.exists(COUNTRY_CODES_FILE))
         return;
 
-    QString filename = LAT_LONG_CACHE_FILE;
-    quint32 cacheRevision = LAT_LONG_CACHE_REVISION;
-    if (saveMapToFile(filename, latLongCache, cacheRevision))
-        qCDebug(jtIpToLocation) << latLongCache.size() << " lat,lng pairs stored in " << filename;
-    else
-        qCritical() << "Can't save lat,lng pairs in the file " << filename;
+    QMap<QString, QString> countryCodes;
+    QMap<QString, QPointF> latLongs;
+    populateQMapFromFile(COUNTRY_CODES_FILE, countryCodes, COUNTRY_CODES_CACHE_REVISION);
+    populateQMapFromFile(LAT_LONG_CACHE_FILE, latLongs, LAT_LONG_CACHE_REVISION);
+
+    for (auto it = countryCodes.constBegin(); it != countryCodes.constEnd(); ++it) {
+        if (latLongs.contains(it.key()))
+            locationsTable.insert(it.key(), it.value(), latLongs[it.key()]);
+    }
+    locationsTable.compact();
+
+    qCDebug(jtIpToLocation) << locationsTable.getSize() << "IP locations imported from the old cache files";
+
+    cacheDir.remove(COUNTRY_CODES_FILE);
+    cacheDir.remove(LAT_LONG_CACHE_FILE);
 }
 
 void WebIpToLocationResolver::saveCountryNamesToFile()
@@ -74,32 +99,6 @@ void WebIpToLocationResolver::saveCountryNamesToFile()
         qCritical() << "Can't save country names in the file " << filename;
 }
 
-void WebIpToLocationResolver::saveCountryCodesToFile()
-{
-    quint32 cacheRevision = COUNTRY_CODES_CACHE_REVISION;
-    if (saveMapToFile(COUNTRY_CODES_FILE, countryCodesCache, cacheRevision))
-        qCDebug(jtIpToLocation) << countryCodesCache.size() << " country codes stored in " << COUNTRY_CODES_FILE;
-    else
-        qCritical() << "Can't save country codes in the file " << COUNTRY_CODES_FILE;
-}
-
-bool WebIpToLocationResolver::saveMapToFile(const QString &fileName, const QMap<QString, QPointF> &map, quint32 cacheHeaderRevision)
-{
-    if (map.isEmpty())
-        return true;
-
-    QFile cacheFile(cacheDir.absoluteFilePath(fileName));
-    if (cacheFile.open(QFile::WriteOnly)) {
-        QDataStream stream(&cacheFile);
-        CacheHeader cacheHeader(cacheHeaderRevision);
-        stream << cacheHeader;
-        stream << map;
-        return true;
-    }
-    return false;
-}
-
-
 bool WebIpToLocationResolver::saveMapToFile(const QString &fileName, const QMap<QString, QString> &map, quint32 cacheHeaderRevision)
 {
     if (map.isEmpty())
@@ -121,6 +120,12 @@ void WebIpToLocationResolver::replyFinished(QNetworkReply *reply)
     QString ip = reply->property("ip").toString();
     QString language = reply->property("language").toString();
 
+    reply->deleteLater();
+
+    requestedIps.remove(ip);
+    if (!pendingIps.isEmpty() && !requestsTimer.isActive())
+        sendPendingRequests(); // a request slot is available
+
     if (language != currentLanguage)
         return; //discard the received data if the language was changed since the last request.
 
@@ -141,14 +146,13 @@ void WebIpToLocationResolver::replyFinished(QNetworkReply *reply)
         if (countryObject.contains("name") && countryObject.contains("code")) {
             QString countryName = countryObject["name"].toString();
             QString countryCode = countryObject["code"].toString();
-            countryCodesCache.insert(ip, countryCode);
             countryNamesCache.insert(countryCode, countryName);
             if (root.contains("location")) {
                 QJsonObject locationObject = root["location"].toObject();
                 if (locationObject.contains("latitude") && locationObject.contains("longitude")) {
                     double latitude = locationObject["latitude"].toDouble();
                     double longitude = locationObject["longitude"].toDouble();
-                    latLongCache.insert(ip, QPointF(latitude, longitude));
+                    locationsTable.insert(ip, countryCode, QPointF(latitude, longitude));
                     qCDebug(jtIpToLocation) << "Data received IP:" << ip << " Lang:" << language << " country code:" << countryCode << " country name:" << countryName << "lat:" << latitude << " long:" << longitude;
                 }
                 else {
@@ -165,10 +169,21 @@ void WebIpToLocationResolver::replyFinished(QNetworkReply *reply)
         }
     }
     else {
+        failedIps.insert(ip);
         qCDebug(jtIpToLocation) << "error requesting " << ip << ". Returning an empty location!";
     }
+}
 
-    reply->deleteLater();
+void WebIpToLocationResolver::sendPendingRequests()
+{
+    while (!pendingIps.isEmpty() && requestedIps.size() < MAX_PARALLEL_REQUESTS) {
+        QString ip = *pendingIps.begin();
+        pendingIps.remove(ip);
+        requestedIps.insert(ip);
+        requestDataFromWebService(ip);
+    }
+
+    // the remaining IPs are requested when the replies arrive (replyFinished)
 }
 
 // At moment the current api is geoip.nekudo.com. Another option is https://freegeoip.net/json/
@@ -228,21 +243,34 @@ Geo::Location WebIpToLocationResolver::resolve(const QString &ip, const QString
         loadCountryNamesFromFile(currentLanguage); //update the country names QMap
     }
 
-    if (countryCodesCache.contains(ip)) {
-        QString countryCode = countryCodesCache[ip];
+    QString countryCode;
+    QPointF latLong;
+    if (locationsTable.find(ip, &countryCode, &latLong)) {
         if (countryNamesCache.contains(countryCode)) {
             QString countryName = countryNamesCache[countryCode];
-            if (latLongCache.contains(ip)) {
-                qreal latitude = latLongCache[ip].x();
-                qreal longitude = latLongCache[ip].y();
-                return Location(countryName, countryCode, latitude, longitude);
-            }
+            return Location(countryName, countryCode, latLong.x(), latLong.y());
         }
     }
 
-    if (!ip.isEmpty()) {
-        requestDataFromWebService(ip);
+    if (ip.isEmpty())
+        return Location();
+
+    if (offlineResolver) {
+        Location location = offlineResolver->resolve(ip, currentLanguage);
+        if (!location.isUnknown()) {
+            locationsTable.insert(ip, location.getCountryCode(), QPointF(location.getLatitude(), location.getLongitude()));
+            if (!countryNamesCache.contains(location.getCountryCode())) // web service names are translated, offline names are not
+                countryNamesCache.insert(location.getCountryCode(), location.getCountryName());
+            return location;
+        }
     }
+
+    if (!offlineMode && !requestedIps.contains(ip) && !failedIps.contains(ip)) {
+        pendingIps.insert(ip);
+        if (!requestsTimer.isActive())
+            requestsTimer.start();
+    }
+
     return Location();//empty location, the next request for same ip probabily return from cache
 }
 
@@ -251,20 +279,6 @@ QString WebIpToLocationResolver::buildFileNameFromLanguage(const QString &langua
    return COUNTRY_NAMES_FILE_PREFIX + "_" + languageCode + ".bin";
 }
 
-void WebIpToLocationResolver::loadLatLongsFromFile()
-{
-    QString fileName = LAT_LONG_CACHE_FILE;
-    quint32 expectedCacheHeaderRevision = LAT_LONG_CACHE_REVISION;
-    if (populateQMapFromFile(fileName, latLongCache, expectedCacheHeaderRevision)) {
-        qCDebug(jtIpToLocation) << latLongCache.size() << " lat,long pairs loaded in cache";
-    }
-    else
-    {
-        qCritical() << "Can't open the file " << fileName;
-    }
-}
-
-
 void WebIpToLocationResolver::loadCountryNamesFromFile(const QString &languageCode)
 {
     QString fileName = buildFileNameFromLanguage(languageCode);
@@ -278,15 +292,6 @@ void WebIpToLocationResolver::loadCountryNamesFromFile(const QString &languageCo
     }
 }
 
-void WebIpToLocationResolver::loadCountryCodesFromFile()
-{
-    quint32 expectedCacheHeaderRevision = COUNTRY_CODES_CACHE_REVISION;
-    if (populateQMapFromFile(COUNTRY_CODES_FILE, countryCodesCache, expectedCacheHeaderRevision))
-        qCDebug(jtIpToLocation) << countryCodesCache.size() << " cached country codes loaded from file!";
-    else
-        qCritical() << "Can't open the file " << COUNTRY_CODES_FILE;
-}
-
 bool WebIpToLocationResolver::populateQMapFromFile(const QString &fileName, QMap<QString, QString> &map, quint32 expectedCacheHeaderRevision)
 {
     map.clear();
@@ -326,38 +331,9 @@ bool WebIpToLocationResolver::populateQMapFromFile(const QString &fileName, QMap
 }
 
 
-void WebIpToLocationResolver::loadOldCacheContent()
-{
-    //load cache content from the old 'cache.bin' file. This code will be delete in future versions
-    QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
-    QFile cacheFile(cacheDir.absoluteFilePath("cache.bin"));
-    if (cacheFile.open(QFile::ReadOnly)) {
-        QTextStream inputStream(&cacheFile);
-        while (!inputStream.atEnd()) {
-            QString line = inputStream.readLine();
-            if (!line.isNull() && !line.isEmpty()) {
-                QStringList parts = line.split(";");
-                if (!parts.isEmpty()) {
-                    QString ip = parts.at(0);
-                    QString countryName = (parts.size() >= 1) ? parts.at(1) : "";
-                    QString countryCode = (parts.size() >= 2) ? parts.at(2) : "";
-                    countryCodesCache.insert(ip, countryCode);
-                    countryNamesCache.insert(countryCode, countryName);
-                }
-            }
-        }
-    }
-}
-
 void WebIpToLocationResolver::deleteOldCacheFile()
 {
     QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
     QFile cacheFile(cacheDir.absoluteFilePath("cache.bin"));
     cacheFile.remove();
 }
-
-bool WebIpToLocationResolver::needLoadTheOldCache()
-{
-    QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
-    return QFile(cacheDir.absoluteFilePath("cache.bin")).exists();
-}
@@ -2,7 +2,11 @@
 #define FREEGEOIPTOLOCATIONRESOLVER_H
 
 #include "IpToLocationResolver.h"
+#include "IpLocationTable.h"
 #include <QMap>
+#include <QSet>
+#include <QTimer>
+#include <QScopedPointer>
 #include <QLoggingCategory>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -20,31 +24,39 @@ public:
     ~WebIpToLocationResolver();
     Geo::Location resolve(const QString &ip, const QString &languageCode) override;
 
+    // first tier used before the web service, the resolver is owned by this class
+    void setOfflineResolver(IpToLocationResolver *resolver);
+
+    // when enabled the web service is not used, just the cached locations and the offline resolver
+    void setOfflineMode(bool offlineMode);
+
 private:
-    QMap<QString, QString> countryCodesCache; // IP -> country code (2 upper case letters)
+    IpLocationTable locationsTable;           // IP -> country code and lat, long
     QMap<QString, QString> countryNamesCache; // country code => translated country name
-    QMap<QString, QPointF> latLongCache;      // IP => QPointF(latitude, longitude)
     QNetworkAccessManager httpClient;
 
+    QScopedPointer<IpToLocationResolver> offlineResolver;
+    bool offlineMode;
+
+    // unknown IPs are requested in batches, many IPs are resolved when a big room is entered
+    QSet<QString> pendingIps;
+    QSet<QString> requestedIps; // waiting for web service reply
+    QSet<QString> failedIps;    // not requested again in this session
+    QTimer requestsTimer;
+
     void requestDataFromWebService(const QString &ip);
 
     // loading
-    void loadCountryCodesFromFile();
     void loadCountryNamesFromFile(const QString &languageCode);
-    void loadLatLongsFromFile();
     bool populateQMapFromFile(const QString &fileName, QMap<QString, QString> &map, quint32 expectedCacheHeaderRevision);
     bool populateQMapFromFile(const QString &fileName, QMap<QString, QPointF> &map, quint32 expectedCacheHeaderRevision);
 
-    bool needLoadTheOldCache();
-    void loadOldCacheContent(); // these functions are used to handle the old 'cache.bin' content used until the version 2.0.13. This will be deleted in future.
+    void importOldCacheFiles(); // the QMap files used until the memory mapped table
     void deleteOldCacheFile();
 
     //saving
-    void saveCountryCodesToFile();
     void saveCountryNamesToFile();
-    void saveLatLongsToFile();
     bool saveMapToFile(const QString &fileName, const QMap<QString, QString> &map, quint32 cacheHeaderRevision);
-    bool saveMapToFile(const QString &fileName, const QMap<QString, QPointF> &map, quint32 cacheHeaderRevision);
 
     static QString buildFileNameFromLanguage(const QString &languageCode);
     static QString sanitizeLanguageCode(const QString &languageCode);
@@ -58,12 +70,17 @@ private:
     static const QString COUNTRY_CODES_FILE;
     static const QString COUNTRY_NAMES_FILE_PREFIX;
     static const QString LAT_LONG_CACHE_FILE;
+    static const QString LOCATIONS_TABLE_FILE;
+
+    static const int REQUESTS_DELAY; // in milliseconds, used to group the requests
+    static const int MAX_PARALLEL_REQUESTS;
 
     static const quint32 COUNTRY_CODES_CACHE_REVISION;
     static const quint32 COUNTRY_NAMES_CACHE_REVISION;
     static const quint32 LAT_LONG_CACHE_REVISION;
 
 private slots:
+    void sendPendingRequests();
     void replyFinished(QNetworkReply *);
     void replyError(QNetworkReply::NetworkError);
 
@@ -133,6 +133,14 @@ void JamRoomViewPanel::changeEvent(QEvent *e)
     QFrame::changeEvent(e);
 }
 
+void JamRoomViewPanel::enterEvent(QEvent *e)
+{
+    if (roomInfo.hasStream() && !roomInfo.isEmpty())
+        emit hovered(roomInfo);
+
+    QFrame::enterEvent(e);
+}
+
 void JamRoomViewPanel::translateUi()
 {
     ui->labelRoomStatus->setText(buildRoomDescriptionString());
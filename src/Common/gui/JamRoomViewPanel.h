@@ -48,9 +48,11 @@ signals:
     void startingListeningTheRoom(const Login::RoomInfo &roomInfo);
     void finishingListeningTheRoom(const Login::RoomInfo &roomInfo);
     void enteringInTheRoom(const Login::RoomInfo &roomInfo);
+    void hovered(const Login::RoomInfo &roomInfo); // used to prefetch the room stream
 
 protected:
     void changeEvent(QEvent *) override;
+    void enterEvent(QEvent *) override;
 
 private slots:
     void toggleRoomListening();
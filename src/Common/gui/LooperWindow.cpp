@@ -781,6 +781,8 @@ void LooperWindow::showSaveDialogs()
     loopFileName = file::sanitizeFileName(loopFileName);
     loopSaver.save(loopFileName, bpm, bpi, encodeInOggVorbis, vorbisQuality, sampleRate, bitDepth);
 
+    mainController->getLoopsIndex()->rescan();
+
     looper->setLoopName(loopFileName);
 
     updateControls();
@@ -878,7 +880,7 @@ void LooperWindow::showLoadMenu()
     quint16 currentBpm = ninjamController->getCurrentBpm();
 
     QString loopsDir = mainController->getSettings().getLooperSavePath();
-    QList<LoopInfo> loopsInfos = LoopLoader::loadLoopsInfo(loopsDir, currentBpm);
+    QList<LoopInfo> loopsInfos = mainController->getLoopsIndex()->getLoops(currentBpm); // the loops are indexed in background
 
     QString matchedMenuText = (!loopsInfos.isEmpty()) ? (tr("%1 BPM loops").arg(currentBpm)) : (tr("No loops for %1 BPM").arg(currentBpm));
     QMenu *bpmMatchedMenu = new QMenu(matchedMenuText);
@@ -914,7 +916,7 @@ void LooperWindow::showLoadMenu()
         QString loopFilePath = QFileDialog::getOpenFileName(this, fileDialogTitle, loopsDir, filter);
         if (!loopFilePath.isEmpty()) {
             QString loopDir = QFileInfo(loopFilePath).dir().absolutePath();
-            loadLoopInfo(loopDir, LoopLoader::loadLoopInfo(loopFilePath));
+            loadLoopInfo(loopDir, LoopInfo::loadFromFile(loopFilePath));
         }
     });
 
@@ -24,8 +24,11 @@
 #include <QDesktopServices>
 #include <QRect>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QSet>
 #include <QImage>
 #include <QCameraInfo>
+#include <QFileDialog>
 
 #include "MainController.h"
 #include "ThemeLoader.h"
@@ -46,6 +49,8 @@ const quint8 MainWindow::MAX_REFRESH_RATE = 60; // in Hertz
 
 const int MainWindow::PERFORMANCE_MONITOR_REFRESH_TIME = 200; //in miliseconds
 
+const int MainWindow::SETTINGS_AUTO_SAVE_TIME = 60000; // in miliseconds
+
 const QString MainWindow::JAMTABA_CHAT_BOT_NAME("JamTaba");
 
 MainWindow::MainWindow(Controller::MainController *mainController, QWidget *parent) :
@@ -56,6 +61,9 @@ MainWindow::MainWindow(Controller::MainController *mainController, QWidget *pare
     roomToJump(nullptr),
     chordsPanel(nullptr),
     lastPerformanceMonitorUpdate(0),
+    lastPaintTime(0),
+    guiFrameTime(0),
+    maxGuiFrameTime(0),
     camera(nullptr),
     videoFrameGrabber(nullptr),
     cameraView(nullptr),
@@ -502,6 +510,10 @@ void MainWindow::initialize()
 
     initializeGuiRefreshTimer();
 
+    QTimer *settingsAutoSaveTimer = new QTimer(this);
+    connect(settingsAutoSaveTimer, &QTimer::timeout, this, &MainWindow::autoSaveSettings);
+    settingsAutoSaveTimer->start(SETTINGS_AUTO_SAVE_TIME);
+
     if (qApp->styleSheet().isEmpty()) { // allow custom stylesheet via app arguments
         QString themeName = mainController->getTheme();
         QString themesDir = Configurator::getInstance()->getThemesDir().absolutePath();
@@ -581,6 +593,17 @@ void MainWindow::toggleLocalTracksCollapseStatus()
     updateCollapseButtons();
 }
 
+void MainWindow::autoSaveSettings()
+{
+    if (mainController) // only the changed settings are written, in background
+        mainController->saveLastUserSettings(getAutoSaveInputsSettings());
+}
+
+Persistence::LocalInputTrackSettings MainWindow::getAutoSaveInputsSettings() const
+{
+    return getInputsSettings();
+}
+
 Persistence::LocalInputTrackSettings MainWindow::getInputsSettings() const
 {
     LocalInputTrackSettings settings;
@@ -984,6 +1007,11 @@ JamRoomViewPanel *MainWindow::createJamRoomViewPanel(const Login::RoomInfo &room
 
     connect(newJamRoomView, SIGNAL(enteringInTheRoom(Login::RoomInfo)), this, SLOT(tryEnterInRoom(Login::RoomInfo)));
 
+    connect(newJamRoomView, &JamRoomViewPanel::hovered, this, [=](const Login::RoomInfo &roomInfo){
+        auto prefetcher = mainController->getRoomStreamPrefetcher();
+        prefetcher->addInterest(roomInfo.getID(), roomInfo.getStreamUrl(), Audio::RoomStreamPrefetcher::HOVER_INTEREST);
+    });
+
     return newJamRoomView;
 }
 
@@ -1000,34 +1028,49 @@ void MainWindow::refreshPublicRoomsList(const QList<Login::RoomInfo> &publicRoom
     hideBusyDialog();
 
     QList<Login::RoomInfo> sortedRooms(publicRooms);
-    qSort(sortedRooms.begin(), sortedRooms.end(), jamRoomLessThan);
+    qStableSort(sortedRooms.begin(), sortedRooms.end(), jamRoomLessThan); // stable sort to avoid moving rooms with same users count
 
     int index = 0;
     bool twoCollumns = canUseTwoColumnLayoutInPublicRooms();
+    QGridLayout *layout = dynamic_cast<QGridLayout *>(ui.allRoomsContent->layout());
+    QSet<long long> publicRoomIDs;
     for (const Login::RoomInfo &roomInfo : sortedRooms) {
         if (roomInfo.getType() == Login::RoomTYPE::NINJAM) { // skipping other rooms at moment
+            publicRoomIDs.insert(roomInfo.getID());
             int rowIndex = twoCollumns ? (index / 2) : (index);
             int collumnIndex = twoCollumns ? (index % 2) : 0;
+            index++;
+
             JamRoomViewPanel *roomViewPanel = roomViewPanels[roomInfo.getID()];
             if (roomViewPanel) {
-                roomViewPanel->refresh(roomInfo);
-                // check if is playing a public room stream but this room is empty now
-                if (mainController->isPlayingRoomStream()) {
-                    if (roomInfo.isEmpty()
-                        && mainController->getCurrentStreamingRoomID() == roomInfo.getID())
-                        stopCurrentRoomStream();
+                if (roomViewPanel->getRoomInfo() != roomInfo) { // only changed rooms are refreshed
+                    mainController->getRoomStreamPrefetcher()->updateRoom(roomInfo.getID(), roomInfo.getStreamUrl(), roomInfo.isEmpty());
+                    roomViewPanel->refresh(roomInfo);
+                    // check if is playing a public room stream but this room is empty now
+                    if (mainController->isPlayingRoomStream()) {
+                        if (roomInfo.isEmpty()
+                            && mainController->getCurrentStreamingRoomID() == roomInfo.getID())
+                            stopCurrentRoomStream();
+                    }
                 }
-                ui.allRoomsContent->layout()->removeWidget(roomViewPanel); // the widget is removed but added again
+
+                int currentRow = -1, currentCollumn = -1, rowSpan, collumnSpan;
+                layout->getItemPosition(layout->indexOf(roomViewPanel), &currentRow, &currentCollumn, &rowSpan, &collumnSpan);
+                if (currentRow == rowIndex && currentCollumn == collumnIndex)
+                    continue; // the panel is already in the right place
+
+                layout->removeWidget(roomViewPanel); // the widget is removed but added again
             } else {
+                mainController->getRoomStreamPrefetcher()->updateRoom(roomInfo.getID(), roomInfo.getStreamUrl(), roomInfo.isEmpty());
                 roomViewPanel = createJamRoomViewPanel(roomInfo);
                 roomViewPanels.insert(roomInfo.getID(), roomViewPanel);
             }
-            QGridLayout *layout = dynamic_cast<QGridLayout *>(ui.allRoomsContent->layout());
             layout->addWidget(roomViewPanel, rowIndex, collumnIndex);
-            index++;
         }
     }
 
+    mainController->getRoomStreamPrefetcher()->removeMissingRooms(publicRoomIDs); // the rooms interests are not kept for the whole session
+
     if (mainController->isPlayingInNinjamRoom())
         this->ninjamWindow->updateGeoLocations();
     /** updating country flag and country names after refresh the public rooms list. This is necessary because the call to webservice used to get country codes and  country names is not synchronous. So, if country code and name are not cached we receive these data from the webservice after some seconds.*/
@@ -1696,15 +1739,59 @@ void MainWindow::setInputTracksPreparingStatus(bool preparing)
     }
 }
 
+bool MainWindow::event(QEvent *ev)
+{
+    if (ev->type() != QEvent::UpdateRequest)
+        return QMainWindow::event(ev);
+
+    // Qt is merging all update() calls in one UpdateRequest, this is the repaint cost of the entire window
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+
+    bool result = QMainWindow::event(ev);
+
+    lastPaintTime = paintTimer.nsecsElapsed();
+
+    return result;
+}
+
+void MainWindow::updateGuiFrameTime(qint64 tickTime)
+{
+    double frameTime = (tickTime + lastPaintTime) / 1000000.0;
+    lastPaintTime = 0; // the window is not repainted in all ticks
+
+    guiFrameTime = guiFrameTime * 0.9 + frameTime * 0.1;
+    maxGuiFrameTime = qMax(maxGuiFrameTime, frameTime);
+}
+
 void MainWindow::timerEvent(QTimerEvent *)
 {
     if (!mainController)
         return;
 
-    // update local input track peaks
+    QElapsedTimer tickTimer;
+    tickTimer.start();
+
+    // update local input track peaks. Plugins GUI are updated here too, so this is done even when the window is minimized
     for (TrackGroupView *channel : localGroupChannels)
         channel->updateGuiElements();
 
+    // prevent screen saver if user is playing
+    if (mainController->isPlayingInNinjamRoom())
+        screensaverBlocker.update();
+
+    // looper windows are top level windows, they are updated even when the main window is minimized
+    for (LooperWindow *looperWindow : looperWindows.values()) {
+        if (looperWindow && looperWindow->isVisible() && !looperWindow->isMinimized()) {
+            looperWindow->updateDrawings();
+        }
+    }
+
+    if (isMinimized()) { // nothing to paint in main window
+        updateGuiFrameTime(tickTimer.nsecsElapsed());
+        return;
+    }
+
     // update metronome peaks
     if (mainController->isPlayingInNinjamRoom()) {
         // update tracks peaks
@@ -1712,20 +1799,6 @@ void MainWindow::timerEvent(QTimerEvent *)
             ninjamWindow->updatePeaks();
     }
 
-    // update cpu and memmory usage
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    if (now - lastPerformanceMonitorUpdate >= PERFORMANCE_MONITOR_REFRESH_TIME) {
-
-        if (performanceMonitorLabel)
-            performanceMonitorLabel->setText(QString("MEM: %1%").arg(performanceMonitor.getMemmoryUsed()));
-
-        lastPerformanceMonitorUpdate = now;
-    }
-
-    // prevent screen saver if user is playing
-    if (mainController->isPlayingInNinjamRoom())
-        screensaverBlocker.update();
-
     // update public server stream plot
     if (mainController->isPlayingRoomStream()) {
         long long roomID = mainController->getCurrentStreamingRoomID();
@@ -1743,13 +1816,6 @@ void MainWindow::timerEvent(QTimerEvent *)
         }
     }
 
-    // update looper window sound waves
-    for (LooperWindow *looperWindow : looperWindows.values()) {
-        if (looperWindow && looperWindow->isVisible()) {
-            looperWindow->updateDrawings();
-        }
-    }
-
     // update master peaks
     Audio::AudioPeak masterPeak = mainController->getMasterPeak();
     ui.masterMeter->setPeak(masterPeak.getLeftPeak(), masterPeak.getRightPeak(),
@@ -1757,6 +1823,23 @@ void MainWindow::timerEvent(QTimerEvent *)
 
     // update all blinkable buttons
     BlinkableButton::updateAllBlinkableButtons();
+
+    updateGuiFrameTime(tickTimer.nsecsElapsed());
+
+    // update cpu and memmory usage
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - lastPerformanceMonitorUpdate >= PERFORMANCE_MONITOR_REFRESH_TIME) {
+
+        if (performanceMonitorLabel) {
+            performanceMonitorLabel->setText(QString("MEM: %1% GUI: %2 ms (max %3 ms)")
+                                             .arg(performanceMonitor.getMemmoryUsed())
+                                             .arg(guiFrameTime, 0, 'f', 1)
+                                             .arg(maxGuiFrameTime, 0, 'f', 1));
+        }
+
+        maxGuiFrameTime = 0;
+        lastPerformanceMonitorUpdate = now;
+    }
 }
 
 void MainWindow::resizeEvent(QResizeEvent *ev)
@@ -1901,6 +1984,23 @@ void MainWindow::centerDialog(QWidget *dialog)
     dialog->move(dialog->mapFromGlobal(QPoint(x, y)));
 }
 
+void MainWindow::exportIntervalsTelemetry()
+{
+    auto ninjamController = mainController->getNinjamController();
+    if (!mainController->isPlayingInNinjamRoom() || !ninjamController) {
+        showMessageBox(tr("Intervals statistics"), tr("Connect in a ninjam server to collect the intervals statistics!"), QMessageBox::Information);
+        return;
+    }
+
+    QString fileName = QString("intervals_%1.csv").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss"));
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Export intervals statistics"), fileName, tr("CSV files (*.csv)"));
+    if (filePath.isEmpty())
+        return;
+
+    if (!ninjamController->exportIntervalsTelemetry(filePath))
+        showMessageBox(tr("Error!"), tr("Can't write the file %1").arg(filePath), QMessageBox::Critical);
+}
+
 void MainWindow::showNinjamCommunityWebPage()
 {
     QDesktopServices::openUrl(QUrl("http://www.ninbot.com"));
@@ -1960,6 +2060,8 @@ void MainWindow::setupPreferencesDialogSignals(PreferencesDialog *dialog)
 
     connect(dialog, &PreferencesDialog::encodingQualityChanged, mainController, &MainController::setEncodingQuality);
 
+    connect(dialog, &PreferencesDialog::adaptiveEncodingQualityChanged, mainController, &MainController::setAdaptiveEncodingQuality);
+
     connect(dialog, &PreferencesDialog::looperAudioEncodingFlagChanged, mainController, &MainController::storeLooperAudioEncodingFlag);
 
     connect(dialog, &PreferencesDialog::looperFolderChanged, mainController, &MainController::storeLooperFolder);
@@ -2330,6 +2432,8 @@ void MainWindow::setupSignals()
 
     connect(ui.actionPrivate_Server, &QAction::triggered, this, &MainWindow::showPrivateServerDialog);
 
+    connect(ui.actionExportIntervalsTelemetry, &QAction::triggered, this, &MainWindow::exportIntervalsTelemetry);
+
     connect(ui.actionReportBugs, &QAction::triggered, this, &MainWindow::showJamtabaIssuesWebPage);
 
     connect(ui.actionWiki, &QAction::triggered, this, &MainWindow::showJamtabaWikiWebPage);
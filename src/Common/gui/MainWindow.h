@@ -58,6 +58,7 @@ public:
     void detachMainController();
 
     virtual Persistence::LocalInputTrackSettings getInputsSettings() const;
+    virtual Persistence::LocalInputTrackSettings getAutoSaveInputsSettings() const; // cheap version used in the periodic saves
 
     int getChannelGroupsCount() const;
 
@@ -150,6 +151,7 @@ protected:
 
     virtual void setupPreferencesDialogSignals(PreferencesDialog *dialog);
 
+    bool event(QEvent *) override;
     void closeEvent(QCloseEvent *) override;
     void changeEvent(QEvent *) override;
     void timerEvent(QTimerEvent *) override;
@@ -180,6 +182,8 @@ protected slots:
 
     void showPrivateServerDialog();
 
+    void exportIntervalsTelemetry();
+
     // view menu
     void updateMeteringMenu();
     void handleMenuMeteringAction(QAction *);
@@ -260,6 +264,8 @@ private slots:
     void changeTheme(QAction *action);
     void translateThemeMenu();
 
+    void autoSaveSettings();
+
     void handleThemeChanged();
 
     void translateCollapseButtonsToolTips();
@@ -417,6 +423,14 @@ private:
     qint64 lastPerformanceMonitorUpdate;
     static const int PERFORMANCE_MONITOR_REFRESH_TIME;
 
+    static const int SETTINGS_AUTO_SAVE_TIME; // saving the settings periodically, the changes are not lost in a crash
+
+    // GUI refresh cost (timer tick + window repaint), in milliseconds
+    qint64 lastPaintTime; // in nanoseconds
+    double guiFrameTime; // smoothed
+    double maxGuiFrameTime; // max value since the last performance monitor update
+    void updateGuiFrameTime(qint64 tickTime);
+
     static const QString NIGHT_MODE_SUFFIX;
 
 };
@@ -20,7 +20,8 @@ const int NinjamTrackView::WIDE_HEIGHT = 70; // height used in horizontal layout
 NinjamTrackView::NinjamTrackView(Controller::MainController *mainController, long trackID) :
     BaseTrackView(mainController, trackID),
     orientation(Qt::Vertical),
-    downloadingFirstInterval(true)
+    downloadingFirstInterval(true),
+    telemetryIntervals(0)
 {
     channelNameLabel = createChannelNameLabel();
 
@@ -176,6 +177,27 @@ void NinjamTrackView::updateGuiElements()
 
     auto trackNode = static_cast<NinjamTrackNode *>(mainController->getTrackNode(getTrackID()));
     peakMeter->setStereo(trackNode->isStereo());
+
+    // the tooltip is updated only when a new interval is received or missed
+    Audio::IntervalTelemetry::Snapshot telemetry = trackNode->getTelemetry().getSnapshot();
+    int intervals = telemetry.receivedIntervals + telemetry.missedIntervals;
+    if (intervals != telemetryIntervals) {
+        telemetryIntervals = intervals;
+        updateChannelNameToolTip(telemetry);
+    }
+}
+
+void NinjamTrackView::updateChannelNameToolTip(const Audio::IntervalTelemetry::Snapshot &telemetry)
+{
+    QString toolTip = channelName;
+    if (telemetry.receivedIntervals > 0 || telemetry.missedIntervals > 0) {
+        toolTip += "\n" + tr("Intervals: %1 received, %2 missed").arg(telemetry.receivedIntervals).arg(telemetry.missedIntervals);
+        toolTip += "\n" + tr("Interval size: %1 KB (average %2 KB)").arg(telemetry.lastIntervalBytes/1024).arg(telemetry.averageIntervalBytes/1024);
+        toolTip += "\n" + tr("Download: %1 ms, %2 KB/s").arg(telemetry.downloadTime).arg(telemetry.throughput/1024);
+        toolTip += "\n" + tr("Arrival before playback: %1 ms (min %2 ms)").arg(telemetry.arrivalMargin).arg(telemetry.minArrivalMargin);
+        toolTip += "\n" + tr("Decoding: %1 us").arg(telemetry.decodeTime);
+    }
+    channelNameLabel->setToolTip(toolTip);
 }
 
 void NinjamTrackView::setActivatedStatus(bool deactivated)
@@ -325,7 +347,13 @@ void NinjamTrackView::setChannelName(const QString &name)
         this->channelNameLabel->setAlignment(Qt::AlignCenter);
     else
         this->channelNameLabel->setAlignment(Qt::AlignLeft);
-    this->channelNameLabel->setToolTip(name);
+
+    this->channelName = name;
+    auto trackNode = static_cast<NinjamTrackNode *>(mainController->getTrackNode(getTrackID()));
+    if (trackNode)
+        updateChannelNameToolTip(trackNode->getTelemetry().getSnapshot());
+    else
+        this->channelNameLabel->setToolTip(name);
 }
 
 void NinjamTrackView::setPan(int value)
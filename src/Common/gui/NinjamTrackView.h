@@ -64,6 +64,10 @@ private:
     bool downloadingFirstInterval;
     void setDownloadedChunksDisplayVisibility(bool visible);
 
+    QString channelName;
+    int telemetryIntervals; // received and missed intervals showed in the channel name tooltip
+    void updateChannelNameToolTip(const Audio::IntervalTelemetry::Snapshot &telemetry);
+
     MultiStateButton *createLowCutButton(bool checked);
 
     void updateLowCutButtonToolTip();
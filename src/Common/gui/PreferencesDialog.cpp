@@ -105,6 +105,7 @@ void PreferencesDialog::setupSignals()
     connect(ui->browseAccentBeatButton, SIGNAL(clicked(bool)), this, SLOT(openAccentBeatAudioFileBrowser()));
 
     connect(ui->comboBoxEncoderQuality, SIGNAL(activated(int)), this, SLOT(emitEncodingQualityChanged()));
+    connect(ui->checkBoxAdaptiveEncoderQuality, &QCheckBox::clicked, this, &PreferencesDialog::adaptiveEncodingQualityChanged);
 
     connect(ui->radioButtonLooperOggEncoding, &QCheckBox::toggled, this, &PreferencesDialog::looperAudioEncodingFlagChanged);
     connect(ui->lineEditLoopsFolder, &QLineEdit::textChanged, this,  &PreferencesDialog::looperFolderChanged);
@@ -186,6 +187,8 @@ void PreferencesDialog::populateEncoderQualityComboBox()
     else {
         ui->comboBoxEncoderQuality->setCurrentIndex(ui->comboBoxEncoderQuality->count() - 1);
     }
+
+    ui->checkBoxAdaptiveEncoderQuality->setChecked(settings->isUsingAdaptiveEncodingQuality());
 }
 
 bool PreferencesDialog::usingCustomEncodingQuality()
@@ -39,6 +39,7 @@ signals:
     void jamRecorderStatusChanged(const QString &writerId, bool status);
     void recordingPathSelected(const QString &newRecordingPath);
     void encodingQualityChanged(float newEncodingQuality);
+    void adaptiveEncodingQualityChanged(bool adaptive);
     void looperAudioEncodingFlagChanged(bool savingEncodedAudio);
     void looperWaveFilesBitDepthChanged(quint8 bitDepth);
     void looperFolderChanged(const QString &newLoopsFolder);
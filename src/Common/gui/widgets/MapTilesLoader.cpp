@@ -0,0 +1,96 @@
+#include "MapTilesLoader.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QFile>
+#include <QDebug>
+
+const int MapTilesLoader::DEFAULT_MAX_CACHE_SIZE = 16 * 1024; // 16 MB, 64 tiles using 256x256 ARGB pixels
+
+MapTilesLoader *MapTilesLoader::getInstance()
+{
+    static MapTilesLoader instance;
+    return &instance;
+}
+
+MapTilesLoader::MapTilesLoader() :
+    tiles(DEFAULT_MAX_CACHE_SIZE),
+    tilesDir(":/tiles/map/")
+{
+    threadPool.setMaxThreadCount(1); // tiles are small, one thread is enough and keeps the loading order
+}
+
+void MapTilesLoader::setTilesDir(const QString &newDir)
+{
+    if (tilesDir == newDir)
+        return;
+
+    tilesDir = newDir;
+    tiles.clear();
+    missingTiles.clear();
+}
+
+void MapTilesLoader::setMaxCacheSize(int maxSizeInKBytes)
+{
+    tiles.setMaxCost(maxSizeInKBytes);
+}
+
+quint64 MapTilesLoader::createKey(int zoom, int x, int y)
+{
+    return (static_cast<quint64>(zoom) << 56) | (static_cast<quint64>(x & 0x0FFFFFFF) << 28) | static_cast<quint64>(y & 0x0FFFFFFF);
+}
+
+QPixmap MapTilesLoader::getTile(int zoom, int x, int y)
+{
+    const quint64 key = createKey(zoom, x, y);
+
+    QPixmap *tile = tiles.object(key); // moved to the top of LRU list
+    if (tile)
+        return *tile;
+
+    if (pendingTiles.contains(key) || missingTiles.contains(key))
+        return QPixmap();
+
+    pendingTiles.insert(key);
+
+    QString path = QString(tilesDir + "%1/%2/%3.png").arg(zoom).arg(x).arg(y);
+    QtConcurrent::run(&threadPool, [=]() {
+        QImage image = decodeTile(path);
+        QMetaObject::invokeMethod(this, "handleDecodedTile", Qt::QueuedConnection, Q_ARG(quint64, key), Q_ARG(QImage, image));
+    });
+
+    return QPixmap();
+}
+
+QImage MapTilesLoader::decodeTile(const QString &path)
+{
+    if (!QFile::exists(path)) {
+        qCritical() << "Tile not found:" << path;
+        return QImage();
+    }
+
+    QImage image(path);
+    if (image.isNull())
+        return image;
+
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied); // fast to convert and paint
+}
+
+void MapTilesLoader::handleDecodedTile(quint64 key, const QImage &image)
+{
+    pendingTiles.remove(key);
+
+    if (image.isNull()) {
+        missingTiles.insert(key);
+        return;
+    }
+
+    QPixmap *tile = new QPixmap(QPixmap::fromImage(image)); // QPixmap can be created only in the GUI thread
+    int cost = qMax(1, tile->width() * tile->height() * tile->depth() / 8 / 1024);
+    tiles.insert(key, tile, cost);
+
+    int zoom = static_cast<int>(key >> 56);
+    int x = static_cast<int>((key >> 28) & 0x0FFFFFFF);
+    int y = static_cast<int>(key & 0x0FFFFFFF);
+
+    emit tileLoaded(zoom, x, y);
+}
@@ -0,0 +1,54 @@
+#ifndef _MAP_TILES_LOADER_H
+#define _MAP_TILES_LOADER_H
+
+#include <QObject>
+#include <QCache>
+#include <QSet>
+#include <QPixmap>
+#include <QImage>
+#include <QThreadPool>
+
+/**
+ * Tiles service shared by all MapWidgets. The tile images are decoded in a worker thread and
+ * stored in a size bounded LRU cache, so only the visible tiles of each zoom level are in memory.
+ */
+
+class MapTilesLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MapTilesLoader *getInstance();
+
+    // return a null pixmap and schedule the loading when the tile is not cached
+    QPixmap getTile(int zoom, int x, int y);
+
+    void setTilesDir(const QString &newDir);
+
+    void setMaxCacheSize(int maxSizeInKBytes);
+
+signals:
+    void tileLoaded(int zoom, int x, int y);
+
+private slots:
+    void handleDecodedTile(quint64 key, const QImage &image);
+
+private:
+    MapTilesLoader();
+
+    static QImage decodeTile(const QString &path);
+
+    static quint64 createKey(int zoom, int x, int y);
+
+    QThreadPool threadPool;
+
+    QCache<quint64, QPixmap> tiles; // the cost is the tile size in KBytes
+    QSet<quint64> pendingTiles;
+    QSet<quint64> missingTiles; // tiles not found are not loaded again
+
+    QString tilesDir;
+
+    static const int DEFAULT_MAX_CACHE_SIZE; // in KBytes
+};
+
+#endif
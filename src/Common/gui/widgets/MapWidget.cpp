@@ -1,4 +1,5 @@
 #include "MapWidget.h"
+#include "MapTilesLoader.h"
 #include <QtCore>
 #include <QtWidgets>
 #include <QDebug>
@@ -10,19 +11,12 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-QString MapWidget::TILES_DIR = ":/tiles/map/";
 const int MapWidget::TILES_SIZE = 256; // tile size in pixels
 const qreal MapWidget::TEXT_MARGIM = 3;
 const int MapWidget::MARKER_POSITIONS = 8;
 bool MapWidget::usingNightMode = false;
-const int MapWidget::ZOOM = 1; // fixed zoom level
-
-QHash<QPoint, QPixmap> MapWidget::tilePixmaps;
-
-uint qHash(const QPoint& p)
-{
-    return p.x() * 17 ^ p.y();
-}
+const int MapWidget::DEFAULT_ZOOM = 1;
+const int MapWidget::MAX_ZOOM = 18;
 
 QPointF tileForCoordinate(qreal lat, qreal lng, int zoom)
 {
@@ -52,10 +46,13 @@ qreal getDistance(const QPointF &p1, const QPointF &p2)
 
 MapWidget::MapWidget(QWidget *parent) :
     QWidget(parent),
+    zoom(DEFAULT_ZOOM),
+    mapPixmapIsDirty(true),
+    mapPixmapInNightMode(false),
     blurActivated(false)
 {
+    connect(MapTilesLoader::getInstance(), &MapTilesLoader::tileLoaded, this, &MapWidget::handleLoadedTile);
 
-    loadTiles();
     setCenter(QPointF(0, 0));
     installEventFilter(this);
     initializeFonts();
@@ -66,6 +63,33 @@ void MapWidget::setBlurMode(bool blurEnabled)
     this->blurActivated = blurEnabled;
 }
 
+void MapWidget::setZoom(int newZoom)
+{
+    newZoom = qBound(0, newZoom, MAX_ZOOM);
+    if (zoom != newZoom) {
+        zoom = newZoom;
+        updateGeometry();
+        invalidate();
+    }
+}
+
+void MapWidget::handleLoadedTile(int zoom, int x, int y)
+{
+    if (zoom != this->zoom)
+        return;
+
+    const int tiles = 1 << zoom;
+    for (int tx = tilesRect.left(); tx <= tilesRect.right(); ++tx) {
+        for (int ty = tilesRect.top(); ty <= tilesRect.bottom(); ++ty) {
+            if ((tx + tiles) % tiles == x && (ty + tiles) % tiles == y) { // the loaded tile is visible in this map?
+                mapPixmapIsDirty = true;
+                update();
+                return;
+            }
+        }
+    }
+}
+
 void MapWidget::initializeFonts()
 {
     QFont widgetFont = font();
@@ -79,7 +103,7 @@ void MapWidget::initializeFonts()
 
 void MapWidget::setTilesDir(const QString &newDir)
 {
-    MapWidget::TILES_DIR = newDir;
+    MapTilesLoader::getInstance()->setTilesDir(newDir);
 }
 
 QPointF MapWidget::getCenterLatLong() const
@@ -196,7 +220,7 @@ void MapWidget::setCenter(QPointF latLong)
 QSize MapWidget::minimumSizeHint() const
 {
     QSize hint = QWidget::minimumSizeHint();
-    QRectF minRect = computeMinimumRect(ZOOM);
+    QRectF minRect = computeMinimumRect(zoom);
     hint.setHeight(qMax(240.0, minRect.height()));
     return hint;
 }
@@ -206,7 +230,7 @@ void MapWidget::invalidate()
     if (width() <= 0 || height() <= 0)
         return;
 
-    QPointF center = tileForCoordinate(latitude, longitude, ZOOM);
+    QPointF center = tileForCoordinate(latitude, longitude, zoom);
     qreal tileX = center.x();
     qreal tileY = center.y();
 
@@ -230,22 +254,10 @@ void MapWidget::invalidate()
     // build a rect
     tilesRect = QRect(xs, ys, xe - xs + 1, ye - ys + 1);
 
+    mapPixmapIsDirty = true;
     update();
 }
 
-void MapWidget::loadTiles()
-{
-    int totalTiles = std::pow(2, ZOOM);
-    for (int x = 0; x < totalTiles; ++x) {
-        for (int y = 0; y < totalTiles; ++y) {
-            QPoint tp(x, y);
-            if (!tilePixmaps.contains(tp)) {
-                tilePixmaps.insert(tp, loadTile(ZOOM, x, y));
-            }
-        }
-    }
-}
-
 void MapWidget::updateMapPositionsCache()
 {
     static const int markersHeight = fontMetrics().height() * 2;
@@ -267,22 +279,10 @@ void MapWidget::resizeEvent(QResizeEvent *)
     setCenter(getCenterLatLong());
 }
 
-QPixmap MapWidget::loadTile(int zoomLevel, int x, int y)
-{
-    QString path(MapWidget::TILES_DIR + "%1/%2/%3.png");
-    path = path.arg(zoomLevel).arg(x).arg(y);
-    QFile imageFile(path);
-    if (!imageFile.exists()) {
-        qCritical() << "Tile not found to zoom:" << zoomLevel << " x:" << x << " y:" << y;
-        return QPixmap();
-    }
-
-    return QPixmap(path);
-}
-
 void MapWidget::drawMapTiles(QPainter &p, const QRect &rect)
 {
-    int tiles = std::pow(2, ZOOM);
+    MapTilesLoader *tilesLoader = MapTilesLoader::getInstance();
+    int tiles = 1 << zoom;
     for (int x = 0; x <= tilesRect.width(); ++x) {
         for (int y = 0; y <= tilesRect.height(); ++y) {
             QPoint tp(x + tilesRect.left(), y + tilesRect.top());
@@ -290,8 +290,9 @@ void MapWidget::drawMapTiles(QPainter &p, const QRect &rect)
             if (rect.intersects(box)) {
                 tp.setX((tp.x() + tiles) % tiles);
                 tp.setY((tp.y() + tiles) % tiles);
-                if (tilePixmaps.contains(tp)) {
-                    p.drawPixmap(box, tilePixmaps.value(tp));
+                QPixmap tile = tilesLoader->getTile(zoom, tp.x(), tp.y()); // null when the tile is not loaded yet
+                if (!tile.isNull()) {
+                    p.drawPixmap(box, tile);
                 }
             }
         }
@@ -305,16 +306,36 @@ void MapWidget::drawMapTiles(QPainter &p, const QRect &rect)
     }
 }
 
-void MapWidget::paintEvent(QPaintEvent *event)
+void MapWidget::renderMapPixmap()
 {
-    QPainter p;
-    p.begin(this);
+    // rendered in device pixels, the tiles and markers are sharp in HiDPI screens
+    mapPixmap = QPixmap(size() * devicePixelRatioF());
+    mapPixmap.setDevicePixelRatio(devicePixelRatioF());
+    mapPixmap.fill(Qt::transparent);
+
+    QPainter p(&mapPixmap);
     p.setRenderHint(QPainter::Antialiasing, true);
 
-    drawMapTiles(p, event->rect());
+    drawMapTiles(p, rect());
 
     drawPlayersMarkers(p);
 
+    mapPixmapIsDirty = false;
+    mapPixmapInNightMode = usingNightMode;
+}
+
+void MapWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    if (mapPixmapIsDirty || mapPixmap.size() != size() * devicePixelRatioF() || mapPixmapInNightMode != usingNightMode)
+        renderMapPixmap();
+
+    QPainter p;
+    p.begin(this);
+
+    p.drawPixmap(0, 0, mapPixmap);
+
     if (blurActivated) {
         p.fillRect(rect(), QColor(0, 0, 0, 140)); // draw a transparent black layer and create more contrast to show the sound wave
     }
@@ -330,12 +351,12 @@ void MapWidget::setNightMode(bool useNightMode)
 
 QPointF MapWidget::getMarkerScreenCoordinate(const MapMarker &marker) const
 {
-    QPointF center = tileForCoordinate(latitude, longitude, ZOOM);
+    QPointF center = tileForCoordinate(latitude, longitude, zoom);
     qreal hCenter = width()/2.0;
     qreal vCenter = height()/2.0;
 
     QPointF latLong = marker.getLatLong();
-    QPointF tile = tileForCoordinate(latLong.x(), latLong.y(), ZOOM);
+    QPointF tile = tileForCoordinate(latLong.x(), latLong.y(), zoom);
     qreal x = hCenter - ((center.x() - tile.x()) * TILES_SIZE);
     qreal y = vCenter - ((center.y() - tile.y()) * TILES_SIZE);
     return QPointF(x, y);
@@ -20,6 +20,7 @@ public:
     static void setTilesDir(const QString &newDir);
     static void setNightMode(bool useNightMode);
     void setBlurMode(bool blurEnabled);
+    void setZoom(int newZoom);
 
 protected:
     void resizeEvent(QResizeEvent *) override;
@@ -28,19 +29,26 @@ protected:
     bool eventFilter(QObject *, QEvent *) override;
 
 private slots:
-    void loadTiles();
+    void handleLoadedTile(int zoom, int x, int y);
 
 private:
-    static const int ZOOM;
+    static const int DEFAULT_ZOOM;
+    static const int MAX_ZOOM;
+    int zoom;
     qreal latitude;
     qreal longitude;
 
     QPoint offset;
     QRect tilesRect;
-    static QHash<QPoint, QPixmap> tilePixmaps; // tiles cache
 
     static bool usingNightMode;
 
+    // tiles and markers are rendered once, the pixmap is invalidated when markers, size or tiles change
+    QPixmap mapPixmap;
+    bool mapPixmapIsDirty;
+    bool mapPixmapInNightMode;
+    void renderMapPixmap();
+
     QList<MapMarker> markers;
 
     void invalidate();
@@ -60,11 +68,9 @@ private:
 
     void setCenter(QPointF latLong);
 
-    QPixmap loadTile(int zoomLevel, int x, int y);
-
     QPointF getCenterLatLong() const;
 
-    QRectF computeMinimumRect(int ZOOM) const;
+    QRectF computeMinimumRect(int zoom) const;
 
     QPointF getMarkerScreenCoordinate(const MapMarker &marker) const;
 
@@ -93,7 +99,6 @@ private:
 
     bool blurActivated;
 
-    static QString TILES_DIR;
     static const qreal TEXT_MARGIM;
     static const int TILES_SIZE;
     static const int MARKER_POSITIONS;
@@ -4,13 +4,18 @@
 #include <QResizeEvent>
 #include <QDateTime>
 #include <QPainter>
+#include <QPixmapCache>
 #include <QStyle>
+#include <QtMath>
+#include <algorithm>
 
 const int BaseMeter::LINES_MARGIN = 3;
 const int BaseMeter::MIN_SIZE = 1;
 const int BaseMeter::DEFAULT_DECAY_TIME = 2000;
 const quint8 BaseMeter::SEGMENTS_SIZE = 6;
 
+bool BaseMeter::usingPixmapCache = true;
+
 
 const int AudioMeter::MAX_PEAK_MARKER_SIZE = 2;
 const int AudioMeter::MAX_PEAK_SHOW_TIME = 1500;
@@ -57,13 +62,49 @@ void BaseMeter::resizeEvent(QResizeEvent * /*ev*/)
 }
 
 
+void BaseMeter::setUsingPixmapCache(bool usingCache)
+{
+    BaseMeter::usingPixmapCache = usingCache;
+}
+
 void BaseMeter::paintSegments(QPainter &painter, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments)
 {
     const quint32 segmentsToPaint = (quint32)peakPosition/SEGMENTS_SIZE;
 
-    if (segmentsColors.size() < segmentsToPaint)
+    if (segmentsToPaint == 0 || segmentsColors.size() < segmentsToPaint)
         return;
 
+    if (!usingPixmapCache) {
+        fillSegments(painter, rect, segmentsToPaint, segmentsColors, drawSegments);
+        return;
+    }
+
+    // blit just the lit part of the pre-rendered segments
+    const QPixmap pixmap = getSegmentsPixmap(rect, segmentsColors, drawSegments);
+    const qreal segmentsStep = drawSegments ? SEGMENTS_SIZE : (SEGMENTS_SIZE - 1);
+    const qreal litSize = (segmentsToPaint - 1) * segmentsStep + SEGMENTS_SIZE;
+
+    // the target is in widget coordinates, the source in pixmap (device) pixels
+    const qreal pixelRatio = pixmap.devicePixelRatio();
+    const qreal pixmapWidth = pixmap.width() / pixelRatio;
+    const qreal pixmapHeight = pixmap.height() / pixelRatio;
+
+    QRectF target;
+    if (isVertical()) {
+        const qreal top = qMax(0.0, rect.height() - litSize);
+        target = QRectF(rect.left(), top, pixmapWidth, pixmapHeight - top);
+    }
+    else {
+        target = QRectF(0.0, rect.top(), qMin(rect.left() + litSize, pixmapWidth), pixmapHeight);
+    }
+
+    const QRectF source(isVertical() ? 0.0 : target.left() * pixelRatio, isVertical() ? target.top() * pixelRatio : 0.0,
+                        target.width() * pixelRatio, target.height() * pixelRatio);
+    painter.drawPixmap(target, pixmap, source);
+}
+
+void BaseMeter::fillSegments(QPainter &painter, const QRectF &rect, quint32 segmentsToPaint, const std::vector<QColor> &segmentsColors, bool drawSegments)
+{
     const bool isVerticalMeter = isVertical();
 
     qreal x = rect.left();
@@ -80,6 +121,84 @@ void BaseMeter::paintSegments(QPainter &painter, const QRectF &rect, float peakP
     }
 }
 
+QPixmap BaseMeter::getSegmentsPixmap(const QRectF &rect, const std::vector<QColor> &segmentsColors, bool drawSegments)
+{
+    // The pixmap contains all segments lit. Vertical meters are rendered with x = 0 and horizontal meters
+    // with y = 0, so the same pixmap is used for all channels (translated rects) of all meters.
+    const bool isVerticalMeter = isVertical();
+    const QRectF pixmapRect = isVerticalMeter ? QRectF(0.0, rect.top(), rect.width(), rect.height())
+                                              : QRectF(rect.left(), 0.0, rect.width(), rect.height());
+    const qreal pixelRatio = devicePixelRatioF(); // sharp segments in HiDPI screens
+
+    const QString &key = getSegmentsPixmapKey(pixmapRect, pixelRatio, segmentsColors, drawSegments);
+
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    const int pixmapWidth = isVerticalMeter ? qCeil(rect.width()) : width();
+    const int pixmapHeight = isVerticalMeter ? height() : qCeil(rect.height());
+
+    pixmap = QPixmap(qMax(1, qCeil(pixmapWidth * pixelRatio)), qMax(1, qCeil(pixmapHeight * pixelRatio)));
+    pixmap.setDevicePixelRatio(pixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    fillSegments(painter, pixmapRect, segmentsColors.size(), segmentsColors, drawSegments);
+    painter.end();
+
+    QPixmapCache::insert(key, pixmap);
+
+    return pixmap;
+}
+
+const QString &BaseMeter::getSegmentsPixmapKey(const QRectF &pixmapRect, qreal pixelRatio, const std::vector<QColor> &segmentsColors, bool drawSegments)
+{
+    for (const SegmentsPixmapKey &pixmapKey : segmentsPixmapKeys) {
+        if (pixmapKey.colors == &segmentsColors && pixmapKey.pixmapRect == pixmapRect
+                && pixmapKey.pixelRatio == pixelRatio && pixmapKey.drawSegments == drawSegments)
+            return pixmapKey.key;
+    }
+
+    // the segments rect changed (stereo or peaks/RMS painting flags), the meter was moved to another screen, or a new colors vector
+    auto it = std::find_if(segmentsPixmapKeys.begin(), segmentsPixmapKeys.end(), [&](const SegmentsPixmapKey &pixmapKey) {
+        return pixmapKey.colors == &segmentsColors;
+    });
+
+    if (it == segmentsPixmapKeys.end())
+        it = segmentsPixmapKeys.insert(segmentsPixmapKeys.end(), SegmentsPixmapKey());
+
+    const bool isVerticalMeter = isVertical();
+    const int pixmapWidth = isVerticalMeter ? qCeil(pixmapRect.width()) : width();
+    const int pixmapHeight = isVerticalMeter ? height() : qCeil(pixmapRect.height());
+
+    quint32 colorsHash = 0;
+    for (const QColor &color : segmentsColors)
+        colorsHash = colorsHash * 31 + color.rgba();
+
+    it->colors = &segmentsColors;
+    it->pixmapRect = pixmapRect;
+    it->pixelRatio = pixelRatio;
+    it->drawSegments = drawSegments;
+    it->key = QString("JamtabaMeter_%1x%2_%3_%4_%5_%6_%7_%8_%9")
+            .arg(pixmapWidth)
+            .arg(pixmapHeight)
+            .arg(qRound((isVerticalMeter ? pixmapRect.height() : pixmapRect.left()) * 100))
+            .arg(qRound(pixmapRect.top() * 100))
+            .arg(qRound(pixelRatio * 100))
+            .arg(isVerticalMeter ? 1 : 0)
+            .arg(drawSegments ? 1 : 0)
+            .arg(segmentsColors.size())
+            .arg(colorsHash);
+
+    return it->key;
+}
+
+void BaseMeter::invalidateSegmentsPixmapKeys()
+{
+    segmentsPixmapKeys.clear();
+}
+
 QSize BaseMeter::minimumSizeHint() const
 {
     bool isVerticalMeter = isVertical();
@@ -92,6 +211,7 @@ QSize BaseMeter::minimumSizeHint() const
 void BaseMeter::setOrientation(Qt::Orientation orientation)
 {
     this->orientation = orientation;
+    invalidateSegmentsPixmapKeys();
     updateStyleSheet();
     update();
 }
@@ -133,6 +253,8 @@ AudioMeter::AudioMeter(QWidget *parent) :
         currentRms[i] = 0.0f;
         lastMaxPeakTime[i] = 0;
     }
+
+    paintedState = computePaintedState();
 }
 
 void AudioMeter::setDrawSegments(bool drawSegments)
@@ -204,6 +326,7 @@ void AudioMeter::recreateInterpolatedColors()
     // rebuild the peak and RMS colors vector
     peakColors.clear();
     rmsColors.clear();
+    invalidateSegmentsPixmapKeys();
 
     const quint32 size = isVertical() ? height() : width();
     const quint32 segments = size/SEGMENTS_SIZE;
@@ -287,10 +410,56 @@ qreal AudioMeter::getPeakPosition(qreal linearPeak, qreal rectSize, qreal peakVa
     return peakPosition;
 }
 
+bool AudioMeter::PaintedState::operator==(const PaintedState &other) const
+{
+    for (int i = 0; i < 2; ++i) {
+        if (peakSegments[i] != other.peakSegments[i] || rmsSegments[i] != other.rmsSegments[i])
+            return false;
+
+        if (maxPeakPosition[i] != other.maxPeakPosition[i])
+            return false;
+    }
+
+    return paintingFlags == other.paintingFlags;
+}
+
+AudioMeter::PaintedState AudioMeter::computePaintedState() const
+{
+    const static qreal peakValuesOffset = MAX_SMOOTHED_LINEAR_VALUE - 1.0f;
+    const qreal rectSize = isVertical() ? height() : width();
+
+    PaintedState state;
+    for (int i = 0; i < 2; ++i) {
+        qreal peakPosition = currentPeak[i] ? getPeakPosition(currentPeak[i], rectSize, peakValuesOffset) : 0;
+        qreal rmsPosition = currentRms[i] ? getPeakPosition(currentRms[i], rectSize, peakValuesOffset) : 0;
+        qreal maxPeakPosition = maxPeak[i] ? getPeakPosition(maxPeak[i], rectSize, peakValuesOffset) : 0;
+
+        state.peakSegments[i] = qMax(0, static_cast<int>(peakPosition)) / SEGMENTS_SIZE;
+        state.rmsSegments[i] = qMax(0, static_cast<int>(rmsPosition)) / SEGMENTS_SIZE;
+        state.maxPeakPosition[i] = maxPeak[i] ? qRound(maxPeakPosition) : -1;
+    }
+
+    state.paintingFlags = (paintingPeaks ? 1 : 0) | (paintingRMS ? 2 : 0) | (paintingMaxPeakMarker ? 4 : 0) | (stereo ? 8 : 0);
+
+    return state;
+}
+
+void AudioMeter::updateIfVisuallyChanged()
+{
+    // hidden and minimized meters are fully repainted by Qt when exposed again
+    if (!isVisible() || window()->isMinimized())
+        return;
+
+    if (!(computePaintedState() == paintedState))
+        update();
+}
+
 void AudioMeter::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
 
+    paintedState = computePaintedState();
+
     const static qreal peakValuesOffset = MAX_SMOOTHED_LINEAR_VALUE - 1.0f; // peaks are not starting at 0dB, so we need a offset
 
     if (isEnabled()) {
@@ -334,8 +503,6 @@ void AudioMeter::paintEvent(QPaintEvent *)
         if (paintingDbMarkers)
             painter.drawPixmap(0.0, 0.0, dbMarkersPixmap);
    }
-
-    updateInternalValues(); // compute decay and max peak
 }
 
 void AudioMeter::setPaintingDbMarkers(bool paintDbMarkers)
@@ -429,6 +596,8 @@ std::vector<float> AudioMeter::createDBValues()
 
 void AudioMeter::setPeak(float peak, float rms)
 {
+    updateInternalValues(); // compute decay and max peak
+
     peak = limitFloatValue(peak, 0.0f, AudioMeter::MAX_LINEAR_VALUE);
     rms = limitFloatValue(rms, 0.0f, AudioMeter::MAX_LINEAR_VALUE);
 
@@ -443,12 +612,14 @@ void AudioMeter::setPeak(float peak, float rms)
     if (rms > currentRms[0] || rms > currentRms[1])
         currentRms[0] = currentRms[1] = rms;
 
-    update();
+    updateIfVisuallyChanged();
 }
 
 
 void AudioMeter::setPeak(float leftPeak, float rightPeak, float leftRms, float rightRms)
 {
+    updateInternalValues(); // compute decay and max peak
+
     leftPeak = limitFloatValue(leftPeak, 0.0f, AudioMeter::MAX_LINEAR_VALUE);
     rightPeak = limitFloatValue(rightPeak, 0.0f, AudioMeter::MAX_LINEAR_VALUE);
 
@@ -477,7 +648,7 @@ void AudioMeter::setPeak(float leftPeak, float rightPeak, float leftRms, float r
             currentRms[i] = rms[i];
     }
 
-    update();
+    updateIfVisuallyChanged();
 }
 
 void AudioMeter::setPaintMaxPeakMarker(bool paintMaxPeak)
@@ -526,6 +697,7 @@ MidiActivityMeter::MidiActivityMeter(QWidget *parent) :
 void MidiActivityMeter::recreateInterpolatedColors()
 {
     colors.clear();
+    invalidateSegmentsPixmapKeys();
 
     const quint32 size = isVertical() ? height() : width();
     const quint32 segments = size/SEGMENTS_SIZE;
@@ -16,6 +16,10 @@ public:
     QSize minimumSizeHint() const override;
     virtual void updateStyleSheet();
 
+    // when enabled (default) the lit segments are pre-rendered in pixmaps shared by all meters with same size and colors
+    static void setUsingPixmapCache(bool usingCache);
+    static bool isUsingPixmapCache();
+
 protected:
 
     virtual void recreateInterpolatedColors() = 0;
@@ -26,6 +30,8 @@ protected:
 
     bool isVertical() const;
 
+    void invalidateSegmentsPixmapKeys(); // call when the meter size, orientation or colors are changed
+
     static float limitFloatValue(float value, float minValue = 0.0f, float maxValue = 1.0f);
 
     qint64 lastUpdate;
@@ -39,6 +45,25 @@ protected:
     static const int LINES_MARGIN;
     static const int MIN_SIZE;
     static const int DEFAULT_DECAY_TIME;
+
+private:
+    void fillSegments(QPainter &painter, const QRectF &rect, quint32 segmentsToPaint, const std::vector<QColor> &segmentsColors, bool drawSegments);
+    QPixmap getSegmentsPixmap(const QRectF &rect, const std::vector<QColor> &segmentsColors, bool drawSegments);
+    const QString &getSegmentsPixmapKey(const QRectF &pixmapRect, qreal pixelRatio, const std::vector<QColor> &segmentsColors, bool drawSegments);
+
+    // the pixmap cache keys are built once per colors vector (peaks and RMS), not in every paint
+    struct SegmentsPixmapKey
+    {
+        const std::vector<QColor> *colors;
+        QRectF pixmapRect;
+        qreal pixelRatio;
+        bool drawSegments;
+        QString key;
+    };
+
+    std::vector<SegmentsPixmapKey> segmentsPixmapKeys;
+
+    static bool usingPixmapCache;
 };
 
 inline bool BaseMeter::isVertical() const
@@ -46,6 +71,11 @@ inline bool BaseMeter::isVertical() const
     return orientation == Qt::Vertical;
 }
 
+inline bool BaseMeter::isUsingPixmapCache()
+{
+    return usingPixmapCache;
+}
+
 //========================================================================
 
 class AudioMeter : public BaseMeter
@@ -127,6 +157,22 @@ private:
 
     bool stereo; // draw 2 meters?
 
+    // what is visible on screen, used to skip repaints when the peak values change less than a segment
+    struct PaintedState
+    {
+        int peakSegments[2];
+        int rmsSegments[2];
+        int maxPeakPosition[2];
+        int paintingFlags;
+
+        bool operator==(const PaintedState &other) const;
+    };
+
+    PaintedState paintedState;
+
+    PaintedState computePaintedState() const;
+    void updateIfVisuallyChanged();
+
     QPixmap dbMarkersPixmap;
     bool paintingDbMarkers;
 
@@ -28,6 +28,7 @@ Q_DECLARE_LOGGING_CATEGORY(jtMidi)
 // Q_DECLARE_LOGGING_CATEGORY(jtJoystick) ToDOooo
 Q_DECLARE_LOGGING_CATEGORY(jtConfigurator)
 Q_DECLARE_LOGGING_CATEGORY(jtMetronome)
+Q_DECLARE_LOGGING_CATEGORY(jtLoops)
 
 void jamtabaLogHandler(QtMsgType, const QMessageLogContext &, const QString &);
 
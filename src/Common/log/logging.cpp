@@ -20,3 +20,4 @@ Q_LOGGING_CATEGORY(jtAudio,                 "jt.Audio")
 Q_LOGGING_CATEGORY(jtMidi,                  "jt.Midi")
 Q_LOGGING_CATEGORY(jtConfigurator,          "jt.Configurator")
 Q_LOGGING_CATEGORY(jtMetronome,             "jt.Metronome")
+Q_LOGGING_CATEGORY(jtLoops,                 "jt.Loops")
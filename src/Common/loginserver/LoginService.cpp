@@ -26,6 +26,11 @@ UserInfo::UserInfo(long long id, const QString &name, const QString &ip) :
     //
 }
 
+bool UserInfo::operator==(const UserInfo &other) const
+{
+    return id == other.id && name == other.name && ip == other.ip;
+}
+
 RoomInfo::RoomInfo(long long id, const QString &roomName, int roomPort, RoomTYPE roomType,
                    int maxUsers, const QList<UserInfo> &users, int maxChannels, int bpi, int bpm, const QString &streamUrl) :
     id(id),
@@ -63,6 +68,20 @@ bool RoomInfo::isEmpty() const
     return getNonBotUsersCount() == 0;
 }
 
+bool RoomInfo::operator==(const RoomInfo &other) const
+{
+    return id == other.id
+            && name == other.name
+            && port == other.port
+            && type == other.type
+            && maxUsers == other.maxUsers
+            && maxChannels == other.maxChannels
+            && bpi == other.bpi
+            && bpm == other.bpm
+            && streamUrl == other.streamUrl
+            && users == other.users;
+}
+
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 class HttpParamsFactory
@@ -147,6 +166,8 @@ void LoginService::connectInServer(const QString &userName, int instrumentID,
                                                                    sampleRate);
     qCDebug(jtLoginService) << "Connecting in server ...";
 
+    lastPublicRooms.clear();
+
     pendingReply = sendCommandToServer(query);
 
     if (pendingReply) {
@@ -289,16 +310,15 @@ void LoginService::connectedSlot()
 
 void LoginService::roomsListReceivedSlot()
 {
-    QString json = QString(pendingReply->readAll());
-    handleJson(json);
+    handleJson(pendingReply->readAll());
 }
 
-void LoginService::handleJson(const QString &json)
+void LoginService::handleJson(const QByteArray &json)
 {
     if (json.isEmpty())
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(QByteArray(json.toStdString().c_str()));
+    QJsonDocument document = QJsonDocument::fromJson(json);
     QJsonObject root = document.object();
     if (!connected) { // first time handling json?
         bool clientIsServerCompatible = root.contains("clientCompatibility") && root["clientCompatibility"].toBool();
@@ -337,6 +357,11 @@ void LoginService::handleJson(const QString &json)
         QString key = getRoomInfoUniqueName(roomInfo);
         lastChordProgressions.insert(key, lastChordProgression);
     }
+
+    if (publicRooms == lastPublicRooms)
+        return; // nothing changed since the last refresh
+
+    lastPublicRooms = publicRooms;
     emit roomsListAvailable(publicRooms);
 }
 
@@ -19,6 +19,9 @@ public:
     inline QString getIp() const { return ip; }
     inline QString getName() const { return name; }
 
+    bool operator==(const UserInfo &other) const;
+    inline bool operator!=(const UserInfo &other) const { return !(*this == other); }
+
 private:
     long long id;
     QString name;
@@ -66,6 +69,9 @@ public:
     int getBpm() const;
     int getBpi() const;
 
+    bool operator==(const RoomInfo &other) const; // compare all fields, including the users list
+    bool operator!=(const RoomInfo &other) const;
+
 protected:
     long long id;
 
@@ -151,6 +157,11 @@ inline RoomTYPE RoomInfo::getType() const
     return type;
 }
 
+inline bool RoomInfo::operator!=(const RoomInfo &other) const
+{
+    return !(*this == other);
+}
+
 // +++++++++++++++++++++++++++++++++++++++++++++++++++
 
 class LoginService : public QObject
@@ -194,8 +205,9 @@ private:
 
     QMap<QString, QString> lastChordProgressions;
 
+    QList<RoomInfo> lastPublicRooms; // the rooms list is emitted only when something changed
 
-    void handleJson(const QString &json);
+    void handleJson(const QByteArray &json);
 
     QNetworkReply *sendCommandToServer(const QUrlQuery &, bool synchronous = false);
 
@@ -0,0 +1,103 @@
+#ifndef _LOOP_INFO_H_
+#define _LOOP_INFO_H_
+
+#include <QString>
+#include <QList>
+
+namespace Audio {
+
+struct LoopLayerInfo
+{
+    float pan;
+    float gain;
+    bool locked;
+};
+
+class LoopInfo
+{
+public:
+    LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool usingEncodedAudio, quint8 mode);
+    LoopInfo();
+
+    static LoopInfo loadFromFile(const QString &loopFilePath); // read the loop json file, the audio files are not loaded
+
+    void addLayer(bool isLocked, float gain, float pan);
+
+    bool isValid() const;
+
+    QString toString(bool showBpm = false) const;
+
+    quint8 getLayersCount() const;
+
+    bool audioIsEncoded() const;
+
+    QString getName() const;
+
+    QList<LoopLayerInfo> getLayersInfo() const;
+
+    quint8 getLooperMode() const;
+
+    quint16 getBpi() const;
+    quint32 getBpm() const;
+
+    quint32 getSampleRate() const; // zero in loops saved by older versions
+    void setSampleRate(quint32 sampleRate);
+
+private:
+    quint32 bpm;
+    quint16 bpi;
+    quint32 sampleRate;
+    QString name;
+    bool usingEncodedAudio;
+    QList<LoopLayerInfo> layers;
+    quint8 looperMode;
+};
+
+inline quint16 LoopInfo::getBpi() const
+{
+    return bpi;
+}
+
+inline quint32 LoopInfo::getBpm() const
+{
+    return bpm;
+}
+
+inline quint32 LoopInfo::getSampleRate() const
+{
+    return sampleRate;
+}
+
+inline void LoopInfo::setSampleRate(quint32 sampleRate)
+{
+    this->sampleRate = sampleRate;
+}
+
+inline quint8 LoopInfo::getLooperMode() const
+{
+    return looperMode;
+}
+
+inline quint8 LoopInfo::getLayersCount() const
+{
+    return layers.size();
+}
+
+inline bool LoopInfo::audioIsEncoded() const
+{
+    return usingEncodedAudio;
+}
+
+inline QString LoopInfo::getName() const
+{
+    return name;
+}
+
+inline QList<LoopLayerInfo> LoopInfo::getLayersInfo() const
+{
+    return layers;
+}
+
+} // namespace
+
+#endif
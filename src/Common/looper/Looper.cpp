@@ -536,6 +536,12 @@ void Looper::processChangeRequests()
     }
 }
 
+void Looper::reserve(uint samplesInCycle)
+{
+    for (quint8 l = 0; l < MAX_LOOP_LAYERS; ++l)
+        layers[l]->reserve(samplesInCycle);
+}
+
 void Looper::startNewCycle(uint samplesInCycle)
 {
     if (samplesInCycle != intervalLenght)
@@ -55,6 +55,7 @@ public:
     void setLayerSamples(quint8 layer, const SamplesBuffer &samples);
 
     void startNewCycle(uint samplesInCycle);
+    void reserve(uint samplesInCycle); // allocate the layers memory out of the audio thread, before a longer cycle starts
 
     void selectLayer(quint8 layerIndex);
     bool canSelectLayers() const;
@@ -10,6 +10,14 @@
 using namespace Audio;
 using namespace std;
 
+const uint LooperLayer::PEAKS_CACHE_CAPACITY = 4096; // more than one peak per pixel in the looper wave panels
+
+LooperLayer::Storage::Storage(uint samples) :
+    leftChannel(samples, 0.0f),
+    rightChannel(samples, 0.0f)
+{
+}
+
 LooperLayer::LooperLayer()
     : availableSamples(0),
       lastSamplesPerPeak(0),
@@ -20,14 +28,67 @@ LooperLayer::LooperLayer()
       pan(0),
       leftGain(1),
       rightGain(1),
-      muteState(MuteState::Unmuted)
+      muteState(MuteState::Unmuted),
+      reservedStorage(nullptr),
+      releasedStorage(nullptr),
+      storageSize(0)
 {
     setPan(0); // center
+
+    peaksCache.reserve(PEAKS_CACHE_CAPACITY); // avoid the peaks cache growing in the audio thread when recording
 }
 
 LooperLayer::~LooperLayer()
 {
+    delete reservedStorage.fetchAndStoreOrdered(nullptr);
+    delete releasedStorage.fetchAndStoreOrdered(nullptr);
+}
+
+void LooperLayer::reserve(uint samplesPerCycle)
+{
+    delete releasedStorage.fetchAndStoreAcquire(nullptr); // the channels replaced in the last cycles
+
+    if (samplesPerCycle <= static_cast<uint>(storageSize.loadAcquire()))
+        return;
+
+    Storage *storage = reservedStorage.fetchAndStoreAcquire(nullptr);
+    if (!storage || storage->leftChannel.size() < samplesPerCycle) {
+        delete storage;
+        storage = new Storage(samplesPerCycle);
+    }
+
+    // only the audio thread is taking the reserved storage, the slot is still empty
+    if (!reservedStorage.testAndSetRelease(nullptr, storage))
+        delete storage;
+}
+
+void LooperLayer::releaseStorage(Storage *storage)
+{
+    // deleted in the next reserve() call, out of the audio thread. Deleting here just when the last released storage was not collected yet
+    if (storage && !releasedStorage.testAndSetRelease(nullptr, storage))
+        delete storage;
+}
+
+void LooperLayer::growChannels(quint32 samplesPerCycle)
+{
+    Storage *storage = reservedStorage.fetchAndStoreAcquire(nullptr);
+    if (storage && storage->leftChannel.size() >= samplesPerCycle) {
+        const uint samplesToCopy = qMin(availableSamples, static_cast<uint>(leftChannel.size()));
+        if (samplesToCopy) {
+            std::memcpy(&(storage->leftChannel[0]), &(leftChannel[0]), samplesToCopy * sizeof(float));
+            std::memcpy(&(storage->rightChannel[0]), &(rightChannel[0]), samplesToCopy * sizeof(float));
+        }
+        leftChannel.swap(storage->leftChannel);
+        rightChannel.swap(storage->rightChannel);
+    }
+    else { // reserve() was not called, allocating in the audio thread
+        leftChannel.resize(samplesPerCycle);
+        rightChannel.resize(samplesPerCycle);
+    }
+
+    releaseStorage(storage);
 
+    storageSize.storeRelease(static_cast<int>(leftChannel.size()));
 }
 
 void LooperLayer::reset()
@@ -252,11 +313,8 @@ std::vector<float> LooperLayer::getSamplesPeaks(uint samplesPerPeak)
 
 void LooperLayer::resize(quint32 samplesPerCycle)
 {
-    if (samplesPerCycle > leftChannel.capacity())
-        leftChannel.resize(samplesPerCycle);
-
-    if (samplesPerCycle > rightChannel.capacity())
-        rightChannel.resize(samplesPerCycle);
+    if (samplesPerCycle > leftChannel.size())
+        growChannels(samplesPerCycle);
 
     if (availableSamples && samplesPerCycle > availableSamples) { // need copy samples?
         uint initialAvailableSamples = availableSamples;
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <QtGlobal>
+#include <QAtomicPointer>
+#include <QAtomicInt>
 
 namespace Audio {
 
@@ -35,6 +37,9 @@ public:
 
     void prepareForNewCycle(uint samplesInNewCycle, bool isOverdubbing);
 
+    // called out of the audio thread when a longer cycle is scheduled, the memory is allocated here and used in prepareForNewCycle
+    void reserve(uint samplesPerCycle);
+
     float computeMaxPeak(uint from, uint samplesPerPeak) const;
 
     std::vector<float> getSamplesPeaks(uint samplesPerPeak);
@@ -62,9 +67,20 @@ public:
     uint getAvailableSamples() const;
 
 private:
+    struct Storage
+    {
+        explicit Storage(uint samples);
+        std::vector<float> leftChannel;
+        std::vector<float> rightChannel;
+    };
+
     std::vector<float> leftChannel;
     std::vector<float> rightChannel;
 
+    QAtomicPointer<Storage> reservedStorage; // allocated out of the audio thread, used when a longer cycle starts
+    QAtomicPointer<Storage> releasedStorage; // the replaced channels, deleted out of the audio thread
+    QAtomicInt storageSize; // the channels size, read out of the audio thread
+
     std::vector<float> peaksCache;
     uint lastSamplesPerPeak;
     uint availableSamples;
@@ -81,6 +97,10 @@ private:
     MuteState muteState;
 
     void resize(quint32 samplesPerCycle);
+    void growChannels(quint32 samplesPerCycle);
+    void releaseStorage(Storage *storage);
+
+    static const uint PEAKS_CACHE_CAPACITY;
 
 };
 
@@ -12,54 +12,6 @@
 
 using namespace Audio;
 
-LoopInfo::LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool audioIsEncoded, quint8 mode) :
-    bpm(bpm),
-    bpi(bpi),
-    name(name),
-    usingEncodedAudio(audioIsEncoded),
-    looperMode(mode)
-{
-    //
-}
-
-LoopInfo::LoopInfo()
-    : LoopInfo(0, 0, QString(), false, 0) // calling overloaded constructor
-{
-    //
-}
-
-bool LoopInfo::isValid() const
-{
-    return !name.isEmpty() && bpm > 0 && bpi > 0 && layers.size() > 0;
-}
-
-QString LoopInfo::toString(bool showBpm) const
-{
-    QString text = name;
-    text += " (";
-
-    if (showBpm)
-        text += QString::number(bpm) + " BPM, ";
-
-    text += QString::number(bpi) + " BPI, ";
-    text += QString::number(layers.size()) + " layers";
-
-    text += ")";
-
-    return text;
-}
-
-void LoopInfo::addLayer(bool isLocked, float gain, float pan)
-{
-    LoopLayerInfo layerInfo;
-    layerInfo.locked = isLocked;
-    layerInfo.gain = gain;
-    layerInfo.pan = pan;
-    layers.append(layerInfo);
-}
-
-// -------------------------------------------------------------------
-
 LoopSaver::LoopSaver(const QString &savePath, Looper *looper) :
     savePath(savePath),
     looper(looper)
@@ -103,6 +55,7 @@ void LoopSaver::save(const QString &loopFileName, uint bpm, uint bpi, bool encod
         QJsonObject root;
         root["bpm"] = static_cast<int>(bpm);
         root["bpi"] = static_cast<int>(bpi);
+        root["sampleRate"] = static_cast<int>(sampleRate);
         root["loopLenght"] = static_cast<int>(looper->getIntervalLenght());
         root["audioFormat"] = encodeInOggVorbis ? "ogg" : "wave";
         root["looperMode"] = static_cast<int>(looper->getMode());
@@ -241,56 +194,10 @@ QList<LoopInfo> LoopLoader::loadLoopsInfo(const QString &loadPath, quint32 bpmTo
     QFileInfoList fileInfoList = loadDir.entryInfoList(QStringList("*.json"), filters);
     for (const QFileInfo &fileInfo : fileInfoList) {
         QString loopFilePath = fileInfo.absoluteFilePath();
-        LoopInfo loopInfo = LoopLoader::loadLoopInfo(loopFilePath);
+        LoopInfo loopInfo = LoopInfo::loadFromFile(loopFilePath);
         if (loopInfo.isValid() && loopInfo.getBpm() == bpmToMatch)
             allInfos.append(loopInfo);
     }
 
     return allInfos;
 }
-
-LoopInfo LoopLoader::loadLoopInfo(const QString &loopFilePath)
-{
-    QFile file(loopFilePath);
-    if (!file.open(QFile::ReadOnly)) {
-        qCritical() << "Error loading loop metada:" << file.errorString();
-        return LoopInfo();
-    }
-
-    if (QFileInfo(file).suffix() != "json") {
-        qCritical() << "Error loading loop metada, not a json file" << loopFilePath;
-        return LoopInfo();
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    QJsonObject root = doc.object();
-
-    quint32 bpm = (root.contains("bpm") ? (root["bpm"].toInt()) : 0);
-    quint16 bpi = (root.contains("bpi") ? (root["bpi"].toInt()) : 0);
-    bool audioIsEncoded = root.contains("audioFormat") && root["audioFormat"].toString() == "ogg";
-    QString loopName = QFileInfo(file).baseName();
-    quint8 looperMode = root.contains("looperMode") ? root["looperMode"].toInt() : 0;
-
-    LoopInfo loopInfo(bpm, bpi, loopName, audioIsEncoded, looperMode);
-
-    if (root.contains("layers")) {
-        if (root["layers"].isArray()) { // new loop file format
-            QJsonArray layers = root["layers"].toArray();
-            for (int i = 0; i < layers.size(); ++i) {
-                QJsonObject layer = layers.at(i).toObject();
-                bool isLocked = layer.contains("locked") ? layer["locked"].toBool() : false;
-                float gain = layer.contains("gain") ? layer["gain"].toDouble() : 1.0;
-                float pan = layer.contains("pan") ? layer["pan"].toDouble() : 0.0;
-                loopInfo.addLayer(isLocked, gain, pan);
-            }
-        }
-        else { // using old loop file format
-            int layers = root["layers"].toInt(0);
-            for (int l = 0; l < layers; ++l) {
-                loopInfo.addLayer(false, 1.0, 0.0);
-            }
-        }
-    }
-
-    return loopInfo;
-}
@@ -1,6 +1,8 @@
 #ifndef _LOOPER_PERSISTENCE_H_
 #define _LOOPER_PERSISTENCE_H_
 
+#include "LoopInfo.h"
+
 #include <QString>
 #include <QSet>
 #include <QList>
@@ -29,84 +31,6 @@ private:
 
 };
 
-// +++++++++++++++++++++++++++++++++++++++++++++++++++++=
-
-struct LoopLayerInfo
-{
-    float pan;
-    float gain;
-    bool locked;
-};
-
-class LoopInfo
-{
-public:
-    LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool usingEncodedAudio, quint8 mode);
-    LoopInfo();
-
-    void addLayer(bool isLocked, float gain, float pan);
-
-    bool isValid() const;
-
-    QString toString(bool showBpm = false) const;
-
-    quint8 getLayersCount() const;
-
-    bool audioIsEncoded() const;
-
-    QString getName() const;
-
-    QList<LoopLayerInfo> getLayersInfo() const;
-
-    quint8 getLooperMode() const;
-
-    quint16 getBpi() const;
-    quint32 getBpm() const;
-
-private:
-    quint32 bpm;
-    quint16 bpi;
-    QString name;
-    bool usingEncodedAudio;
-    QList<LoopLayerInfo> layers;
-    quint8 looperMode;
-};
-
-inline quint16 LoopInfo::getBpi() const
-{
-    return bpi;
-}
-
-inline quint32 LoopInfo::getBpm() const
-{
-    return bpm;
-}
-
-inline quint8 LoopInfo::getLooperMode() const
-{
-    return looperMode;
-}
-
-inline quint8 LoopInfo::getLayersCount() const
-{
-    return layers.size();
-}
-
-inline bool LoopInfo::audioIsEncoded() const
-{
-    return usingEncodedAudio;
-}
-
-inline QString LoopInfo::getName() const
-{
-    return name;
-}
-
-inline QList<LoopLayerInfo> LoopInfo::getLayersInfo() const
-{
-    return layers;
-}
-
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=
 
 class LoopLoader
@@ -116,7 +40,6 @@ public:
     explicit LoopLoader(const QString &loadPath);
     void load(LoopInfo loopInfo, Looper *looper, uint currentSampleRate, quint32 samplesPerInterval);
 
-    static LoopInfo loadLoopInfo(const QString &loopFilePath);
     static QList<LoopInfo> loadLoopsInfo(const QString &loadPath, quint32 bpmToMatch);
     static bool loadAudioFile(const QString &filePath, uint currentSampleRate, SamplesBuffer &out);
 
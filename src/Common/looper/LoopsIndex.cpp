@@ -0,0 +1,302 @@
+#include "LoopsIndex.h"
+#include "persistence/CacheHeader.h"
+#include "log/Logging.h"
+
+#include <QFileSystemWatcher>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QTimer>
+#include <QSet>
+
+using namespace Audio;
+
+const quint32 LoopsIndexer::INDEX_REVISION = 1;
+const QString LoopsIndex::INDEX_FILE_NAME("loops_index.bin");
+
+QDataStream &operator<<(QDataStream &stream, const LoopsIndexEntry &entry)
+{
+    const LoopInfo &info = entry.loopInfo;
+    stream << entry.fileName
+           << entry.lastModified
+           << info.getName()
+           << info.getBpm()
+           << info.getBpi()
+           << info.getSampleRate()
+           << info.audioIsEncoded()
+           << info.getLooperMode();
+
+    QList<LoopLayerInfo> layers = info.getLayersInfo();
+    stream << static_cast<quint8>(layers.size());
+    for (const LoopLayerInfo &layer : layers)
+        stream << layer.locked << layer.gain << layer.pan;
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, LoopsIndexEntry &entry)
+{
+    QString name;
+    quint32 bpm;
+    quint16 bpi;
+    quint32 sampleRate;
+    bool audioIsEncoded;
+    quint8 looperMode;
+    quint8 layers;
+
+    stream >> entry.fileName
+           >> entry.lastModified
+           >> name
+           >> bpm
+           >> bpi
+           >> sampleRate
+           >> audioIsEncoded
+           >> looperMode
+           >> layers;
+
+    LoopInfo info(bpm, bpi, name, audioIsEncoded, looperMode);
+    info.setSampleRate(sampleRate);
+    for (quint8 l = 0; l < layers; ++l) {
+        bool locked;
+        float gain;
+        float pan;
+        stream >> locked >> gain >> pan;
+        info.addLayer(locked, gain, pan);
+    }
+    entry.loopInfo = info;
+
+    return stream;
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=
+
+LoopsIndexer::LoopsIndexer(const QString &indexFilePath) :
+    indexFilePath(indexFilePath),
+    watcher(nullptr),
+    scanTimer(nullptr)
+{
+
+}
+
+void LoopsIndexer::setLoopsPath(const QString &loopsPath)
+{
+    if (loopsPath == this->loopsPath)
+        return;
+
+    if (!watcher) {
+        watcher = new QFileSystemWatcher(this);
+
+        scanTimer = new QTimer(this);
+        scanTimer->setSingleShot(true);
+        scanTimer->setInterval(500);
+
+        connect(watcher, &QFileSystemWatcher::directoryChanged, scanTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+        connect(scanTimer, &QTimer::timeout, this, &LoopsIndexer::scan);
+    }
+
+    if (!this->loopsPath.isEmpty())
+        watcher->removePath(this->loopsPath);
+
+    this->loopsPath = loopsPath;
+
+    entries.clear();
+    emit entriesCleared();
+
+    loadIndexFile(); // the indexed loops are available before the scan
+
+    scan();
+}
+
+void LoopsIndexer::scan()
+{
+    if (loopsPath.isEmpty())
+        return;
+
+    if (watcher->directories().isEmpty() && QDir(loopsPath).exists())
+        watcher->addPath(loopsPath); // the loops folder is created when the first loop is saved
+
+    QList<LoopsIndexEntry> changedEntries;
+    QStringList removedFiles;
+    QSet<QString> existingFiles;
+
+    QDir loadDir(loopsPath);
+    QDir::Filters filters = QDir::NoDotAndDotDot | QDir::Files;
+    QFileInfoList fileInfoList = loadDir.entryInfoList(QStringList("*.json"), filters);
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        QString fileName = fileInfo.fileName();
+        qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+        existingFiles.insert(fileName);
+
+        auto it = entries.find(fileName);
+        if (it != entries.end() && it->lastModified == lastModified)
+            continue; // not changed, the json file is not parsed
+
+        LoopsIndexEntry entry;
+        entry.fileName = fileName;
+        entry.lastModified = lastModified;
+        entry.loopInfo = LoopInfo::loadFromFile(fileInfo.absoluteFilePath()); // invalid loops are indexed too, so they are not parsed again
+
+        entries.insert(fileName, entry);
+        changedEntries.append(entry);
+    }
+
+    for (const QString &fileName : entries.keys()) {
+        if (!existingFiles.contains(fileName)) {
+            entries.remove(fileName);
+            removedFiles.append(fileName);
+        }
+    }
+
+    if (changedEntries.isEmpty() && removedFiles.isEmpty())
+        return;
+
+    qCDebug(jtLoops) << "Loops index updated:" << changedEntries.size() << "changed loops," << removedFiles.size() << "removed loops";
+
+    emit entriesChanged(changedEntries, removedFiles);
+
+    writeIndexFile();
+}
+
+void LoopsIndexer::loadIndexFile()
+{
+    QFile indexFile(indexFilePath);
+    if (!indexFile.open(QFile::ReadOnly))
+        return;
+
+    QDataStream stream(&indexFile);
+
+    CacheHeader header;
+    stream >> header;
+    if (!header.isValid(INDEX_REVISION)) {
+        qCCritical(jtLoops) << "Invalid loops index header, the index will be rebuilt.";
+        return;
+    }
+
+    QString indexedPath;
+    stream >> indexedPath;
+    if (indexedPath != loopsPath)
+        return; // the loops folder was changed
+
+    QList<LoopsIndexEntry> loadedEntries;
+    stream >> loadedEntries;
+    if (stream.status() != QDataStream::Ok) {
+        qCCritical(jtLoops) << "Error reading the loops index, the index will be rebuilt.";
+        return;
+    }
+
+    for (const LoopsIndexEntry &entry : loadedEntries)
+        entries.insert(entry.fileName, entry);
+
+    if (!loadedEntries.isEmpty())
+        emit entriesChanged(loadedEntries, QStringList());
+}
+
+void LoopsIndexer::writeIndexFile()
+{
+    QSaveFile indexFile(indexFilePath); // the old index is replaced only when the new index is completely written
+    if (!indexFile.open(QFile::WriteOnly)) {
+        qCCritical(jtLoops) << "Error writing the loops index:" << indexFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&indexFile);
+    stream << CacheHeader(INDEX_REVISION);
+    stream << loopsPath;
+    stream << entries.values();
+
+    indexFile.commit();
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=
+
+LoopsIndex::LoopsIndex(const QDir &cacheDir) :
+    indexer(new LoopsIndexer(cacheDir.absoluteFilePath(INDEX_FILE_NAME)))
+{
+    qRegisterMetaType<QList<Audio::LoopsIndexEntry>>("QList<Audio::LoopsIndexEntry>");
+
+    indexerThread.setObjectName("LoopsIndexer");
+    indexer->moveToThread(&indexerThread);
+
+    connect(&indexerThread, &QThread::finished, indexer, &QObject::deleteLater);
+
+    // queued connections, the indexer is running in another thread
+    connect(this, &LoopsIndex::loopsPathChanged, indexer, &LoopsIndexer::setLoopsPath);
+    connect(this, &LoopsIndex::scanRequested, indexer, &LoopsIndexer::scan);
+    connect(indexer, &LoopsIndexer::entriesChanged, this, &LoopsIndex::updateEntries);
+    connect(indexer, &LoopsIndexer::entriesCleared, this, &LoopsIndex::clearEntries);
+
+    indexerThread.start(QThread::LowPriority);
+}
+
+LoopsIndex::~LoopsIndex()
+{
+    indexerThread.quit();
+    indexerThread.wait();
+}
+
+void LoopsIndex::setLoopsPath(const QString &loopsPath)
+{
+    emit loopsPathChanged(loopsPath);
+}
+
+void LoopsIndex::rescan()
+{
+    emit scanRequested();
+}
+
+QList<LoopInfo> LoopsIndex::getLoops(quint32 bpm) const
+{
+    QList<LoopInfo> loops;
+
+    auto it = loopsByBpm.find(bpm);
+    if (it == loopsByBpm.end())
+        return loops;
+
+    for (const LoopInfo &loopInfo : it.value()) {
+        if (loopInfo.isValid())
+            loops.append(loopInfo);
+    }
+
+    return loops;
+}
+
+void LoopsIndex::updateEntries(const QList<LoopsIndexEntry> &changedEntries, const QStringList &removedFiles)
+{
+    for (const QString &fileName : removedFiles)
+        removeEntry(fileName);
+
+    for (const LoopsIndexEntry &entry : changedEntries) {
+        removeEntry(entry.fileName); // the loop BPM can be changed
+        quint32 bpm = entry.loopInfo.getBpm();
+        loopsByBpm[bpm].insert(entry.fileName, entry.loopInfo);
+        filesBpm.insert(entry.fileName, bpm);
+    }
+
+    emit loopsChanged();
+}
+
+void LoopsIndex::clearEntries()
+{
+    loopsByBpm.clear();
+    filesBpm.clear();
+
+    emit loopsChanged();
+}
+
+void LoopsIndex::removeEntry(const QString &fileName)
+{
+    auto it = filesBpm.find(fileName);
+    if (it == filesBpm.end())
+        return;
+
+    auto bpmLoops = loopsByBpm.find(it.value());
+    if (bpmLoops != loopsByBpm.end()) {
+        bpmLoops->remove(fileName);
+        if (bpmLoops->isEmpty())
+            loopsByBpm.erase(bpmLoops);
+    }
+
+    filesBpm.erase(it);
+}
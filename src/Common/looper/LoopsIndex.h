@@ -0,0 +1,107 @@
+#ifndef _LOOPS_INDEX_H_
+#define _LOOPS_INDEX_H_
+
+#include "LoopInfo.h"
+
+#include <QObject>
+#include <QThread>
+#include <QDir>
+#include <QMap>
+#include <QHash>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace Audio {
+
+struct LoopsIndexEntry
+{
+    QString fileName; // the loop json file name
+    qint64 lastModified; // in ms since epoch, used to detect changed files without parsing them
+    LoopInfo loopInfo;
+};
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=
+
+/**
+ * Runs in the LoopsIndex thread. Compare the loop files modification time with the indexed entries
+ * and parse only new or changed json files. The index is persisted in the cache dir, so the loops
+ * are available right after the app start, before the first scan.
+ */
+
+class LoopsIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LoopsIndexer(const QString &indexFilePath);
+
+public slots:
+    void setLoopsPath(const QString &loopsPath);
+    void scan();
+
+signals:
+    void entriesChanged(const QList<Audio::LoopsIndexEntry> &changedEntries, const QStringList &removedFiles);
+    void entriesCleared();
+
+private:
+    void loadIndexFile();
+    void writeIndexFile();
+
+    QString indexFilePath;
+    QString loopsPath;
+    QMap<QString, LoopsIndexEntry> entries; // file name as key
+
+    QFileSystemWatcher *watcher; // created in the indexer thread
+    QTimer *scanTimer; // debounce the watcher notifications, a saved loop changes the directory many times
+
+    static const quint32 INDEX_REVISION;
+};
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=
+
+/**
+ * A persistent index of the saved loops, kept updated in background by a LoopsIndexer watching the loops folder.
+ * The index is queried in the GUI thread and the loops are grouped by BPM, so building the looper load menu
+ * doesn't touch the disk.
+ */
+
+class LoopsIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LoopsIndex(const QDir &cacheDir);
+    ~LoopsIndex();
+
+    void setLoopsPath(const QString &loopsPath);
+    void rescan(); // called after saving a loop, overwritten files are not always notified by the watcher
+
+    QList<LoopInfo> getLoops(quint32 bpm) const; // valid loops only, sorted by name
+
+signals:
+    void loopsChanged();
+    void loopsPathChanged(const QString &loopsPath);
+    void scanRequested();
+
+private slots:
+    void updateEntries(const QList<Audio::LoopsIndexEntry> &changedEntries, const QStringList &removedFiles);
+    void clearEntries();
+
+private:
+    void removeEntry(const QString &fileName);
+
+    QThread indexerThread;
+    LoopsIndexer *indexer;
+
+    QMap<quint32, QMap<QString, LoopInfo>> loopsByBpm; // BPM -> (file name -> loop)
+    QHash<QString, quint32> filesBpm; // file name -> BPM, used to remove or move changed loops
+
+    static const QString INDEX_FILE_NAME;
+};
+
+} // namespace
+
+Q_DECLARE_METATYPE(Audio::LoopsIndexEntry)
+
+#endif
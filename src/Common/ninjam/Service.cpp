@@ -10,10 +10,19 @@
 #include <QTcpSocket>
 #include "ServerMessagesHandler.h"
 
+#if defined(Q_OS_LINUX)
+    #include <sys/ioctl.h>
+    #include <linux/sockios.h>
+#elif defined(Q_OS_MAC)
+    #include <sys/socket.h>
+#endif
+
 using namespace Ninjam;
 
 const QStringList Service::botNames = buildBotNamesList();
 
+const int Service::UPLOAD_DRAIN_CHECK_PERIOD = 10;
+
 /**
     This is a nested class used to bind the downloaded audio data (encoded in ogg vorbis) with a GUID (global unique ID),
     an user name and a channel index (users can use more than one channel). When a dowload is finished (the ninjam audio interval is
@@ -85,12 +94,16 @@ private:
 
 Service::Service() :
     lastSendTime(0),
+    totalBytesSent(0),
     initialized(false),
     socket(nullptr),
     messagesHandler(new ServerMessagesHandler(this)),
     serverKeepAlivePeriod(30)
 {
+    uploadClock.start();
 
+    uploadDrainTimer.setInterval(UPLOAD_DRAIN_CHECK_PERIOD);
+    connect(&uploadDrainTimer, SIGNAL(timeout()), this, SLOT(checkIntervalUploadCompletion()));
 }
 
 Service::~Service()
@@ -102,6 +115,7 @@ Service::~Service()
     disconnect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(handleSocketError(QAbstractSocket::SocketError)));
     disconnect(socket, SIGNAL(disconnected()), this, SLOT(handleSocketDisconnection()));
     disconnect(socket, SIGNAL(connected()), this, SLOT(handleSocketConnection()));
+    disconnect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(handleBytesWritten()));
 
     if (socket->isValid() && socket->isOpen())
         socket->disconnectFromHost();
@@ -114,6 +128,7 @@ void Service::setupSocketSignals()
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(handleSocketError(QAbstractSocket::SocketError)));
     connect(socket, SIGNAL(disconnected()), this, SLOT(handleSocketDisconnection()));
     connect(socket, SIGNAL(connected()), this, SLOT(handleSocketConnection()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(handleBytesWritten()));
 }
 
 void Service::sendIntervalPart(const QByteArray &GUID, const QByteArray &encodedData,
@@ -123,6 +138,72 @@ void Service::sendIntervalPart(const QByteArray &GUID, const QByteArray &encoded
         return;
 
     sendMessageToServer(ClientIntervalUploadWrite(GUID, encodedData, isLastPart));
+
+    for (IntervalUpload &upload : intervalUploads) {
+        if (upload.openIntervals.contains(GUID)) {
+            upload.encodedBytes += encodedData.size();
+            if (isLastPart) {
+                upload.openIntervals.remove(GUID);
+                upload.closing = true;
+                if (upload.openIntervals.isEmpty())
+                    upload.endOffset = totalBytesSent;
+            }
+            break;
+        }
+    }
+
+    if (isLastPart)
+        checkIntervalUploadCompletion();
+}
+
+qint64 Service::getBytesToWrite() const
+{
+    return socket ? socket->bytesToWrite() + getSystemQueuedBytes() : 0;
+}
+
+qint64 Service::getSystemQueuedBytes() const
+{
+    // the flush() is moving the bytes to the OS queue, the bytes are really sent when this queue is empty
+    qintptr descriptor = socket ? socket->socketDescriptor() : -1;
+    if (descriptor == -1)
+        return 0;
+
+#if defined(Q_OS_LINUX)
+    int queuedBytes = 0; // unsent and not acknowledged bytes
+    if (ioctl(static_cast<int>(descriptor), SIOCOUTQ, &queuedBytes) == 0)
+        return queuedBytes;
+#elif defined(Q_OS_MAC)
+    int queuedBytes = 0;
+    socklen_t size = sizeof(queuedBytes);
+    if (getsockopt(static_cast<int>(descriptor), SOL_SOCKET, SO_NWRITE, &queuedBytes, &size) == 0)
+        return queuedBytes;
+#endif
+
+    return 0; // not available in Windows, only the Qt socket buffer is used
+}
+
+void Service::handleBytesWritten()
+{
+    checkIntervalUploadCompletion();
+}
+
+void Service::checkIntervalUploadCompletion()
+{
+    qint64 sentBytes = totalBytesSent - getBytesToWrite();
+    while (!intervalUploads.isEmpty()) {
+        const IntervalUpload &upload = intervalUploads.first();
+        if (upload.endOffset < 0 || sentBytes < upload.endOffset)
+            break;
+
+        emit intervalUploaded(uploadClock.elapsed() - upload.startTime, upload.encodedBytes);
+        intervalUploads.removeFirst();
+    }
+
+    bool waitingDrain = !intervalUploads.isEmpty() && intervalUploads.first().endOffset >= 0;
+    if (waitingDrain && !uploadDrainTimer.isActive())
+        uploadDrainTimer.start();
+    else if (!waitingDrain)
+        uploadDrainTimer.stop();
 }
 
 void Service::sendIntervalBegin(const QByteArray &GUID, quint8 channelIndex, bool isAudioInterval)
@@ -130,6 +211,24 @@ void Service::sendIntervalBegin(const QByteArray &GUID, quint8 channelIndex, boo
     if (!initialized)
         return;
 
+    if (isAudioInterval) {
+        // the last part of a channel is sent before the next interval begin, a new upload is started
+        if (intervalUploads.isEmpty() || intervalUploads.last().closing) {
+            for (int i = intervalUploads.size() - 2; i >= 0; --i) { // a channel removed in the middle of an older interval
+                if (intervalUploads.at(i).endOffset < 0)
+                    intervalUploads.removeAt(i);
+            }
+
+            IntervalUpload upload;
+            upload.startTime = uploadClock.elapsed();
+            upload.encodedBytes = 0;
+            upload.closing = false;
+            upload.endOffset = -1;
+            intervalUploads.append(upload);
+        }
+        intervalUploads.last().openIntervals.insert(GUID);
+    }
+
     sendMessageToServer(ClientUploadIntervalBegin(GUID, channelIndex, this->userName, isAudioInterval));
 }
 
@@ -148,6 +247,9 @@ void Service::clear()
 {
     initialized = false;
     currentServer.reset();
+    intervalUploads.clear();
+    uploadDrainTimer.stop();
+    totalBytesSent = 0;
 }
 
 void Service::handleSocketError(QAbstractSocket::SocketError e)
@@ -256,6 +358,7 @@ void Service::sendMessageToServer(const ClientMessage &message)
     } while (dataSended < totalDataToSend && bytesWrited != -1);
 
     if (bytesWrited > 0) {
+        totalBytesSent += dataSended;
         socket->flush();
         lastSendTime = QDateTime::currentMSecsSinceEpoch();
     } else {
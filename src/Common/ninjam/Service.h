@@ -5,6 +5,10 @@
 #include <QScopedPointer>
 #include <QObject>
 #include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QSet>
+#include <QList>
 #include "log/Logging.h"
 //#include "ServerMessageProcessor.h"
 
@@ -55,6 +59,7 @@ public:
     // audio interval upload
     void sendIntervalPart(const QByteArray &GUID, const QByteArray &encodedAudioBuffer, bool isLastPart);
     void sendIntervalBegin(const QByteArray &GUID, quint8 channelIndex, bool isAudioInterval);
+    qint64 getBytesToWrite() const; // the upload backlog in socket, including the bytes queued in the OS (when available)
 
     void sendNewChannelsListToServer(const QStringList &channelsNames);
     void sendRemovedChannelIndex(int removedChannelIndex);
@@ -87,6 +92,7 @@ signals:
     void audioIntervalCompleted(const Ninjam::User &user, quint8 channelIndex, const QByteArray &encodedAudioData);
     void videoIntervalCompleted(const Ninjam::User &user, const QByteArray &encodedVideoData);
     void audioIntervalDownloading(const Ninjam::User &user, quint8 channelIndex, int bytesDownloaded);
+    void intervalUploaded(qint64 uploadTime, qint64 intervalBytes); // time (ms) from the interval begin until the last byte leaves the OS queue
     void disconnectedFromServer(const Ninjam::Server &server);
     void connectedInServer(const Ninjam::Server &server);
     void publicChatMessageReceived(const Ninjam::User &sender, const QString &message);
@@ -114,6 +120,8 @@ private slots:
     void handleSocketError(QAbstractSocket::SocketError error);
     void handleSocketDisconnection();
     void handleSocketConnection();
+    void handleBytesWritten();
+    void checkIntervalUploadCompletion();
 
 private:
     QScopedPointer<ServerMessagesHandler> messagesHandler;
@@ -126,6 +134,25 @@ private:
     static QStringList buildBotNamesList();
 
     long lastSendTime; // time stamp of last send
+
+    // the channels of an interval are measured together, from the first interval begin until the socket drain
+    struct IntervalUpload
+    {
+        qint64 startTime;
+        qint64 encodedBytes;
+        QSet<QByteArray> openIntervals; // GUIDs waiting the last part
+        bool closing; // a last part was sent, the next interval begins are not part of this upload
+        qint64 endOffset; // completed when the sent bytes reach this offset, -1 while the intervals are open
+    };
+
+    QList<IntervalUpload> intervalUploads; // the last is the current interval, the others are waiting the socket drain
+    QElapsedTimer uploadClock;
+    qint64 totalBytesSent; // bytes written in socket since the connection
+    QTimer uploadDrainTimer; // the OS queue is not notifying when the bytes are sent, so it is polled
+
+    static const int UPLOAD_DRAIN_CHECK_PERIOD; // in milliseconds
+
+    qint64 getSystemQueuedBytes() const;
     long serverKeepAlivePeriod;
     QString serverLicence;
 
@@ -1,4 +1,5 @@
 #include "Settings.h"
+#include "SettingsWriter.h"
 #include <QDebug>
 #include <QApplication>
 #include <QStandardPaths>
@@ -7,6 +8,7 @@
 #include <QJsonDocument>
 
 #include <QDir>
+#include <QFileInfo>
 #include <QList>
 #include <QStringList>
 #include <QSettings>
@@ -21,6 +23,13 @@ QString Settings::fileName = "Jamtaba64.json";
 QString Settings::fileName = "Jamtaba.json";
 #endif
 
+// the plugins data blobs are stored in this dir, one file per blob named by the content hash
+static QDir getPluginsDataDir()
+{
+    QDir baseDir = Configurator::getInstance()->getBaseDir();
+    return QDir(baseDir.absoluteFilePath(QFileInfo(Settings::getFileName()).completeBaseName() + "_plugins_data"));
+}
+
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 SettingsObject::SettingsObject(const QString &name) :
@@ -209,6 +218,8 @@ AudioSettings::AudioSettings() :
     sampleRate(44100),
     bufferSize(128),
     encodingQuality(VorbisEncoder::QUALITY_NORMAL),
+    adaptiveEncodingQuality(false),
+    intervalPreRollTime(250),
     firstIn(-1),
     firstOut(-1),
     lastIn(-1),
@@ -234,6 +245,10 @@ void AudioSettings::read(const QJsonObject &in)
         encodingQuality = VorbisEncoder::QUALITY_LOW;
     else if(encodingQuality > VorbisEncoder::QUALITY_HIGH)
         encodingQuality = VorbisEncoder::QUALITY_HIGH;
+
+    adaptiveEncodingQuality = getValueFromJson(in, "adaptiveEncodingQuality", false);
+
+    intervalPreRollTime = qBound(0, getValueFromJson(in, "intervalPreRollTime", 250), 2000);
 }
 
 void AudioSettings::write(QJsonObject &out) const
@@ -246,6 +261,8 @@ void AudioSettings::write(QJsonObject &out) const
     out["lastOut"] = lastOut;
     out["audioDevice"] = audioDevice;
     out["encodingQuality"] = encodingQuality;
+    out["adaptiveEncodingQuality"] = adaptiveEncodingQuality;
+    out["intervalPreRollTime"] = intervalPreRollTime;
 }
 
 // +++++++++++++++++++++++++++++
@@ -422,7 +439,8 @@ void WindowSettings::write(QJsonObject &out) const
 // +++++++++++++++++++++++++++++++++++++++
 
 VstSettings::VstSettings() :
-    SettingsObject("VST")
+    SettingsObject("VST"),
+    sandboxPlugins(false)
 {
 }
 
@@ -447,6 +465,8 @@ void VstSettings::write(QJsonObject &out) const
         BlackedArray.append(blackVst);
 
     out["BlackListPlugins"] = BlackedArray;
+
+    out["sandboxPlugins"] = sandboxPlugins;
 }
 
 void VstSettings::read(const QJsonObject &in)
@@ -473,6 +493,8 @@ void VstSettings::read(const QJsonObject &in)
         for (int x = 0; x < cacheArray.size(); ++x)
             blackedPlugins.append(cacheArray.at(x).toString());
     }
+
+    sandboxPlugins = getValueFromJson(in, "sandboxPlugins", false);
 }
 
 // +++++++++++++++++++++++++++++++++++++++
@@ -567,6 +589,11 @@ LocalInputTrackSettings::LocalInputTrackSettings(bool createOneTrack) :
 }
 
 void LocalInputTrackSettings::write(QJsonObject &out) const
+{
+    write(out, nullptr); // plugins data in base64 strings
+}
+
+void LocalInputTrackSettings::write(QJsonObject &out, QMap<QString, QByteArray> *pluginsData) const
 {
     QJsonArray channelsArray;
     for (const Channel &channel : channels) {
@@ -602,8 +629,16 @@ void LocalInputTrackSettings::write(QJsonObject &out) const
 
                 pluginObject["bypassed"] = plugin.bypassed;
 
-                if (!plugin.data.isEmpty())
-                    pluginObject["data"]     = QString(plugin.data.toBase64());
+                if (!plugin.data.isEmpty()) {
+                    if (pluginsData) { // big plugin chunks are not encoded in the json file
+                        QString dataFile = SettingsWriter::getBlobHash(plugin.data);
+                        pluginsData->insert(dataFile, plugin.data);
+                        pluginObject["dataFile"] = dataFile;
+                    }
+                    else {
+                        pluginObject["data"] = QString(plugin.data.toBase64());
+                    }
+                }
 
                 pluginObject["category"] = static_cast<quint8>(plugin.category);
 
@@ -632,17 +667,27 @@ Plugin LocalInputTrackSettings::jsonObjectToPlugin(QJsonObject pluginObject)
 
     bool bypassed = getValueFromJson(pluginObject, "bypassed", false);
 
-    QString dataString = getValueFromJson(pluginObject, "data", QString());
+    QByteArray data;
+    QString dataFile = getValueFromJson(pluginObject, "dataFile", QString());
+    if (!dataFile.isEmpty()) {
+        QFile file(getPluginsDataDir().absoluteFilePath(dataFile));
+        if (file.open(QIODevice::ReadOnly))
+            data = file.readAll();
+        else
+            qWarning(jtConfigurator) << "Settings : Can't load the plugin data file:" << file.errorString();
+    }
+    else {
+        QString dataString = getValueFromJson(pluginObject, "data", QString());
+        data = QByteArray::fromBase64(dataString.toLatin1());
+    }
 
     Audio::PluginDescriptor::Category category = static_cast<Audio::PluginDescriptor::Category>(getValueFromJson(pluginObject, "category", quint8(1))); // 1 is the VST enum value
 
-    QByteArray rawByteArray(dataString.toStdString().c_str());
-
     QString manufacturer = getValueFromJson(pluginObject, "manufacturer", QString());
 
     Audio::PluginDescriptor descriptor(name, category, manufacturer, path);
 
-    return Persistence::Plugin(descriptor, bypassed, QByteArray::fromBase64(rawByteArray));
+    return Persistence::Plugin(descriptor, bypassed, data);
 }
 
 void LocalInputTrackSettings::read(const QJsonObject &in, bool allowSubchannels)
@@ -920,8 +965,14 @@ bool Settings::readFile(const QList<SettingsObject *> &sections)
             this->usingNarrowedTracks = false;
 
         // read settings sections (Audio settings, Midi settings, ninjam settings, etc...)
-        for (SettingsObject *so : sections)
-            so->read(root[so->getName()].toObject());
+        for (SettingsObject *so : sections) {
+            QString sectionName = so->getName();
+            QJsonObject sectionObject = root[sectionName].toObject();
+            if (fileContent.contains(sectionName) && fileContent[sectionName].toObject() == sectionObject)
+                continue; // section not changed since the last read/write
+
+            so->read(sectionObject);
+        }
 
         if(root.contains("intervalsBeforeInactivityWarning")) {
             intervalsBeforeInactivityWarning = root["intervalsBeforeInactivityWarning"].toInt();
@@ -929,6 +980,11 @@ bool Settings::readFile(const QList<SettingsObject *> &sections)
                 intervalsBeforeInactivityWarning = 1;
         }
 
+        if (root.contains("roomStreamsToPrefetch"))
+            roomStreamsToPrefetch = qBound(0, root["roomStreamsToPrefetch"].toInt(0), 5);
+
+        fileContent = root;
+
         return true;
     }
     else {
@@ -956,34 +1012,54 @@ void Settings::setLooperPreferredMode(quint8 looperMode)
 
 bool Settings::writeFile(const QList<SettingsObject *> &sections) // io ops ...
 {
-    QDir configFileDir = Configurator::getInstance()->getBaseDir();
-    QFile file(configFileDir.absoluteFilePath(fileName));
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonObject root;
+    QJsonObject root;
 
-        // writing global settings
-        root["userName"] = lastUserName; // write user name
-        root["translation"] = translation; // write translate locale
-        root["theme"] = theme;
-        root["intervalProgressShape"] = ninjamIntervalProgressShape;
-        root["tracksLayoutOrientation"] = tracksLayoutOrientation;
-        root["usingNarrowTracks"] = usingNarrowedTracks;
-        root["masterGain"] = masterFaderGain;
-        root["intervalsBeforeInactivityWarning"] = static_cast<int>(intervalsBeforeInactivityWarning);
-
-        // write settings sections
-        for (SettingsObject *so : sections) {
-            QJsonObject sectionObject;
+    // writing global settings
+    root["userName"] = lastUserName; // write user name
+    root["translation"] = translation; // write translate locale
+    root["theme"] = theme;
+    root["intervalProgressShape"] = ninjamIntervalProgressShape;
+    root["tracksLayoutOrientation"] = tracksLayoutOrientation;
+    root["usingNarrowTracks"] = usingNarrowedTracks;
+    root["masterGain"] = masterFaderGain;
+    root["intervalsBeforeInactivityWarning"] = static_cast<int>(intervalsBeforeInactivityWarning);
+    root["roomStreamsToPrefetch"] = roomStreamsToPrefetch;
+
+    // the last content is updated only when the writer finished, a failed write is retried in the next save
+    QDir configFileDir = Configurator::getInstance()->getBaseDir();
+    QString filePath = configFileDir.absoluteFilePath(fileName);
+    SettingsWriter *writer = SettingsWriter::getInstance();
+    QJsonObject writtenContent;
+    if (writer->getWrittenContent(filePath, &writtenContent))
+        fileContent = writtenContent;
+
+    QJsonObject lastContent = fileContent;
+    writer->getLatestContent(filePath, &lastContent); // the content waiting to be written is not written again
+
+    // write settings sections
+    QMap<QString, QByteArray> pluginsData;
+    QStringList changedSections;
+    for (SettingsObject *so : sections) {
+        QJsonObject sectionObject;
+        if (so == &inputsSettings)
+            inputsSettings.write(sectionObject, &pluginsData);
+        else
             so->write(sectionObject);
-            root[so->getName()] = sectionObject;
-        }
-        QJsonDocument doc(root);
-        file.write(doc.toJson());
-        return true;
-    } else {
-        qCritical() << file.errorString();
+
+        if (lastContent[so->getName()].toObject() != sectionObject)
+            changedSections.append(so->getName());
+
+        root[so->getName()] = sectionObject;
     }
-    return false;
+
+    if (root == lastContent)
+        return true; // nothing changed
+
+    qCDebug(jtConfigurator) << "Saving settings, changed sections:" << changedSections;
+
+    writer->write(filePath, root, getPluginsDataDir().absolutePath(), pluginsData);
+
+    return true;
 }
 
 // PRESETS
@@ -1066,7 +1142,8 @@ Settings::Settings() :
     theme("Flat"), // flat as default theme,
     ninjamIntervalProgressShape(0),
     usingNarrowedTracks(false),
-    intervalsBeforeInactivityWarning(5) // 5 intervals by default
+    intervalsBeforeInactivityWarning(5), // 5 intervals by default
+    roomStreamsToPrefetch(0) // room streams prefetching is disabled by default
 {
     // qDebug() << "Settings in " << fileDir;
 }
@@ -57,6 +57,8 @@ public:
     int lastOut;
     int audioDevice;
     float encodingQuality;
+    bool adaptiveEncodingQuality; // reduce the encoding quality when the upload is slow
+    int intervalPreRollTime; // in milliseconds, the next intervals are decoded before the interval start (0 to disable)
 };
 
 // +++++++++++++++++++++++++++++++++++++
@@ -132,6 +134,7 @@ public:
     QStringList cachedPlugins;
     QStringList foldersToScan;
     QStringList blackedPlugins; // vst in blackbox....
+    bool sandboxPlugins; // run the VST plugins in a separated process
 };
 
 class AudioUnitSettings  : public SettingsObject
@@ -275,6 +278,7 @@ class LocalInputTrackSettings : public SettingsObject
 public:
     explicit LocalInputTrackSettings(bool createOneTrack = false);
     void write(QJsonObject &out) const override;
+    void write(QJsonObject &out, QMap<QString, QByteArray> *pluginsData) const; // plugins data stored in the map, not in the json
     void read(const QJsonObject &in) override;
     void read(const QJsonObject &in, bool allowSubchannels);
     QList<Channel> channels;
@@ -367,6 +371,10 @@ private:
 
     uint intervalsBeforeInactivityWarning;
 
+    int roomStreamsToPrefetch; // how many public rooms streams are kept connected in background? Zero disable the prefetching
+
+    QJsonObject fileContent; // the last content read from or written to the settings file, used to find the changed sections
+
     bool readFile(const QList<SettingsObject *> &sections);
     bool writeFile(const QList<SettingsObject *> &sections);
 
@@ -374,11 +382,16 @@ public:
     Settings();
     ~Settings();
 
+    static QString getFileName();
+
     void storeWaveDrawingMode(quint8 mode);
     quint8 getLastWaveDrawingMode() const;
 
     float getEncodingQuality() const;
     void setEncodingQuality(float quality);
+    bool isUsingAdaptiveEncodingQuality() const;
+    void setAdaptiveEncodingQuality(bool adaptive);
+    int getIntervalPreRollTime() const;
 
     void setBuiltInMetronome(const QString &metronomeAlias);
     QString getBuiltInMetronome() const;
@@ -396,7 +409,7 @@ public:
     bool isUsingNarrowedTracks() const;
 
     LocalInputTrackSettings getInputsSettings() const;
-    void save(const LocalInputTrackSettings &inputsSettings);
+    void save(const LocalInputTrackSettings &inputsSettings); // only the changes are saved, the file is written in background by SettingsWriter
     void load();
 
     float getLastMasterGain() const;
@@ -441,6 +454,8 @@ public:
     void removeVstFromBlackList(const QString &pluginPath);
     QStringList getVstPluginsPaths() const;
     QStringList getBlackListedPlugins() const;
+    bool isSandboxingVstPlugins() const;
+    void setSandboxingVstPlugins(bool sandboxPlugins);
     void clearVstCache();
     void clearBlackBox();
 
@@ -524,6 +539,8 @@ public:
     bool isRememberingLowCut() const;
 
     uint getIntervalsBeforeInactivityWarning() const;
+
+    int getRoomStreamsToPrefetch() const;
 };
 
 inline uint Settings::getIntervalsBeforeInactivityWarning() const
@@ -531,6 +548,21 @@ inline uint Settings::getIntervalsBeforeInactivityWarning() const
     return intervalsBeforeInactivityWarning;
 }
 
+inline bool Settings::isSandboxingVstPlugins() const
+{
+    return vstSettings.sandboxPlugins;
+}
+
+inline void Settings::setSandboxingVstPlugins(bool sandboxPlugins)
+{
+    vstSettings.sandboxPlugins = sandboxPlugins;
+}
+
+inline int Settings::getRoomStreamsToPrefetch() const
+{
+    return roomStreamsToPrefetch;
+}
+
 inline bool Settings::isRememberingMute() const
 {
     return rememberSettings.rememberMute;
@@ -720,6 +752,11 @@ inline bool Settings::isSaveMultiTrackActivated() const
     return recordingSettings.saveMultiTracksActivated;
 }
 
+inline QString Settings::getFileName()
+{
+    return fileName;
+}
+
 inline void Settings::setSaveMultiTrack(bool saveMultiTracks)
 {
     recordingSettings.saveMultiTracksActivated = saveMultiTracks;
@@ -862,6 +899,21 @@ inline void Settings::setEncodingQuality(float quality)
     audioSettings.encodingQuality = quality;
 }
 
+inline bool Settings::isUsingAdaptiveEncodingQuality() const
+{
+    return audioSettings.adaptiveEncodingQuality;
+}
+
+inline void Settings::setAdaptiveEncodingQuality(bool adaptive)
+{
+    audioSettings.adaptiveEncodingQuality = adaptive;
+}
+
+inline int Settings::getIntervalPreRollTime() const
+{
+    return audioSettings.intervalPreRollTime;
+}
+
 } // namespace
 
 #endif
@@ -0,0 +1,166 @@
+#include "SettingsWriter.h"
+#include "log/Logging.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QSet>
+
+using namespace Persistence;
+
+const int SettingsWriter::DEBOUNCE_TIME = 2000;
+
+SettingsWriter *SettingsWriter::getInstance()
+{
+    static SettingsWriter instance;
+    return &instance;
+}
+
+SettingsWriter::SettingsWriter() :
+    hasPendingWrite(false),
+    waitingRunningWrite(false)
+{
+    threadPool.setMaxThreadCount(1); // the writes are serialized
+
+    debounceTimer.setSingleShot(true);
+    debounceTimer.setInterval(DEBOUNCE_TIME);
+    connect(&debounceTimer, &QTimer::timeout, this, &SettingsWriter::startWriting);
+    connect(&runningWriteWatcher, &QFutureWatcher<bool>::finished, this, &SettingsWriter::handleWriteFinished);
+}
+
+bool SettingsWriter::getWrittenContent(const QString &filePath, QJsonObject *content) const
+{
+    if (!writtenContents.contains(filePath))
+        return false;
+
+    *content = writtenContents[filePath];
+    return true;
+}
+
+bool SettingsWriter::getLatestContent(const QString &filePath, QJsonObject *content) const
+{
+    if (hasPendingWrite && pendingWrite.filePath == filePath) {
+        *content = pendingWrite.content;
+        return true;
+    }
+
+    if (waitingRunningWrite && runningWriteFilePath == filePath) {
+        *content = runningWriteContent;
+        return true;
+    }
+
+    return getWrittenContent(filePath, content);
+}
+
+QString SettingsWriter::getBlobHash(const QByteArray &blob)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(blob, QCryptographicHash::Sha1).toHex());
+}
+
+void SettingsWriter::write(const QString &filePath, const QJsonObject &content, const QString &blobsDir,
+                           const QMap<QString, QByteArray> &blobs)
+{
+    pendingWrite.filePath = filePath;
+    pendingWrite.content = content;
+    pendingWrite.blobsDir = blobsDir;
+    pendingWrite.blobs = blobs;
+    hasPendingWrite = true;
+
+    debounceTimer.start(); // restarting the timer, only the last content is written
+}
+
+void SettingsWriter::startWriting()
+{
+    if (!hasPendingWrite)
+        return;
+
+    if (runningWrite.isRunning()) { // trying again later
+        debounceTimer.start();
+        return;
+    }
+
+    runningWrite = QtConcurrent::run(&threadPool, &SettingsWriter::writeFiles, pendingWrite);
+    runningWriteWatcher.setFuture(runningWrite);
+    runningWriteFilePath = pendingWrite.filePath;
+    runningWriteContent = pendingWrite.content;
+    waitingRunningWrite = true;
+
+    pendingWrite = PendingWrite();
+    hasPendingWrite = false;
+}
+
+void SettingsWriter::handleWriteFinished()
+{
+    if (!waitingRunningWrite) // already handled in flush()
+        return;
+
+    waitingRunningWrite = false;
+    if (runningWrite.result())
+        writtenContents[runningWriteFilePath] = runningWriteContent;
+
+    runningWriteContent = QJsonObject();
+}
+
+void SettingsWriter::flush()
+{
+    debounceTimer.stop();
+
+    runningWrite.waitForFinished();
+    handleWriteFinished();
+
+    if (hasPendingWrite) {
+        if (writeFiles(pendingWrite))
+            writtenContents[pendingWrite.filePath] = pendingWrite.content;
+
+        pendingWrite = PendingWrite();
+        hasPendingWrite = false;
+    }
+}
+
+bool SettingsWriter::writeFiles(const PendingWrite &pendingWrite)
+{
+    QDir blobsDir(pendingWrite.blobsDir);
+    if (!pendingWrite.blobs.isEmpty() && !blobsDir.exists())
+        blobsDir.mkpath(".");
+
+    // blobs are named by the content hash, existing files are not written again
+    for (auto it = pendingWrite.blobs.constBegin(); it != pendingWrite.blobs.constEnd(); ++it) {
+        QString blobPath = blobsDir.absoluteFilePath(it.key());
+        if (QFile::exists(blobPath))
+            continue;
+
+        QSaveFile blobFile(blobPath);
+        if (!blobFile.open(QIODevice::WriteOnly) || blobFile.write(it.value()) != it.value().size() || !blobFile.commit()) {
+            qCritical() << "Can't write the plugin data file" << blobPath << blobFile.errorString();
+            return false; // the settings file is not referencing missing blobs
+        }
+    }
+
+    QSaveFile file(pendingWrite.filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(pendingWrite.content).toJson());
+    if (!file.commit()) {
+        qCritical() << "Can't write the settings file" << pendingWrite.filePath << file.errorString();
+        return false;
+    }
+
+    // deleting the blobs not used anymore
+    if (blobsDir.exists()) {
+        QSet<QString> usedBlobs = QSet<QString>::fromList(pendingWrite.blobs.keys());
+        for (const QString &blobFile : blobsDir.entryList(QDir::Files)) {
+            if (!usedBlobs.contains(blobFile))
+                blobsDir.remove(blobFile);
+        }
+    }
+
+    qCDebug(jtConfigurator) << "Settings file written:" << pendingWrite.filePath;
+
+    return true;
+}
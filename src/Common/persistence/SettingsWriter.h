@@ -0,0 +1,79 @@
+#ifndef _SETTINGS_WRITER_H
+#define _SETTINGS_WRITER_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMap>
+
+namespace Persistence {
+
+/**
+ * Write the settings file in a worker thread. Successive writes are debounced, only the last
+ * content is written. The files are replaced atomically (temp file + rename), and the plugins
+ * data blobs are stored in separated files named by the content hash.
+ */
+
+class SettingsWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SettingsWriter *getInstance();
+
+    // the blobs map is content hash -> data, all blobs not in the map are deleted from blobsDir
+    void write(const QString &filePath, const QJsonObject &content, const QString &blobsDir,
+               const QMap<QString, QByteArray> &blobs);
+
+    void flush(); // write the pending content now, blocking until all writes are finished
+
+    // the content of the last successful write, updated in main thread when the write is finished
+    bool getWrittenContent(const QString &filePath, QJsonObject *content) const;
+
+    // the last content passed to write(), pending or running. Finished writes return the written content.
+    bool getLatestContent(const QString &filePath, QJsonObject *content) const;
+
+    static QString getBlobHash(const QByteArray &blob);
+
+private slots:
+    void startWriting();
+    void handleWriteFinished();
+
+private:
+    SettingsWriter();
+
+    struct PendingWrite
+    {
+        QString filePath;
+        QJsonObject content;
+        QString blobsDir;
+        QMap<QString, QByteArray> blobs;
+    };
+
+    static bool writeFiles(const PendingWrite &pendingWrite);
+
+    QTimer debounceTimer;
+    QThreadPool threadPool;
+    QFuture<bool> runningWrite;
+    QFutureWatcher<bool> runningWriteWatcher;
+
+    PendingWrite pendingWrite;
+    bool hasPendingWrite;
+
+    QString runningWriteFilePath;
+    QJsonObject runningWriteContent;
+    bool waitingRunningWrite;
+
+    QMap<QString, QJsonObject> writtenContents; // file path -> content
+
+    static const int DEBOUNCE_TIME; // in milliseconds
+};
+
+} // namespace
+
+#endif
@@ -4,12 +4,24 @@
 #include <QFile>
 #include <QStandardPaths>
 #include <QDataStream>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QVector>
 #include "Configurator.h"
 #include "CacheHeader.h"
 
+#include <algorithm>
+
 using namespace Persistence;
 
-const quint32 UsersDataCacheHeader::REVISION = 3; // added 3 low cut states (off, normal and drastic) in revision 3
+const quint32 UsersDataCacheHeader::REVISION = 4; // append only log of records in revision 4
+const quint32 UsersDataCacheHeader::LEGACY_REVISION = 3; // added 3 low cut states (off, normal and drastic) in revision 3
+
+const int UsersDataCache::DEFAULT_MAX_ENTRIES = 50000;
+const int UsersDataCache::DEFAULT_MAX_ENTRY_AGE = 365; // in days
+const int UsersDataCache::COMPACTION_MIN_RECORDS = 512; // outdated records in the log file
+const quint32 UsersDataCache::MAX_RECORD_SIZE = 64 * 1024; // bigger records are treated as corrupted data
+const qint64 UsersDataCache::TOUCH_INTERVAL = 24 * 60 * 60 * 1000; // the last use of read-only entries is stored once a day
 
 const bool CacheEntry::DEFAULT_MUTED = false;
 const quint8 CacheEntry::DEFAULT_LOW_CUT_STATE = 0; // OFF state is default
@@ -120,8 +132,11 @@ void CacheEntry::setGain(float gain)
 }
 
 UsersDataCache::UsersDataCache(const QDir &cacheDir) :
-    CACHE_FILE_NAME("tracks_cache.bin"),
-    cacheDir(cacheDir)
+    cacheDir(cacheDir),
+    logRecords(0),
+    maxEntries(DEFAULT_MAX_ENTRIES),
+    maxEntryAge(DEFAULT_MAX_ENTRY_AGE),
+    CACHE_FILE_NAME("tracks_cache.bin")
 {
     // check if the tracks_cache_bin file is in the old dir and copy the file to the 'cache' dir.
     // This piece of code will be deleted in future versions.
@@ -135,20 +150,34 @@ UsersDataCache::UsersDataCache(const QDir &cacheDir) :
     }
 
     loadCacheEntriesFromFile();
+
+    if (evictEntries() > 0 || needsCompaction())
+        compact();
+    else
+        openLogFile();
 }
 
 UsersDataCache::~UsersDataCache()
 {
-    if (!cacheEntries.isEmpty())
-        writeCacheEntriesToFile();
+    // all changes are already in the log file, the rewrite is just avoiding a huge log in the next startup
+    if (needsCompaction())
+        compact();
 }
 
 CacheEntry UsersDataCache::getUserCacheEntry(const QString &userIp, const QString &userName,
                                              quint8 channelID)
 {
     QString userUniqueKey = getUserUniqueKey(userIp, userName, channelID);
-    if (cacheEntries.contains(userUniqueKey))
-        return cacheEntries[userUniqueKey];
+    auto iterator = cacheEntries.find(userUniqueKey);
+    if (iterator != cacheEntries.end()) {
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        bool storeLastUse = now - iterator->lastUse > TOUCH_INTERVAL;
+        iterator->lastUse = now;
+        if (storeLastUse)
+            appendRecord(*iterator);
+
+        return iterator->entry;
+    }
 
     return CacheEntry(userIp, userName, channelID); // return a entry using default values for pan, gain, mute, etc.
 }
@@ -156,54 +185,242 @@ CacheEntry UsersDataCache::getUserCacheEntry(const QString &userIp, const QStrin
 void UsersDataCache::updateUserCacheEntry(CacheEntry entry)
 {
     QString userKey = getUserUniqueKey(entry.getUserIP(), entry.getUserName(), entry.getChannelID());
-    cacheEntries.insert(userKey, entry); // replace the last value or insert
+
+    StoredEntry &storedEntry = cacheEntries[userKey]; // replace the last value or insert
+    storedEntry.entry = entry;
+    storedEntry.lastUse = QDateTime::currentMSecsSinceEpoch();
+
+    appendRecord(storedEntry);
+
+    if (evictEntries() > 0 || needsCompaction())
+        compact();
+}
+
+void UsersDataCache::setMaxEntries(int maxEntries)
+{
+    this->maxEntries = qMax(1, maxEntries);
+
+    if (evictEntries() > 0)
+        compact();
+}
+
+void UsersDataCache::setMaxEntryAge(int days)
+{
+    maxEntryAge = qMax(1, days);
+
+    if (evictEntries() > 0)
+        compact();
 }
 
 QString UsersDataCache::getUserUniqueKey(const QString &userIp, const QString &userName,
                                          quint8 channelID)
 {
-    // the unique key is just a string...
-    return userIp + userName + QString::number(channelID);
+    // the separators are avoiding collisions like '1.2.3.4' + '5name' and '1.2.3.45' + 'name'
+    return userIp + QChar(0) + userName + QChar(0) + QString::number(channelID);
+}
+
+QByteArray UsersDataCache::serializeRecord(const StoredEntry &storedEntry)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << storedEntry.lastUse << storedEntry.entry;
+
+    // record = size + data + checksum, an incomplete record (crash while writing) is detected in the next load
+    QByteArray record;
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+    recordStream << static_cast<quint32>(data.size());
+    recordStream.writeRawData(data.constData(), data.size());
+    recordStream << qChecksum(data.constData(), data.size());
+
+    return record;
 }
 
 void UsersDataCache::loadCacheEntriesFromFile()
 {
     // load tracks cache content from file
     QFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
-    if (cacheFile.open(QFile::ReadOnly)) {
-        QDataStream stream(&cacheFile);
+    if (!cacheFile.open(QFile::ReadOnly))
+        return;
 
-        CacheHeader cacheHeader;
-        stream >> cacheHeader;
-        quint32 expectedHeaderRevision = UsersDataCacheHeader::REVISION;
-        if (cacheHeader.isValid(expectedHeaderRevision))
-            stream >> cacheEntries;
-        else
-            qCritical() << "Invalid cache header when loading users data cache.";
+    QDataStream stream(&cacheFile);
+
+    CacheHeader cacheHeader;
+    stream >> cacheHeader;
+    if (cacheHeader.isValid(UsersDataCacheHeader::REVISION))
+        loadLogRecords(stream);
+    else if (cacheHeader.isValid(UsersDataCacheHeader::LEGACY_REVISION))
+        loadLegacyEntries(stream);
+    else
+        qCritical() << "Invalid cache header when loading users data cache.";
 
-        qCDebug(jtCache) << "Tracks cache items loaded from file: " << cacheEntries.size();
+    qCDebug(jtCache) << "Tracks cache items loaded from file: " << cacheEntries.size();
+}
+
+void UsersDataCache::loadLegacyEntries(QDataStream &stream)
+{
+    QMap<QString, CacheEntry> legacyEntries;
+    stream >> legacyEntries;
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const CacheEntry &entry : legacyEntries) {
+        StoredEntry storedEntry;
+        storedEntry.entry = entry;
+        storedEntry.lastUse = now;
+        cacheEntries.insert(getUserUniqueKey(entry.getUserIP(), entry.getUserName(), entry.getChannelID()), storedEntry);
     }
+
+    logRecords = -1; // force the compaction, the legacy file is rewritten in the new format
 }
 
-void UsersDataCache::writeCacheEntriesToFile()
+void UsersDataCache::loadLogRecords(QDataStream &stream)
 {
-    qCDebug(jtCache) << "Saving cache file";
+    QIODevice *device = stream.device();
+    qint64 validSize = device->pos();
+
+    while (!stream.atEnd()) {
+        quint32 size;
+        stream >> size;
+        if (stream.status() != QDataStream::Ok || size > MAX_RECORD_SIZE
+                || device->bytesAvailable() < static_cast<qint64>(size + sizeof(quint16)))
+            break;
+
+        QByteArray data(size, Qt::Uninitialized);
+        quint16 checksum;
+        stream.readRawData(data.data(), size);
+        stream >> checksum;
+        if (stream.status() != QDataStream::Ok || checksum != qChecksum(data.constData(), size))
+            break;
+
+        StoredEntry storedEntry;
+        QDataStream recordStream(data);
+        recordStream >> storedEntry.lastUse >> storedEntry.entry;
+        const CacheEntry &entry = storedEntry.entry;
+        cacheEntries.insert(getUserUniqueKey(entry.getUserIP(), entry.getUserName(), entry.getChannelID()), storedEntry);
+
+        logRecords++;
+        validSize = device->pos();
+    }
 
-    QFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
-    if (cacheFile.open(QFile::WriteOnly)) {
-        qCDebug(jtCache) << "Tracks cache file opened to write.";
-        QDataStream stream(&cacheFile);
+    if (validSize < device->size()) {
+        qCritical() << "Discarding" << (device->size() - validSize) << "corrupted bytes in the tracks cache file";
+        logRecords = -1; // force the compaction, the corrupted tail is not kept
+    }
+}
+
+void UsersDataCache::openLogFile()
+{
+    logFile.close();
+    logFile.setFileName(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
+    if (!logFile.open(QFile::WriteOnly | QFile::Append)) {
+        qCritical() << "Can't open the tracks cache file in" << QFileInfo(logFile).absoluteFilePath();
+        return;
+    }
 
-        CacheHeader cacheHeader(UsersDataCacheHeader::REVISION);
-        stream << cacheHeader;
+    if (logFile.size() == 0) {
+        QDataStream stream(&logFile);
+        stream << CacheHeader(UsersDataCacheHeader::REVISION);
+        logFile.flush();
+        logRecords = 0;
+    }
+}
 
-        stream << cacheEntries;
+void UsersDataCache::appendRecord(const StoredEntry &storedEntry)
+{
+    if (!logFile.isOpen())
+        return;
 
-        qCDebug(jtCache) << cacheEntries.size() << " items stored in tracks cache file!";
-    } else {
-        qCritical() << "Can't open the tracks cache file in"
-                            << QFileInfo(cacheFile).absoluteFilePath();
+    QByteArray record = serializeRecord(storedEntry);
+    if (logFile.write(record) != record.size() || !logFile.flush()) {
+        qCritical() << "Error writing the tracks cache file:" << logFile.errorString();
+        return;
     }
+
+    logRecords++;
+}
+
+bool UsersDataCache::needsCompaction() const
+{
+    if (logRecords < 0)
+        return true;
+
+    int outdatedRecords = logRecords - cacheEntries.size();
+    return outdatedRecords > qMax(COMPACTION_MIN_RECORDS, cacheEntries.size() / 2);
+}
+
+int UsersDataCache::evictEntries()
+{
+    int evictedEntries = 0;
+
+    // the entries not used in 'maxEntryAge' days
+    qint64 oldestLastUse = QDateTime::currentMSecsSinceEpoch() - static_cast<qint64>(maxEntryAge) * 24 * 60 * 60 * 1000;
+    for (auto iterator = cacheEntries.begin(); iterator != cacheEntries.end();) {
+        if (iterator->lastUse < oldestLastUse) {
+            iterator = cacheEntries.erase(iterator);
+            evictedEntries++;
+        }
+        else {
+            ++iterator;
+        }
+    }
+
+    // the least recently used entries, evicting 10% more to avoid compacting in every new entry
+    if (cacheEntries.size() > maxEntries) {
+        int entriesToEvict = cacheEntries.size() - maxEntries + maxEntries / 10;
+        QVector<qint64> lastUses;
+        lastUses.reserve(cacheEntries.size());
+        for (const StoredEntry &storedEntry : cacheEntries)
+            lastUses.append(storedEntry.lastUse);
+
+        std::nth_element(lastUses.begin(), lastUses.begin() + (entriesToEvict - 1), lastUses.end());
+        qint64 threshold = lastUses.at(entriesToEvict - 1);
+
+        for (auto iterator = cacheEntries.begin(); iterator != cacheEntries.end() && entriesToEvict > 0;) {
+            if (iterator->lastUse <= threshold) {
+                iterator = cacheEntries.erase(iterator);
+                entriesToEvict--;
+                evictedEntries++;
+            }
+            else {
+                ++iterator;
+            }
+        }
+    }
+
+    if (evictedEntries > 0)
+        qCDebug(jtCache) << evictedEntries << "entries evicted from tracks cache";
+
+    return evictedEntries;
+}
+
+void UsersDataCache::compact()
+{
+    qCDebug(jtCache) << "Compacting tracks cache file";
+
+    logFile.close();
+
+    QSaveFile cacheFile(cacheDir.absoluteFilePath(CACHE_FILE_NAME));
+    if (cacheFile.open(QFile::WriteOnly)) {
+        QDataStream stream(&cacheFile);
+        stream << CacheHeader(UsersDataCacheHeader::REVISION);
+
+        for (const StoredEntry &storedEntry : cacheEntries) {
+            QByteArray record = serializeRecord(storedEntry);
+            stream.writeRawData(record.constData(), record.size());
+        }
+
+        if (cacheFile.commit()) {
+            logRecords = cacheEntries.size();
+            qCDebug(jtCache) << cacheEntries.size() << " items stored in tracks cache file!";
+        }
+        else {
+            qCritical() << "Can't write the tracks cache file:" << cacheFile.errorString();
+        }
+    }
+    else {
+        qCritical() << "Can't open the tracks cache file in" << cacheFile.fileName();
+    }
+
+    openLogFile();
 }
 
 // ++++++++++++++++++
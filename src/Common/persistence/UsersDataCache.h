@@ -2,21 +2,28 @@
 #define USERSDATACACHE_H
 
 #include <QString>
-#include <QMap>
+#include <QHash>
 #include <QRegExp>
 #include <QDir>
+#include <QFile>
+#include <QDataStream>
 
 /**
 
   This class is used to store/remember the users level, pan, mute and boost. When a user enter in the jam
   the data is recovered/remembered from this cache.
 
+  The entries are kept in a hash and every change is appended (and flushed) to a log file, so a crash
+  is not losing the changes. The log is compacted when it contains too many outdated records, and the
+  entries not used for a long time (or the least recently used, when the cache is full) are evicted.
+
  */
 
 namespace Persistence {
 
 struct UsersDataCacheHeader {
     static const quint32 REVISION;
+    static const quint32 LEGACY_REVISION; // the whole QMap<QString, CacheEntry> serialized
 };
 
 class CacheEntry // cache entries are per channel, not per user.
@@ -109,20 +116,67 @@ public:
     CacheEntry getUserCacheEntry(const QString &userIp, const QString &userName, quint8 channelID);
 
     void updateUserCacheEntry(CacheEntry entry);
+
+    int getSize() const;
+    int getLogRecords() const;
+
+    void setMaxEntries(int maxEntries);
+    void setMaxEntryAge(int days);
+
+    void compact(); // rewrite the log file using just the current entries
+
 private:
-    QMap<QString, CacheEntry> cacheEntries;
+    struct StoredEntry
+    {
+        CacheEntry entry;
+        qint64 lastUse; // msecs since epoch
+    };
+
+    QHash<QString, StoredEntry> cacheEntries;
 
     QDir cacheDir;
+    QFile logFile; // opened in append mode
+
+    int logRecords; // records in the log file, including the outdated ones
+    int maxEntries;
+    int maxEntryAge; // in days
 
     static QString getUserUniqueKey(const QString &userIp, const QString &userName,
                                     quint8 channelID);
 
+    static QByteArray serializeRecord(const StoredEntry &storedEntry);
+
     void loadCacheEntriesFromFile();
-    void writeCacheEntriesToFile();
+    void loadLegacyEntries(QDataStream &stream);
+    void loadLogRecords(QDataStream &stream);
+    void openLogFile();
+    void appendRecord(const StoredEntry &storedEntry);
+
+    bool needsCompaction() const;
+    int evictEntries(); // return the number of evicted entries
 
     const QString CACHE_FILE_NAME;
+
+    static const int DEFAULT_MAX_ENTRIES;
+    static const int DEFAULT_MAX_ENTRY_AGE;
+    static const int COMPACTION_MIN_RECORDS;
+    static const quint32 MAX_RECORD_SIZE;
+    static const qint64 TOUCH_INTERVAL;
 };
 
+inline int UsersDataCache::getSize() const
+{
+    return cacheEntries.size();
+}
+
+inline int UsersDataCache::getLogRecords() const
+{
+    return logRecords;
+}
+
 }// namespace
 
+QDataStream &operator<<(QDataStream &stream, const Persistence::CacheEntry &entry);
+QDataStream &operator>>(QDataStream &stream, Persistence::CacheEntry &entry);
+
 #endif // USERSDATACACHE_H
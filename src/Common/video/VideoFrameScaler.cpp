@@ -0,0 +1,120 @@
+#include "VideoFrameScaler.h"
+
+#include <QPainter>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrent>
+
+QThreadPool *VideoFrameScaler::threadPool()
+{
+    // all video widgets share the same small pool, remote video feeds are low frame rate
+    static QThreadPool pool;
+    static bool initialized = false;
+    if (!initialized) {
+        pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+        initialized = true;
+    }
+    return &pool;
+}
+
+VideoFrameScaler::VideoFrameScaler(QObject *parent) :
+    QObject(parent),
+    pendingDevicePixelRatio(1.0),
+    hasPendingImage(false),
+    running(false),
+    currentDestination(0),
+    droppedFrames(0)
+{
+
+}
+
+VideoFrameScaler::~VideoFrameScaler()
+{
+    {
+        QMutexLocker locker(&mutex);
+        hasPendingImage = false; // the running task will finish after the current frame
+    }
+
+    future.waitForFinished();
+}
+
+QRect VideoFrameScaler::computeTargetRect(const QSize &imageSize, const QSize &widgetSize)
+{
+    if (imageSize.isEmpty() || widgetSize.isEmpty())
+        return QRect(QPoint(0, 0), widgetSize);
+
+    QSize targetSize = imageSize.scaled(widgetSize, Qt::KeepAspectRatio);
+    int x = (widgetSize.width() - targetSize.width()) / 2;
+    int y = (widgetSize.height() - targetSize.height()) / 2;
+
+    return QRect(QPoint(x, y), targetSize);
+}
+
+void VideoFrameScaler::scale(const QImage &image, const QSize &targetSize, qreal devicePixelRatio)
+{
+    if (image.isNull() || targetSize.isEmpty())
+        return;
+
+    QMutexLocker locker(&mutex);
+
+    if (hasPendingImage)
+        dropFrame(); // the previous pending frame was not scaled yet, just replace it
+
+    pendingImage = image;
+    pendingSize = targetSize;
+    pendingDevicePixelRatio = devicePixelRatio;
+    hasPendingImage = true;
+
+    if (!running) {
+        running = true;
+        future = QtConcurrent::run(threadPool(), this, &VideoFrameScaler::processPendingFrames);
+    }
+}
+
+QImage &VideoFrameScaler::nextDestinationImage(const QSize &size)
+{
+    // the last emitted image can be in the GUI, the other one is reused when released (detached)
+    int next = (currentDestination + 1) % 2;
+    if (!destinationImages[next].isDetached() && destinationImages[currentDestination].isDetached())
+        next = currentDestination;
+
+    currentDestination = next;
+
+    QImage &image = destinationImages[currentDestination];
+    if (image.size() != size || !image.isDetached())
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied); // still in use by the GUI, the shared data is not touched
+
+    return image;
+}
+
+void VideoFrameScaler::processPendingFrames()
+{
+    forever {
+        QImage sourceImage;
+        QSize targetSize;
+        qreal devicePixelRatio;
+        {
+            QMutexLocker locker(&mutex);
+            if (!hasPendingImage) {
+                running = false;
+                return;
+            }
+            sourceImage = pendingImage;
+            targetSize = pendingSize;
+            devicePixelRatio = pendingDevicePixelRatio;
+            pendingImage = QImage(); // release the source frame as soon as possible
+            hasPendingImage = false;
+        }
+
+        QImage &destination = nextDestinationImage(targetSize);
+        destination.fill(Qt::transparent);
+
+        QPainter painter(&destination);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(destination.rect(), sourceImage, sourceImage.rect());
+        painter.end();
+
+        destination.setDevicePixelRatio(devicePixelRatio); // set before sharing the image, no copies in GUI thread
+
+        emit frameScaled(destination); // queued to GUI thread
+    }
+}
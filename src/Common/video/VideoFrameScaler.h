@@ -0,0 +1,71 @@
+#ifndef VIDEOFRAMESCALER_H
+#define VIDEOFRAMESCALER_H
+
+#include <QObject>
+#include <QImage>
+#include <QMutex>
+#include <QFuture>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+/**
+ * Scale video frames outside the GUI thread. Each VideoWidget owns one scaler. Only the
+ * most recent frame is kept while a scale is running, older pending frames are dropped and counted.
+ * The scaled frames are painted in two destination images (ping-pong). A destination is rewritten
+ * only when the GUI released it, so in the steady state we don't allocate or copy an image for every frame.
+ */
+
+class VideoFrameScaler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VideoFrameScaler(QObject *parent = nullptr);
+    ~VideoFrameScaler();
+
+    // the target size is in device pixels, the scaled image is emitted with the device pixel ratio
+    void scale(const QImage &image, const QSize &targetSize, qreal devicePixelRatio = 1.0);
+
+    // the image rect (in widget coordinates) keeping the image aspect ratio, centered in the widget
+    static QRect computeTargetRect(const QSize &imageSize, const QSize &widgetSize);
+
+    void dropFrame(); // used to count frames skipped before reaching the scaler (hidden widgets, for example)
+
+    uint getDroppedFrames() const;
+
+signals:
+    void frameScaled(const QImage &scaledImage);
+
+private:
+    void processPendingFrames(); // running in a pool thread
+
+    QImage &nextDestinationImage(const QSize &size);
+
+    QMutex mutex;
+    QImage pendingImage;
+    QSize pendingSize;
+    qreal pendingDevicePixelRatio;
+    bool hasPendingImage;
+    bool running;
+
+    QImage destinationImages[2];
+    int currentDestination;
+
+    QAtomicInt droppedFrames;
+
+    QFuture<void> future;
+
+    static QThreadPool *threadPool();
+};
+
+inline uint VideoFrameScaler::getDroppedFrames() const
+{
+    return static_cast<uint>(droppedFrames.load());
+}
+
+inline void VideoFrameScaler::dropFrame()
+{
+    droppedFrames.fetchAndAddRelaxed(1);
+}
+
+#endif // VIDEOFRAMESCALER_H
@@ -1,4 +1,5 @@
 #include "VideoWidget.h"
+#include "VideoFrameScaler.h"
 #include <QIcon>
 #include <QDebug>
 
@@ -7,8 +8,10 @@ const int VideoWidget::MIN_SIZE = 32;
 VideoWidget::VideoWidget(QWidget *parent, bool activated) :
     QWidget(parent),
     activated(activated),
-    targetRect(0, 0, VideoWidget::MIN_SIZE, VideoWidget::MIN_SIZE)
+    targetRect(0, 0, VideoWidget::MIN_SIZE, VideoWidget::MIN_SIZE),
+    frameScaler(new VideoFrameScaler(this))
 {
+    connect(frameScaler, &VideoFrameScaler::frameScaled, this, &VideoWidget::setScaledImage, Qt::QueuedConnection);
 
     webcamIcon = QIcon(":/images/webcam.png");
 }
@@ -17,53 +20,73 @@ void VideoWidget::activate(bool status)
 {
     if (status != activated) {
         activated = status;
+
+        if (activated && !currentImage.isNull())
+            updateScaledImage();
+
         update();
 
         emit statusChanged(activated);
     }
 }
 
+uint VideoWidget::getDroppedFrames() const
+{
+    return frameScaler->getDroppedFrames();
+}
+
+bool VideoWidget::canPaintFrames() const
+{
+    return activated && isVisible() && !visibleRegion().isEmpty(); // skip hidden or fully obscured widgets
+}
+
 void VideoWidget::setCurrentFrame(const QImage &image)
 {
+    bool sizeChanged = image.size() != currentImage.size();
+
     currentImage = image;
 
-    if (!currentImage.isNull() && activated) {
+    if (currentImage.isNull() || !activated)
+        return;
 
-        updateScaledImage();
-        updateGeometry();
+    if (!canPaintFrames()) {
+        frameScaler->dropFrame();
+        return;
     }
 
-    if (activated)
-        update();
+    if (sizeChanged)
+        updateGeometry();
+
+    updateScaledImage();
 }
 
-void VideoWidget::updateScaledImage()
+void VideoWidget::setScaledImage(const QImage &image)
 {
-    QRect sourceRect = currentImage.rect();
-
-    qreal ratio = 1.0;
+    scaledImage = image; // shared with the scaler, released when the next frame arrives
 
-    bool small = height() < width();
-    if (small)
-        ratio =  static_cast<float>(height())/sourceRect.height();
-    else
-        ratio =  static_cast<float>(width())/sourceRect.width();
+    update();
+}
 
-    qreal targetHeight = small ? height() : currentImage.height() * ratio;
-    qreal targetWidth = small ? currentImage.width() * ratio : width();
-    qreal targetX = (width() - targetWidth) / 2.0;
-    qreal targetY = (height() - targetHeight) / 2.0;
+void VideoWidget::updateTargetRect()
+{
+    targetRect = VideoFrameScaler::computeTargetRect(currentImage.size(), size());
+}
 
-    targetRect = QRect(targetX, targetY, targetWidth, targetHeight);
+void VideoWidget::updateScaledImage()
+{
+    updateTargetRect();
 
-    scaledImage = currentImage.scaled(targetRect.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    // the scaled frame is produced in device pixels, so painting is just a blit
+    qreal devicePixelRatio = devicePixelRatioF();
+    QSize scaledSize = targetRect.size() * devicePixelRatio;
+    frameScaler->scale(currentImage, scaledSize, devicePixelRatio);
 }
 
 void VideoWidget::resizeEvent(QResizeEvent *ev)
 {
     Q_UNUSED(ev);
 
-    if (!currentImage.isNull())
+    if (!currentImage.isNull() && activated)
         updateScaledImage();
 
     updateGeometry();
@@ -88,7 +111,7 @@ void VideoWidget::paintEvent(QPaintEvent *ev)
     static const QColor bgColor(0, 0, 0, 30);
     painter.fillRect(rect(), bgColor);
 
-    if (!currentImage.isNull() && activated) {
+    if (!scaledImage.isNull() && activated) {
         painter.drawImage(targetRect, scaledImage, scaledImage.rect());
     }
 
@@ -108,6 +131,9 @@ void VideoWidget::showEvent(QShowEvent *ev)
 {
     Q_UNUSED(ev);
 
+    if (!currentImage.isNull() && activated)
+        updateScaledImage(); // frames were skipped while hidden
+
     emit visibilityChanged(true);
 }
 
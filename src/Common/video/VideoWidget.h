@@ -6,6 +6,7 @@
 #include <QPaintEvent>
 #include <QIcon>
 
+class VideoFrameScaler;
 
 class VideoWidget : public QWidget
 {
@@ -23,6 +24,8 @@ public:
         return activated;
     }
 
+    uint getDroppedFrames() const; // frames not painted because the widget was hidden or the scaler was busy
+
 signals:
     void statusChanged(bool activated);
     void visibilityChanged(bool visible);
@@ -38,12 +41,20 @@ protected:
 
     QSize minimumSizeHint() const override;
 
+private slots:
+    void setScaledImage(const QImage &image);
+
 private:
     QImage currentImage;
     QImage scaledImage;
     QRect targetRect;
 
     void updateScaledImage();
+    void updateTargetRect();
+
+    bool canPaintFrames() const;
+
+    VideoFrameScaler *frameScaler;
 
     bool activated;
 
@@ -0,0 +1,200 @@
+#include "SandboxChannel.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <climits>
+
+#if defined(Q_OS_LINUX)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+#elif defined(Q_OS_WIN)
+    #include <windows.h>
+#elif defined(Q_OS_MAC)
+    #include <dlfcn.h>
+    #include <cstdint>
+#endif
+
+using namespace Vst;
+
+const int SandboxBlock::MAX_CHANNELS;
+const int SandboxBlock::MAX_FRAMES;
+const int SandboxBlock::MAX_MIDI_MESSAGES;
+const int SandboxRing::SIZE;
+const quint32 SandboxSharedData::VERSION;
+
+static_assert(sizeof(QAtomicInt) == sizeof(int), "QAtomicInt is used as a futex word");
+
+#ifdef Q_OS_MAC
+namespace {
+
+/**
+    __ulock_wait/__ulock_wake are the darwin futex (used by libc++ in std::atomic::wait). They are available
+    since OS X 10.12, Jamtaba supports 10.7, so the functions are resolved in runtime.
+*/
+
+const uint32_t UL_COMPARE_AND_WAIT_SHARED = 3;
+const uint32_t ULF_WAKE_ALL = 0x00000100;
+
+typedef int (*UlockWaitFunction)(uint32_t operation, void *address, uint64_t value, uint32_t timeoutInMicroseconds);
+typedef int (*UlockWakeFunction)(uint32_t operation, void *address, uint64_t wakeValue);
+
+UlockWaitFunction ulockWait = reinterpret_cast<UlockWaitFunction>(dlsym(RTLD_DEFAULT, "__ulock_wait"));
+UlockWakeFunction ulockWake = reinterpret_cast<UlockWakeFunction>(dlsym(RTLD_DEFAULT, "__ulock_wake"));
+
+} // namespace
+#endif
+
+SandboxSignal::SandboxSignal() :
+    event(nullptr)
+{
+}
+
+SandboxSignal::~SandboxSignal()
+{
+    close();
+}
+
+bool SandboxSignal::open(const QString &name)
+{
+#ifdef Q_OS_WIN
+    close();
+
+    // auto reset event, created by the first process and opened by the second
+    event = CreateEventW(nullptr, FALSE, FALSE, reinterpret_cast<LPCWSTR>(name.utf16()));
+    return event != nullptr;
+#else
+    Q_UNUSED(name)
+    return true;
+#endif
+}
+
+void SandboxSignal::close()
+{
+#ifdef Q_OS_WIN
+    if (event) {
+        CloseHandle(static_cast<HANDLE>(event));
+        event = nullptr;
+    }
+#endif
+}
+
+void SandboxSignal::wait(QAtomicInt &word, int observedValue, int timeoutInMicroseconds)
+{
+#if defined(Q_OS_LINUX)
+    // the shared memory is mapped in 2 processes, so the futex can't be FUTEX_PRIVATE
+    timespec timeout;
+    timeout.tv_sec = timeoutInMicroseconds / 1000000;
+    timeout.tv_nsec = (timeoutInMicroseconds % 1000000) * 1000;
+    syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAIT, observedValue, &timeout, nullptr, 0);
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(word)
+    Q_UNUSED(observedValue)
+
+    // a block written before the wait leave the event signaled, so no wake up is lost
+    DWORD timeoutInMilliseconds = static_cast<DWORD>((timeoutInMicroseconds + 999) / 1000);
+    if (event)
+        WaitForSingleObject(static_cast<HANDLE>(event), timeoutInMilliseconds);
+#else
+    if (ulockWait) {
+        // zero is an infinite timeout in __ulock_wait
+        ulockWait(UL_COMPARE_AND_WAIT_SHARED, &word, static_cast<uint32_t>(observedValue), static_cast<uint32_t>(qMax(timeoutInMicroseconds, 1)));
+        return;
+    }
+
+    // old OS X versions, yielding until the producer write a new block or the timeout
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 timeoutInNanoseconds = static_cast<qint64>(timeoutInMicroseconds) * 1000;
+    while (word.loadAcquire() == observedValue && timer.nsecsElapsed() < timeoutInNanoseconds)
+        QThread::yieldCurrentThread();
+#endif
+}
+
+void SandboxSignal::wake(QAtomicInt &word)
+{
+#if defined(Q_OS_LINUX)
+    syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(word)
+    if (event)
+        SetEvent(static_cast<HANDLE>(event));
+#else
+    if (ulockWake)
+        ulockWake(UL_COMPARE_AND_WAIT_SHARED | ULF_WAKE_ALL, &word, 0);
+#endif
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+void SandboxRing::reset()
+{
+    writeIndex.store(0);
+    readIndex.store(0);
+}
+
+SandboxBlock *SandboxRing::getWriteBlock()
+{
+    const int write = writeIndex.load();
+    if (write - readIndex.loadAcquire() >= SIZE)
+        return nullptr; // full
+
+    return &blocks[write & (SIZE - 1)];
+}
+
+void SandboxRing::commitWrite(SandboxSignal &signal)
+{
+    writeIndex.fetchAndAddRelease(1);
+    wakeConsumer(signal);
+}
+
+SandboxBlock *SandboxRing::getReadBlock()
+{
+    const int read = readIndex.load();
+    if (writeIndex.loadAcquire() == read)
+        return nullptr; // empty
+
+    return &blocks[read & (SIZE - 1)];
+}
+
+void SandboxRing::commitRead()
+{
+    readIndex.fetchAndAddRelease(1);
+}
+
+bool SandboxRing::waitForData(SandboxSignal &signal, int timeoutInMicroseconds)
+{
+    const int observedWriteIndex = writeIndex.loadAcquire();
+    if (observedWriteIndex != readIndex.load())
+        return true;
+
+    signal.wait(writeIndex, observedWriteIndex, timeoutInMicroseconds);
+
+    return writeIndex.loadAcquire() != readIndex.load();
+}
+
+void SandboxRing::wakeConsumer(SandboxSignal &signal)
+{
+    signal.wake(writeIndex);
+}
+
+// +++++++++++++++++++++++++++++++++++++++++++
+
+void SandboxSharedData::reset()
+{
+    version = VERSION;
+    state.store(STARTING);
+    requests.reset();
+    responses.reset();
+}
+
+QString SandboxSharedData::getRequestsSignalName(const QString &sharedMemoryKey)
+{
+    return sharedMemoryKey + "-requests";
+}
+
+QString SandboxSharedData::getResponsesSignalName(const QString &sharedMemoryKey)
+{
+    return sharedMemoryKey + "-responses";
+}
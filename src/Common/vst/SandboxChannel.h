@@ -0,0 +1,105 @@
+#ifndef VST_SANDBOX_CHANNEL_H
+#define VST_SANDBOX_CHANNEL_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QString>
+
+namespace Vst {
+
+/**
+ * The audio transport between Jamtaba and a sandboxed VST plugin running in the VstScanner process (--sandbox mode).
+ * Everything here lives in a QSharedMemory segment: two single producer/single consumer rings of audio blocks,
+ * one for the requests (Jamtaba -> plugin) and another for the responses. The consumer sleeps on the ring write
+ * index (futex in Linux, __ulock in macOS) or in a named event (Windows), see SandboxSignal.
+ */
+
+struct SandboxBlock
+{
+    static const int MAX_CHANNELS = 2;
+    static const int MAX_FRAMES = 4096;
+    static const int MAX_MIDI_MESSAGES = 64;
+
+    quint32 sequence; // responses are matched with the requests using the sequence, late responses are discarded
+    quint32 frames;
+    quint32 midiMessages;
+    qint32 midiData[MAX_MIDI_MESSAGES]; // status | data1 << 8 | data2 << 16
+    float samples[MAX_CHANNELS][MAX_FRAMES];
+};
+
+/**
+ * The process local part of the ring wait. Windows can't wait on a shared memory address from another process,
+ * so a named event is opened (with the same name) in Jamtaba and in the sandbox process. Linux and macOS are
+ * using the ring write index and the event is not created.
+ */
+
+class SandboxSignal
+{
+public:
+    SandboxSignal();
+    ~SandboxSignal();
+
+    bool open(const QString &name);
+    void close();
+
+    void wait(QAtomicInt &word, int observedValue, int timeoutInMicroseconds);
+    void wake(QAtomicInt &word);
+
+private:
+    Q_DISABLE_COPY(SandboxSignal)
+
+    void *event; // Windows HANDLE
+};
+
+class SandboxRing
+{
+public:
+    void reset();
+
+    // producer side
+    SandboxBlock *getWriteBlock(); // nullptr when the ring is full
+    void commitWrite(SandboxSignal &signal); // publish the written block and wake the consumer
+
+    // consumer side
+    SandboxBlock *getReadBlock(); // nullptr when the ring is empty
+    void commitRead();
+    bool waitForData(SandboxSignal &signal, int timeoutInMicroseconds); // false if the ring still empty after the timeout
+
+    void wakeConsumer(SandboxSignal &signal); // used to stop a sleeping consumer
+
+private:
+    static const int SIZE = 4; // power of 2
+
+    QAtomicInt writeIndex; // also used as the futex (or __ulock) word
+    QAtomicInt readIndex;
+
+    SandboxBlock blocks[SIZE];
+};
+
+struct SandboxSharedData
+{
+    static const quint32 VERSION = 1;
+
+    enum State
+    {
+        STARTING,
+        RUNNING,
+        STOPPING
+    };
+
+    void reset();
+
+    // names of the Windows events, the same shared memory key is known by both processes
+    static QString getRequestsSignalName(const QString &sharedMemoryKey);
+    static QString getResponsesSignalName(const QString &sharedMemoryKey);
+
+    quint32 version;
+    QAtomicInt state;
+
+    SandboxRing requests; // Jamtaba -> sandbox process
+    SandboxRing responses; // sandbox process -> Jamtaba
+};
+
+} // namespace
+
+#endif // VST_SANDBOX_CHANNEL_H
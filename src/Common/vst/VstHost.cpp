@@ -204,6 +204,10 @@ long VSTCALLBACK VstHost::hostCallback(AEffect *effect, long opcode, long index,
         return 1L;
     }
 
+    case audioMasterIOChanged: // 13 - initialDelay (or the number of inputs/outputs) changed
+        emit VstHost::getInstance()->pluginLatencyChanged();
+        return 1L;
+
     case audioMasterUpdateDisplay:// 42
         //QCoreApplication::processEvents();  crashing in MAC
         return 1L;
@@ -219,6 +223,7 @@ long VSTCALLBACK VstHost::hostCallback(AEffect *effect, long opcode, long index,
             || (!strcmp(str, "sendVstMidiEventFlagIsRealtime"))
             || (!strcmp(str, "sendVstTimeInfo"))
             || (!strcmp(str, "supplyIdle"))
+            || (!strcmp(str, "acceptIOChanges"))
             )
             return 1L;
 
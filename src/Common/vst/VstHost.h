@@ -44,6 +44,7 @@ protected:
 
 signals:
     void pluginRequestingWindowResize(const QString &pluginName, int newWidth, int newHeight);
+    void pluginLatencyChanged(); // audioMasterIOChanged, emitted in the plugin thread
 
 private:
     VstTimeInfo vstTimeInfo;
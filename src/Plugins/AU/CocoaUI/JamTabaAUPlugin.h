@@ -31,6 +31,8 @@ public:
     
     qint32 getStartPositionForHostSync() const override;
     
+    bool getHostPpqPosition(double *ppqPosition) const override;
+    
     MainControllerPlugin *createPluginMainController(const Persistence::Settings &settings, JamTabaPlugin *plugin) const override;
     
     // JamTabaAUInterface
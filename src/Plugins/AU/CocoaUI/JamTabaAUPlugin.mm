@@ -108,12 +108,7 @@ void JamTabaAUPlugin::processAudio(Float32 **inputs, Float32 **outputs, UInt16 i
     if (controller->isPlayingInNinjamRoom()) {
         
         // ++++++++++ sync ninjam with host  ++++++++++++
-        if (transportStartDetectedInHost()) {// user pressing play/start in host?
-            NinjamControllerPlugin *ninjamController = controller->getNinjamController();
-            if (ninjamController->isWaitingForHostSync()) {
-                ninjamController->startSynchronizedWithHost(getStartPositionForHostSync());
-            }
-        }
+        synchronizeWithHost();
     }
     
     // ++++++++++ Audio processing +++++++++++++++
@@ -173,6 +168,15 @@ qint32 JamTabaAUPlugin::getStartPositionForHostSync() const
  
 }
 
+bool JamTabaAUPlugin::getHostPpqPosition(double *ppqPosition) const
+{
+    if (hostState.tempo <= 0 || hostState.sampleRate <= 0) // the position is computed using the host tempo
+        return false;
+
+    *ppqPosition = hostState.ppqPos;
+    return true;
+}
+
 bool JamTabaAUPlugin::hostIsPlaying() const
 {
     return hostState.playing;
@@ -67,6 +67,23 @@ void JamTabaPlugin::close()
     JamTabaPlugin::instanceIsInitialized = false; // the anti troll flag :)
 }
 
+void JamTabaPlugin::synchronizeWithHost()
+{
+    NinjamControllerPlugin *ninjamController = controller->getNinjamController();
+    Q_ASSERT(ninjamController);
+
+    double hostPpqPosition = 0;
+    bool hostPositionIsValid = getHostPpqPosition(&hostPpqPosition);
+
+    if (transportStartDetectedInHost()) { // user pressing play/start in host?
+        if (ninjamController->isWaitingForHostSync())
+            ninjamController->startSynchronizedWithHost(hostPositionIsValid ? getStartPositionForHostSync() : 0);
+    }
+
+    if (hostIsPlaying() && hostPositionIsValid) // the interval is not moved when host is not reporting the position
+        ninjamController->followHostPosition(hostPpqPosition, getHostBpm());
+}
+
 void JamTabaPlugin::setSampleRate(float sampleRate)
 {
     if (controller)
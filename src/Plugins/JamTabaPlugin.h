@@ -41,10 +41,14 @@ protected:
 
     inline bool transportStartDetectedInHost() const;
 
+    void synchronizeWithHost(); // start the synchronized interval or keep it aligned with host bars, called in audio callbacks
+
     virtual bool hostIsPlaying() const = 0;
     
     virtual qint32 getStartPositionForHostSync() const = 0;
 
+    virtual bool getHostPpqPosition(double *ppqPosition) const = 0; // host position in quarter notes, false when host is not reporting the position
+
     virtual MainControllerPlugin *createPluginMainController(const Persistence::Settings &settings, JamTabaPlugin *plugin) const = 0;
 
 };
@@ -8,11 +8,18 @@
 
 using namespace Controller;
 
+const int MainControllerPlugin::OUTPUT_BUSES = 8;
+
 MainControllerPlugin::MainControllerPlugin(const Persistence::Settings &settings, JamTabaPlugin *plugin) :
     MainController(settings),
-    plugin(plugin)
+    plugin(plugin),
+    outputBuses(OUTPUT_BUSES),
+    renderedFrames(0)
 {
     qCDebug(jtCore) << "Creating MainControllerVST instance!";
+
+    for (int bus = 0; bus < OUTPUT_BUSES; ++bus)
+        outputBusesTracks.append(-1);
 }
 
 MainControllerPlugin::~MainControllerPlugin()
@@ -37,6 +44,78 @@ int MainControllerPlugin::addInputTrackNode(Audio::LocalInputNode *inputTrackNod
     return inputTrackID;
 }
 
+bool MainControllerPlugin::addTrack(long trackID, Audio::AudioNode *trackNode)
+{
+    if (!inputTracks.contains(trackID)) { // local inputs are not routed, the host already have these signals
+        QMutexLocker locker(&mutex);
+
+        // the first bus is reserved to metronome, the ninjam tracks are using the free buses
+        int busIndex = -1;
+        if (trackID == NinjamController::METRONOME_TRACK_ID) {
+            busIndex = 0;
+        }
+        else {
+            for (int bus = 1; bus < OUTPUT_BUSES && busIndex < 0; ++bus) {
+                if (outputBusesTracks.at(bus) < 0)
+                    busIndex = bus;
+            }
+        }
+
+        if (busIndex >= 0) {
+            outputBusesTracks[busIndex] = trackID;
+            trackNode->setOutputBus(&outputBuses[busIndex]);
+        }
+    }
+
+    return MainController::addTrack(trackID, trackNode);
+}
+
+void MainControllerPlugin::removeTrack(long trackID)
+{
+    {
+        QMutexLocker locker(&mutex);
+        int busIndex = outputBusesTracks.indexOf(trackID);
+        if (busIndex >= 0)
+            outputBusesTracks[busIndex] = -1; // the bus will be reused by the next ninjam track
+    }
+
+    MainController::removeTrack(trackID);
+}
+
+void MainControllerPlugin::wrapOutputBuses(float **busesSamples, int frameLenght)
+{
+    for (uint bus = 0; bus < outputBuses.size(); ++bus)
+        outputBuses[bus].buffer.wrap(busesSamples + bus * 2, frameLenght);
+}
+
+void MainControllerPlugin::unwrapOutputBuses()
+{
+    for (Audio::OutputBus &bus : outputBuses)
+        bus.buffer.unwrap();
+}
+
+void MainControllerPlugin::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate)
+{
+    for (Audio::OutputBus &bus : outputBuses) {
+        bus.buffer.setFrameLenght(out.getFrameLenght());
+        bus.buffer.zero();
+    }
+    renderedFrames = 0;
+
+    MainController::process(in, out, sampleRate);
+}
+
+void MainControllerPlugin::doAudioProcess(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate)
+{
+    // called one time per audio block, or one time for each part when the block is crossing the ninjam interval boundary
+    for (Audio::OutputBus &bus : outputBuses)
+        bus.offset = renderedFrames;
+
+    MainController::doAudioProcess(in, out, sampleRate);
+
+    renderedFrames += out.getFrameLenght();
+}
+
 QString MainControllerPlugin::getUserEnvironmentString() const
 {
     return MainController::getUserEnvironmentString() + " running in " + getHostName();
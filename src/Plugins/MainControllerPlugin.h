@@ -5,6 +5,9 @@
 #include "NinjamController.h"
 #include "audio/core/PluginDescriptor.h"
 #include "NinjamControllerPlugin.h"
+#include "audio/core/AudioNode.h"
+
+#include <vector>
 
 class JamTabaPlugin;
 
@@ -32,6 +35,19 @@ public:
 
     int addInputTrackNode(Audio::LocalInputNode *inputTrackNode) override;
 
+    bool addTrack(long trackID, Audio::AudioNode *trackNode) override;
+    void removeTrack(long trackID) override;
+
+    void process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate) override;
+
+    const Audio::SamplesBuffer &getOutputBusBuffer(int busIndex) const;
+
+    // the buses are rendered directly in the host outputs, two channels per bus
+    void wrapOutputBuses(float **busesSamples, int frameLenght);
+    void unwrapOutputBuses();
+
+    static const int OUTPUT_BUSES; // metronome and the first ninjam tracks, the main mix is not included
+
     void setSampleRate(int newSampleRate) override;
 
     float getSampleRate() const override;
@@ -61,8 +77,20 @@ protected:
         return std::vector<Midi::MidiMessage>(); // empty buffer
     }
 
+    void doAudioProcess(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate) override;
+
     JamTabaPlugin *plugin;
 
+private:
+    std::vector<Audio::OutputBus> outputBuses;
+    QList<long> outputBusesTracks; // the track ID routed to each bus, -1 in free buses
+    uint renderedFrames; // frames rendered in the current audio block, used as buses offset
+
 };
 
+inline const Audio::SamplesBuffer &MainControllerPlugin::getOutputBusBuffer(int busIndex) const
+{
+    return outputBuses[busIndex].buffer;
+}
+
 #endif // MAINCONTROLLERPLUGIN_H
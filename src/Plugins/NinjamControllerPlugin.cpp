@@ -3,11 +3,13 @@
 
 #include "audio/MetronomeTrackNode.h"
 #include "audio/NinjamTrackNode.h"
+#include "log/Logging.h"
 
 NinjamControllerPlugin::NinjamControllerPlugin(MainControllerPlugin *controller) :
     NinjamController(controller),
+    controller(controller),
     waitingForHostSync(false),
-    controller(controller)
+    followingHost(false)
 {
     //
 }
@@ -46,6 +48,7 @@ void NinjamControllerPlugin::activateAudioNodes()
 void NinjamControllerPlugin::disableHostSync()
 {
     waitingForHostSync = false;
+    followingHost = false;
     activateAudioNodes();
 }
 
@@ -58,10 +61,42 @@ void NinjamControllerPlugin::startSynchronizedWithHost(qint32 startPosition)
         else
             intervalPosition = samplesInInterval - qAbs(startPosition % samplesInInterval);
 
+        hostPositionFollower.reset();
+        followingHost = true;
+
         activateAudioNodes();
     }
 }
 
+void NinjamControllerPlugin::followHostPosition(double hostPpqPosition, int hostBpm)
+{
+    if (!followingHost || waitingForHostSync)
+        return;
+
+    if (!hostPositionFollower.isAnchored(currentBpi)) { // BPI changes are processed in interval start, the new intervals are anchored again
+        hostPositionFollower.anchor(hostPpqPosition, intervalPosition, samplesInInterval, currentBpi);
+        return;
+    }
+
+    if (hostBpm != currentBpm) // host grid and ninjam interval are not compatible, waiting until user fix the host BPM
+        return;
+
+    intervalPosition = hostPositionFollower.follow(hostPpqPosition, intervalPosition, samplesInInterval);
+}
+
+void NinjamControllerPlugin::handleNewInterval()
+{
+    NinjamController::handleNewInterval();
+
+    if (hostPositionFollower.hasPendingResync()) { // host jumped in the last interval, the new interval starts in host position
+        long resyncPosition = hostPositionFollower.takeResyncPosition(samplesInInterval, currentBpi);
+        if (resyncPosition > 0) {
+            qCDebug(jtVstPlugin) << "Host position jump detected, new interval starting in" << resyncPosition;
+            intervalPosition = resyncPosition;
+        }
+    }
+}
+
 void NinjamControllerPlugin::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate)
 {
     if (!waitingForHostSync)
@@ -2,6 +2,7 @@
 #define NINJAM_CONTROLLER_VST_H
 
 #include "NinjamController.h"
+#include "audio/HostPositionFollower.h"
 
 class MainControllerPlugin;
 
@@ -13,17 +14,24 @@ public:
 
     bool isWaitingForHostSync() const;
 
-    void startSynchronizedWithHost(qint32 startPosition);
+    void startSynchronizedWithHost(qint32 startPosition); // the interval is anchored in the next valid host position
     void stopAndWaitForHostSync();
     void disableHostSync();
 
+    void followHostPosition(double hostPpqPosition, int hostBpm); // called in every audio callback while host is playing
+
     void process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int sampleRate);
 
+protected:
+    void handleNewInterval() override;
+
 private:
 
     MainControllerPlugin *controller; // just a casted version of mainController instance
 
     bool waitingForHostSync;
+    bool followingHost;
+    Audio::HostPositionFollower hostPositionFollower; // the anchor is updated when the BPI is changed
 
     void deactivateAudioNodes(); // ninjam related audio nodes will not be rendered
     void activateAudioNodes();
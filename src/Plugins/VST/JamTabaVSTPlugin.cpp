@@ -20,7 +20,7 @@ JamTabaVSTPlugin::JamTabaVSTPlugin(audioMasterCallback audioMaster) :
 {
     qCDebug(jtVstPlugin) << "Plugin constructor...";
     setNumInputs(DEFAULT_INPUTS*2);
-    setNumOutputs(DEFAULT_OUTPUTS*2);
+    setNumOutputs((DEFAULT_OUTPUTS + MainControllerPlugin::OUTPUT_BUSES) * 2);
 
     canProcessReplacing(true);
     programsAreChunks(false);
@@ -156,6 +156,31 @@ VstInt32 JamTabaVSTPlugin::canDo(char *text)
     return 0;
 }
 
+bool JamTabaVSTPlugin::getOutputProperties(VstInt32 index, VstPinProperties *properties)
+{
+    if (index < 0 || index >= (DEFAULT_OUTPUTS + MainControllerPlugin::OUTPUT_BUSES) * 2)
+        return false;
+
+    int bus = index / 2;
+    QString label;
+    if (bus == 0)
+        label = "Jamtaba";
+    else if (bus == 1)
+        label = "Metronome";
+    else
+        label = QString("Ninjam %1").arg(bus - 1);
+
+    label += (index % 2 == 0) ? " L" : " R";
+
+    vst_strncpy(properties->label, label.toUtf8().constData(), kVstMaxLabelLen - 1);
+    vst_strncpy(properties->shortLabel, label.toUtf8().constData(), kVstMaxShortLabelLen - 1);
+    properties->flags = kVstPinIsActive;
+    if (index % 2 == 0)
+        properties->flags |= kVstPinIsStereo; // the first channel of each stereo pair
+
+    return true;
+}
+
 qint32 JamTabaVSTPlugin::getStartPositionForHostSync() const
 {
     qint32 startPosition = 0;
@@ -174,6 +199,28 @@ qint32 JamTabaVSTPlugin::getStartPositionForHostSync() const
     return startPosition;
 }
 
+bool JamTabaVSTPlugin::getHostPpqPosition(double *ppqPosition) const
+{
+    if (!timeInfo || !(timeInfo->flags & kVstPpqPosValid))
+        return false;
+
+    *ppqPosition = timeInfo->ppqPos;
+    return true;
+}
+
+bool JamTabaVSTPlugin::hostIsReusingInputsAsOutputs(float **inputs, float **outputs) const
+{
+    const int totalOutputs = outputBuffer.getChannels() + MainControllerPlugin::OUTPUT_BUSES * 2;
+    for (int in = 0; in < inputBuffer.getChannels(); ++in) {
+        for (int out = 0; out < totalOutputs; ++out) {
+            if (inputs[in] == outputs[out])
+                return true;
+        }
+    }
+
+    return false;
+}
+
 void JamTabaVSTPlugin::processReplacing(float **inputs, float **outputs, VstInt32 sampleFrames)
 {
     if (!controller)
@@ -184,28 +231,33 @@ void JamTabaVSTPlugin::processReplacing(float **inputs, float **outputs, VstInt3
         // ++++++++++ sync ninjam BPM with host BPM ++++++++++++
         // ask timeInfo to VST host
 
-        timeInfo = getTimeInfo(kVstTransportPlaying | kVstTransportChanged | kVstTempoValid);
-        if (transportStartDetectedInHost()) { // user pressing play/start in host?
-            NinjamControllerPlugin *ninjamController = controller->getNinjamController();
-            Q_ASSERT(ninjamController);
-            if (ninjamController->isWaitingForHostSync())
-                ninjamController->startSynchronizedWithHost(getStartPositionForHostSync());
-        }
+        timeInfo = getTimeInfo(kVstTransportPlaying | kVstTransportChanged | kVstTempoValid | kVstPpqPosValid | kVstBarsValid | kVstTimeSigValid);
+        if (timeInfo)
+            synchronizeWithHost();
     }
 
     // ++++++++++ Audio processing +++++++++++++++
-    inputBuffer.setFrameLenght(sampleFrames);
-    for (int c = 0; c < inputBuffer.getChannels(); ++c)
-        memcpy(inputBuffer.getSamplesArray(c), inputs[c], sizeof(float) * sampleFrames);
+    // the host buffers are rendered in place, the inputs are copied only when the host is reusing them as outputs
+    if (hostIsReusingInputsAsOutputs(inputs, outputs)) {
+        inputBuffer.setFrameLenght(sampleFrames);
+        for (int c = 0; c < inputBuffer.getChannels(); ++c)
+            memcpy(inputBuffer.getSamplesArray(c), inputs[c], sizeof(float) * sampleFrames);
+    }
+    else {
+        inputBuffer.wrap(inputs, sampleFrames);
+    }
 
-    outputBuffer.setFrameLenght(sampleFrames);
+    outputBuffer.wrap(outputs, sampleFrames);
     outputBuffer.zero();
 
+    // metronome and ninjam tracks in separated stereo outputs, so users can record the stems in the host
+    controller->wrapOutputBuses(outputs + outputBuffer.getChannels(), sampleFrames);
+
     controller->process(inputBuffer, outputBuffer, this->sampleRate);
 
-    int channels = outputBuffer.getChannels();
-    for (int c = 0; c < channels; ++c)
-        memcpy(outputs[c], outputBuffer.getSamplesArray(c), sizeof(float) * sampleFrames);
+    controller->unwrapOutputBuses();
+    outputBuffer.unwrap();
+    inputBuffer.unwrap();
 
     // ++++++++++++++++++++++++++++++
     hostWasPlayingInLastAudioCallBack = hostIsPlaying();
@@ -5,7 +5,7 @@
 #define uniqueIDInstrument CCONST('V', 'b', 'I', 's')
 #define VST_EVENT_BUFFER_SIZE 1000
 #define DEFAULT_INPUTS 2
-#define DEFAULT_OUTPUTS 1
+#define DEFAULT_OUTPUTS 1 // the main mix, the metronome and ninjam tracks are using the next stereo outputs (MainControllerPlugin::OUTPUT_BUSES)
 
 #include "JamTabaPlugin.h" // base plugin class
 
@@ -35,6 +35,8 @@ public:
     bool getProductString(char *text);
     VstInt32 getVendorVersion();
 
+    bool getOutputProperties(VstInt32 index, VstPinProperties *properties);
+
     VstInt32 getNumMidiInputChannels();
     VstInt32 getNumMidiOutputChannels();
 
@@ -58,8 +60,12 @@ protected:
 
     qint32 getStartPositionForHostSync() const override;
     bool hostIsPlaying() const override;
+    bool getHostPpqPosition(double *ppqPosition) const override;
 
     MainControllerPlugin *createPluginMainController(const Persistence::Settings &settings, JamTabaPlugin *plugin) const override;
+
+private:
+    bool hostIsReusingInputsAsOutputs(float **inputs, float **outputs) const; // in place processing in host side
 };
 
 
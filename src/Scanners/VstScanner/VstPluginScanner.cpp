@@ -10,8 +10,12 @@
 #include <QDirIterator>
 #include <QLibrary>
 
+#include <iostream>
+#include <string>
+
 VstPluginScanner::VstPluginScanner()
-    : BaseScanner()
+    : BaseScanner(),
+      readingPathsFromInput(false)
 {
     qCDebug(jtStandalonePluginFinder) << "Creating vst plugin scanner!";
 }
@@ -42,6 +46,26 @@ Audio::PluginDescriptor VstPluginScanner::getPluginDescriptor(const QFileInfo &p
 }
 
 void VstPluginScanner::scan()
+{
+    writeToProcessOutput("JT-Scanner-Starting");
+
+    if (readingPathsFromInput)
+        scanPathsFromInput();
+    else
+        scanFolders();
+
+    writeToProcessOutput("JT-Scanner-Finished");
+}
+
+void VstPluginScanner::scanPlugin(const QFileInfo &pluginFileInfo)
+{
+    writeToProcessOutput("JT-Scanner-Scanning: "+ pluginFileInfo.absoluteFilePath());
+    auto descriptor = getPluginDescriptor(pluginFileInfo);
+    if (descriptor.isValid())
+        writeToProcessOutput("JT-Scanner-Scan-Finished: " + descriptor.getPath());
+}
+
+void VstPluginScanner::scanFolders()
 {
     if (foldersToScan.isEmpty()) {
         qCInfo(jtStandalonePluginFinder) << "Folders to scan is empty!";
@@ -50,7 +74,6 @@ void VstPluginScanner::scan()
         qCDebug(jtStandalonePluginFinder) << "Folders to scan: " << foldersToScan;
     }
 
-    writeToProcessOutput("JT-Scanner-Starting");
     for (const QString &scanFolder : foldersToScan)
     {
         QDirIterator folderIterator(scanFolder, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
@@ -59,20 +82,25 @@ void VstPluginScanner::scan()
             folderIterator.next(); // point to next file inside current folder
             QFileInfo pluginFileInfo(folderIterator.filePath());
 
-            if (!skipList.contains(pluginFileInfo.absoluteFilePath()))
-            {
-                if (canScan(pluginFileInfo)) {
-                    writeToProcessOutput("JT-Scanner-Scanning: "+ pluginFileInfo.absoluteFilePath());
-                    auto descriptor = getPluginDescriptor(pluginFileInfo);
-                    if (descriptor.isValid())
-                        writeToProcessOutput("JT-Scanner-Scan-Finished: " + descriptor.getPath());
-                }
-            }
+            if (!skipList.contains(pluginFileInfo.absoluteFilePath()) && canScan(pluginFileInfo))
+                scanPlugin(pluginFileInfo);
         }
     }
-    writeToProcessOutput("JT-Scanner-Finished");
 }
 
+void VstPluginScanner::scanPathsFromInput()
+{
+    // one plugin path per line, the scheduler close the input (or send an empty line) when there is nothing more to scan
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        QString pluginPath = QString::fromUtf8(line.c_str()).trimmed();
+        if (pluginPath.isEmpty())
+            break;
+
+        scanPlugin(QFileInfo(pluginPath));
+        writeToProcessOutput("JT-Scanner-Scan-Done: " + pluginPath); // the scheduler knows the plugin didn't crash the scanner, valid or not
+    }
+}
 
 bool VstPluginScanner::canScan(const QFileInfo &pluginFileInfo) const
 {
@@ -80,6 +108,11 @@ bool VstPluginScanner::canScan(const QFileInfo &pluginFileInfo) const
       In Mac VST plugins are bundles, in windows these plugins are DLLs.
     */
 
+#ifdef Q_OS_LINUX
+    if (pluginFileInfo.suffix() == "so")
+        return true;
+#endif
+
     return pluginFileInfo.isBundle() || pluginFileInfo.suffix() == "dll";
 }
 
@@ -96,6 +129,10 @@ void VstPluginScanner::initialize(int argc, char *argv[])
         return;
 
     QString foldersString = QString::fromUtf8(argv[1]);
+    if (foldersString == "--stdin") {
+        readingPathsFromInput = true;
+        return;
+    }
 
     if (!foldersString.isEmpty())
         this->foldersToScan = foldersString.split(";"); // the folders are separated using ';'
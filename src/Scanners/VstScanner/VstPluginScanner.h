@@ -14,6 +14,11 @@ private:
 
     QStringList foldersToScan;
     QStringList skipList; // contain blackListed and cached plugins
+    bool readingPathsFromInput; // the plugin paths are sent by the parallel scan scheduler in the standard input
+
+    void scanPlugin(const QFileInfo &pluginFileInfo);
+    void scanFolders();
+    void scanPathsFromInput();
 
     void initialize(int argc, char *argv[]) override;
 
@@ -0,0 +1,367 @@
+#include "VstSandboxHost.h"
+#include "vst/VstHost.h"
+#include "vst/VstLoader.h"
+#include "vst/Utils.h"
+#include "VstPluginChecker.h"
+#include "log/Logging.h"
+
+#include <QByteArray>
+
+#include <iostream>
+#include <string>
+#include <cstring>
+
+using namespace Vst;
+
+const int VstSandboxHost::WAIT_TIMEOUT = 100000;
+
+static void writeToProcessOutput(const QString &string)
+{
+    // same format used in BaseScanner, Jamtaba is reading these lines with QProcess
+    std::cout << '\n' << string.toStdString() << '\n';
+    std::flush(std::cout);
+}
+
+VstSandboxHost::VstSandboxHost() :
+    sharedData(nullptr),
+    effect(nullptr),
+    sampleRate(44100),
+    blockSize(256),
+    wantMidi(false),
+    pluginRunning(false),
+    pendingSampleRate(0),
+    suspendRequested(0)
+{
+    vstMidiEvents.reserved = 0;
+    vstMidiEvents.numEvents = 0;
+    for (int i = 0; i < SandboxBlock::MAX_MIDI_MESSAGES; ++i)
+        vstMidiEvents.events[i] = reinterpret_cast<VstEvent *>(&midiEvents[i]);
+}
+
+VstSandboxHost::~VstSandboxHost()
+{
+    unloadPlugin();
+}
+
+int VstSandboxHost::runSandbox(int argc, char *argv[])
+{
+    if (!initialize(argc, argv) || !loadPlugin())
+        return 1;
+
+    QString readyMessage = QString("JT-Sandbox-Ready: %1;%2;%3;%4;%5")
+            .arg(effect->numInputs)
+            .arg(effect->numOutputs)
+            .arg((effect->flags & effFlagsIsSynth) ? 1 : 0)
+            .arg(effect->initialDelay)
+            .arg(Vst::utils::getPluginName(effect));
+
+    sharedData->state.store(SandboxSharedData::RUNNING);
+    start(QThread::TimeCriticalPriority);
+
+    writeToProcessOutput(readyMessage);
+
+    readControlMessages(); // blocking until Jamtaba close the standard input
+
+    sharedData->state.store(SandboxSharedData::STOPPING);
+    sharedData->requests.wakeConsumer(requestsSignal);
+    wait();
+
+    unloadPlugin();
+
+    return 0;
+}
+
+bool VstSandboxHost::initialize(int argc, char *argv[])
+{
+    // --sandbox <shared memory key> <plugin path> <sample rate> <block size>
+    if (argc < 6) {
+        qCritical() << "Missing sandbox arguments!";
+        return false;
+    }
+
+    pluginPath = QString::fromUtf8(argv[3]);
+    sampleRate = QString(argv[4]).toInt();
+    blockSize = qBound(16, QString(argv[5]).toInt(), SandboxBlock::MAX_FRAMES);
+
+    sharedMemory.setKey(QString::fromUtf8(argv[2]));
+    if (!sharedMemory.attach()) {
+        qCritical() << "Can't attach the sandbox shared memory:" << sharedMemory.errorString();
+        return false;
+    }
+
+    if (sharedMemory.size() < static_cast<int>(sizeof(SandboxSharedData))) {
+        qCritical() << "Invalid sandbox shared memory size:" << sharedMemory.size();
+        return false;
+    }
+
+    sharedData = static_cast<SandboxSharedData *>(sharedMemory.data());
+    if (sharedData->version != SandboxSharedData::VERSION) {
+        qCritical() << "Invalid sandbox shared memory version:" << sharedData->version;
+        return false;
+    }
+
+    const QString key = sharedMemory.key();
+    if (!requestsSignal.open(SandboxSharedData::getRequestsSignalName(key))
+            || !responsesSignal.open(SandboxSharedData::getResponsesSignalName(key))) {
+        qCritical() << "Can't open the sandbox signals!";
+        return false;
+    }
+
+    return true;
+}
+
+bool VstSandboxHost::loadPlugin()
+{
+    // PluginChecker is implemented in WindowsVstPluginChecker and MacVstPluginChecker files
+    if (!Vst::PluginChecker::isValidPluginFile(pluginPath)) {
+        qCritical() << "Invalid plugin file:" << pluginPath;
+        return false;
+    }
+
+    VstHost *host = VstHost::getInstance();
+    host->setSampleRate(sampleRate);
+    host->setBlockSize(blockSize);
+
+    effect = VstLoader::load(pluginPath, host);
+    if (!effect) {
+        qCritical() << "Can't load the plugin" << pluginPath;
+        return false;
+    }
+
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, blockSize, NULL, 0.0f);
+    effect->dispatcher(effect, effOpen, 0, 0, NULL, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, blockSize, NULL, 0.0f);
+
+    wantMidi = (effect->dispatcher(effect, effCanDo, 0, 0, (void*)"receiveVstMidiEvent", 0) == 1);
+
+    inputBuffers.assign(effect->numInputs, std::vector<float>(SandboxBlock::MAX_FRAMES, 0.0f));
+    outputBuffers.assign(effect->numOutputs, std::vector<float>(SandboxBlock::MAX_FRAMES, 0.0f));
+    inputArrays.resize(effect->numInputs);
+    outputArrays.resize(effect->numOutputs);
+    for (int c = 0; c < effect->numInputs; ++c)
+        inputArrays[c] = inputBuffers[c].data();
+    for (int c = 0; c < effect->numOutputs; ++c)
+        outputArrays[c] = outputBuffers[c].data();
+
+    resumePlugin();
+
+    return true;
+}
+
+void VstSandboxHost::unloadPlugin()
+{
+    if (!effect)
+        return;
+
+    suspendPlugin();
+    VstLoader::unload(effect);
+    effect = nullptr;
+}
+
+void VstSandboxHost::resumePlugin()
+{
+    if (pluginRunning)
+        return;
+
+    effect->dispatcher(effect, effMainsChanged, 0, 1, NULL, 0.0f);
+    effect->dispatcher(effect, effStartProcess, 0, 1, NULL, 0.0f);
+    pluginRunning = true;
+}
+
+void VstSandboxHost::suspendPlugin()
+{
+    if (!pluginRunning)
+        return;
+
+    effect->dispatcher(effect, effStopProcess, 0, 1, NULL, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 0, NULL, 0.0f);
+    pluginRunning = false;
+}
+
+void VstSandboxHost::enqueueCommand(ControlCommand::Type type, const QByteArray &state, int value)
+{
+    ControlCommand command = { type, state, value };
+
+    commandsMutex.lock();
+    pendingCommands.append(command);
+    commandsMutex.unlock();
+
+    sharedData->requests.wakeConsumer(requestsSignal); // the command is executed even when no audio blocks are arriving
+}
+
+void VstSandboxHost::executePendingCommands()
+{
+    QList<ControlCommand> commands;
+    commandsMutex.lock();
+    commands.swap(pendingCommands);
+    commandsMutex.unlock();
+
+    for (const ControlCommand &command : commands) {
+        switch (command.type) {
+        case ControlCommand::GET_STATE: {
+            QByteArray state;
+            if (effect->flags & effFlagsProgramChunks) {
+                char *chunk = nullptr;
+                long result = effect->dispatcher(effect, effGetChunk, false, 0, &chunk, 0);
+                if (result > 0 && chunk)
+                    state = QByteArray(chunk, result);
+            }
+            writeToProcessOutput("JT-Sandbox-State: " + QString::fromLatin1(state.toBase64()));
+            break;
+        }
+        case ControlCommand::SET_STATE:
+            if (!command.state.isEmpty())
+                effect->dispatcher(effect, effSetChunk, false, command.state.size(), (void*)command.state.data(), 0);
+            writeToProcessOutput("JT-Sandbox-State-Restored");
+            break;
+        case ControlCommand::SET_BYPASS:
+            effect->dispatcher(effect, effSetBypass, 0, command.value, NULL, 0);
+            break;
+        }
+    }
+}
+
+void VstSandboxHost::applyPendingChanges()
+{
+    int newSampleRate = pendingSampleRate.fetchAndStoreRelaxed(0);
+    if (newSampleRate > 0 && newSampleRate != sampleRate) {
+        bool wasRunning = pluginRunning;
+        suspendPlugin();
+        sampleRate = newSampleRate;
+        VstHost::getInstance()->setSampleRate(sampleRate);
+        effect->dispatcher(effect, effSetSampleRate, 0, 0, NULL, sampleRate);
+        if (wasRunning)
+            resumePlugin();
+    }
+
+    if (suspendRequested.load())
+        suspendPlugin();
+    else
+        resumePlugin();
+}
+
+void VstSandboxHost::run()
+{
+    SandboxRing &requests = sharedData->requests;
+    SandboxRing &responses = sharedData->responses;
+
+    while (sharedData->state.load() == SandboxSharedData::RUNNING) {
+        bool hasRequests = requests.waitForData(requestsSignal, WAIT_TIMEOUT);
+
+        executePendingCommands(); // never while the plugin is processing
+        applyPendingChanges();
+
+        if (!hasRequests)
+            continue;
+
+        while (SandboxBlock *request = requests.getReadBlock()) {
+            SandboxBlock *response = responses.getWriteBlock();
+            if (response) { // a full responses ring means Jamtaba is not reading, the block is dropped
+                processRequest(*request, *response);
+                responses.commitWrite(responsesSignal);
+            }
+            requests.commitRead();
+        }
+    }
+}
+
+void VstSandboxHost::fillVstEvents(const SandboxBlock &request)
+{
+    int messages = qMin(static_cast<int>(request.midiMessages), SandboxBlock::MAX_MIDI_MESSAGES);
+    vstMidiEvents.numEvents = messages;
+    for (int m = 0; m < messages; ++m) {
+        qint32 data = request.midiData[m];
+        VstMidiEvent &vstEvent = midiEvents[m];
+        vstEvent.type = kVstMidiType;
+        vstEvent.byteSize = sizeof(VstMidiEvent);
+        vstEvent.deltaFrames = vstEvent.reserved1 = vstEvent.reserved2 = 0;
+        vstEvent.midiData[0] = data & 0xFF;
+        vstEvent.midiData[1] = (data >> 8) & 0xFF;
+        vstEvent.midiData[2] = (data >> 16) & 0xFF;
+        vstEvent.midiData[3] = 0;
+        vstEvent.flags = kVstMidiEventIsRealtime;
+    }
+}
+
+void VstSandboxHost::processRequest(const SandboxBlock &request, SandboxBlock &response)
+{
+    int frames = qMin(static_cast<int>(request.frames), SandboxBlock::MAX_FRAMES);
+
+    response.sequence = request.sequence;
+    response.frames = frames;
+    response.midiMessages = 0;
+
+    if (!pluginRunning) { // suspended plugins are not changing the audio
+        for (int c = 0; c < SandboxBlock::MAX_CHANNELS; ++c)
+            std::memcpy(response.samples[c], request.samples[c], frames * sizeof(float));
+        return;
+    }
+
+    if (frames > blockSize) {
+        blockSize = frames;
+        suspendPlugin();
+        effect->dispatcher(effect, effSetBlockSize, 0, blockSize, NULL, 0.0f);
+        resumePlugin();
+    }
+
+    if (wantMidi && request.midiMessages > 0) {
+        fillVstEvents(request);
+        effect->dispatcher(effect, effProcessEvents, 0, 0, (void*)&vstMidiEvents, 0);
+    }
+
+    int inputChannels = static_cast<int>(inputArrays.size());
+    for (int c = 0; c < inputChannels; ++c) {
+        if (c < SandboxBlock::MAX_CHANNELS)
+            std::memcpy(inputArrays[c], request.samples[c], frames * sizeof(float));
+        else
+            std::memset(inputArrays[c], 0, frames * sizeof(float));
+    }
+
+    if (effect->flags & effFlagsCanReplacing)
+        effect->processReplacing(effect, inputArrays.data(), outputArrays.data(), frames);
+
+    int outputChannels = static_cast<int>(outputArrays.size());
+    for (int c = 0; c < SandboxBlock::MAX_CHANNELS; ++c) {
+        if (outputChannels > 0) // mono plugins are copied to both channels
+            std::memcpy(response.samples[c], outputArrays[qMin(c, outputChannels - 1)], frames * sizeof(float));
+        else
+            std::memset(response.samples[c], 0, frames * sizeof(float));
+    }
+}
+
+void VstSandboxHost::readControlMessages()
+{
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        QString message = QString::fromUtf8(line.c_str()).trimmed();
+        if (message.isEmpty())
+            continue;
+
+        QString command = message.section(':', 0, 0);
+        QString value = message.section(':', 1).trimmed();
+
+        if (command == "JT-Sandbox-GetState") {
+            enqueueCommand(ControlCommand::GET_STATE);
+        }
+        else if (command == "JT-Sandbox-SetState") {
+            enqueueCommand(ControlCommand::SET_STATE, QByteArray::fromBase64(value.toLatin1()));
+        }
+        else if (command == "JT-Sandbox-SampleRate") {
+            pendingSampleRate.store(value.toInt());
+        }
+        else if (command == "JT-Sandbox-Suspend") {
+            suspendRequested.store(1);
+        }
+        else if (command == "JT-Sandbox-Resume") {
+            suspendRequested.store(0);
+        }
+        else if (command == "JT-Sandbox-Bypass") {
+            enqueueCommand(ControlCommand::SET_BYPASS, QByteArray(), value.toInt());
+        }
+        else {
+            qCritical() << "Unknown sandbox command:" << message;
+        }
+    }
+}
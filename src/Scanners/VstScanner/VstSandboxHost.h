@@ -0,0 +1,102 @@
+#ifndef VST_SANDBOX_HOST_H
+#define VST_SANDBOX_HOST_H
+
+#include "aeffectx.h"
+#include "vst/SandboxChannel.h"
+
+#include <QSharedMemory>
+#include <QThread>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QList>
+#include <QByteArray>
+
+#include <vector>
+
+/**
+ * Host a single VST plugin in the VstScanner process (--sandbox mode). The audio blocks are exchanged with
+ * Jamtaba using the shared memory rings in SandboxSharedData, the standard input/output are used only for
+ * the control messages (plugin state, sample rate, suspend/resume). A crashing plugin kills just this process.
+ */
+
+class VstSandboxHost : public QThread
+{
+
+public:
+    VstSandboxHost();
+    ~VstSandboxHost();
+
+    int runSandbox(int argc, char *argv[]);
+
+protected:
+    void run() override; // the audio loop
+
+private:
+    bool initialize(int argc, char *argv[]);
+    bool loadPlugin();
+    void unloadPlugin();
+    void readControlMessages();
+
+    void processRequest(const Vst::SandboxBlock &request, Vst::SandboxBlock &response);
+    void fillVstEvents(const Vst::SandboxBlock &request);
+    void applyPendingChanges();
+
+    // the plugin dispatcher is not reentrant, the commands received in control thread are executed in the audio loop
+    struct ControlCommand
+    {
+        enum Type
+        {
+            GET_STATE,
+            SET_STATE,
+            SET_BYPASS
+        };
+
+        Type type;
+        QByteArray state;
+        int value;
+    };
+
+    void enqueueCommand(ControlCommand::Type type, const QByteArray &state = QByteArray(), int value = 0);
+    void executePendingCommands(); // called between the audio blocks
+
+    void resumePlugin();
+    void suspendPlugin();
+
+    QSharedMemory sharedMemory;
+    Vst::SandboxSharedData *sharedData;
+    Vst::SandboxSignal requestsSignal;
+    Vst::SandboxSignal responsesSignal;
+
+    AEffect *effect;
+    QString pluginPath;
+    int sampleRate;
+    int blockSize;
+    bool wantMidi;
+    bool pluginRunning;
+
+    QAtomicInt pendingSampleRate; // changed in control thread, applied in the audio loop
+    QAtomicInt suspendRequested;
+
+    QMutex commandsMutex;
+    QList<ControlCommand> pendingCommands;
+
+    std::vector<std::vector<float>> inputBuffers;
+    std::vector<std::vector<float>> outputBuffers;
+    std::vector<float *> inputArrays;
+    std::vector<float *> outputArrays;
+
+    template<int N>
+    struct VSTEventBlock
+    {
+        VstInt32 numEvents;
+        VstIntPtr reserved;
+        VstEvent *events[N];
+    };
+
+    VSTEventBlock<Vst::SandboxBlock::MAX_MIDI_MESSAGES> vstMidiEvents;
+    VstMidiEvent midiEvents[Vst::SandboxBlock::MAX_MIDI_MESSAGES];
+
+    static const int WAIT_TIMEOUT; // in microseconds, used to check the STOPPING state
+};
+
+#endif // VST_SANDBOX_HOST_H
@@ -1,7 +1,15 @@
 #include "VstPluginScanner.h"
+#include "VstSandboxHost.h"
+
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::strcmp(argv[1], "--sandbox") == 0) { // hosting a single plugin for Jamtaba
+        VstSandboxHost sandboxHost;
+        return sandboxHost.runSandbox(argc, argv);
+    }
+
     VstPluginScanner scanner;
     scanner.start(argc, argv);
     return 0;
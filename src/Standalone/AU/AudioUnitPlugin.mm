@@ -415,6 +415,7 @@ void AudioUnitPlugin::process(const Audio::SamplesBuffer &inBuffer, Audio::Sampl
 
     if (!bufferList) {
         qCritical() << "Buffer list is null";
+        outBuffer.set(inBuffer);
         return;
     }
 
@@ -441,6 +442,7 @@ void AudioUnitPlugin::process(const Audio::SamplesBuffer &inBuffer, Audio::Sampl
 
     if (status != noErr) {
         qWarning() << "Error rendering audio unit " << getName() << " OSStatus: " << status;
+        outBuffer.set(inBuffer);
         return;
     }
 
@@ -454,6 +456,7 @@ void AudioUnitPlugin::process(const Audio::SamplesBuffer &inBuffer, Audio::Sampl
     */
 
     if(isVirtualInstrument()){
+        outBuffer.set(inBuffer);
         outBuffer.add(internalOutBuffer); // AUi add and preserve the last generated output samples
     }
     else{
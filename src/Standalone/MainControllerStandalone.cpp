@@ -5,6 +5,7 @@
 #include "audio/PortAudioDriver.h"
 #include "audio/core/LocalInputNode.h"
 #include "vst/VstPlugin.h"
+#include "vst/SandboxedVstPlugin.h"
 #include "vst/VstHost.h"
 #include "vst/VstPluginFinder.h"
 #include "audio/core/PluginDescriptor.h"
@@ -101,24 +102,37 @@ bool MainControllerStandalone::pluginDescriptorLessThan(const Audio::PluginDescr
         Audio::Plugin *plugin = createPluginInstance(descriptor);
         if (plugin) {
             plugin->start();
-            QMutexLocker locker(&mutex);
-            getInputTrack(inputTrackIndex)->addProcessor(plugin, pluginSlotIndex);
+            {
+                QMutexLocker locker(&mutex);
+                getInputTrack(inputTrackIndex)->addProcessor(plugin, pluginSlotIndex);
+            }
+            updateLatencyCompensation();
         }
         return plugin;
     }
 
     void MainControllerStandalone::removePlugin(int inputTrackIndex, Audio::Plugin *plugin)
     {
-        QMutexLocker locker(&mutex);
-        QString pluginName = plugin->getName();
-        try {
+        bool detached = false;
+        {
+            QMutexLocker locker(&mutex); // the audio thread waits only for the chain update, the plugin is unloaded below
             Audio::AudioNode *trackNode = getInputTrack(inputTrackIndex);
             if (trackNode)
-                trackNode->removeProcessor(plugin);
+                detached = trackNode->detachProcessor(plugin);
         }
-        catch (...) {
-            qCritical() << "Error removing plugin " << pluginName;
+
+        if (detached) {
+            QString pluginName = plugin->getName();
+            try {
+                plugin->suspend();
+                delete plugin;
+            }
+            catch (...) {
+                qCritical() << "Error removing plugin " << pluginName;
+            }
         }
+
+        updateLatencyCompensation();
     }
 
     void MainControllerStandalone::addPluginsScanPath(const QString &path)
@@ -384,6 +398,10 @@ MainControllerStandalone::MainControllerStandalone(Persistence::Settings setting
 
     connect(Vst::VstHost::getInstance(), &Vst::VstHost::pluginRequestingWindowResize,
             this, &MainControllerStandalone::setVstPluginWindowSize);
+
+    // the plugins are reporting latency changes in the audio thread, the compensation is updated in main thread
+    connect(Vst::VstHost::getInstance(), &Vst::VstHost::pluginLatencyChanged,
+            this, &MainControllerStandalone::updateLatencyCompensation, Qt::QueuedConnection);
 }
 
 void MainControllerStandalone::setVstPluginWindowSize(QString pluginName, int newWidht, int newHeight)
@@ -440,7 +458,7 @@ void MainControllerStandalone::start()
 
 
     qCInfo(jtCore) << "Creating plugin finder...";
-    vstPluginFinder.reset(new audio::VSTPluginFinder());
+    vstPluginFinder.reset(new audio::VSTPluginFinder(Configurator::getInstance()->getCacheDir()));
 
 #ifdef Q_OS_MAC
 
@@ -495,6 +513,15 @@ Audio::Plugin *MainControllerStandalone::createPluginInstance(
             return new Audio::JamtabaDelay(audioDriver->getSampleRate());
     }
     else if (descriptor.isVST()) {
+        if (settings.isSandboxingVstPlugins()) { // the plugin run in a separated process, a crash is not killing Jamtaba
+            auto sandboxedPlugin = new Vst::SandboxedVstPlugin(descriptor.getPath(), audioDriver->getSampleRate(), audioDriver->getBufferSize());
+            if (sandboxedPlugin->load(descriptor.getPath()))
+                return sandboxedPlugin;
+
+            delete sandboxedPlugin;
+            return nullptr;
+        }
+
         Vst::VstHost *host = Vst::VstHost::getInstance();
         auto vstPlugin = new Vst::VstPlugin(host, descriptor.getPath());
         if (vstPlugin->load(descriptor.getPath()))
@@ -635,6 +662,8 @@ void MainControllerStandalone::scanAllVstPlugins()
 {
     saveLastUserSettings(settings.getInputsSettings()); // save the config file before start scanning
     clearPluginsCache();
+    if (vstPluginFinder)
+        vstPluginFinder->clearScanCache(); // the plugins cached as invalid are scanned again
     scanVstPlugins(false);
 }
 
@@ -16,8 +16,8 @@ class PluginFinder : public QObject
     Q_OBJECT
 
 public:
-    void scan(const QStringList &foldersToScan = QStringList(), const QStringList &skipList = QStringList());
-    void cancel();
+    virtual void scan(const QStringList &foldersToScan = QStringList(), const QStringList &skipList = QStringList());
+    virtual void cancel();
 
 protected:
     QProcess scanProcess;
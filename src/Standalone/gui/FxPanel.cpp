@@ -1,12 +1,16 @@
 #include "FxPanel.h"
 #include "FxPanelItem.h"
 #include "LocalTrackViewStandalone.h"
+#include "audio/core/AudioNode.h"
+#include "audio/core/Plugins.h"
 
 #include <QVBoxLayout>
 #include <QPainter>
 
 using namespace Controller;
 
+const int FxPanel::MIN_ITEMS = 4;
+
 FxPanel::FxPanel(LocalTrackViewStandalone *parent, MainControllerStandalone *mainController) :
     QWidget(parent),
     controller(mainController),
@@ -16,11 +20,15 @@ FxPanel::FxPanel(LocalTrackViewStandalone *parent, MainControllerStandalone *mai
     mainLayout->setContentsMargins(QMargins(0, 0, 0, 0));
     mainLayout->setSpacing(1);
 
-    for (int i = 0; i < 4; i++) {
-        FxPanelItem *item = new FxPanelItem(localTrackView, mainController);
-        items.append(item);
-        mainLayout->addWidget(item);
-    }
+    for (int i = 0; i < MIN_ITEMS; i++)
+        createItem();
+}
+
+void FxPanel::createItem()
+{
+    FxPanelItem *item = new FxPanelItem(localTrackView, controller);
+    items.append(item);
+    layout()->addWidget(item);
 }
 
 void FxPanel::removePlugins()
@@ -54,6 +62,17 @@ void FxPanel::addPlugin(Audio::Plugin *plugin, quint32 pluginSlotIndex)
         else
             qCritical() << "Can't add " << plugin->getName() << " in slot index " << pluginSlotIndex;
     }
+
+    if (getPluginFreeSlotIndex() < 0) // the plugins chain has no fixed size, always keeping a free slot
+        createItem();
+}
+
+void FxPanel::updateCpuUsage(const Audio::AudioNode *node)
+{
+    for (FxPanelItem *item : items) {
+        if (item->containPlugin())
+            item->setCpuUsage(node->getProcessorCpuUsage(item->getAudioPlugin()));
+    }
 }
 
 FxPanel::~FxPanel()
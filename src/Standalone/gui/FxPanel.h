@@ -5,6 +5,10 @@
 #include "MainControllerStandalone.h"
 
 class FxPanelItem;
+
+namespace Audio {
+class AudioNode;
+}
 class LocalTrackViewStandalone;
 
 class FxPanel : public QWidget
@@ -22,6 +26,8 @@ public:
 
     void removePlugins();
 
+    void updateCpuUsage(const Audio::AudioNode *node);
+
     inline LocalTrackViewStandalone *getLocalTrackView() const
     {
         return localTrackView;
@@ -33,9 +39,13 @@ public:
     }
 
 private:
+    void createItem();
+
     QList<FxPanelItem *> items;
     Controller::MainControllerStandalone *controller; // storing a 'casted' controller for convenience
     LocalTrackViewStandalone *localTrackView;
+
+    static const int MIN_ITEMS;
 };
 
 #endif // FXPANEL_H
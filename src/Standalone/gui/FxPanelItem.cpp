@@ -53,6 +53,7 @@ void FxPanelItem::on_buttonClicked()
 {
     if (plugin) {
         this->plugin->setBypass(!this->bypassButton->isChecked());
+        mainController->updateLatencyCompensation();
         updateStyleSheet();
     }
 }
@@ -77,10 +78,16 @@ void FxPanelItem::setPlugin(Audio::Plugin *plugin)
     updateStyleSheet();
 }
 
+void FxPanelItem::setCpuUsage(float cpuUsage)
+{
+    setToolTip(tr("%1 - CPU: %2%").arg(plugin ? plugin->getName() : QString()).arg(cpuUsage, 0, 'f', 1));
+}
+
 void FxPanelItem::unsetPlugin()
 {
     this->plugin->closeEditor();
     this->label->setText("");
+    setToolTip(QString());
     this->bypassButton->setVisible(false);
 
     mainController->removePlugin(this->localTrackView->getInputIndex(), plugin);
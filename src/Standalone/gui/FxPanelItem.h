@@ -31,6 +31,8 @@ public:
         return plugin;
     }
 
+    void setCpuUsage(float cpuUsage); // percentage of the audio block duration
+
     bool pluginIsBypassed();
     const Audio::Plugin *getAudioPlugin() const
     {
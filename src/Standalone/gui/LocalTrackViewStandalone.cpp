@@ -191,6 +191,9 @@ void LocalTrackViewStandalone::updateGuiElements()
 
     if (midiPeakMeter->isVisible())
         midiPeakMeter->update();
+
+    if (inputNode && fxPanel)
+        fxPanel->updateCpuUsage(inputNode);
 }
 
 void LocalTrackViewStandalone::reset()
@@ -436,6 +439,8 @@ void LocalTrackViewStandalone::addPlugin(Audio::Plugin *plugin, quint32 slotInde
 {
     if (fxPanel) {
         plugin->setBypass(bypassed);
+        if (bypassed)
+            controller->updateLatencyCompensation(); // bypassed plugins latency is not compensated
         fxPanel->addPlugin(plugin, slotIndex);
         refreshInputSelectionName(); // refresh input type combo box, if the added plugins is a virtual instrument Jamtaba will try auto change the input type to midi
         update();
@@ -238,7 +238,7 @@ void MainWindowStandalone::restoreLocalSubchannelPluginsList(
             Audio::Plugin *pluginInstance = controller->addPlugin(inputTrackIndex, pluginSlotIndex, descriptor);
             if (pluginInstance) {
                 try {
-                    pluginInstance->restoreFromSerializedData(plugin.data);
+                    pluginInstance->restorePersistentState(plugin.data);
                 }
                 catch (...) {
                     qWarning() << "Exception restoring " << pluginInstance->getName();
@@ -274,11 +274,11 @@ LocalTrackGroupViewStandalone *MainWindowStandalone::createLocalTrackGroupView(i
     return new LocalTrackGroupViewStandalone(channelGroupIndex, this);
 }
 
-QList<Persistence::Plugin> buildPersistentPluginList(QList<const Audio::Plugin *> trackPlugins)
+QList<Persistence::Plugin> buildPersistentPluginList(QList<const Audio::Plugin *> trackPlugins, bool usingLastPluginsState)
 {
     QList<Persistence::Plugin> persistentPlugins;
     foreach (const Audio::Plugin *p, trackPlugins) {
-        QByteArray serializedData = p->getSerializedData();
+        QByteArray serializedData = p->getPersistentState(usingLastPluginsState);
         Persistence::Plugin plugin(p->getDescriptor(), p->isBypassed(), serializedData);
         persistentPlugins.append(plugin);
     }
@@ -286,6 +286,17 @@ QList<Persistence::Plugin> buildPersistentPluginList(QList<const Audio::Plugin *
 }
 
 LocalInputTrackSettings MainWindowStandalone::getInputsSettings() const
+{
+    return getInputsSettings(false);
+}
+
+LocalInputTrackSettings MainWindowStandalone::getAutoSaveInputsSettings() const
+{
+    // the plugins are not serialized in auto saves, the sandboxed plugins are blocking in a round trip
+    return getInputsSettings(true);
+}
+
+LocalInputTrackSettings MainWindowStandalone::getInputsSettings(bool usingLastPluginsState) const
 {
     // the base class is returning just the basic: gain, mute, pan , etc for each channel and subchannel
     LocalInputTrackSettings baseSettings = MainWindow::getInputsSettings();
@@ -308,7 +319,7 @@ LocalInputTrackSettings MainWindowStandalone::getInputsSettings() const
             Subchannel newSubChannel = subchannel;
             LocalTrackViewStandalone *trackView = trackViews.at(subChannelID);
             if (trackView)
-                newSubChannel.setPlugins(buildPersistentPluginList(trackView->getInsertedPlugins()));
+                newSubChannel.setPlugins(buildPersistentPluginList(trackView->getInsertedPlugins(), usingLastPluginsState));
 
 
             subChannelID++;
@@ -16,6 +16,7 @@ public:
     explicit MainWindowStandalone(MainControllerStandalone *controller);
 
     Persistence::LocalInputTrackSettings getInputsSettings() const override;
+    Persistence::LocalInputTrackSettings getAutoSaveInputsSettings() const override;
 
     void addChannelsGroup(const QString &groupName) override;
 
@@ -39,6 +40,8 @@ protected:
 
     void restoreLocalSubchannelPluginsList(LocalTrackViewStandalone *subChannelView, const Persistence::Subchannel &subChannel);
 
+    Persistence::LocalInputTrackSettings getInputsSettings(bool usingLastPluginsState) const;
+
     PreferencesDialog *createPreferencesDialog() override;
 
 protected slots: // TODO change to private slots?
@@ -0,0 +1,429 @@
+#include "SandboxedVstPlugin.h"
+
+#include "audio/core/SamplesBuffer.h"
+#include "audio/core/PluginDescriptor.h"
+#include "midi/MidiMessage.h"
+#include "vst/Utils.h"
+#include "log/Logging.h"
+
+#include <QApplication>
+#include <QProcess>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <algorithm>
+#include <new>
+
+using namespace Vst;
+
+QAtomicInt SandboxedVstPlugin::instancesCounter(0);
+const int SandboxedVstPlugin::READY_TIMEOUT = 10000;
+const int SandboxedVstPlugin::CONTROL_TIMEOUT = 3000;
+const int SandboxedVstPlugin::MISSED_BLOCKS_REPORT_PERIOD = 5000;
+
+SandboxedVstPlugin::SandboxedVstPlugin(const QString &pluginPath, int sampleRate, int blockSize) :
+    Audio::Plugin(Vst::utils::createDescriptor(nullptr, pluginPath)),
+    path(pluginPath),
+    sampleRate(sampleRate),
+    blockSize(blockSize),
+    virtualInstrument(false),
+    latency(0),
+    sharedData(nullptr),
+    process(nullptr),
+    processRunning(0),
+    lastSequence(0),
+    averageRoundTripTime(0),
+    maxRoundTripTime(0),
+    processedBlocks(0),
+    missedBlocks(0),
+    reportedMissedBlocks(0),
+    missedBlocksTimer(nullptr)
+{
+}
+
+SandboxedVstPlugin::~SandboxedVstPlugin()
+{
+    qCDebug(jtStandaloneVstPlugin) << getName() << "sandbox round trip average:" << averageRoundTripTime
+                                   << "ms max:" << maxRoundTripTime << "ms processed blocks:" << processedBlocks
+                                   << "missed blocks:" << missedBlocks.load();
+
+    stopSandboxProcess();
+}
+
+QString SandboxedVstPlugin::getSandboxExecutablePath()
+{
+    // the plugins are hosted by the VstScanner executable, in the same folder of Jamtaba executable
+    QString executablePath = QApplication::applicationDirPath() + "/VstScanner";
+#ifdef Q_OS_WIN
+    executablePath += ".exe";
+#endif
+    if (QFile(executablePath).exists())
+        return executablePath;
+
+    qCritical() << "Sandbox executable not founded in" << executablePath;
+    return QString();
+}
+
+bool SandboxedVstPlugin::createSharedMemory()
+{
+    QString key = QString("JamTabaSandbox-%1-%2")
+            .arg(QApplication::applicationPid())
+            .arg(instancesCounter.fetchAndAddRelaxed(1));
+
+    sharedMemory.setKey(key);
+    if (!sharedMemory.create(sizeof(SandboxSharedData))) {
+        if (sharedMemory.error() != QSharedMemory::AlreadyExists) {
+            qCritical() << "Can't create the sandbox shared memory:" << sharedMemory.errorString();
+            return false;
+        }
+
+        // in Unix the segment of a crashed Jamtaba instance is not released
+        sharedMemory.attach();
+        sharedMemory.detach();
+        if (!sharedMemory.create(sizeof(SandboxSharedData))) {
+            qCritical() << "Can't create the sandbox shared memory:" << sharedMemory.errorString();
+            return false;
+        }
+    }
+
+    sharedData = new (sharedMemory.data()) SandboxSharedData();
+    sharedData->reset();
+
+    if (!requestsSignal.open(SandboxSharedData::getRequestsSignalName(key))
+            || !responsesSignal.open(SandboxSharedData::getResponsesSignalName(key))) {
+        qCritical() << "Can't create the sandbox signals!";
+        return false;
+    }
+
+    return true;
+}
+
+bool SandboxedVstPlugin::load(const QString &path)
+{
+    this->path = path;
+
+    QString executablePath = getSandboxExecutablePath();
+    if (executablePath.isEmpty() || !createSharedMemory())
+        return false;
+
+    QStringList arguments;
+    arguments << "--sandbox" << sharedMemory.key() << path << QString::number(sampleRate) << QString::number(blockSize);
+
+    process = new QProcess();
+    process->setProcessChannelMode(QProcess::ForwardedErrorChannel); // the plugin messages are not blocking the sandbox process
+    process->start(executablePath, arguments);
+    if (!process->waitForStarted()) {
+        qCritical() << "Can't start the sandbox process for" << path << process->errorString();
+        stopSandboxProcess();
+        return false;
+    }
+
+    // Ready message format: numInputs;numOutputs;isSynth;latency;pluginName
+    QString readyMessage;
+    if (!waitForControlMessage("JT-Sandbox-Ready:", READY_TIMEOUT, &readyMessage)) {
+        qCritical() << "The sandbox process is not responding for" << path;
+        stopSandboxProcess();
+        return false;
+    }
+
+    QStringList parts = readyMessage.split(";");
+    if (parts.size() < 5) {
+        qCritical() << "Invalid sandbox ready message:" << readyMessage;
+        stopSandboxProcess();
+        return false;
+    }
+
+    virtualInstrument = parts.at(2) == "1";
+    latency = parts.at(3).toInt();
+
+    QString pluginName = parts.mid(4).join(";");
+    if (!pluginName.isEmpty()) {
+        name = pluginName;
+        descriptor = Audio::PluginDescriptor(name, Audio::PluginDescriptor::VST_Plugin, descriptor.getManufacturer(), path);
+    }
+
+    QObject::connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus){
+        if (processRunning.fetchAndStoreRelaxed(0)) // the audio is passed through after a crash
+            qCritical() << "The sandbox process for" << getName() << "finished! Exit code:" << exitCode << "status:" << exitStatus;
+    });
+
+    processRunning.store(1);
+
+    // the audio thread is just counting the late blocks, they are reported here
+    missedBlocksTimer = new QTimer(this);
+    QObject::connect(missedBlocksTimer, &QTimer::timeout, this, [=](){
+        reportMissedBlocks();
+    });
+    missedBlocksTimer->start(MISSED_BLOCKS_REPORT_PERIOD);
+
+    qCDebug(jtStandaloneVstPlugin) << getName() << "loaded in sandbox process" << process->processId();
+
+    return true;
+}
+
+void SandboxedVstPlugin::reportMissedBlocks()
+{
+    const int blocks = missedBlocks.load();
+    if (blocks == reportedMissedBlocks)
+        return;
+
+    qCWarning(jtStandaloneVstPlugin) << getName() << (blocks - reportedMissedBlocks)
+                                     << "late blocks passed through without processing in the sandbox process, total:" << blocks;
+    reportedMissedBlocks = blocks;
+}
+
+void SandboxedVstPlugin::stopSandboxProcess()
+{
+    processRunning.store(0);
+
+    if (missedBlocksTimer) {
+        missedBlocksTimer->stop();
+        reportMissedBlocks();
+    }
+
+    if (process) {
+        process->disconnect(this);
+        process->closeWriteChannel(); // the sandbox process stop when the standard input is closed
+        if (!process->waitForFinished(CONTROL_TIMEOUT)) {
+            qCritical() << "Killing the sandbox process for" << getName();
+            process->kill();
+            process->waitForFinished(CONTROL_TIMEOUT);
+        }
+        delete process;
+        process = nullptr;
+    }
+
+    if (sharedData) {
+        sharedData->~SandboxSharedData();
+        sharedData = nullptr;
+    }
+
+    requestsSignal.close();
+    responsesSignal.close();
+
+    if (sharedMemory.isAttached())
+        sharedMemory.detach();
+}
+
+void SandboxedVstPlugin::sendControlMessage(const QString &message) const
+{
+    if (!processRunning.load())
+        return;
+
+    process->write(message.toUtf8() + '\n');
+}
+
+bool SandboxedVstPlugin::waitForControlMessage(const QString &messagePrefix, int timeout, QString *value) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    forever {
+        while (process->canReadLine()) {
+            QString line = QString::fromUtf8(process->readLine()).trimmed();
+            if (line.startsWith(messagePrefix)) {
+                if (value)
+                    *value = line.mid(messagePrefix.size()).trimmed();
+                return true;
+            }
+        }
+
+        int remainingTime = timeout - static_cast<int>(timer.elapsed());
+        if (remainingTime <= 0 || process->state() == QProcess::NotRunning)
+            return false;
+
+        process->waitForReadyRead(remainingTime);
+    }
+}
+
+void SandboxedVstPlugin::start()
+{
+    // nothing to do, the plugin is opened and resumed when the sandbox process is started in load()
+}
+
+void SandboxedVstPlugin::suspend()
+{
+    sendControlMessage("JT-Sandbox-Suspend");
+}
+
+void SandboxedVstPlugin::resume()
+{
+    sendControlMessage("JT-Sandbox-Resume");
+}
+
+void SandboxedVstPlugin::updateGui()
+{
+    // sandboxed plugins have no editor
+}
+
+void SandboxedVstPlugin::openEditor(const QPoint &centerOfScreen)
+{
+    Q_UNUSED(centerOfScreen)
+
+    qCDebug(jtStandaloneVstPlugin) << "The editor is not available for sandboxed plugins," << getName();
+}
+
+void SandboxedVstPlugin::setSampleRate(int newSampleRate)
+{
+    sampleRate = newSampleRate;
+    sendControlMessage(QString("JT-Sandbox-SampleRate: %1").arg(newSampleRate));
+}
+
+void SandboxedVstPlugin::setBypass(bool state)
+{
+    Plugin::setBypass(state);
+    sendControlMessage(QString("JT-Sandbox-Bypass: %1").arg(state ? 1 : 0));
+}
+
+QByteArray SandboxedVstPlugin::getSerializedData() const
+{
+    if (!processRunning.load())
+        return QByteArray();
+
+    sendControlMessage("JT-Sandbox-GetState");
+
+    QString state;
+    if (!waitForControlMessage("JT-Sandbox-State:", CONTROL_TIMEOUT, &state)) {
+        qCritical() << "Can't read the state of sandboxed plugin" << getName();
+        return QByteArray();
+    }
+
+    return QByteArray::fromBase64(state.toLatin1());
+}
+
+void SandboxedVstPlugin::restoreFromSerializedData(const QByteArray &dataToRestore)
+{
+    if (dataToRestore.isEmpty() || !processRunning.load())
+        return;
+
+    qCInfo(jtStandaloneVstPlugin) << "\t\trestoring sandboxed plugin data to" << getName();
+
+    sendControlMessage("JT-Sandbox-SetState: " + QString::fromLatin1(dataToRestore.toBase64()));
+
+    if (!waitForControlMessage("JT-Sandbox-State-Restored", CONTROL_TIMEOUT, nullptr))
+        qCritical() << "Can't restore the state of sandboxed plugin" << getName();
+}
+
+void SandboxedVstPlugin::updateRoundTripStats(qint64 roundTripTimeInNanoseconds)
+{
+    double roundTripTime = roundTripTimeInNanoseconds / 1000000.0;
+
+    if (processedBlocks == 0)
+        averageRoundTripTime = roundTripTime;
+    else
+        averageRoundTripTime += (roundTripTime - averageRoundTripTime) * 0.05; // moving average
+
+    maxRoundTripTime = qMax(maxRoundTripTime, roundTripTime);
+    processedBlocks++;
+}
+
+void SandboxedVstPlugin::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, std::vector<Midi::MidiMessage> &midiBuffer)
+{
+    if (isBypassed() || !processRunning.load()) {
+        out.set(in); // the input samples are passed through
+        return;
+    }
+
+    SandboxRing &responses = sharedData->responses;
+
+    // discarding the late responses
+    while (responses.getReadBlock())
+        responses.commitRead();
+
+    /**
+        Same behavior of VstPlugin: VSTis are adding the output samples to preserve the output generated by
+        the previous VSTi in the chain, VSTs are replacing the output samples.
+    */
+    if (virtualInstrument)
+        out.set(in);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // waiting at maximum half block, the other half is used by the rest of the audio chain
+    const int totalFrames = static_cast<int>(out.getFrameLenght());
+    const qint64 timeout = static_cast<qint64>(totalFrames) * 1000000000 / qMax(sampleRate, 1) / 2;
+
+    // host blocks bigger than the shared blocks are sent in chunks, sharing the same timeout
+    int offset = 0;
+    while (offset < totalFrames) {
+        const int frames = qMin(totalFrames - offset, SandboxBlock::MAX_FRAMES);
+        const std::vector<Midi::MidiMessage> *midiMessages = (offset == 0) ? &midiBuffer : nullptr;
+        if (!processChunk(in, out, offset, frames, midiMessages, timer, timeout)) {
+            missedBlocks.fetchAndAddRelaxed(1);
+            if (!virtualInstrument) // the remaining input samples are passed through
+                out.set(in, offset, totalFrames - offset, offset);
+            return;
+        }
+        offset += frames;
+    }
+}
+
+bool SandboxedVstPlugin::processChunk(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int offset, int frames,
+                                      const std::vector<Midi::MidiMessage> *midiBuffer, const QElapsedTimer &timer, qint64 timeout)
+{
+    SandboxRing &requests = sharedData->requests;
+    SandboxRing &responses = sharedData->responses;
+
+    SandboxBlock *request = requests.getWriteBlock();
+    if (!request) // the sandbox process is not consuming the requests
+        return false;
+
+    const int inputChannels = in.getChannels();
+
+    request->sequence = ++lastSequence;
+    request->frames = frames;
+    for (int c = 0; c < SandboxBlock::MAX_CHANNELS; ++c) {
+        if (inputChannels > 0) {
+            const float *samples = in.getSamplesArray(qMin(c, inputChannels - 1)) + offset; // mono inputs are duplicated
+            std::copy(samples, samples + frames, request->samples[c]);
+        }
+        else {
+            std::fill(request->samples[c], request->samples[c] + frames, 0.0f);
+        }
+    }
+
+    const int midiMessages = midiBuffer ? qMin(static_cast<int>(midiBuffer->size()), SandboxBlock::MAX_MIDI_MESSAGES) : 0;
+    request->midiMessages = midiMessages;
+    for (int m = 0; m < midiMessages; ++m) {
+        const Midi::MidiMessage &message = midiBuffer->at(m);
+        request->midiData[m] = (message.getStatus() & 0xFF) | ((message.getData1() & 0xFF) << 8) | ((message.getData2() & 0xFF) << 16);
+    }
+
+    const qint64 requestTime = timer.nsecsElapsed();
+
+    requests.commitWrite(requestsSignal);
+
+    SandboxBlock *response = nullptr;
+    forever {
+        qint64 remainingTime = timeout - timer.nsecsElapsed();
+        if (remainingTime <= 0 || !responses.waitForData(responsesSignal, static_cast<int>(remainingTime / 1000)))
+            return false; // late response
+
+        response = responses.getReadBlock();
+        if (response->sequence == lastSequence)
+            break;
+
+        responses.commitRead(); // response for a previous block
+    }
+
+    updateRoundTripStats(timer.nsecsElapsed() - requestTime);
+
+    const int outputChannels = out.getChannels();
+    for (int c = 0; c < outputChannels; ++c) {
+        const float *samples = response->samples[qMin(c, SandboxBlock::MAX_CHANNELS - 1)];
+        float *outputSamples = out.getSamplesArray(c) + offset;
+        if (virtualInstrument) {
+            for (int s = 0; s < frames; ++s)
+                outputSamples[s] += samples[s];
+        }
+        else {
+            std::copy(samples, samples + frames, outputSamples);
+        }
+    }
+
+    responses.commitRead();
+
+    return true;
+}
@@ -0,0 +1,126 @@
+#ifndef SANDBOXED_VST_PLUGIN_H
+#define SANDBOXED_VST_PLUGIN_H
+
+#include "audio/core/Plugins.h"
+#include "vst/SandboxChannel.h"
+
+#include <QSharedMemory>
+#include <QAtomicInt>
+
+class QProcess;
+class QTimer;
+class QElapsedTimer;
+
+namespace Vst {
+
+/**
+ * A VST plugin running in a separated VstScanner process (--sandbox mode). The audio blocks are sent using
+ * a shared memory ring and the response is awaited at most half block duration. A late (or crashed) plugin
+ * is not blocking the audio thread, the input samples are passed through and the block is counted as missed.
+ * The plugin editor and the MIDI output are not available in the sandbox.
+ */
+
+class SandboxedVstPlugin : public Audio::Plugin
+{
+public:
+    SandboxedVstPlugin(const QString &pluginPath, int sampleRate, int blockSize);
+    ~SandboxedVstPlugin();
+
+    bool load(const QString &path);
+
+    void process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, std::vector<Midi::MidiMessage> &midiBuffer) override;
+
+    void start() override;
+    void suspend() override;
+    void resume() override;
+    void updateGui() override;
+    void openEditor(const QPoint &centerOfScreen) override;
+    void setSampleRate(int newSampleRate) override;
+    void setBypass(bool state) override;
+
+    QString getPath() const override;
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &dataToRestore) override;
+
+    bool isVirtualInstrument() const override;
+    int getLatency() const override;
+
+    // round trip statistics, in milliseconds
+    double getAverageRoundTripTime() const;
+    double getMaxRoundTripTime() const;
+    int getMissedBlocks() const;
+
+private:
+    bool createSharedMemory();
+    void stopSandboxProcess();
+    void sendControlMessage(const QString &message) const;
+    bool waitForControlMessage(const QString &messagePrefix, int timeout, QString *value) const;
+    void updateRoundTripStats(qint64 roundTripTimeInNanoseconds);
+    void reportMissedBlocks();
+
+    bool processChunk(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &out, int offset, int frames,
+                      const std::vector<Midi::MidiMessage> *midiBuffer, const QElapsedTimer &timer, qint64 timeout);
+
+    static QString getSandboxExecutablePath();
+
+    QString path;
+    int sampleRate;
+    int blockSize;
+    bool virtualInstrument;
+    int latency; // reported by the plugin when the sandbox process is ready
+
+    QSharedMemory sharedMemory;
+    Vst::SandboxSharedData *sharedData;
+    Vst::SandboxSignal requestsSignal;
+    Vst::SandboxSignal responsesSignal;
+    QProcess *process;
+    QAtomicInt processRunning; // cleared when the sandbox process crash
+
+    quint32 lastSequence;
+
+    double averageRoundTripTime;
+    double maxRoundTripTime;
+    quint64 processedBlocks;
+    QAtomicInt missedBlocks; // incremented in the audio thread, reported in the main thread
+    int reportedMissedBlocks;
+    QTimer *missedBlocksTimer;
+
+    static QAtomicInt instancesCounter; // used to create unique shared memory keys
+    static const int READY_TIMEOUT; // in milliseconds
+    static const int CONTROL_TIMEOUT;
+    static const int MISSED_BLOCKS_REPORT_PERIOD;
+};
+
+inline QString SandboxedVstPlugin::getPath() const
+{
+    return path;
+}
+
+inline bool SandboxedVstPlugin::isVirtualInstrument() const
+{
+    return virtualInstrument;
+}
+
+inline int SandboxedVstPlugin::getLatency() const
+{
+    return latency;
+}
+
+inline double SandboxedVstPlugin::getAverageRoundTripTime() const
+{
+    return averageRoundTripTime;
+}
+
+inline double SandboxedVstPlugin::getMaxRoundTripTime() const
+{
+    return maxRoundTripTime;
+}
+
+inline int SandboxedVstPlugin::getMissedBlocks() const
+{
+    return missedBlocks.load();
+}
+
+} // namespace
+
+#endif // SANDBOXED_VST_PLUGIN_H
@@ -84,6 +84,14 @@ bool VstPlugin::canGenerateMidiMessages() const
     return returnValue >= 0;
 }
 
+int VstPlugin::getLatency() const
+{
+    if (!effect)
+        return 0;
+
+    return effect->initialDelay;
+}
+
 bool VstPlugin::isVirtualInstrument() const
 {
     if (!effect) {
@@ -231,8 +239,8 @@ void VstPlugin::fillVstEventsList(const std::vector<Midi::MidiMessage> &midiBuff
 void VstPlugin::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &outBuffer, std::vector<Midi::MidiMessage> &midiBuffer)
 {
 
-    Q_UNUSED(in)
     if (isBypassed() || !effect || !loaded || !started) {
+        outBuffer.set(in);
         return;
     }
 
@@ -277,6 +285,7 @@ void VstPlugin::process(const Audio::SamplesBuffer &in, Audio::SamplesBuffer &ou
     */
 
     if (isVirtualInstrument()) {
+        outBuffer.set(in);
         outBuffer.add(*internalOutputBuffer); // VSTis add and preserve the last generated output samples
     }
     else {
@@ -2,26 +2,75 @@
 
 #include <QApplication>
 #include <QLibraryInfo>
+#include <QDirIterator>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
 
 #include "log/Logging.h"
 
 using namespace audio;
 
-VSTPluginFinder::VSTPluginFinder()
+const int VSTPluginFinder::SHARD_SIZE = 4; // small shards keep all processes busy when some plugins are slow to load
+const int VSTPluginFinder::PLUGIN_SCAN_TIMEOUT = 30000;
+
+class VSTPluginFinder::ScanProcess
+{
+public:
+    ScanProcess() :
+        process(new QProcess()),
+        timeoutTimer(new QTimer())
+    {
+        timeoutTimer->setSingleShot(true);
+        timeoutTimer->setInterval(PLUGIN_SCAN_TIMEOUT);
+    }
+
+    ~ScanProcess()
+    {
+        timeoutTimer->stop();
+        timeoutTimer->deleteLater();
+        process->deleteLater(); // the process can be deleted inside his own signal
+    }
+
+    QProcess *process;
+    QTimer *timeoutTimer; // started when a plugin scan starts, the process is killed if the plugin hangs
+    QStringList shard; // plugins sent to the process and not scanned yet
+    QString scanningPlugin; // used to recover the plugin path when the process crash
+};
+
+VSTPluginFinder::VSTPluginFinder(const QDir &cacheDir) :
+    scanCache(cacheDir),
+    maxScanProcesses(qBound(1, QThread::idealThreadCount(), 8)),
+    badPlugins(0),
+    scanning(false),
+    canceled(false)
 {
-    //
+    connect(&scanPlanWatcher, &QFutureWatcher<ScanPlan>::finished, this, [this](){
+        executeScanPlan(scanPlanWatcher.result());
+    });
 }
 
 VSTPluginFinder::~VSTPluginFinder()
 {
-    //
+    scanPlanWatcher.waitForFinished();
+
+    for (ScanProcess *scanProcess : scanProcesses) {
+        scanProcess->process->disconnect(this);
+        scanProcess->process->kill();
+        scanProcess->process->waitForFinished(1000);
+        delete scanProcess;
+    }
+}
+
+void VSTPluginFinder::setMaxScanProcesses(int maxProcesses)
+{
+    maxScanProcesses = qMax(1, maxProcesses);
 }
 
-Audio::PluginDescriptor VSTPluginFinder::getPluginDescriptor(const QFileInfo &f)
+void VSTPluginFinder::clearScanCache()
 {
-    QString name = Audio::PluginDescriptor::getVstPluginNameFromPath(f.absoluteFilePath());
-    Audio::PluginDescriptor::Category category = Audio::PluginDescriptor::VST_Plugin;
-    return Audio::PluginDescriptor(name, category, f.absoluteFilePath());
+    scanCache.clear();
+    scanCache.save();
 }
 
 QString VSTPluginFinder::getScannerExecutablePath() const
@@ -38,28 +87,316 @@ QString VSTPluginFinder::getScannerExecutablePath() const
     return "";
 }
 
-void VSTPluginFinder::handleScanningStart(const QString &scannedLine)
+bool VSTPluginFinder::canScan(const QFileInfo &pluginFileInfo)
 {
-    QStringList parts = scannedLine.split(": ");
-    if (parts.size() < 2) {
-        qCritical() << "Missing parts in scanned line: " << scannedLine;
+    // In Mac VST plugins are bundles, in windows these plugins are DLLs. Same rule used in VstScanner.
+#ifdef Q_OS_LINUX
+    if (pluginFileInfo.suffix() == "so")
+        return true;
+#endif
+
+    return pluginFileInfo.isBundle() || pluginFileInfo.suffix() == "dll";
+}
+
+VSTPluginFinder::ScanPlan VSTPluginFinder::createScanPlan(const QStringList &foldersToScan, const QStringList &skipList, const QHash<QString, VstScanCache::Entry> &cachedEntries)
+{
+    ScanPlan plan;
+    QSet<QString> skippedPlugins;
+    skippedPlugins.reserve(skipList.size());
+    for (const QString &skippedPlugin : skipList)
+        skippedPlugins.insert(skippedPlugin);
+
+    for (const QString &scanFolder : foldersToScan) {
+        QDirIterator folderIterator(scanFolder, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (folderIterator.hasNext()) {
+            folderIterator.next(); // point to next file inside current folder
+            QFileInfo pluginFileInfo(folderIterator.filePath());
+            QString pluginPath = pluginFileInfo.absoluteFilePath();
+
+            if (skippedPlugins.contains(pluginPath) || !canScan(pluginFileInfo))
+                continue;
+
+            skippedPlugins.insert(pluginPath); // avoid scanning the same plugin twice when the folders are overlapped
+
+            VstScanCache::Entry stamp = VstScanCache::readFileStamp(pluginPath);
+            auto cached = cachedEntries.find(pluginPath);
+            bool isCached = cached != cachedEntries.end() && cached->size == stamp.size;
+            if (isCached && cached->lastModified == stamp.lastModified) {
+                plan.unchangedPlugins.append(cached.value()); // the file is not even hashed
+                continue;
+            }
+
+            stamp.hash = VstScanCache::computeHash(pluginPath);
+            if (isCached && cached->hash == stamp.hash) {
+                stamp.result = cached->result; // just touched
+                plan.unchangedPlugins.append(stamp);
+            }
+            else {
+                plan.changedPlugins.append(stamp);
+            }
+        }
+    }
+
+    for (const QString &cachedPath : cachedEntries.keys()) {
+        if (!QFileInfo::exists(cachedPath))
+            plan.removedPlugins.append(cachedPath);
+    }
+
+    return plan;
+}
+
+void VSTPluginFinder::scan(const QStringList &foldersToScan, const QStringList &skipList)
+{
+    if (scanning) {
+        qCritical() << "VST scan is already running!";
+        return;
+    }
+
+    if (getScannerExecutablePath().isEmpty())
+        return; // scanner executable not found!
+
+    scanning = true;
+    canceled = false;
+    badPlugins = 0;
+
+    emit scanStarted();
+
+    // walking in the folders and hashing the changed files can be slow, this is done in background
+    scanPlanWatcher.setFuture(QtConcurrent::run(&VSTPluginFinder::createScanPlan, foldersToScan, skipList, scanCache.getEntries()));
+}
+
+void VSTPluginFinder::executeScanPlan(const ScanPlan &plan)
+{
+    for (const QString &removedPlugin : plan.removedPlugins)
+        scanCache.remove(removedPlugin);
+
+    for (const VstScanCache::Entry &entry : plan.unchangedPlugins) {
+        scanCache.update(entry);
+        if (entry.result == VstScanCache::VALID_PLUGIN && !canceled)
+            emit pluginScanFinished(Audio::PluginDescriptor::getVstPluginNameFromPath(entry.path), entry.path);
+    }
+
+    qCDebug(jtStandalonePluginFinder) << "VST scan plan: " << plan.unchangedPlugins.size() << "cached plugins," << plan.changedPlugins.size() << "plugins to scan";
+
+    if (canceled) {
+        finishParallelScan();
+        return;
+    }
+
+    for (const VstScanCache::Entry &entry : plan.changedPlugins) {
+        pendingPlugins.append(entry.path);
+        scanningPlugins.insert(entry.path, entry);
+    }
+
+    const int shards = (pendingPlugins.size() + SHARD_SIZE - 1) / SHARD_SIZE;
+    const int processes = qMin(maxScanProcesses, shards);
+    for (int p = 0; p < processes && !canceled; ++p)
+        startScanProcess();
+
+    if (scanProcesses.isEmpty())
+        finishParallelScan(); // nothing to scan, all plugins are cached
+}
+
+void VSTPluginFinder::startScanProcess()
+{
+    ScanProcess *scanProcess = new ScanProcess();
+    scanProcesses.append(scanProcess);
+
+    QProcess *process = scanProcess->process;
+    connect(process, &QProcess::readyReadStandardOutput, this, [=](){
+        consumeScanProcessOutput(scanProcess);
+    });
+
+    connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus){
+        handleScanProcessFinished(scanProcess, exitStatus != QProcess::NormalExit || exitCode != 0);
+    });
+
+    connect(scanProcess->timeoutTimer, &QTimer::timeout, this, [=](){
+        handleScanProcessTimeout(scanProcess);
+    });
+
+    connect(process, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error), this, [=](QProcess::ProcessError error){
+        if (error == QProcess::FailedToStart) { // finished() is not emitted
+            qCritical() << error << scanProcess->process->errorString();
+            canceled = true; // avoid starting other processes
+            handleScanProcessFinished(scanProcess, false);
+        }
+    });
+
+    // execute the scanner in another process to avoid crash Jamtaba process
+    process->start(getScannerExecutablePath(), QStringList("--stdin"));
+
+    if (!scanProcesses.contains(scanProcess))
+        return; // failed to start
+
+    qCDebug(jtStandalonePluginFinder) << "Scan process started (PID: " << process->processId() << ")";
+
+    sendNextShard(scanProcess);
+}
+
+void VSTPluginFinder::sendNextShard(ScanProcess *scanProcess)
+{
+    if (canceled || pendingPlugins.isEmpty()) {
+        scanProcess->process->closeWriteChannel(); // the scanner process finish after the last plugin
+        return;
+    }
+
+    QByteArray paths;
+    while (scanProcess->shard.size() < SHARD_SIZE && !pendingPlugins.isEmpty()) {
+        QString pluginPath = pendingPlugins.takeFirst();
+        scanProcess->shard.append(pluginPath);
+        paths.append(pluginPath.toUtf8()).append('\n');
+    }
+
+    scanProcess->process->write(paths);
+}
+
+void VSTPluginFinder::consumeScanProcessOutput(ScanProcess *scanProcess)
+{
+    QProcess *process = scanProcess->process;
+    while (process->canReadLine()) {
+        QString readedLine = QString::fromUtf8(process->readLine()).trimmed();
+        if (readedLine.isEmpty())
+            continue;
+
+        if (readedLine.startsWith("JT-Scanner-Scanning:")) {
+            scanProcess->scanningPlugin = getPathFromScannedLine(readedLine);
+            scanProcess->timeoutTimer->start();
+            emit pluginScanStarted(scanProcess->scanningPlugin);
+        }
+        else if (readedLine.startsWith("JT-Scanner-Scan-Finished")) {
+            QString pluginPath = getPathFromScannedLine(readedLine);
+            auto scanningPlugin = scanningPlugins.find(pluginPath);
+            if (scanningPlugin == scanningPlugins.end()) {
+                qCritical() << "Unexpected plugin in scanner output:" << pluginPath;
+                continue;
+            }
+
+            scanningPlugin->result = VstScanCache::VALID_PLUGIN;
+            emit pluginScanFinished(Audio::PluginDescriptor::getVstPluginNameFromPath(pluginPath), pluginPath);
+        }
+        else if (readedLine.startsWith("JT-Scanner-Scan-Done")) {
+            QString pluginPath = getPathFromScannedLine(readedLine);
+            VstScanCache::Entry entry = scanningPlugins.take(pluginPath);
+            if (!entry.path.isEmpty()) {
+                if (entry.result != VstScanCache::VALID_PLUGIN)
+                    entry.result = VstScanCache::INVALID_PLUGIN;
+                scanCache.update(entry);
+            }
+
+            scanProcess->shard.removeOne(pluginPath);
+            scanProcess->scanningPlugin.clear();
+            scanProcess->timeoutTimer->stop();
+            if (scanProcess->shard.isEmpty())
+                sendNextShard(scanProcess);
+        }
+    }
+}
+
+void VSTPluginFinder::handleScanProcessFinished(ScanProcess *scanProcess, bool crashed)
+{
+    consumeScanProcessOutput(scanProcess); // the last lines
+
+    if (crashed && !scanProcess->shard.isEmpty()) {
+        QString badPlugin = scanProcess->scanningPlugin.isEmpty() ? scanProcess->shard.first() : scanProcess->scanningPlugin;
+        scanProcess->shard.removeOne(badPlugin);
+        scanningPlugins.remove(badPlugin); // not cached, the plugin will be black listed
+        badPlugins++;
+
+        qCDebug(jtStandalonePluginFinder) << "Scan process crashed scanning" << badPlugin;
+        emit badPluginDetected(badPlugin);
+
+        // the remaining plugins in the shard are scanned by another process
+        for (int i = scanProcess->shard.size() - 1; i >= 0; --i)
+            pendingPlugins.prepend(scanProcess->shard.at(i));
+    }
+    else if (!scanProcess->shard.isEmpty()) {
+        qCritical() << "Scan process finished without scanning" << scanProcess->shard;
+    }
+
+    scanProcesses.removeOne(scanProcess);
+    scanProcess->process->disconnect(this);
+    delete scanProcess;
+
+    if (canceled)
+        pendingPlugins.clear();
+
+    while (!pendingPlugins.isEmpty() && scanProcesses.size() < maxScanProcesses)
+        startScanProcess();
+
+    if (scanProcesses.isEmpty())
+        finishParallelScan();
+}
+
+void VSTPluginFinder::handleScanProcessTimeout(ScanProcess *scanProcess)
+{
+    if (scanProcess->scanningPlugin.isEmpty())
+        return;
+
+    qCDebug(jtStandalonePluginFinder) << "Plugin scan timeout, killing the scan process:" << scanProcess->scanningPlugin;
+
+    // the killed process is handled as a crash, the hung plugin is black listed and the shard is rescanned
+    scanProcess->process->kill();
+}
+
+void VSTPluginFinder::finishParallelScan()
+{
+    if (!scanning)
+        return;
+
+    pendingPlugins.clear();
+    scanningPlugins.clear();
+    scanCache.save();
+
+    scanning = false;
+
+    qCDebug(jtStandalonePluginFinder) << "VST scan finished! Bad plugins:" << badPlugins;
+
+    emit scanFinished(badPlugins == 0 && !canceled);
+}
+
+void VSTPluginFinder::cancel()
+{
+    if (!scanning)
         return;
+
+    qCDebug(jtStandalonePluginFinder) << "Terminating scan processes!";
+
+    canceled = true;
+    pendingPlugins.clear();
+    for (ScanProcess *scanProcess : scanProcesses) {
+        scanProcess->shard.clear(); // the terminated processes are not crashing
+        scanProcess->process->terminate();
+    }
+}
+
+QString VSTPluginFinder::getPathFromScannedLine(const QString &scannedLine)
+{
+    int index = scannedLine.indexOf(": ");
+    if (index < 0) {
+        qCritical() << "Missing parts in scanned line: " << scannedLine;
+        return QString();
     }
 
-    QString pluginPath = parts.at(1);
+    return scannedLine.mid(index + 2);
+}
+
+void VSTPluginFinder::handleScanningStart(const QString &scannedLine)
+{
+    QString pluginPath = getPathFromScannedLine(scannedLine);
+    if (pluginPath.isEmpty())
+        return;
+
     lastScannedPlugin = pluginPath;// store the plugin path, if the scanner process crash we can add this bad plugin in the black list
     emit pluginScanStarted(pluginPath);
 }
 
 void VSTPluginFinder::handleScanningFinished(const QString &scannedLine)
 {
-    QStringList parts = scannedLine.split(": ");
-    if (parts.size() < 2) {
-        qCritical() << "Missing parts in scanned line: " << scannedLine;
+    QString pluginPath = getPathFromScannedLine(scannedLine);
+    if (pluginPath.isEmpty())
         return;
-    }
 
-    QString pluginPath = parts.at(1);
     QString pluginName = Audio::PluginDescriptor::getVstPluginNameFromPath(pluginPath);
     emit pluginScanFinished(pluginName, pluginPath);
 }
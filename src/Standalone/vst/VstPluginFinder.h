@@ -2,17 +2,43 @@
 #define VSTPLUGINFINDER_H
 
 #include "PluginFinder.h"
+#include "VstScanCache.h"
 #include "audio/core/PluginDescriptor.h"
 
+#include <QFutureWatcher>
+
 namespace audio {
 
+/**
+ * Scan the VST plugins using many VstScanner processes in parallel. The plugin files are collected (and compared
+ * with the VstScanCache) in background, and the changed plugins are sent in small shards to the scanner processes
+ * standard input. When a plugin crash a scanner process only this plugin is black listed, the remaining plugins
+ * in the shard are scanned by a new process.
+ */
+
 class VSTPluginFinder : public PluginFinder
 {
 
 public:
-    VSTPluginFinder();
+    explicit VSTPluginFinder(const QDir &cacheDir);
     virtual ~VSTPluginFinder();
 
+    void scan(const QStringList &foldersToScan = QStringList(), const QStringList &skipList = QStringList()) override;
+    void cancel() override;
+
+    void setMaxScanProcesses(int maxProcesses);
+    void clearScanCache();
+
+    struct ScanPlan
+    {
+        QList<VstScanCache::Entry> unchangedPlugins; // results reused from cache
+        QList<VstScanCache::Entry> changedPlugins; // new or updated plugins, need a scan
+        QStringList removedPlugins; // cached plugins not founded in disk
+    };
+
+    static ScanPlan createScanPlan(const QStringList &foldersToScan, const QStringList &skipList, const QHash<QString, VstScanCache::Entry> &cachedEntries);
+    static bool canScan(const QFileInfo &pluginFileInfo);
+
 protected:
     QString getScannerExecutablePath() const override;
 
@@ -20,11 +46,32 @@ protected:
     void handleScanningFinished(const QString &scannedLine) override;
 
 private:
-    QProcess scanProcess;
-    QString lastScannedPlugin; // used to recover the last plugin path when the scanner process crash
+    class ScanProcess;
+
+    void executeScanPlan(const ScanPlan &plan);
+    void startScanProcess();
+    void sendNextShard(ScanProcess *scanProcess);
+    void consumeScanProcessOutput(ScanProcess *scanProcess);
+    void handleScanProcessFinished(ScanProcess *scanProcess, bool crashed);
+    void handleScanProcessTimeout(ScanProcess *scanProcess);
+    void finishParallelScan();
+
+    static QString getPathFromScannedLine(const QString &scannedLine);
+
+    VstScanCache scanCache;
+    QFutureWatcher<ScanPlan> scanPlanWatcher;
+
+    QList<ScanProcess *> scanProcesses;
+    QStringList pendingPlugins; // waiting for a scanner process
+    QHash<QString, VstScanCache::Entry> scanningPlugins; // file stamps of the plugins sent to scanner processes
 
-    Audio::PluginDescriptor getPluginDescriptor(const QFileInfo &f);
+    int maxScanProcesses;
+    int badPlugins;
+    bool scanning;
+    bool canceled;
 
+    static const int SHARD_SIZE;
+    static const int PLUGIN_SCAN_TIMEOUT; // in milliseconds, hung plugins are black listed
 };
 
 } // namespace
@@ -0,0 +1,142 @@
+#include "VstScanCache.h"
+#include "persistence/CacheHeader.h"
+#include "log/Logging.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QCryptographicHash>
+
+using namespace audio;
+
+const quint32 VstScanCache::REVISION = 1;
+const qint64 VstScanCache::HASHED_BYTES = 1024 * 1024; // hashing the entire file is too slow for big plugins, the size is compared too
+
+QDataStream &operator<<(QDataStream &stream, const VstScanCache::Entry &entry)
+{
+    return stream
+           << entry.path
+           << entry.size
+           << entry.lastModified
+           << entry.hash
+           << entry.result;
+}
+
+QDataStream &operator>>(QDataStream &stream, VstScanCache::Entry &entry)
+{
+    return stream
+           >> entry.path
+           >> entry.size
+           >> entry.lastModified
+           >> entry.hash
+           >> entry.result;
+}
+
+VstScanCache::VstScanCache(const QDir &cacheDir) :
+    cacheFilePath(cacheDir.absoluteFilePath("vst_scan_cache.bin")),
+    changed(false)
+{
+    load();
+}
+
+VstScanCache::~VstScanCache()
+{
+    save();
+}
+
+static QString getPluginBinaryPath(const QString &pluginPath)
+{
+    QFileInfo pluginFileInfo(pluginPath);
+    if (pluginFileInfo.isBundle()) { // Mac plugins are bundles, the bundle folder is not changed when the binary is updated
+        QString binaryPath = pluginFileInfo.absoluteFilePath() + "/Contents/MacOS/" + pluginFileInfo.completeBaseName();
+        if (QFileInfo(binaryPath).isFile())
+            return binaryPath;
+    }
+
+    return pluginPath;
+}
+
+VstScanCache::Entry VstScanCache::readFileStamp(const QString &pluginPath)
+{
+    QFileInfo binaryInfo(getPluginBinaryPath(pluginPath));
+
+    Entry entry;
+    entry.path = pluginPath;
+    entry.size = binaryInfo.size();
+    entry.lastModified = binaryInfo.lastModified().toMSecsSinceEpoch();
+    entry.result = NOT_SCANNED;
+
+    return entry;
+}
+
+QByteArray VstScanCache::computeHash(const QString &pluginPath)
+{
+    QFile file(getPluginBinaryPath(pluginPath));
+    if (!file.open(QFile::ReadOnly))
+        return QByteArray();
+
+    return QCryptographicHash::hash(file.read(HASHED_BYTES), QCryptographicHash::Md5);
+}
+
+void VstScanCache::update(const Entry &entry)
+{
+    entries.insert(entry.path, entry);
+    changed = true;
+}
+
+void VstScanCache::remove(const QString &pluginPath)
+{
+    if (entries.remove(pluginPath) > 0)
+        changed = true;
+}
+
+void VstScanCache::clear()
+{
+    entries.clear();
+    changed = true;
+}
+
+void VstScanCache::load()
+{
+    QFile cacheFile(cacheFilePath);
+    if (!cacheFile.open(QFile::ReadOnly))
+        return;
+
+    QDataStream stream(&cacheFile);
+
+    CacheHeader cacheHeader;
+    stream >> cacheHeader;
+    if (!cacheHeader.isValid(REVISION)) {
+        qCritical() << "Invalid cache header when loading the VST scan cache.";
+        return;
+    }
+
+    stream >> entries;
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Error reading the VST scan cache, all plugins will be scanned.";
+        entries.clear();
+    }
+
+    qCDebug(jtStandalonePluginFinder) << "VST scan cache items loaded from file:" << entries.size();
+}
+
+void VstScanCache::save()
+{
+    if (!changed)
+        return;
+
+    QSaveFile cacheFile(cacheFilePath);
+    if (!cacheFile.open(QFile::WriteOnly)) {
+        qCritical() << "Error writing the VST scan cache:" << cacheFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream << CacheHeader(REVISION);
+    stream << entries;
+
+    if (cacheFile.commit())
+        changed = false;
+}
@@ -0,0 +1,68 @@
+#ifndef VST_SCAN_CACHE_H
+#define VST_SCAN_CACHE_H
+
+#include <QDir>
+#include <QHash>
+#include <QByteArray>
+
+namespace audio {
+
+/**
+ * The scan results of every VST plugin file, keyed by path. An entry is reused when the plugin file size
+ * and modification time are unchanged, or when the file content hash is unchanged (a touched file).
+ * So a rescan only loads new or updated plugins.
+ */
+
+class VstScanCache
+{
+
+public:
+    explicit VstScanCache(const QDir &cacheDir);
+    ~VstScanCache();
+
+    enum ScanResult
+    {
+        NOT_SCANNED,
+        VALID_PLUGIN,
+        INVALID_PLUGIN
+    };
+
+    struct Entry
+    {
+        QString path;
+        qint64 size;
+        qint64 lastModified; // in ms since epoch
+        QByteArray hash;
+        quint8 result;
+    };
+
+    static Entry readFileStamp(const QString &pluginPath); // the hash is not computed
+    static QByteArray computeHash(const QString &pluginPath);
+
+    QHash<QString, Entry> getEntries() const;
+
+    void update(const Entry &entry);
+    void remove(const QString &pluginPath);
+    void clear();
+
+    void save();
+
+private:
+    void load();
+
+    QString cacheFilePath;
+    QHash<QString, Entry> entries;
+    bool changed;
+
+    static const quint32 REVISION;
+    static const qint64 HASHED_BYTES;
+};
+
+inline QHash<QString, VstScanCache::Entry> VstScanCache::getEntries() const
+{
+    return entries;
+}
+
+} // namespace
+
+#endif // VST_SCAN_CACHE_H
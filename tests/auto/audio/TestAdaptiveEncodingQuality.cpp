@@ -0,0 +1,98 @@
+#include "TestAdaptiveEncodingQuality.h"
+
+#include "audio/vorbis/AdaptiveEncodingQuality.h"
+#include <QTest>
+
+namespace {
+const float MAX_QUALITY = 0.3f;
+const float MIN_QUALITY = -0.1f;
+const qint64 INTERVAL_PERIOD = 10000; // in milliseconds
+const qint64 INTERVAL_BYTES = 100000;
+
+// the interval is uploaded while it is recorded, the late uploads are ending long after the interval period
+const qint64 LATE_UPLOAD = INTERVAL_PERIOD * 1.5;
+const qint64 FAST_UPLOAD = INTERVAL_PERIOD + 100;
+const qint64 SLOW_UPLOAD = INTERVAL_PERIOD * 1.1; // not late, but not fast enough to increase the quality
+}
+
+void TestAdaptiveEncodingQuality::lateUploadDecreaseQuality()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+
+    QVERIFY(adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+    QCOMPARE(adaptiveQuality.getQuality(), MAX_QUALITY - AdaptiveEncodingQuality::QUALITY_STEP);
+}
+
+void TestAdaptiveEncodingQuality::qualityIsIncreasedAfterFastUploads()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+    adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+    float lowQuality = adaptiveQuality.getQuality();
+
+    for (int i = 0; i < AdaptiveEncodingQuality::FAST_UPLOADS_TO_INCREASE - 1; ++i) {
+        QVERIFY(!adaptiveQuality.update(FAST_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+        QCOMPARE(adaptiveQuality.getQuality(), lowQuality);
+    }
+
+    QVERIFY(adaptiveQuality.update(FAST_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+    QCOMPARE(adaptiveQuality.getQuality(), MAX_QUALITY);
+}
+
+void TestAdaptiveEncodingQuality::slowUploadIsResetingFastUploads()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+    adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+    float lowQuality = adaptiveQuality.getQuality();
+
+    for (int i = 0; i < AdaptiveEncodingQuality::FAST_UPLOADS_TO_INCREASE - 1; ++i)
+        adaptiveQuality.update(FAST_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+
+    QVERIFY(!adaptiveQuality.update(SLOW_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+    QVERIFY(!adaptiveQuality.update(FAST_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+    QCOMPARE(adaptiveQuality.getQuality(), lowQuality);
+}
+
+void TestAdaptiveEncodingQuality::qualityIsClampedToUserMaximum()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+
+    for (int i = 0; i < AdaptiveEncodingQuality::FAST_UPLOADS_TO_INCREASE * 2; ++i)
+        QVERIFY(!adaptiveQuality.update(FAST_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+
+    QCOMPARE(adaptiveQuality.getQuality(), MAX_QUALITY);
+
+    // user selected a lower quality
+    adaptiveQuality.setMaxQuality(0.0f);
+    QCOMPARE(adaptiveQuality.getQuality(), 0.0f);
+}
+
+void TestAdaptiveEncodingQuality::qualityIsClampedToMinimum()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+
+    for (int i = 0; i < 10; ++i)
+        adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+
+    QCOMPARE(adaptiveQuality.getQuality(), MIN_QUALITY);
+    QVERIFY(!adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD));
+}
+
+void TestAdaptiveEncodingQuality::resetRestoresUserQuality()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+    adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+    adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, INTERVAL_PERIOD);
+    QVERIFY(adaptiveQuality.getQuality() < MAX_QUALITY);
+
+    adaptiveQuality.reset();
+    QCOMPARE(adaptiveQuality.getQuality(), MAX_QUALITY);
+}
+
+void TestAdaptiveEncodingQuality::emptyIntervalsAreIgnored()
+{
+    AdaptiveEncodingQuality adaptiveQuality(MAX_QUALITY, MIN_QUALITY);
+
+    QVERIFY(!adaptiveQuality.update(LATE_UPLOAD, 0, INTERVAL_PERIOD));
+    QVERIFY(!adaptiveQuality.update(LATE_UPLOAD, INTERVAL_BYTES, 0));
+    QCOMPARE(adaptiveQuality.getQuality(), MAX_QUALITY);
+}
@@ -0,0 +1,26 @@
+#ifndef TESTADAPTIVEENCODINGQUALITY_H
+#define TESTADAPTIVEENCODINGQUALITY_H
+
+#include <QObject>
+
+class TestAdaptiveEncodingQuality: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lateUploadDecreaseQuality();
+
+    void qualityIsIncreasedAfterFastUploads();
+
+    void slowUploadIsResetingFastUploads();
+
+    void qualityIsClampedToUserMaximum();
+
+    void qualityIsClampedToMinimum();
+
+    void resetRestoresUserQuality();
+
+    void emptyIntervalsAreIgnored();
+};
+
+#endif // TESTADAPTIVEENCODINGQUALITY_H
@@ -0,0 +1,153 @@
+#include "TestAudioNode.h"
+
+#include "audio/core/AudioNode.h"
+#include "audio/core/AudioNodeProcessor.h"
+#include "audio/core/SamplesBuffer.h"
+#include <QTest>
+
+using namespace Audio;
+
+namespace {
+
+// a node generating a constant input
+class ConstantNode : public AudioNode
+{
+public:
+    explicit ConstantNode(float value) : value(value) {}
+
+    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<Midi::MidiMessage> &midiBuffer) override
+    {
+        internalInputBuffer.setFrameLenght(out.getFrameLenght());
+        for (int c = 0; c < internalInputBuffer.getChannels(); ++c)
+            for (uint s = 0; s < internalInputBuffer.getFrameLenght(); ++s)
+                internalInputBuffer.set(c, s, value);
+
+        AudioNode::processReplacing(in, out, sampleRate, midiBuffer);
+    }
+
+private:
+    float value;
+};
+
+// out = in * multiplier + offset
+class LinearProcessor : public AudioNodeProcessor
+{
+public:
+    LinearProcessor(float multiplier, float offset, int latency = 0) :
+        multiplier(multiplier),
+        offset(offset),
+        latency(latency)
+    {
+    }
+
+    void process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<Midi::MidiMessage> &midiMessages) override
+    {
+        Q_UNUSED(midiMessages)
+        for (int c = 0; c < out.getChannels(); ++c)
+            for (uint s = 0; s < out.getFrameLenght(); ++s)
+                out.set(c, s, in.get(c, s) * multiplier + offset);
+    }
+
+    int getLatency() const override { return latency; }
+
+    void suspend() override {}
+    void resume() override {}
+    void updateGui() override {}
+    void openEditor(const QPoint &) override {}
+    void closeEditor() override {}
+
+private:
+    float multiplier;
+    float offset;
+    int latency;
+};
+
+float processNode(AudioNode &node)
+{
+    SamplesBuffer in(2, 16);
+    SamplesBuffer out(2, 16);
+    out.zero();
+    std::vector<Midi::MidiMessage> midiBuffer;
+    node.processReplacing(in, out, 44100, midiBuffer);
+    return out.get(0, 0);
+}
+
+} // namespace
+
+void TestAudioNode::processorsChain_data()
+{
+    QTest::addColumn<int>("processors");
+    QTest::addColumn<float>("expectedOutput");
+
+    // each processor is computing 'in * 2 + 1', starting with 1
+    QTest::newRow("No processors") << 0 << 1.0f;
+    QTest::newRow("One processor") << 1 << 3.0f;
+    QTest::newRow("Two processors") << 2 << 7.0f;
+    QTest::newRow("Three processors") << 3 << 15.0f;
+    QTest::newRow("Six processors") << 6 << 127.0f;
+}
+
+void TestAudioNode::processorsChain()
+{
+    QFETCH(int, processors);
+    QFETCH(float, expectedOutput);
+
+    ConstantNode node(1);
+    for (int i = 0; i < processors; ++i)
+        node.addProcessor(new LinearProcessor(2, 1), i);
+
+    QCOMPARE(processNode(node), expectedOutput);
+    QCOMPARE(processNode(node), expectedOutput); // the same result in the next block
+}
+
+void TestAudioNode::bypassedProcessorsAreSkipped()
+{
+    ConstantNode node(1);
+    LinearProcessor *bypassedProcessor = new LinearProcessor(10, 0);
+    node.addProcessor(new LinearProcessor(2, 0), 0);
+    node.addProcessor(bypassedProcessor, 1);
+    node.addProcessor(new LinearProcessor(1, 1), 2);
+
+    bypassedProcessor->setBypass(true);
+    QCOMPARE(processNode(node), 3.0f);
+
+    bypassedProcessor->setBypass(false);
+    QCOMPARE(processNode(node), 21.0f);
+}
+
+void TestAudioNode::emptySlotsAreSkipped()
+{
+    ConstantNode node(1);
+    node.addProcessor(new LinearProcessor(3, 0), 5);
+
+    QCOMPARE(processNode(node), 3.0f);
+}
+
+void TestAudioNode::latencyIsSummed()
+{
+    ConstantNode node(1);
+    LinearProcessor *bypassedProcessor = new LinearProcessor(1, 0, 1000);
+    node.addProcessor(new LinearProcessor(1, 0, 64), 0);
+    node.addProcessor(new LinearProcessor(1, 0, 32), 1);
+    node.addProcessor(bypassedProcessor, 2);
+
+    bypassedProcessor->setBypass(true);
+    QCOMPARE(node.getProcessorsLatency(), 96);
+
+    bypassedProcessor->setBypass(false);
+    QCOMPARE(node.getProcessorsLatency(), 1096);
+}
+
+void TestAudioNode::removeProcessorKeepTheNextSlots()
+{
+    ConstantNode node(1);
+    LinearProcessor *firstProcessor = new LinearProcessor(2, 0);
+    node.addProcessor(firstProcessor, 0);
+    node.addProcessor(new LinearProcessor(1, 1), 1);
+
+    node.removeProcessor(firstProcessor);
+    QCOMPARE(processNode(node), 2.0f);
+
+    node.addProcessor(new LinearProcessor(3, 0), 0); // the free slot is reused before the remaining processor
+    QCOMPARE(processNode(node), 4.0f);
+}
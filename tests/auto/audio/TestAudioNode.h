@@ -0,0 +1,23 @@
+#ifndef TESTAUDIONODE_H
+#define TESTAUDIONODE_H
+
+#include <QObject>
+
+class TestAudioNode: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void processorsChain_data();
+    void processorsChain(); // check the processors order using odd and even chain lengths (ping-pong buffers)
+
+    void bypassedProcessorsAreSkipped();
+
+    void emptySlotsAreSkipped();
+
+    void latencyIsSummed();
+
+    void removeProcessorKeepTheNextSlots();
+};
+
+#endif // TESTAUDIONODE_H
@@ -0,0 +1,111 @@
+#include "TestHostPositionFollower.h"
+
+#include "audio/HostPositionFollower.h"
+#include <QTest>
+
+using namespace Audio;
+
+namespace {
+const int BPI = 16;
+const long SAMPLES_PER_BEAT = 1000;
+const long SAMPLES_IN_INTERVAL = BPI * SAMPLES_PER_BEAT;
+}
+
+void TestHostPositionFollower::notAnchoredAfterReset()
+{
+    HostPositionFollower follower;
+    QVERIFY(!follower.isAnchored(BPI));
+
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+    QVERIFY(follower.isAnchored(BPI));
+
+    follower.reset();
+    QVERIFY(!follower.isAnchored(BPI));
+}
+
+void TestHostPositionFollower::smallDriftIsCorrectedSlowly()
+{
+    HostPositionFollower follower;
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+
+    // host is in the second beat (1000), ninjam is 10 samples late
+    long position = follower.follow(1.0, 990, SAMPLES_IN_INTERVAL);
+    QCOMPARE(position, 990L + HostPositionFollower::MAX_CORRECTION_PER_BLOCK);
+
+    // ninjam is 3 samples ahead
+    position = follower.follow(1.0, 1003, SAMPLES_IN_INTERVAL);
+    QCOMPARE(position, 1000L);
+
+    QVERIFY(!follower.hasPendingResync());
+}
+
+void TestHostPositionFollower::roundingErrorsAreIgnored()
+{
+    HostPositionFollower follower;
+    follower.anchor(2.0, 2000, SAMPLES_IN_INTERVAL, BPI);
+
+    QCOMPARE(follower.follow(3.0, 2999, SAMPLES_IN_INTERVAL), 2999L);
+    QCOMPARE(follower.follow(3.0, 3001, SAMPLES_IN_INTERVAL), 3001L);
+}
+
+void TestHostPositionFollower::jumpIsResynchronizedInIntervalStart()
+{
+    HostPositionFollower follower;
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+
+    // user moved the host cursor 4 beats ahead, the current interval is not changed
+    long position = follower.follow(5.0, 1000, SAMPLES_IN_INTERVAL);
+    QCOMPARE(position, 1000L);
+    QVERIFY(follower.hasPendingResync());
+
+    QCOMPARE(follower.takeResyncPosition(SAMPLES_IN_INTERVAL, BPI), 4000L);
+    QVERIFY(!follower.hasPendingResync());
+
+    // the new interval is aligned with the host
+    QCOMPARE(follower.follow(5.0, 4000, SAMPLES_IN_INTERVAL), 4000L);
+}
+
+void TestHostPositionFollower::jumpBackIsResynchronizedInIntervalStart()
+{
+    HostPositionFollower follower;
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+
+    // host is looping, the cursor is 3 beats behind ninjam
+    QCOMPARE(follower.follow(7.0, 10000, SAMPLES_IN_INTERVAL), 10000L);
+    QVERIFY(follower.hasPendingResync());
+
+    QCOMPARE(follower.takeResyncPosition(SAMPLES_IN_INTERVAL, BPI), SAMPLES_IN_INTERVAL - 3000);
+}
+
+void TestHostPositionFollower::pendingResyncIsCanceledWhenHostIsAlignedAgain()
+{
+    HostPositionFollower follower;
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+
+    follower.follow(5.0, 1000, SAMPLES_IN_INTERVAL);
+    QVERIFY(follower.hasPendingResync());
+
+    follower.follow(1.5, 1500, SAMPLES_IN_INTERVAL); // host cursor moved back
+    QVERIFY(!follower.hasPendingResync());
+    QCOMPARE(follower.takeResyncPosition(SAMPLES_IN_INTERVAL, BPI), 0L);
+}
+
+void TestHostPositionFollower::bpiChangeInvalidatesAnchorAndPendingResync()
+{
+    HostPositionFollower follower;
+    follower.anchor(0, 0, SAMPLES_IN_INTERVAL, BPI);
+
+    follower.follow(5.0, 1000, SAMPLES_IN_INTERVAL);
+    QVERIFY(follower.hasPendingResync());
+
+    // BPI changed in the interval start, the drift was measured in the old interval
+    const int newBpi = BPI * 2;
+    QVERIFY(!follower.isAnchored(newBpi));
+    QCOMPARE(follower.takeResyncPosition(newBpi * SAMPLES_PER_BEAT, newBpi), 0L);
+    QVERIFY(!follower.hasPendingResync());
+
+    // anchored again using the new interval size
+    follower.anchor(8.0, 0, newBpi * SAMPLES_PER_BEAT, newBpi);
+    QVERIFY(follower.isAnchored(newBpi));
+    QCOMPARE(follower.follow(9.0, 1000, newBpi * SAMPLES_PER_BEAT), 1000L);
+}
@@ -0,0 +1,25 @@
+#ifndef TESTHOSTPOSITIONFOLLOWER_H
+#define TESTHOSTPOSITIONFOLLOWER_H
+
+#include <QObject>
+
+class TestHostPositionFollower: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void notAnchoredAfterReset();
+
+    void smallDriftIsCorrectedSlowly();
+
+    void roundingErrorsAreIgnored();
+
+    void jumpIsResynchronizedInIntervalStart();
+    void jumpBackIsResynchronizedInIntervalStart();
+
+    void pendingResyncIsCanceledWhenHostIsAlignedAgain();
+
+    void bpiChangeInvalidatesAnchorAndPendingResync();
+};
+
+#endif // TESTHOSTPOSITIONFOLLOWER_H
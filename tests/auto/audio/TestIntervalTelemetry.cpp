@@ -0,0 +1,79 @@
+#include "TestIntervalTelemetry.h"
+
+#include "audio/IntervalTelemetry.h"
+#include <QTest>
+
+using namespace Audio;
+
+void TestIntervalTelemetry::emptySnapshot()
+{
+    IntervalTelemetry telemetry;
+    IntervalTelemetry::Snapshot snapshot = telemetry.getSnapshot();
+
+    QCOMPARE(snapshot.receivedIntervals, 0);
+    QCOMPARE(snapshot.missedIntervals, 0);
+    QCOMPARE(snapshot.minArrivalMargin, 0); // no valid minimum before the first interval
+    QVERIFY(!telemetry.isDownloading());
+    QVERIFY(!telemetry.hasMissedInterval());
+}
+
+void TestIntervalTelemetry::receivedIntervalsAreCounted()
+{
+    IntervalTelemetry telemetry;
+
+    telemetry.startDownload();
+    QVERIFY(telemetry.isDownloading());
+    telemetry.finishDownload(1000, 200);
+    QVERIFY(!telemetry.isDownloading());
+
+    telemetry.startDownload();
+    telemetry.finishDownload(2000, 100);
+
+    IntervalTelemetry::Snapshot snapshot = telemetry.getSnapshot();
+    QCOMPARE(snapshot.receivedIntervals, 2);
+    QCOMPARE(snapshot.lastIntervalBytes, 2000);
+    QVERIFY(snapshot.averageIntervalBytes > 1000 && snapshot.averageIntervalBytes < 2000);
+    QCOMPARE(snapshot.arrivalMargin, 100);
+}
+
+void TestIntervalTelemetry::missedIntervalIsClearedByNextInterval()
+{
+    IntervalTelemetry telemetry;
+
+    telemetry.startDownload();
+    telemetry.addMissedInterval();
+    QVERIFY(telemetry.hasMissedInterval());
+
+    telemetry.finishDownload(1000, -50);
+    QVERIFY(!telemetry.hasMissedInterval());
+
+    IntervalTelemetry::Snapshot snapshot = telemetry.getSnapshot();
+    QCOMPARE(snapshot.missedIntervals, 1);
+    QCOMPARE(snapshot.arrivalMargin, -50);
+}
+
+void TestIntervalTelemetry::minArrivalMarginIsKept()
+{
+    IntervalTelemetry telemetry;
+
+    telemetry.finishDownload(1000, 300);
+    telemetry.finishDownload(1000, 20);
+    telemetry.finishDownload(1000, 500);
+
+    IntervalTelemetry::Snapshot snapshot = telemetry.getSnapshot();
+    QCOMPARE(snapshot.arrivalMargin, 500);
+    QCOMPARE(snapshot.minArrivalMargin, 20);
+}
+
+void TestIntervalTelemetry::csvLineHasSameColumnsAsHeader()
+{
+    IntervalTelemetry telemetry;
+    telemetry.setChannelName("user,name", "channel");
+    telemetry.finishDownload(1000, 10);
+
+    QString header = IntervalTelemetry::getCsvHeader();
+    QString line = telemetry.getCsvLine();
+
+    QCOMPARE(line.split(',').size(), header.split(',').size()); // commas in names are replaced
+    QVERIFY(line.startsWith("user name,channel,1,"));
+}
@@ -0,0 +1,22 @@
+#ifndef TESTINTERVALTELEMETRY_H
+#define TESTINTERVALTELEMETRY_H
+
+#include <QObject>
+
+class TestIntervalTelemetry: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptySnapshot();
+
+    void receivedIntervalsAreCounted();
+
+    void missedIntervalIsClearedByNextInterval();
+
+    void minArrivalMarginIsKept();
+
+    void csvLineHasSameColumnsAsHeader();
+};
+
+#endif // TESTINTERVALTELEMETRY_H
@@ -724,6 +724,35 @@ void TestLooper::resizeLayersAndCopySamples_data()
     QTest::newRow("2 samples, resized to 5") << (QStringList() << "1" << "2") << (QStringList() << "1" << "2" << "1" << "2" << "1");
 }
 
+void TestLooper::resizeReservedLayersAndCopySamples()
+{
+    QFETCH(QStringList, initialBuffer);
+    QFETCH(QStringList, finalBuffer);
+
+    Looper looper;
+    looper.setLayers(1, true);
+
+    // simulate recording
+    looper.toggleRecording();
+    looper.startNewCycle(initialBuffer.count());
+    Q_ASSERT(looper.isRecording());
+    looper.addBuffer(createBuffer(initialBuffer.join(',')));
+
+    uint newSamplesPerCycle = finalBuffer.count();
+    looper.reserve(newSamplesPerCycle); // the layers memory is allocated before the new cycle
+    looper.startNewCycle(newSamplesPerCycle); // force recording stop, resize and copy samples
+
+    SamplesBuffer out(1, newSamplesPerCycle);
+    looper.setLayerPan(0, -1); // 100% left to not apply pan law in expected values
+    looper.mixToBuffer(out);
+    checkExpectedValues(finalBuffer.join(','), out);
+}
+
+void TestLooper::resizeReservedLayersAndCopySamples_data()
+{
+    resizeLayersAndCopySamples_data();
+}
+
 void TestLooper::firstUnlockedLayer()
 {
     QFETCH(quint8, maxLayers);
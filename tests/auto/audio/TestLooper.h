@@ -19,6 +19,9 @@ private slots:
     void resizeLayersAndCopySamples();
     void resizeLayersAndCopySamples_data();
 
+    void resizeReservedLayersAndCopySamples();
+    void resizeReservedLayersAndCopySamples_data();
+
     void recording();
     void recording_data();
 
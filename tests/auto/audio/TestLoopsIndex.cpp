@@ -0,0 +1,173 @@
+#include "TestLoopsIndex.h"
+
+#include "looper/LoopsIndex.h"
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+using namespace Audio;
+
+namespace {
+
+void writeLoopFile(const QDir &loopsDir, const QString &loopName, quint32 bpm)
+{
+    QJsonObject layer;
+    layer["locked"] = false;
+    layer["gain"] = 1.0;
+    layer["pan"] = 0.0;
+
+    QJsonObject root;
+    root["bpm"] = static_cast<int>(bpm);
+    root["bpi"] = 16;
+    root["layers"] = QJsonArray() << layer;
+
+    QFile file(loopsDir.absoluteFilePath(loopName + ".json"));
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(QJsonDocument(root).toJson());
+}
+
+// the indexer compares modification times, rewrite the file until the file system reports a new time
+void rewriteLoopFile(const QDir &loopsDir, const QString &loopName, quint32 bpm)
+{
+    QString filePath = loopsDir.absoluteFilePath(loopName + ".json");
+    QDateTime lastModified = QFileInfo(filePath).lastModified();
+    for (int tries = 0; tries < 30; ++tries) {
+        QTest::qSleep(100); // not processing events, the watcher can't start a scan in the middle of the test
+        writeLoopFile(loopsDir, loopName, bpm);
+        if (QFileInfo(filePath).lastModified() != lastModified)
+            return;
+    }
+    QFAIL("The loop file modification time was not changed");
+}
+
+QList<LoopsIndexEntry> changedEntries(const QSignalSpy &spy, int index = 0)
+{
+    return spy.at(index).at(0).value<QList<LoopsIndexEntry>>();
+}
+
+QStringList removedFiles(const QSignalSpy &spy, int index = 0)
+{
+    return spy.at(index).at(1).toStringList();
+}
+
+} // namespace
+
+void TestLoopsIndex::initTestCase()
+{
+    qRegisterMetaType<QList<Audio::LoopsIndexEntry>>("QList<Audio::LoopsIndexEntry>");
+}
+
+void TestLoopsIndex::newFilesAreIndexed()
+{
+    QTemporaryDir loopsDir;
+    QTemporaryDir cacheDir;
+    writeLoopFile(QDir(loopsDir.path()), "loop1", 120);
+    writeLoopFile(QDir(loopsDir.path()), "loop2", 90);
+
+    LoopsIndexer indexer(QDir(cacheDir.path()).absoluteFilePath("index.bin"));
+    QSignalSpy spy(&indexer, &LoopsIndexer::entriesChanged);
+
+    indexer.setLoopsPath(loopsDir.path());
+
+    QCOMPARE(spy.count(), 1);
+    QList<LoopsIndexEntry> entries = changedEntries(spy);
+    QCOMPARE(entries.size(), 2);
+    QVERIFY(removedFiles(spy).isEmpty());
+    for (const LoopsIndexEntry &entry : entries) {
+        QVERIFY(entry.loopInfo.isValid());
+        QCOMPARE(entry.loopInfo.getBpm(), entry.fileName == "loop1.json" ? 120u : 90u);
+    }
+}
+
+void TestLoopsIndex::unchangedFilesAreSkipped()
+{
+    QTemporaryDir loopsDir;
+    QTemporaryDir cacheDir;
+    writeLoopFile(QDir(loopsDir.path()), "loop1", 120);
+
+    LoopsIndexer indexer(QDir(cacheDir.path()).absoluteFilePath("index.bin"));
+    indexer.setLoopsPath(loopsDir.path());
+
+    QSignalSpy spy(&indexer, &LoopsIndexer::entriesChanged);
+    indexer.scan();
+
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestLoopsIndex::modifiedFilesAreReindexed()
+{
+    QTemporaryDir loopsDir;
+    QTemporaryDir cacheDir;
+    writeLoopFile(QDir(loopsDir.path()), "loop1", 120);
+    writeLoopFile(QDir(loopsDir.path()), "loop2", 90);
+
+    LoopsIndexer indexer(QDir(cacheDir.path()).absoluteFilePath("index.bin"));
+    indexer.setLoopsPath(loopsDir.path());
+
+    rewriteLoopFile(QDir(loopsDir.path()), "loop2", 100);
+
+    QSignalSpy spy(&indexer, &LoopsIndexer::entriesChanged);
+    indexer.scan();
+
+    QCOMPARE(spy.count(), 1);
+    QList<LoopsIndexEntry> entries = changedEntries(spy);
+    QCOMPARE(entries.size(), 1); // loop1 is not parsed again
+    QCOMPARE(entries.first().fileName, QString("loop2.json"));
+    QCOMPARE(entries.first().loopInfo.getBpm(), 100u);
+    QVERIFY(removedFiles(spy).isEmpty());
+}
+
+void TestLoopsIndex::deletedFilesAreRemoved()
+{
+    QTemporaryDir loopsDir;
+    QTemporaryDir cacheDir;
+    writeLoopFile(QDir(loopsDir.path()), "loop1", 120);
+    writeLoopFile(QDir(loopsDir.path()), "loop2", 90);
+
+    LoopsIndexer indexer(QDir(cacheDir.path()).absoluteFilePath("index.bin"));
+    indexer.setLoopsPath(loopsDir.path());
+
+    QVERIFY(QFile::remove(QDir(loopsDir.path()).absoluteFilePath("loop1.json")));
+
+    QSignalSpy spy(&indexer, &LoopsIndexer::entriesChanged);
+    indexer.scan();
+
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(changedEntries(spy).isEmpty());
+    QCOMPARE(removedFiles(spy), QStringList("loop1.json"));
+
+    spy.clear();
+    indexer.scan(); // the removed file is not reported again
+
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestLoopsIndex::indexIsPersisted()
+{
+    QTemporaryDir loopsDir;
+    QTemporaryDir cacheDir;
+    writeLoopFile(QDir(loopsDir.path()), "loop1", 120);
+    writeLoopFile(QDir(loopsDir.path()), "loop2", 90);
+
+    QString indexFilePath = QDir(cacheDir.path()).absoluteFilePath("index.bin");
+    {
+        LoopsIndexer indexer(indexFilePath);
+        indexer.setLoopsPath(loopsDir.path());
+    }
+    QVERIFY(QFileInfo(indexFilePath).exists());
+
+    LoopsIndexer indexer(indexFilePath);
+    QSignalSpy spy(&indexer, &LoopsIndexer::entriesChanged);
+
+    indexer.setLoopsPath(loopsDir.path());
+
+    QCOMPARE(spy.count(), 1); // only the entries loaded from the index file, the scan found no changes
+    QCOMPARE(changedEntries(spy).size(), 2);
+    QVERIFY(removedFiles(spy).isEmpty());
+}
@@ -0,0 +1,21 @@
+#ifndef TESTLOOPSINDEX_H
+#define TESTLOOPSINDEX_H
+
+#include <QObject>
+
+// NOTE: LoopsIndexer is writing to storage, every test is using temporary loops and cache dirs
+class TestLoopsIndex: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void newFilesAreIndexed();
+    void unchangedFilesAreSkipped();
+    void modifiedFilesAreReindexed();
+    void deletedFilesAreRemoved();
+    void indexIsPersisted();
+};
+
+#endif // TESTLOOPSINDEX_H
@@ -234,3 +234,50 @@ void TestSamplesBuffer::append_data()
     QTest::newRow("Appending 2 samples") << "1,2,3" << "4,5" << "1,2,3,4,5";
     QTest::newRow("Appending zero samples") << "1,2,3" << "" << "1,2,3";
 }
+
+void TestSamplesBuffer::wrapIsProcessingExternalSamples()
+{
+    SamplesBuffer buffer = createBuffer("1,2");
+
+    float left[] = {1, 2, 3};
+    float right[] = {4, 5, 6};
+    float *externalSamples[] = {left, right};
+
+    buffer.setToStereo();
+    buffer.wrap(externalSamples, 3);
+    QVERIFY(buffer.isWrapping());
+    QCOMPARE(buffer.getFrameLenght(), 3u);
+    QVERIFY(buffer.getSamplesArray(0) == left);
+
+    buffer.applyGain(2, 1);
+    QCOMPARE(left[2], 6.0f);
+    QCOMPARE(right[0], 8.0f);
+
+    buffer.invertStereo();
+    QCOMPARE(buffer.get(0, 0), 8.0f);
+    QCOMPARE(right[0], 8.0f); // the external channels are not moved
+
+    buffer.unwrap();
+    QVERIFY(!buffer.isWrapping());
+    QCOMPARE(buffer.getFrameLenght(), 2u);
+    checkExpectedValues("1,2", buffer);
+}
+
+void TestSamplesBuffer::wrapIsCopyingExternalSamplesWhenGrowing()
+{
+    SamplesBuffer buffer(1);
+
+    float samples[] = {1, 2};
+    float *externalSamples[] = {samples};
+
+    buffer.wrap(externalSamples, 2);
+    buffer.setFrameLenght(4);
+
+    QVERIFY(!buffer.isWrapping());
+    QVERIFY(buffer.getSamplesArray(0) != samples);
+    checkExpectedValues("1,2", buffer);
+
+    buffer.set(0, 3, 7);
+    QCOMPARE(buffer.get(0, 3), 7.0f);
+    QCOMPARE(samples[1], 2.0f);
+}
@@ -31,6 +31,10 @@ private slots:
     void setFrameLenghtIsPreservingSamples();
     void setFrameLenghtIsPreservingSamples_data();
 
+    // the wrapped external channels are processed in place, the owned samples are restored in unwrap()
+    void wrapIsProcessingExternalSamples();
+    void wrapIsCopyingExternalSamplesWhenGrowing();
+
 private:
     Audio::SamplesBuffer createBuffer(QString comaSeparatedValues);
     void checkExpectedValues(QString comaSeparatedExpectedValues, const Audio::SamplesBuffer &buffer);
@@ -0,0 +1,149 @@
+#include "TestSamplesRingBuffer.h"
+
+#include "audio/core/SamplesRingBuffer.h"
+#include <QTest>
+
+using namespace Audio;
+
+void TestSamplesRingBuffer::capacityIsPowerOfTwo()
+{
+    SamplesRingBuffer ringBuffer(2, 1000);
+    QCOMPARE(ringBuffer.getCapacity(), 1024u);
+    QCOMPARE(ringBuffer.getFreeFrames(), 1024u);
+    QCOMPARE(ringBuffer.getAvailableFrames(), 0u);
+}
+
+void TestSamplesRingBuffer::writeAndRead_data()
+{
+    QTest::addColumn<uint>("framesToWrite");
+    QTest::addColumn<uint>("framesToRead");
+    QTest::addColumn<uint>("expectedReadedFrames");
+
+    QTest::newRow("Read all frames") << 10u << 10u << 10u;
+    QTest::newRow("Read some frames") << 10u << 4u << 4u;
+    QTest::newRow("Read more than available") << 4u << 10u << 4u;
+    QTest::newRow("Empty ring") << 0u << 10u << 0u;
+}
+
+void TestSamplesRingBuffer::writeAndRead()
+{
+    QFETCH(uint, framesToWrite);
+    QFETCH(uint, framesToRead);
+    QFETCH(uint, expectedReadedFrames);
+
+    SamplesRingBuffer ringBuffer(2, 16);
+
+    SamplesBuffer in(2, framesToWrite);
+    for (uint i = 0; i < framesToWrite; ++i) {
+        in.set(0, i, i);
+        in.set(1, i, -static_cast<float>(i));
+    }
+
+    QCOMPARE(ringBuffer.write(in), framesToWrite);
+    QCOMPARE(ringBuffer.getAvailableFrames(), framesToWrite);
+
+    SamplesBuffer out(2, framesToRead);
+    QCOMPARE(ringBuffer.read(out, framesToRead), expectedReadedFrames);
+    QCOMPARE(ringBuffer.getAvailableFrames(), framesToWrite - expectedReadedFrames);
+
+    for (uint i = 0; i < expectedReadedFrames; ++i) {
+        QCOMPARE(out.get(0, i), static_cast<float>(i));
+        QCOMPARE(out.get(1, i), -static_cast<float>(i));
+    }
+}
+
+void TestSamplesRingBuffer::writeIsLimitedByFreeFrames()
+{
+    SamplesRingBuffer ringBuffer(1, 8);
+
+    SamplesBuffer in(1, 6);
+    QCOMPARE(ringBuffer.write(in), 6u);
+    QCOMPARE(ringBuffer.write(in), 2u);
+    QCOMPARE(ringBuffer.write(in), 0u);
+    QCOMPARE(ringBuffer.getFreeFrames(), 0u);
+}
+
+void TestSamplesRingBuffer::readAfterWrapAround()
+{
+    SamplesRingBuffer ringBuffer(1, 8);
+    SamplesBuffer out(1, 8);
+
+    SamplesBuffer in(1, 6);
+    for (uint i = 0; i < 6; ++i)
+        in.set(0, i, i + 1);
+
+    ringBuffer.write(in);
+    ringBuffer.read(out, 5); // the next write will wrap around
+
+    ringBuffer.write(in);
+    QCOMPARE(ringBuffer.getAvailableFrames(), 7u);
+
+    QCOMPARE(ringBuffer.read(out, 7), 7u);
+    QCOMPARE(out.get(0, 0), 6.0f);
+    for (uint i = 0; i < 6; ++i)
+        QCOMPARE(out.get(0, i + 1), static_cast<float>(i + 1));
+}
+
+void TestSamplesRingBuffer::monoIsCopiedToAllChannels()
+{
+    SamplesRingBuffer ringBuffer(2, 8);
+
+    SamplesBuffer in(1, 2);
+    in.set(0, 0, 0.5f);
+    in.set(0, 1, 0.25f);
+    ringBuffer.write(in);
+
+    SamplesBuffer out(2, 2);
+    ringBuffer.read(out, 2);
+    QCOMPARE(out.get(0, 0), 0.5f);
+    QCOMPARE(out.get(1, 0), 0.5f);
+    QCOMPARE(out.get(0, 1), 0.25f);
+    QCOMPARE(out.get(1, 1), 0.25f);
+}
+
+void TestSamplesRingBuffer::discardAll()
+{
+    SamplesRingBuffer ringBuffer(2, 8);
+
+    ringBuffer.write(SamplesBuffer(2, 5));
+    ringBuffer.discardAll();
+
+    QCOMPARE(ringBuffer.getAvailableFrames(), 0u);
+    QCOMPARE(ringBuffer.getFreeFrames(), 8u);
+}
+
+void TestSamplesRingBuffer::discardUntilKeepsNewerSamples()
+{
+    SamplesRingBuffer ringBuffer(1, 8);
+
+    ringBuffer.write(SamplesBuffer(1, 5)); // old samples
+    unsigned int position = ringBuffer.getWritePosition();
+
+    SamplesBuffer newSamples(1, 2);
+    newSamples.set(0, 0, 1.0f);
+    newSamples.set(0, 1, 2.0f);
+    ringBuffer.write(newSamples);
+
+    ringBuffer.discardUntil(position);
+    QCOMPARE(ringBuffer.getAvailableFrames(), 2u);
+
+    SamplesBuffer out(1, 2);
+    QCOMPARE(ringBuffer.read(out, 2), 2u);
+    QCOMPARE(out.get(0, 0), 1.0f);
+    QCOMPARE(out.get(0, 1), 2.0f);
+}
+
+void TestSamplesRingBuffer::discardUntilConsumedPosition()
+{
+    SamplesRingBuffer ringBuffer(1, 8);
+
+    ringBuffer.write(SamplesBuffer(1, 3));
+    unsigned int position = ringBuffer.getWritePosition();
+
+    ringBuffer.write(SamplesBuffer(1, 3));
+    SamplesBuffer out(1, 5);
+    ringBuffer.read(out, 5); // reading after the position
+
+    ringBuffer.discardUntil(position); // nothing to discard
+    QCOMPARE(ringBuffer.getAvailableFrames(), 1u);
+}
@@ -0,0 +1,29 @@
+#ifndef TESTSAMPLESRINGBUFFER_H
+#define TESTSAMPLESRINGBUFFER_H
+
+#include <QObject>
+
+class TestSamplesRingBuffer: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void capacityIsPowerOfTwo();
+
+    void writeAndRead_data();
+    void writeAndRead();
+
+    void writeIsLimitedByFreeFrames();
+
+    void readAfterWrapAround();
+
+    void monoIsCopiedToAllChannels();
+
+    void discardAll();
+
+    void discardUntilKeepsNewerSamples();
+
+    void discardUntilConsumedPosition();
+};
+
+#endif // TESTSAMPLESRINGBUFFER_H
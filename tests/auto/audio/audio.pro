@@ -11,16 +11,49 @@ VPATH += ../../../src/Common
 
 HEADERS += TestSamplesBuffer.h
 HEADERS += TestLooper.h
+HEADERS += TestSamplesRingBuffer.h
+HEADERS += TestAudioNode.h
+HEADERS += TestIntervalTelemetry.h
+HEADERS += TestHostPositionFollower.h
+HEADERS += TestAdaptiveEncodingQuality.h
+HEADERS += TestLoopsIndex.h
 HEADERS += audio/core/SamplesBuffer.h
 HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/SamplesRingBuffer.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/core/AudioNodeProcessor.h
 HEADERS += looper/Looper.h
+HEADERS += audio/IntervalTelemetry.h
+HEADERS += audio/HostPositionFollower.h
+HEADERS += audio/vorbis/AdaptiveEncodingQuality.h
+HEADERS += looper/LoopInfo.h
+HEADERS += looper/LoopsIndex.h
+HEADERS += persistence/CacheHeader.h
+HEADERS += log/Logging.h
 
 SOURCES += TestSamplesBuffer.cpp
 SOURCES += TestLooper.cpp
+SOURCES += TestSamplesRingBuffer.cpp
+SOURCES += TestAudioNode.cpp
+SOURCES += TestIntervalTelemetry.cpp
+SOURCES += TestHostPositionFollower.cpp
+SOURCES += TestAdaptiveEncodingQuality.cpp
+SOURCES += TestLoopsIndex.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
 SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/SamplesRingBuffer.cpp
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += midi/MidiMessage.cpp
 SOURCES += looper/Looper.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += looper/LooperLayer.cpp
+SOURCES += audio/IntervalTelemetry.cpp
+SOURCES += audio/HostPositionFollower.cpp
+SOURCES += audio/vorbis/AdaptiveEncodingQuality.cpp
+SOURCES += looper/LoopInfo.cpp
+SOURCES += looper/LoopsIndex.cpp
+SOURCES += persistence/CacheHeader.cpp
+SOURCES += log/logging.cpp
 
 SOURCES += test_Audio.cpp
@@ -3,15 +3,41 @@
 #include <QtTest>
 #include "TestSamplesBuffer.h"
 #include "TestLooper.h"
+#include "TestSamplesRingBuffer.h"
+#include "TestAudioNode.h"
+#include "TestIntervalTelemetry.h"
+#include "TestHostPositionFollower.h"
+#include "TestAdaptiveEncodingQuality.h"
+#include "TestLoopsIndex.h"
 
 int main(int argc, char *argv[])
 {
+    QCoreApplication app(argc, argv); // the loops indexer is using a file system watcher and a timer
+
     TestSamplesBuffer testSamplesBuffer;
     TestLooper testLooper;
+    TestSamplesRingBuffer testSamplesRingBuffer;
+    TestAudioNode testAudioNode;
+    TestIntervalTelemetry testIntervalTelemetry;
+    TestHostPositionFollower testHostPositionFollower;
+    TestAdaptiveEncodingQuality testAdaptiveEncodingQuality;
+    TestLoopsIndex testLoopsIndex;
 
     int result = QTest::qExec(&testSamplesBuffer, argc, argv);
 
     result |= QTest::qExec(&testLooper, argc, argv);
 
+    result |= QTest::qExec(&testSamplesRingBuffer, argc, argv);
+
+    result |= QTest::qExec(&testAudioNode, argc, argv);
+
+    result |= QTest::qExec(&testIntervalTelemetry, argc, argv);
+
+    result |= QTest::qExec(&testHostPositionFollower, argc, argv);
+
+    result |= QTest::qExec(&testAdaptiveEncodingQuality, argc, argv);
+
+    result |= QTest::qExec(&testLoopsIndex, argc, argv);
+
     return result;
 }
@@ -9,3 +9,4 @@ SUBDIRS += geo
 SUBDIRS += midi
 SUBDIRS += ninjam
 SUBDIRS += persistence
+SUBDIRS += video
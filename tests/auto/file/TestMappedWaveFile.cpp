@@ -0,0 +1,306 @@
+#include "TestMappedWaveFile.h"
+
+#include "file/MappedWaveFile.h"
+#include "audio/core/SamplesBuffer.h"
+#include <QDataStream>
+#include <QFile>
+#include <QtEndian>
+#include <QTest>
+
+using namespace Audio;
+
+namespace {
+
+const quint16 WAVE_FORMAT_PCM = 0x0001;
+const quint16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+const quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+const float TOLERANCE = 0.0001f;
+
+QByteArray buildWave(quint16 formatTag, quint16 channels, quint16 bitsPerSample, const QByteArray &samples,
+                     quint16 blockAlign = 0, quint16 subFormat = 0, const QByteArray &extraChunk = QByteArray())
+{
+    const quint32 sampleRate = 44100;
+    if (blockAlign == 0)
+        blockAlign = channels * bitsPerSample / 8;
+
+    const bool extensible = formatTag == WAVE_FORMAT_EXTENSIBLE;
+    const quint32 fmtSize = extensible ? 40 : 16;
+
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream.writeRawData("RIFF", 4);
+    stream << quint32(0); // updated below
+    stream.writeRawData("WAVE", 4);
+
+    stream.writeRawData("fmt ", 4);
+    stream << fmtSize;
+    stream << formatTag;
+    stream << channels;
+    stream << sampleRate;
+    stream << quint32(sampleRate * blockAlign);
+    stream << blockAlign;
+    stream << bitsPerSample;
+    if (extensible) {
+        stream << quint16(22); // extension size
+        stream << bitsPerSample; // valid bits
+        stream << quint32(0); // channel mask
+        stream << subFormat; // the first 2 bytes of the sub format GUID
+        for (int i = 0; i < 14; ++i)
+            stream << quint8(0);
+    }
+
+    if (!extraChunk.isEmpty())
+        stream.writeRawData(extraChunk.constData(), extraChunk.size());
+
+    stream.writeRawData("data", 4);
+    stream << quint32(samples.size());
+    stream.writeRawData(samples.constData(), samples.size());
+
+    qToLittleEndian<quint32>(content.size() - 8, reinterpret_cast<uchar *>(content.data() + 4)); // RIFF chunk size
+
+    return content;
+}
+
+template<typename T>
+QByteArray toLittleEndianBytes(const QList<T> &values)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    for (T value : values)
+        stream << value;
+
+    return bytes;
+}
+
+QByteArray to24BitsBytes(const QList<qint32> &values)
+{
+    QByteArray bytes;
+    for (qint32 value : values) {
+        bytes.append(static_cast<char>(value & 0xFF));
+        bytes.append(static_cast<char>((value >> 8) & 0xFF));
+        bytes.append(static_cast<char>((value >> 16) & 0xFF));
+    }
+    return bytes;
+}
+
+bool compareSamples(const SamplesBuffer &buffer, int channel, const QList<float> &expected)
+{
+    if (buffer.getFrameLenght() < static_cast<uint>(expected.size()))
+        return false;
+
+    for (int i = 0; i < expected.size(); ++i) {
+        float sample = buffer.get(channel, i);
+        if (qAbs(sample - expected.at(i)) > TOLERANCE) {
+            qWarning() << "sample" << i << "in channel" << channel << "is" << sample << ", expected" << expected.at(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void TestMappedWaveFile::initTestCase()
+{
+    QVERIFY(dir.isValid());
+}
+
+QString TestMappedWaveFile::writeWaveFile(const QString &fileName, const QByteArray &content)
+{
+    QString filePath = dir.filePath(fileName);
+    QFile file(filePath);
+    if (!file.open(QFile::WriteOnly))
+        return QString();
+
+    file.write(content);
+    return filePath;
+}
+
+void TestMappedWaveFile::unsigned8Bits()
+{
+    QByteArray samples;
+    samples.append(static_cast<char>(0));
+    samples.append(static_cast<char>(128));
+    samples.append(static_cast<char>(255));
+    samples.append(static_cast<char>(64));
+
+    QString filePath = writeWaveFile("unsigned8Bits.wav", buildWave(WAVE_FORMAT_PCM, 1, 8, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getBitsPerSample(), quint16(8));
+    QCOMPARE(waveFile.getFrameLenght(), 4u);
+
+    SamplesBuffer buffer(1, 4);
+    QCOMPARE(waveFile.read(0, 4, buffer), 4u);
+
+    // 128 is the silence, the unsigned values are shifted
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << -1.0f << 0.0f << 127.0f/128.0f << -0.5f));
+}
+
+void TestMappedWaveFile::signed16Bits()
+{
+    QByteArray samples = toLittleEndianBytes(QList<qint16>() << 0 << 32767 << -32767 << 16384);
+    QString filePath = writeWaveFile("signed16Bits.wav", buildWave(WAVE_FORMAT_PCM, 1, 16, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 4u);
+
+    SamplesBuffer buffer(1, 4);
+    QCOMPARE(waveFile.read(0, 4, buffer), 4u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 0.0f << 1.0f << -1.0f << 16384.0f/32767.0f));
+}
+
+void TestMappedWaveFile::signed24Bits()
+{
+    QByteArray samples = to24BitsBytes(QList<qint32>() << 0 << 8388607 << -8388607 << -4194304);
+    QString filePath = writeWaveFile("signed24Bits.wav", buildWave(WAVE_FORMAT_PCM, 1, 24, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 4u);
+
+    SamplesBuffer buffer(1, 4);
+    QCOMPARE(waveFile.read(0, 4, buffer), 4u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 0.0f << 1.0f << -1.0f << -4194304.0f/8388607.0f));
+}
+
+void TestMappedWaveFile::signed32Bits()
+{
+    QByteArray samples = toLittleEndianBytes(QList<qint32>() << 0 << 2147483647 << -2147483647 << 1073741824);
+    QString filePath = writeWaveFile("signed32Bits.wav", buildWave(WAVE_FORMAT_PCM, 1, 32, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 4u);
+
+    SamplesBuffer buffer(1, 4);
+    QCOMPARE(waveFile.read(0, 4, buffer), 4u);
+
+    // integer samples are scaled to [-1, 1], not read as float
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 0.0f << 1.0f << -1.0f << 0.5f));
+}
+
+void TestMappedWaveFile::float32Bits()
+{
+    QByteArray samples = toLittleEndianBytes(QList<float>() << 0.5f << -0.25f << 1.0f << 0.0f);
+    QString filePath = writeWaveFile("float32Bits.wav", buildWave(WAVE_FORMAT_IEEE_FLOAT, 1, 32, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 4u);
+
+    SamplesBuffer buffer(1, 4);
+    QCOMPARE(waveFile.read(0, 4, buffer), 4u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 0.5f << -0.25f << 1.0f << 0.0f));
+}
+
+void TestMappedWaveFile::paddedFrames()
+{
+    // 16 bits stereo frames padded to 6 bytes
+    QByteArray samples;
+    QList<qint16> left = QList<qint16>() << 32767 << 0 << -16384;
+    QList<qint16> right = QList<qint16>() << -32767 << 16384 << 0;
+    for (int i = 0; i < left.size(); ++i) {
+        samples.append(toLittleEndianBytes(QList<qint16>() << left.at(i) << right.at(i)));
+        samples.append(2, static_cast<char>(0x7F)); // padding
+    }
+
+    QString filePath = writeWaveFile("paddedFrames.wav", buildWave(WAVE_FORMAT_PCM, 2, 16, samples, 6));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 3u);
+
+    SamplesBuffer buffer(2, 3);
+    QCOMPARE(waveFile.read(0, 3, buffer), 3u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 1.0f << 0.0f << -16384.0f/32767.0f));
+    QVERIFY(compareSamples(buffer, 1, QList<float>() << -1.0f << 16384.0f/32767.0f << 0.0f));
+}
+
+void TestMappedWaveFile::extensibleFormat_data()
+{
+    QTest::addColumn<quint16>("subFormat");
+    QTest::addColumn<quint16>("bitsPerSample");
+    QTest::addColumn<QByteArray>("samples");
+    QTest::addColumn<float>("expectedSample");
+
+    QTest::newRow("PCM 16 bits") << WAVE_FORMAT_PCM << quint16(16) << toLittleEndianBytes(QList<qint16>() << -16384) << -16384.0f/32767.0f;
+    QTest::newRow("PCM 32 bits") << WAVE_FORMAT_PCM << quint16(32) << toLittleEndianBytes(QList<qint32>() << -1073741824) << -0.5f;
+    QTest::newRow("Float 32 bits") << WAVE_FORMAT_IEEE_FLOAT << quint16(32) << toLittleEndianBytes(QList<float>() << 0.75f) << 0.75f;
+}
+
+void TestMappedWaveFile::extensibleFormat()
+{
+    QFETCH(quint16, subFormat);
+    QFETCH(quint16, bitsPerSample);
+    QFETCH(QByteArray, samples);
+    QFETCH(float, expectedSample);
+
+    QString filePath = writeWaveFile("extensible.wav", buildWave(WAVE_FORMAT_EXTENSIBLE, 1, bitsPerSample, samples, 0, subFormat));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 1u);
+
+    SamplesBuffer buffer(1, 1);
+    QCOMPARE(waveFile.read(0, 1, buffer), 1u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << expectedSample));
+}
+
+void TestMappedWaveFile::stereoFrames()
+{
+    QByteArray samples = toLittleEndianBytes(QList<qint16>() << 32767 << -32767 << 0 << 16384);
+    QString filePath = writeWaveFile("stereo.wav", buildWave(WAVE_FORMAT_PCM, 2, 16, samples));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getChannels(), quint16(2));
+    QCOMPARE(waveFile.getFrameLenght(), 2u);
+
+    SamplesBuffer buffer(2, 2);
+    QCOMPARE(waveFile.read(0, 2, buffer), 2u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 1.0f << 0.0f));
+    QVERIFY(compareSamples(buffer, 1, QList<float>() << -1.0f << 16384.0f/32767.0f));
+
+    // reading from the second frame
+    SamplesBuffer lastFrame(2, 1);
+    QCOMPARE(waveFile.read(1, 4, lastFrame), 1u);
+    QVERIFY(compareSamples(lastFrame, 1, QList<float>() << 16384.0f/32767.0f));
+}
+
+void TestMappedWaveFile::unknownChunksAreSkipped()
+{
+    // an odd sized chunk, padded to word alignment
+    QByteArray listChunk("LIST");
+    listChunk.append(toLittleEndianBytes(QList<quint32>() << 3));
+    listChunk.append("abc");
+    listChunk.append(static_cast<char>(0));
+
+    QByteArray samples = toLittleEndianBytes(QList<qint16>() << 32767 << -32767);
+    QString filePath = writeWaveFile("chunks.wav", buildWave(WAVE_FORMAT_PCM, 1, 16, samples, 0, 0, listChunk));
+
+    MappedWaveFile waveFile;
+    QVERIFY(waveFile.open(filePath));
+    QCOMPARE(waveFile.getFrameLenght(), 2u);
+
+    SamplesBuffer buffer(1, 2);
+    QCOMPARE(waveFile.read(0, 2, buffer), 2u);
+    QVERIFY(compareSamples(buffer, 0, QList<float>() << 1.0f << -1.0f));
+}
+
+void TestMappedWaveFile::invalidFormat()
+{
+    QByteArray samples = toLittleEndianBytes(QList<qint16>() << 0 << 0);
+    QString filePath = writeWaveFile("compressed.wav", buildWave(0x0002, 1, 16, samples)); // ADPCM
+
+    MappedWaveFile waveFile;
+    QVERIFY(!waveFile.open(filePath));
+    QVERIFY(!waveFile.isOpen());
+}
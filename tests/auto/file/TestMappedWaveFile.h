@@ -0,0 +1,31 @@
+#ifndef TESTMAPPEDWAVEFILE_H
+#define TESTMAPPEDWAVEFILE_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestMappedWaveFile: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void unsigned8Bits();
+    void signed16Bits();
+    void signed24Bits();
+    void signed32Bits();
+    void float32Bits();
+    void paddedFrames();
+    void extensibleFormat_data();
+    void extensibleFormat();
+    void stereoFrames();
+    void unknownChunksAreSkipped();
+    void invalidFormat();
+
+private:
+    QString writeWaveFile(const QString &fileName, const QByteArray &content);
+    QTemporaryDir dir;
+};
+
+#endif // TESTMAPPEDWAVEFILE_H
@@ -8,7 +8,15 @@ INCLUDEPATH += .
 INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
+HEADERS += TestMappedWaveFile.h
 HEADERS += file/FileUtils.h
+HEADERS += file/MappedWaveFile.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
 
+SOURCES += TestMappedWaveFile.cpp
 SOURCES += file/FileUtils.cpp
+SOURCES += file/MappedWaveFile.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
 SOURCES += test_File.cpp
@@ -2,6 +2,7 @@
 #include <QString>
 #include <QtTest/QtTest>
 #include "file/FileUtils.h"
+#include "TestMappedWaveFile.h"
 
 class TestFile: public QObject
 {
@@ -41,8 +42,14 @@ void TestFile::sanitizeFileName_data()
 
 int main(int argc, char *argv[])
 {
-    TestFile test;
-    return QTest::qExec(&test, argc, argv);
+    TestFile testFile;
+    TestMappedWaveFile testMappedWaveFile;
+
+    int result = QTest::qExec(&testFile, argc, argv);
+
+    result |= QTest::qExec(&testMappedWaveFile, argc, argv);
+
+    return result;
 }
 
 #include "test_File.moc"
@@ -1,5 +1,5 @@
 
-QT += testlib
+QT += testlib network
 QT -= gui
 CONFIG += testcase
 TEMPLATE = app
@@ -10,7 +10,9 @@ VPATH += ../../../src/Common
 
 HEADERS += log/logging.h
 HEADERS += geo/IpToLocationResolver.h
+HEADERS += geo/IpLocationTable.h
 
 SOURCES += log/logging.cpp
 SOURCES += geo/IpToLocationResolver.cpp
+SOURCES += geo/IpLocationTable.cpp
 SOURCES += tst_GeoLocation.cpp
@@ -2,6 +2,8 @@
 #include <QString>
 #include <QtTest/QtTest>
 #include "geo/IpToLocationResolver.h"
+#include "geo/IpLocationTable.h"
+#include <QTemporaryDir>
 #include <QDebug>
 
 using namespace Geo;
@@ -13,6 +15,10 @@ class TestGeoLocation: public QObject
 private slots:
     void stripHtmlTags();
     void stripHtmlTags_data();
+
+    void locationsTableLookup();
+    void locationsTablePersistence();
+    void locationsTableCompaction();
 };
 
 void TestGeoLocation::stripHtmlTags()
@@ -38,6 +44,79 @@ void TestGeoLocation::stripHtmlTags_data()
     QTest::newRow("No Html tags to strip") << "Country name" << "Country name";
 }
 
+void TestGeoLocation::locationsTableLookup()
+{
+    QTemporaryDir dir;
+    IpLocationTable table(dir.path() + "/locations.bin");
+
+    QVERIFY(table.insert("200.10.20.128", "BR", QPointF(-23.5, -46.6)));
+    QVERIFY(table.insert("2001:db8::1", "US", QPointF(37.7, -122.4)));
+    QVERIFY(!table.insert("invalid ip", "BR", QPointF(0, 0)));
+
+    QString countryCode;
+    QPointF latLong;
+    QVERIFY(table.find("200.10.20.128", &countryCode, &latLong));
+    QCOMPARE(countryCode, QString("BR"));
+    QCOMPARE(static_cast<float>(latLong.x()), -23.5f);
+
+    QVERIFY(table.find("2001:db8::1", &countryCode, &latLong));
+    QCOMPARE(countryCode, QString("US"));
+
+    QVERIFY(!table.find("200.10.20.129", &countryCode, &latLong));
+    QVERIFY(!table.find("", &countryCode, &latLong));
+}
+
+void TestGeoLocation::locationsTablePersistence()
+{
+    QTemporaryDir dir;
+    QString filePath(dir.path() + "/locations.bin");
+    {
+        IpLocationTable table(filePath);
+        table.insert("10.0.0.128", "PT", QPointF(38.7, -9.1));
+        table.insert("10.0.1.128", "FR", QPointF(48.8, 2.3));
+    }
+
+    IpLocationTable table(filePath); // the appended records were compacted when the first table was destroyed
+    QCOMPARE(table.getSize(), 2);
+    QCOMPARE(table.getAppendedRecords(), 0);
+
+    QString countryCode;
+    QVERIFY(table.find("10.0.1.128", &countryCode, nullptr));
+    QCOMPARE(countryCode, QString("FR"));
+
+    table.insert("10.0.1.128", "DE", QPointF(52.5, 13.4)); // appended record replacing a sorted record
+    QVERIFY(table.find("10.0.1.128", &countryCode, nullptr));
+    QCOMPARE(countryCode, QString("DE"));
+    QCOMPARE(table.getSize(), 3);
+
+    table.compact();
+    QCOMPARE(table.getSize(), 2);
+    QVERIFY(table.find("10.0.1.128", &countryCode, nullptr));
+    QCOMPARE(countryCode, QString("DE"));
+}
+
+void TestGeoLocation::locationsTableCompaction()
+{
+    QTemporaryDir dir;
+    IpLocationTable table(dir.path() + "/locations.bin");
+
+    const int records = IpLocationTable::MAX_APPENDED_RECORDS + 10;
+    for (int i = 0; i < records; ++i) {
+        QString ip = QString("%1.%2.%3.128").arg(1 + i % 200).arg((i * 7) % 256).arg(i / 256);
+        QVERIFY(table.insert(ip, "BR", QPointF(i, -i)));
+    }
+
+    QVERIFY(table.getAppendedRecords() < IpLocationTable::MAX_APPENDED_RECORDS);
+    QCOMPARE(table.getSize(), records);
+
+    for (int i = 0; i < records; ++i) {
+        QString ip = QString("%1.%2.%3.128").arg(1 + i % 200).arg((i * 7) % 256).arg(i / 256);
+        QPointF latLong;
+        QVERIFY(table.find(ip, nullptr, &latLong));
+        QCOMPARE(latLong, QPointF(i, -i));
+    }
+}
+
 
 int main(int argc, char *argv[])
 {
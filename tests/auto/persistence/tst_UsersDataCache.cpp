@@ -36,12 +36,17 @@ private slots:
     void setPanGuard();
 };
 
-// NOTE: UsersDataCache class was not able to test without side effect
-// because destructor write to storage directly.
+// NOTE: UsersDataCache is writing to storage, every test is using a temporary cache dir
 class TestUsersDataCache: public QObject
 {
     Q_OBJECT
 private slots:
+    void entriesArePersisted();
+    void changesSurviveCrash();
+    void corruptedTailIsDiscarded();
+    void logIsCompacted();
+    void leastRecentlyUsedAreEvicted();
+    void legacyFileIsConverted();
 };
 
 void TestCacheHeader::invalidRevision()
@@ -180,8 +185,160 @@ void TestCacheEntry::setPanGuard()
     QCOMPARE(entry.getPan(), expect);
 }
 
+void TestUsersDataCache::entriesArePersisted()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    {
+        UsersDataCache cache(cacheDir);
+        CacheEntry entry("10.0.0.1", "user", 1);
+        entry.setGain(0.5f);
+        entry.setPan(-1.0f);
+        entry.setMuted(true);
+        entry.setLowCutState(2);
+        cache.updateUserCacheEntry(entry);
+    }
+
+    UsersDataCache cache(cacheDir);
+    QCOMPARE(cache.getSize(), 1);
+
+    CacheEntry entry = cache.getUserCacheEntry("10.0.0.1", "user", 1);
+    QCOMPARE(entry.getGain(), 0.5f);
+    QCOMPARE(entry.getPan(), -1.0f);
+    QCOMPARE(entry.isMuted(), true);
+    QCOMPARE(entry.getLowCutState(), 2);
+
+    // ip/name concatenations are not colliding
+    QCOMPARE(cache.getUserCacheEntry("10.0.0.11", "ser", 1).getGain(), CacheEntry::DEFAULT_GAIN);
+}
+
+void TestUsersDataCache::changesSurviveCrash()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    // the first cache is not destroyed before the second is loading, simulating a crash
+    QScopedPointer<UsersDataCache> crashedCache(new UsersDataCache(cacheDir));
+    for (int i = 0; i < 10; ++i) {
+        CacheEntry entry("10.0.0.1", "user", 0);
+        entry.setGain(i / 10.0f);
+        crashedCache->updateUserCacheEntry(entry);
+    }
+
+    UsersDataCache cache(cacheDir);
+    QCOMPARE(cache.getSize(), 1);
+    QCOMPARE(cache.getUserCacheEntry("10.0.0.1", "user", 0).getGain(), 0.9f);
+}
+
+void TestUsersDataCache::corruptedTailIsDiscarded()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    {
+        UsersDataCache cache(cacheDir);
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.1", "user", 0));
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.2", "user", 0));
+    }
+
+    // an incomplete record, like a crash while writing
+    QFile cacheFile(cacheDir.absoluteFilePath("tracks_cache.bin"));
+    QVERIFY(cacheFile.open(QFile::WriteOnly | QFile::Append));
+    cacheFile.write(QByteArray("\x00\x00\x00\x20garbage", 11));
+    cacheFile.close();
+
+    {
+        UsersDataCache cache(cacheDir);
+        QCOMPARE(cache.getSize(), 2);
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.3", "user", 0));
+    }
+
+    UsersDataCache cache(cacheDir);
+    QCOMPARE(cache.getSize(), 3);
+}
+
+void TestUsersDataCache::logIsCompacted()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    UsersDataCache cache(cacheDir);
+    for (int i = 0; i < 5000; ++i) {
+        CacheEntry entry("10.0.0.1", "user", i % 4);
+        entry.setGain(i / 5000.0f);
+        cache.updateUserCacheEntry(entry);
+    }
+
+    QCOMPARE(cache.getSize(), 4);
+    QVERIFY(cache.getLogRecords() < 1000);
+
+    cache.compact();
+    QCOMPARE(cache.getLogRecords(), 4);
+}
+
+void TestUsersDataCache::leastRecentlyUsedAreEvicted()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    {
+        UsersDataCache cache(cacheDir);
+        cache.setMaxEntries(2);
+
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.1", "first", 0));
+        QTest::qSleep(5);
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.2", "second", 0));
+        QTest::qSleep(5);
+        cache.getUserCacheEntry("10.0.0.1", "first", 0); // 'second' is now the least recently used
+        QTest::qSleep(5);
+        cache.updateUserCacheEntry(CacheEntry("10.0.0.3", "third", 0));
+
+        QCOMPARE(cache.getSize(), 2);
+    }
+
+    UsersDataCache cache(cacheDir);
+    QCOMPARE(cache.getSize(), 2);
+    QCOMPARE(cache.getLogRecords(), 2);
+}
+
+void TestUsersDataCache::legacyFileIsConverted()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir cacheDir(tempDir.path());
+
+    {
+        QMap<QString, CacheEntry> legacyEntries;
+        CacheEntry entry("10.0.0.1", "user", 0);
+        entry.setBoost(2.0f);
+        legacyEntries.insert("10.0.0.1user0", entry);
+
+        QFile cacheFile(cacheDir.absoluteFilePath("tracks_cache.bin"));
+        QVERIFY(cacheFile.open(QFile::WriteOnly));
+        QDataStream stream(&cacheFile);
+        stream << CacheHeader(UsersDataCacheHeader::LEGACY_REVISION) << legacyEntries;
+    }
+
+    {
+        UsersDataCache cache(cacheDir);
+        QCOMPARE(cache.getUserCacheEntry("10.0.0.1", "user", 0).getBoost(), 2.0f);
+    }
+
+    UsersDataCache cache(cacheDir);
+    QCOMPARE(cache.getLogRecords(), 1);
+    QCOMPARE(cache.getUserCacheEntry("10.0.0.1", "user", 0).getBoost(), 2.0f);
+}
+
 int main(int argc, char *argv[])
 {
+    QStandardPaths::setTestModeEnabled(true); // UsersDataCache is moving the cache file found in the old data dir
+
     int status = 0;
 
     {
@@ -0,0 +1,97 @@
+#include <QObject>
+#include <QImage>
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+#include "video/VideoFrameScaler.h"
+
+class TestVideoFrameScaler: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void targetRect_data();
+    void targetRect();
+    void scaledImageSize_data();
+    void scaledImageSize();
+    void scaledImagesAreReused();
+};
+
+void TestVideoFrameScaler::targetRect_data()
+{
+    QTest::addColumn<QSize>("imageSize");
+    QTest::addColumn<QSize>("widgetSize");
+    QTest::addColumn<QRect>("expectedRect");
+
+    QTest::newRow("Same size") << QSize(320, 240) << QSize(320, 240) << QRect(0, 0, 320, 240);
+    QTest::newRow("Wide widget") << QSize(320, 240) << QSize(400, 240) << QRect(40, 0, 320, 240);
+    QTest::newRow("Tall widget") << QSize(320, 240) << QSize(320, 400) << QRect(0, 80, 320, 240);
+    QTest::newRow("Upscaling") << QSize(160, 120) << QSize(640, 480) << QRect(0, 0, 640, 480);
+    QTest::newRow("Wide widget smaller than image") << QSize(640, 480) << QSize(300, 120) << QRect(70, 0, 160, 120);
+    QTest::newRow("Wide image in wide widget") << QSize(1280, 480) << QSize(400, 300) << QRect(0, 75, 400, 150);
+    QTest::newRow("Empty image") << QSize() << QSize(100, 50) << QRect(0, 0, 100, 50);
+}
+
+void TestVideoFrameScaler::targetRect()
+{
+    QFETCH(QSize, imageSize);
+    QFETCH(QSize, widgetSize);
+    QFETCH(QRect, expectedRect);
+
+    QCOMPARE(VideoFrameScaler::computeTargetRect(imageSize, widgetSize), expectedRect);
+}
+
+void TestVideoFrameScaler::scaledImageSize_data()
+{
+    QTest::addColumn<QSize>("targetSize");
+    QTest::addColumn<qreal>("devicePixelRatio");
+
+    QTest::newRow("Standard display") << QSize(160, 120) << 1.0;
+    QTest::newRow("High DPI display") << QSize(320, 240) << 2.0;
+}
+
+void TestVideoFrameScaler::scaledImageSize()
+{
+    QFETCH(QSize, targetSize);
+    QFETCH(qreal, devicePixelRatio);
+
+    VideoFrameScaler scaler;
+    QSignalSpy spy(&scaler, SIGNAL(frameScaled(QImage)));
+
+    QImage frame(640, 480, QImage::Format_RGB32);
+    frame.fill(Qt::red);
+    scaler.scale(frame, targetSize, devicePixelRatio);
+
+    QVERIFY(spy.count() > 0 || spy.wait());
+
+    QImage scaledImage = spy.first().first().value<QImage>();
+    QCOMPARE(scaledImage.size(), targetSize); // in device pixels
+    QCOMPARE(scaledImage.devicePixelRatio(), devicePixelRatio);
+    QCOMPARE(scaledImage.pixel(targetSize.width()/2, targetSize.height()/2), QColor(Qt::red).rgb());
+}
+
+void TestVideoFrameScaler::scaledImagesAreReused()
+{
+    VideoFrameScaler scaler;
+    QSignalSpy spy(&scaler, SIGNAL(frameScaled(QImage)));
+
+    QImage frame(640, 480, QImage::Format_RGB32);
+    frame.fill(Qt::blue);
+
+    const QSize targetSize(320, 240);
+    QList<const uchar *> usedBuffers;
+    for (int i = 0; i < 4; ++i) {
+        scaler.scale(frame, targetSize);
+        QVERIFY(spy.count() > 0 || spy.wait());
+
+        QImage scaledImage = spy.takeFirst().first().value<QImage>();
+        usedBuffers.append(scaledImage.constBits());
+        // the scaled image is released here, like the widget does when the next frame is received
+    }
+
+    // the released images are reused by the scaler, no new image for every frame
+    QVERIFY(usedBuffers.toSet().size() <= 2);
+}
+
+QTEST_MAIN(TestVideoFrameScaler)
+
+#include "tst_VideoFrameScaler.moc"
@@ -0,0 +1,12 @@
+QT += testlib concurrent
+CONFIG += testcase
+TEMPLATE = app
+TARGET = video
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+VPATH += ../../../src/Common
+
+HEADERS += video/VideoFrameScaler.h
+
+SOURCES += video/VideoFrameScaler.cpp
+SOURCES += tst_VideoFrameScaler.cpp
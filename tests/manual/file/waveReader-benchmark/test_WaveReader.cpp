@@ -0,0 +1,117 @@
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+#include <file/WaveFileReader.h>
+#include <file/WaveFileWriter.h>
+
+/**
+ * This test is measuring the wave file reading throughput (MB/s). The per sample QDataStream
+ * reader used before the memory mapped reader is reproduced here as reference.
+ */
+
+using namespace Audio;
+
+static bool readUsingDataStream(const QString &filePath, SamplesBuffer &outBuffer)
+{
+    QFile wavFile(filePath);
+    if (!wavFile.open(QFile::ReadOnly))
+        return false;
+
+    QByteArray wavFileContent = wavFile.readAll();
+    QDataStream stream(&wavFileContent, QIODevice::ReadOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    // the test files are written by WaveFileWriter, the header is always 44 bytes
+    stream.skipRawData(22);
+    quint16 channels;
+    stream >> channels;
+    stream.skipRawData(12);
+    quint16 bitsPerSample;
+    stream >> bitsPerSample;
+    stream.skipRawData(4);
+    quint32 dataSize;
+    stream >> dataSize;
+
+    const uint frames = dataSize / channels / (bitsPerSample / 8);
+    outBuffer.setFrameLenght(frames);
+    for (uint s = 0; s < frames; ++s) {
+        for (int c = 0; c < channels; ++c) {
+            if (bitsPerSample == 16) {
+                qint16 sampleValue;
+                stream >> sampleValue;
+                outBuffer.set(c, s, sampleValue / 32767.0f);
+            }
+            else {
+                char buffer[4];
+                stream.readRawData(buffer, 4);
+                float sample = 0;
+                std::memcpy(&sample, &buffer, sizeof(sample));
+                outBuffer.set(c, s, sample);
+            }
+        }
+    }
+
+    return true;
+}
+
+static double toMegabytesPerSecond(qint64 bytes, qint64 nanoSeconds)
+{
+    return (bytes / (1024.0 * 1024.0)) / (nanoSeconds / 1000000000.0);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const quint32 SAMPLE_RATE = 44100;
+    const uint FRAMES = SAMPLE_RATE * 60; // 1 minute
+    const int REPETITIONS = 5;
+
+    SamplesBuffer sine(2, FRAMES);
+    for (uint s = 0; s < FRAMES; ++s) {
+        float value = std::sin(2 * M_PI * 440 * s / SAMPLE_RATE) * 0.8f;
+        sine.set(0, s, value);
+        sine.set(1, s, -value);
+    }
+
+    const quint8 bitDepths[] = {16, 32};
+    for (quint8 bitDepth : bitDepths) {
+        QString filePath = QDir::temp().absoluteFilePath(QString("waveReaderBenchmark_%1.wav").arg(bitDepth));
+        WaveFileWriter().write(filePath, sine, SAMPLE_RATE, bitDepth);
+        qint64 fileSize = QFileInfo(filePath).size();
+
+        qint64 dataStreamTime = 0;
+        qint64 mappedTime = 0;
+        float maxError = 0;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            SamplesBuffer reference(2);
+            QElapsedTimer timer;
+            timer.start();
+            readUsingDataStream(filePath, reference);
+            dataStreamTime += timer.nsecsElapsed();
+
+            SamplesBuffer buffer(2);
+            quint32 sampleRate;
+            timer.restart();
+            WaveFileReader().read(filePath, buffer, sampleRate);
+            mappedTime += timer.nsecsElapsed();
+
+            for (uint s = 0; s < buffer.getFrameLenght(); ++s)
+                maxError = qMax(maxError, std::abs(buffer.get(0, s) - reference.get(0, s)));
+        }
+
+        qInfo() << bitDepth << "bits -> QDataStream:" << toMegabytesPerSecond(fileSize * REPETITIONS, dataStreamTime) << "MB/s"
+                << " Mapped:" << toMegabytesPerSecond(fileSize * REPETITIONS, mappedTime) << "MB/s"
+                << " Max error:" << maxError;
+
+        QFile::remove(filePath);
+    }
+
+    return 0;
+}
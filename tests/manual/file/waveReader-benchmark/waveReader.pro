@@ -0,0 +1,24 @@
+QT += core
+QT -= gui
+CONFIG += console
+TEMPLATE = app
+TARGET = testWaveReader
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../../src/Common
+VPATH += ../../../../src/Common
+
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+HEADERS += file/FileReader.h
+HEADERS += file/WaveFileReader.h
+HEADERS += file/WaveFileWriter.h
+HEADERS += file/MappedWaveFile.h
+
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += file/WaveFileReader.cpp
+SOURCES += file/WaveFileWriter.cpp
+SOURCES += file/MappedWaveFile.cpp
+
+SOURCES += test_WaveReader.cpp
@@ -1,4 +1,4 @@
-QT += core gui widgets multimedia multimediawidgets
+QT += core gui widgets concurrent multimedia multimediawidgets
 
 CONFIG += testcase
 TEMPLATE = app
@@ -48,11 +48,18 @@ RESOURCES += resources/jamtaba.qrc
 SOURCES += jamWindow.cpp
 
 HEADERS += Common/audio/RoomStreamerNode.h
+HEADERS += Common/audio/IntervalTelemetry.h
+HEADERS += Common/audio/HostPositionFollower.h
+HEADERS += Common/audio/RoomStreamPipeline.h
+HEADERS += Common/audio/RoomStreamPrefetcher.h
+HEADERS += Common/audio/core/SamplesRingBuffer.h
 
 HEADERS += Common/persistence/Settings.h
+HEADERS += Common/persistence/SettingsWriter.h
 HEADERS += Common/persistence/UsersDataCache.h
 
 HEADERS += Common/audio/vorbis/VorbisEncoder.h
+HEADERS += Common/audio/vorbis/AdaptiveEncodingQuality.h
 HEADERS += Common/gui/BaseTrackView.h
 HEADERS += Common/gui/BusyDialog.h
 HEADERS += Common/gui/NinjamPanel.h
@@ -82,6 +89,7 @@ HEADERS += Common/gui/widgets/BlinkableButton.h
 HEADERS += Common/gui/widgets/Slider.h
 HEADERS += Common/gui/widgets/UserNameLineEdit.h
 HEADERS += Common/gui/widgets/MapWidget.h
+HEADERS += Common/gui/widgets/MapTilesLoader.h
 HEADERS += Common/gui/widgets/BoostSpinBox.h
 
 HEADERS += Common/gui/chords/ChordProgression.h
@@ -98,6 +106,7 @@ HEADERS += Common/audio/core/AudioNode.h
 HEADERS += Common/video/FFMpegMuxer.h
 HEADERS += Common/video/FFMpegDemuxer.h
 HEADERS += Common/video/VideoWidget.h
+HEADERS += Common/video/VideoFrameScaler.h
 HEADERS += Common/video/VideoFrameGrabber.h
 
 HEADERS += Common/MainController.h
@@ -105,13 +114,19 @@ HEADERS += Common/NinjamController.h
 HEADERS += Common/loginserver/LoginService.h
 HEADERS += Common/geo/IpToLocationResolver.h
 HEADERS += Common/geo/WebIpToLocationResolver.h
+HEADERS += Common/geo/IpLocationTable.h
 HEADERS += Common/ninjam/Service.h
 HEADERS += Common/looper/Looper.h
+HEADERS += Common/looper/LoopInfo.h
+HEADERS += Common/looper/LoopsIndex.h
 
 HEADERS += Standalone/MainControllerStandalone.h
 HEADERS += Standalone/PluginFinder.h
 HEADERS += Standalone/vst/VstPluginFinder.h
+HEADERS += Standalone/vst/VstScanCache.h
 HEADERS += Standalone/vst/VstPlugin.h
+HEADERS += Standalone/vst/SandboxedVstPlugin.h
+HEADERS += Common/vst/SandboxChannel.h
 HEADERS += Standalone/audio/PortAudioDriver.h
 HEADERS += Standalone/gui/LocalTrackViewStandalone.h
 HEADERS += Standalone/gui/LocalTrackGroupViewStandalone.h
@@ -133,7 +148,9 @@ HEADERS += Common/gui/chat/ChatMessagePanel.h
 SOURCES += Standalone/ConfiguratorStandalone.cpp
 SOURCES += Standalone/PluginFinder.cpp
 SOURCES += Standalone/vst/VstPluginFinder.cpp
+SOURCES += Standalone/vst/VstScanCache.cpp
 SOURCES += Standalone/vst/VstPlugin.cpp
+SOURCES += Standalone/vst/SandboxedVstPlugin.cpp
 SOURCES += Standalone/vst/WindowsVstPluginChecker.cpp
 
 SOURCES += Standalone/audio/PortAudioDriver.cpp
@@ -156,19 +173,24 @@ SOURCES += Common/MetronomeUtils.cpp
 SOURCES += Common/vst/VstLoader.cpp
 SOURCES += Common/vst/Utils.cpp
 SOURCES += Common/vst/VstHost.cpp
+SOURCES += Common/vst/SandboxChannel.cpp
 
 SOURCES += Common/video/FFMpegMuxer.cpp
 SOURCES += Common/video/FFMpegDemuxer.cpp
 SOURCES += Common/video/VideoWidget.cpp
+SOURCES += Common/video/VideoFrameScaler.cpp
 SOURCES += Common/video/VideoFrameGrabber.cpp
 
 SOURCES += Common/looper/Looper.cpp
 SOURCES += Common/looper/LooperStates.cpp
 SOURCES += Common/looper/LooperLayer.cpp
 SOURCES += Common/looper/LooperPersistence.cpp
+SOURCES += Common/looper/LoopInfo.cpp
+SOURCES += Common/looper/LoopsIndex.cpp
 
 SOURCES += Common/file/FileReaderFactory.cpp
 SOURCES += Common/file/WaveFileReader.cpp
+SOURCES += Common/file/MappedWaveFile.cpp
 SOURCES += Common/file/WaveFileWriter.cpp
 SOURCES += Common/file/OggFileReader.cpp
 SOURCES += Common/file/Mp3FileReader.cpp
@@ -180,8 +202,10 @@ SOURCES += Common/recorder/ClipSortLogGenerator.cpp
 
 SOURCES += Common/geo/IpToLocationResolver.cpp
 SOURCES += Common/geo/WebIpToLocationResolver.cpp
+SOURCES += Common/geo/IpLocationTable.cpp
 
 SOURCES += Common/persistence/Settings.cpp
+SOURCES += Common/persistence/SettingsWriter.cpp
 SOURCES += Common/persistence/UsersDataCache.cpp
 SOURCES += Common/persistence/CacheHeader.cpp
 
@@ -220,6 +244,7 @@ SOURCES += Common/gui/widgets/UserNameLineEdit.cpp
 SOURCES += Common/gui/widgets/BlinkableButton.cpp
 SOURCES += Common/gui/widgets/LooperWavePanel.cpp
 SOURCES += Common/gui/widgets/MapWidget.cpp
+SOURCES += Common/gui/widgets/MapTilesLoader.cpp
 SOURCES += Common/gui/widgets/BoostSpinBox.cpp
 SOURCES += Common/gui/PreferencesDialog.cpp
 SOURCES += Common/gui/ThemeLoader.cpp
@@ -257,14 +282,20 @@ SOURCES += Common/audio/core/Plugins.cpp
 
 SOURCES += Common/audio/MetronomeTrackNode.cpp
 SOURCES += Common/audio/NinjamTrackNode.cpp
+SOURCES += Common/audio/IntervalTelemetry.cpp
+SOURCES += Common/audio/HostPositionFollower.cpp
 SOURCES += Common/audio/Resampler.cpp
 SOURCES += Common/audio/Mp3Decoder.cpp
 SOURCES += Common/audio/RoomStreamerNode.cpp
+SOURCES += Common/audio/RoomStreamPipeline.cpp
+SOURCES += Common/audio/RoomStreamPrefetcher.cpp
+SOURCES += Common/audio/core/SamplesRingBuffer.cpp
 
 SOURCES += Common/midi/MidiDriver.cpp
 SOURCES += Common/midi/RtMidiDriver.cpp
 SOURCES += Common/midi/MidiMessage.cpp
 SOURCES += Common/audio/vorbis/VorbisEncoder.cpp
+SOURCES += Common/audio/vorbis/AdaptiveEncodingQuality.cpp
 SOURCES += Common/audio/vorbis/VorbisDecoder.cpp
 
 SOURCES += Common/ninjam/Service.cpp
@@ -1,4 +1,4 @@
-QT += core gui widgets
+QT += core gui widgets concurrent
 
 CONFIG += testcase
 TEMPLATE = app
@@ -13,9 +13,11 @@ VPATH += ../../../../src/Common
 SOURCES += test_Map.cpp
 
 HEADERS += gui/widgets/MapWidget.h
+HEADERS += gui/widgets/MapTilesLoader.h
 HEADERS += gui/widgets/MapMarker.h
 
 SOURCES += gui/widgets/MapWidget.cpp
+SOURCES += gui/widgets/MapTilesLoader.cpp
 SOURCES += gui/widgets/MapMarker.cpp
 
 RESOURCES += resource.qrc
@@ -11,10 +11,31 @@
 #include <gui/widgets/PeakMeter.h>
 
 /**
- * This test is stressing the PeakMeter paint and plotting the fps (frames per second).
- * The idea is build a benchmark to compare fps values when optmizing the PeakMeter painting.
+ * This test is stressing the PeakMeter paint and plotting the fps (frames per second) and the
+ * meter paints per second. The idea is build a benchmark to compare the values when optmizing
+ * the PeakMeter painting. Run with --no-cache to measure the old painting (one fillRect per segment).
  */
 
+class BenchmarkMeter : public AudioMeter
+{
+public:
+    explicit BenchmarkMeter(QWidget *parent)
+        : AudioMeter(parent)
+    {
+    }
+
+    static int paintCount;
+
+protected:
+    void paintEvent(QPaintEvent *ev) override
+    {
+        AudioMeter::paintEvent(ev);
+        paintCount++;
+    }
+};
+
+int BenchmarkMeter::paintCount = 0;
+
 class TestMainWindow : public QFrame
 {
 
@@ -27,11 +48,12 @@ public:
         timeCounter.start();
 
         //create meters
-        const int METERS = 64;
+        const int METERS = 100;
         const int METER_WIDTH = 5;
         QHBoxLayout *layout = new QHBoxLayout();
         for (int var = 0; var < METERS; ++var) {
-            AudioMeter *meter = new AudioMeter(this);
+            AudioMeter *meter = new BenchmarkMeter(this);
+            meter->setStereo(true);
             meter->setMinimumWidth(METER_WIDTH);
             layout->addWidget(meter, 1);
         }
@@ -56,9 +78,11 @@ protected:
 
         if(timeCounter.elapsed() >= 1000){
             int fps = frameCount;
-            qInfo() << "FPS:" << fps;
+            qInfo() << "FPS:" << fps << " Meter paints/sec:" << BenchmarkMeter::paintCount
+                    << " Pixmap cache:" << (AudioMeter::isUsingPixmapCache() ? "on" : "off");
             timeCounter.restart();
             frameCount = 0;
+            BenchmarkMeter::paintCount = 0;
         }
     }
 
@@ -66,8 +90,12 @@ protected:
     {
         static float peak = 0;
         QList<AudioMeter *> meters = findChildren<AudioMeter *>();
+        int index = 0;
         foreach (AudioMeter *meter, meters) {
-            meter->setPeak(peak, peak);
+            float leftPeak = std::fmod(peak + index * 0.01f, 1.0f);
+            float rightPeak = std::fmod(peak + index * 0.02f, 1.0f);
+            meter->setPeak(leftPeak, rightPeak, leftPeak * 0.7f, rightPeak * 0.7f);
+            index++;
         }
         peak += 0.00001f;
         //peak = 0.11f;
@@ -86,6 +114,10 @@ private:
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
+
+    if (app.arguments().contains("--no-cache"))
+        AudioMeter::setUsingPixmapCache(false);
+
     TestMainWindow window;
 
     window.show();
@@ -0,0 +1,112 @@
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QFile>
+#include <QDir>
+#include <QMap>
+#include <QDebug>
+#include <persistence/UsersDataCache.h>
+#include <persistence/CacheHeader.h>
+
+/**
+ * This test is measuring the UsersDataCache load (startup) and save (shutdown) times. The whole
+ * QMap file used before the append only log is reproduced here as reference.
+ */
+
+using namespace Persistence;
+
+static CacheEntry createEntry(int index)
+{
+    QString ip = QString("%1.%2.%3.x").arg(index / 65536 % 256).arg(index / 256 % 256).arg(index % 256);
+    CacheEntry entry(ip, QString("user_%1").arg(index), index % 4);
+    entry.setGain((index % 100) / 100.0f);
+    entry.setPan((index % 9) - 4.0f);
+    entry.setMuted(index % 7 == 0);
+    return entry;
+}
+
+static void writeLegacyFile(const QString &filePath, const QMap<QString, CacheEntry> &entries)
+{
+    QFile cacheFile(filePath);
+    if (cacheFile.open(QFile::WriteOnly)) {
+        QDataStream stream(&cacheFile);
+        stream << CacheHeader(UsersDataCacheHeader::LEGACY_REVISION) << entries;
+    }
+}
+
+static QMap<QString, CacheEntry> readLegacyFile(const QString &filePath)
+{
+    QMap<QString, CacheEntry> entries;
+    QFile cacheFile(filePath);
+    if (cacheFile.open(QFile::ReadOnly)) {
+        QDataStream stream(&cacheFile);
+        CacheHeader cacheHeader;
+        stream >> cacheHeader >> entries;
+    }
+    return entries;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+
+    const int ENTRIES = argc > 1 ? QString(argv[1]).toInt() : 50000;
+    const int UPDATES = 1000;
+
+    QTemporaryDir tempDir;
+    QDir cacheDir(tempDir.path());
+    QString legacyFilePath = cacheDir.absoluteFilePath("legacy_cache.bin");
+
+    QMap<QString, CacheEntry> legacyEntries;
+    for (int i = 0; i < ENTRIES; ++i) {
+        CacheEntry entry = createEntry(i);
+        legacyEntries.insert(entry.getUserIP() + entry.getUserName() + QString::number(entry.getChannelID()), entry);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    writeLegacyFile(legacyFilePath, legacyEntries);
+    qint64 legacySaveTime = timer.elapsed();
+
+    timer.restart();
+    int legacyLoaded = readLegacyFile(legacyFilePath).size();
+    qint64 legacyLoadTime = timer.elapsed();
+
+    qInfo() << "Legacy QMap file (" << legacyLoaded << "entries ) -> load:" << legacyLoadTime << "ms"
+            << " save:" << legacySaveTime << "ms";
+
+    // converting the legacy file (first startup after the update)
+    QFile::copy(legacyFilePath, cacheDir.absoluteFilePath("tracks_cache.bin"));
+    timer.restart();
+    {
+        UsersDataCache cache(cacheDir);
+    }
+    qInfo() << "Legacy file conversion:" << timer.elapsed() << "ms";
+
+    // regular startup, some jam session changes and shutdown
+    timer.restart();
+    UsersDataCache *cache = new UsersDataCache(cacheDir);
+    qint64 loadTime = timer.elapsed();
+
+    timer.restart();
+    for (int i = 0; i < UPDATES; ++i) {
+        CacheEntry entry = cache->getUserCacheEntry("1.2.3.x", "jammer", i % 4);
+        entry.setGain((i % 100) / 100.0f);
+        cache->updateUserCacheEntry(entry);
+    }
+    qint64 updatesTime = timer.nsecsElapsed();
+
+    timer.restart();
+    int size = cache->getSize();
+    delete cache;
+    qint64 saveTime = timer.elapsed();
+
+    qInfo() << "Append log (" << size << "entries ) -> load:" << loadTime << "ms"
+            << " save:" << saveTime << "ms"
+            << " update:" << (updatesTime / UPDATES / 1000.0) << "us";
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+QT += core
+QT -= gui
+CONFIG += console
+TEMPLATE = app
+TARGET = testUsersDataCache
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../../src/Common
+VPATH += ../../../../src/Common
+
+HEADERS += log/Logging.h
+HEADERS += persistence/UsersDataCache.h
+HEADERS += persistence/CacheHeader.h
+
+SOURCES += log/logging.cpp
+SOURCES += persistence/UsersDataCache.cpp
+SOURCES += persistence/CacheHeader.cpp
+
+SOURCES += test_UsersDataCache.cpp
@@ -0,0 +1,86 @@
+#include <QApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QDebug>
+#include <vst/VstPluginFinder.h>
+
+/**
+ * This test is measuring the VST scan time. A full scan (empty scan cache) using just one scanner process (the old
+ * behavior), a full scan using parallel scanner processes and an incremental rescan (all plugins cached) are compared.
+ *
+ * Usage: testVstScan <VstScanner executable> <plugins folder> [<plugins folder> ...]
+ */
+
+class BenchmarkPluginFinder : public audio::VSTPluginFinder
+{
+public:
+    BenchmarkPluginFinder(const QDir &cacheDir, const QString &scannerPath) :
+        VSTPluginFinder(cacheDir),
+        scannerPath(scannerPath)
+    {
+    }
+
+protected:
+    QString getScannerExecutablePath() const override
+    {
+        return scannerPath;
+    }
+
+private:
+    QString scannerPath;
+};
+
+static qint64 runScan(BenchmarkPluginFinder &finder, const QStringList &folders, int &foundedPlugins)
+{
+    foundedPlugins = 0;
+    QObject::connect(&finder, &audio::PluginFinder::pluginScanFinished, [&foundedPlugins](){
+        foundedPlugins++;
+    });
+
+    QEventLoop loop;
+    QObject::connect(&finder, &audio::PluginFinder::scanFinished, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    finder.scan(folders);
+    loop.exec();
+
+    finder.disconnect();
+
+    return timer.elapsed();
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    if (argc < 3) {
+        qInfo() << "Usage: testVstScan <VstScanner executable> <plugins folder> [<plugins folder> ...]";
+        return 1;
+    }
+
+    QString scannerPath = QString::fromLocal8Bit(argv[1]);
+    QStringList folders;
+    for (int i = 2; i < argc; ++i)
+        folders << QString::fromLocal8Bit(argv[i]);
+
+    QTemporaryDir cacheDir;
+    BenchmarkPluginFinder finder(QDir(cacheDir.path()), scannerPath);
+    int plugins = 0;
+
+    finder.setMaxScanProcesses(1);
+    qint64 serialTime = runScan(finder, folders, plugins);
+    qInfo() << "Full scan, 1 process:" << serialTime << "ms," << plugins << "plugins";
+
+    finder.clearScanCache();
+    finder.setMaxScanProcesses(QThread::idealThreadCount());
+    qint64 parallelTime = runScan(finder, folders, plugins);
+    qInfo() << "Full scan," << QThread::idealThreadCount() << "processes:" << parallelTime << "ms," << plugins << "plugins";
+
+    qint64 incrementalTime = runScan(finder, folders, plugins);
+    qInfo() << "Incremental rescan:" << incrementalTime << "ms," << plugins << "plugins";
+
+    return 0;
+}
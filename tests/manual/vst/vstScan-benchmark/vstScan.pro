@@ -0,0 +1,26 @@
+QT += core gui widgets concurrent
+CONFIG += console
+TEMPLATE = app
+TARGET = testVstScan
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../../src/Common
+INCLUDEPATH += ../../../../src/Standalone
+VPATH += ../../../../src/Common
+VPATH += ../../../../src/Standalone
+
+HEADERS += PluginFinder.h
+HEADERS += vst/VstPluginFinder.h
+HEADERS += vst/VstScanCache.h
+HEADERS += audio/core/PluginDescriptor.h
+HEADERS += persistence/CacheHeader.h
+HEADERS += log/Logging.h
+
+SOURCES += PluginFinder.cpp
+SOURCES += vst/VstPluginFinder.cpp
+SOURCES += vst/VstScanCache.cpp
+SOURCES += audio/core/PluginDescriptor.cpp
+SOURCES += persistence/CacheHeader.cpp
+SOURCES += log/logging.cpp
+
+SOURCES += test_VstScan.cpp